@@ -0,0 +1,98 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      :
+// Revision    :
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "Compression.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef ECF_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace ecf {
+
+// The uncompressed size is stored as 8 bytes, little endian, in front of the compressed data
+static const std::size_t size_prefix_length = 8;
+
+bool Compression::available() {
+#ifdef ECF_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef ECF_ZLIB
+void Compression::compress(const std::string& data, std::string& compressed) {
+    uLongf compressed_size = compressBound(data.size());
+    compressed.resize(size_prefix_length + compressed_size);
+
+    std::uint64_t data_size = data.size();
+    for (std::size_t i = 0; i < size_prefix_length; i++) {
+        compressed[i] = static_cast<char>((data_size >> (8 * i)) & 0xff);
+    }
+
+    // Favour speed over size, since compression is done by the single threaded server
+    int ret = compress2(reinterpret_cast<Bytef*>(&compressed[size_prefix_length]),
+                        &compressed_size,
+                        reinterpret_cast<const Bytef*>(data.data()),
+                        data.size(),
+                        Z_BEST_SPEED);
+    if (ret != Z_OK) {
+        throw std::runtime_error("Compression::compress: failed with zlib error " + std::to_string(ret));
+    }
+    compressed.resize(size_prefix_length + compressed_size);
+}
+
+void Compression::decompress(const char* compressed,
+                             std::size_t compressed_size,
+                             std::string& data,
+                             std::size_t max_size) {
+    if (compressed_size < size_prefix_length) {
+        throw std::runtime_error("Compression::decompress: data too short");
+    }
+
+    std::uint64_t data_size = 0;
+    for (std::size_t i = 0; i < size_prefix_length; i++) {
+        data_size |= static_cast<std::uint64_t>(static_cast<unsigned char>(compressed[i])) << (8 * i);
+    }
+
+    if (data_size > max_size) {
+        throw std::runtime_error("Compression::decompress: uncompressed size " + std::to_string(data_size) +
+                                 " exceeds the limit of " + std::to_string(max_size));
+    }
+
+    data.resize(data_size);
+    uLongf uncompressed_size = data_size;
+    int ret                  = uncompress(reinterpret_cast<Bytef*>(&data[0]),
+                                          &uncompressed_size,
+                                          reinterpret_cast<const Bytef*>(compressed + size_prefix_length),
+                                          compressed_size - size_prefix_length);
+    if (ret != Z_OK || uncompressed_size != data_size) {
+        throw std::runtime_error("Compression::decompress: failed with zlib error " + std::to_string(ret));
+    }
+}
+#else
+void Compression::compress(const std::string&, std::string&) {
+    throw std::runtime_error("Compression::compress: ecflow was built without zlib");
+}
+
+void Compression::decompress(const char*, std::size_t, std::string&, std::size_t) {
+    throw std::runtime_error("Compression::decompress: ecflow was built without zlib");
+}
+#endif
+
+} // namespace ecf
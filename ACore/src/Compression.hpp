@@ -0,0 +1,47 @@
+#ifndef COMPRESSION_HPP_
+#define COMPRESSION_HPP_
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      :
+// Revision    :
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Compression of the data sent between client and server.
+//               Only available when ecflow is built with zlib (ECF_ZLIB).
+//               The compressed data is prefixed with the uncompressed size.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <string>
+
+namespace ecf {
+
+class Compression {
+public:
+    /// Returns true if compression is supported by this build
+    static bool available();
+
+    /// Compress 'data' into 'compressed'.
+    /// Throws std::runtime_error if compression is not available, or fails
+    static void compress(const std::string& data, std::string& compressed);
+
+    /// Decompress data, as produced by compress(), into 'data'.
+    /// The size prefix comes from the peer, hence it is checked against 'max_size' before any allocation.
+    /// Throws std::runtime_error if compression is not available, data is corrupt, or larger than 'max_size'
+    static void decompress(const char* compressed, std::size_t compressed_size, std::string& data, std::size_t max_size);
+
+private:
+    Compression()                                    = delete;
+    Compression(const Compression&)                  = delete;
+    const Compression& operator=(const Compression&) = delete;
+};
+
+} // namespace ecf
+
+#endif
@@ -653,8 +653,10 @@ std::string File::diff(const std::string& file,
     return std::string();
 }
 
-std::string
-File::backwardSearch(const std::string& rootPath, const std::string& nodePath, const std::string& fileExtn) {
+std::string File::backwardSearch(const std::string& rootPath,
+                                 const std::string& nodePath,
+                                 const std::string& fileExtn,
+                                 size_t* probes) {
     // Do a backward search of rootPath + nodePath
     // If task path if of the form /suite/family/family2/task, then we keep
     // on consuming the first path token this should leave:
@@ -684,6 +686,8 @@ File::backwardSearch(const std::string& rootPath, const std::string& nodePath, c
         std::string combinedPath = rootPath;
         combinedPath += path;
 
+        if (probes)
+            (*probes)++;
         try {
             if (fs::exists(combinedPath)) {
 #ifdef DEBUG_TASK_LOCATION
@@ -709,6 +713,8 @@ File::backwardSearch(const std::string& rootPath, const std::string& nodePath, c
     // Look for file in the root path
     std::string ecf_file  = leafName + fileExtn;
     fs::path ecf_filePath = fs::path(fs::path(rootPath) / ecf_file);
+    if (probes)
+        (*probes)++;
     if (fs::exists(ecf_filePath)) {
 #ifdef DEBUG_TASK_LOCATION
         std::cout << "backwardSearch Node " << leafName << " Found " << ecf_file << " in root path '" << rootPath
@@ -722,7 +728,10 @@ File::backwardSearch(const std::string& rootPath, const std::string& nodePath, c
     return string();
 }
 
-std::string File::forwardSearch(const std::string& rootPath, const std::string& nodePath, const std::string& fileExtn) {
+std::string File::forwardSearch(const std::string& rootPath,
+                                const std::string& nodePath,
+                                const std::string& fileExtn,
+                                size_t* probes) {
     /// Do a forward search of rootPath + nodePath + fileExtn
     /// If task path if of the form /suite/family/family2/task, then we keep
     /// on consuming the last path token this should leave:
@@ -752,6 +761,8 @@ std::string File::forwardSearch(const std::string& rootPath, const std::string&
         std::string combinedPath = rootPath;
         combinedPath += path;
 
+        if (probes)
+            (*probes)++;
         try {
             if (fs::exists(combinedPath)) {
 #ifdef DEBUG_TASK_LOCATION
@@ -783,6 +794,8 @@ std::string File::forwardSearch(const std::string& rootPath, const std::string&
     // Look for file in the root path
     std::string ecf_file  = leafName + fileExtn;
     fs::path ecf_filePath = fs::path(fs::path(rootPath) / ecf_file);
+    if (probes)
+        (*probes)++;
 
     try {
         if (fs::exists(ecf_filePath)) {
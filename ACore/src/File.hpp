@@ -133,9 +133,11 @@ public:
     ///   	<root-path>/family/family2/task.ecf
     ///  	   <root-path>/family2/task.ecf
     ///   	<root-path>/task.ecf
-    /// Returns an empty string if file not found
-    static std::string
-    backwardSearch(const std::string& rootPath, const std::string& nodePath, const std::string& fileExtn);
+    /// Returns an empty string if file not found. probes, if given, is incremented for each file checked
+    static std::string backwardSearch(const std::string& rootPath,
+                                      const std::string& nodePath,
+                                      const std::string& fileExtn,
+                                      size_t* probes = nullptr);
 
     /// Do a forward search of rootPath + nodePath + fileExtn
     /// If task path if of the form /suite/family/family2/task, then we keep
@@ -144,9 +146,11 @@ public:
     ///      <root-path>/suite/family/task.ecf
     ///      <root-path>/suite/task.ecf
     ///      <root-path>/task.ecf
-    /// Returns an empty string if file not found
-    static std::string
-    forwardSearch(const std::string& rootPath, const std::string& nodePath, const std::string& fileExtn);
+    /// Returns an empty string if file not found. probes, if given, is incremented for each file checked
+    static std::string forwardSearch(const std::string& rootPath,
+                                     const std::string& nodePath,
+                                     const std::string& fileExtn,
+                                     size_t* probes = nullptr);
 
     // Remove a directory recursively ****
     static bool removeDir(const boost::filesystem::path& p);
@@ -60,6 +60,7 @@ void Log::create_logimpl() {
 }
 
 bool Log::log(Log::LogType lt, const std::string& message) {
+    std::lock_guard<std::mutex> lock(mx_);
     create_logimpl();
 
     //   if (!logImpl_->log_open_error().empty()) {
@@ -78,6 +79,7 @@ bool Log::log(Log::LogType lt, const std::string& message) {
 }
 
 bool Log::log_no_newline(Log::LogType lt, const std::string& message) {
+    std::lock_guard<std::mutex> lock(mx_);
     create_logimpl();
 
     //   if (!logImpl_->log_open_error().empty()) {
@@ -96,6 +98,7 @@ bool Log::log_no_newline(Log::LogType lt, const std::string& message) {
 }
 
 bool Log::append(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mx_);
     create_logimpl();
 
     //   if (!logImpl_->log_open_error().empty()) {
@@ -114,6 +117,7 @@ bool Log::append(const std::string& message) {
 }
 
 void Log::cache_time_stamp() {
+    std::lock_guard<std::mutex> lock(mx_);
     create_logimpl();
     logImpl_->create_time_stamp();
 }
@@ -123,12 +127,14 @@ const std::string& Log::get_cached_time_stamp() const {
 }
 
 void Log::flush() {
+    std::lock_guard<std::mutex> lock(mx_);
     // will close ofstream and force data to be written to disk.
     // Forcing writing to physical medium can't be guaranteed though!
     logImpl_.reset();
 }
 
 void Log::flush_only() {
+    std::lock_guard<std::mutex> lock(mx_);
     if (logImpl_)
         logImpl_->flush();
 }
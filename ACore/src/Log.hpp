@@ -32,6 +32,7 @@
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -117,6 +118,7 @@ private:
     std::unique_ptr<LogImpl> logImpl_;
     std::string fileName_;
     std::string log_error_;
+    std::mutex mx_; // the server can log from several threads, see ECF_READ_THREADS
 };
 
 // Flush log on destruction
@@ -22,6 +22,7 @@
 #include <string>
 
 #include <cereal/archives/json.hpp>
+#include <cereal/archives/portable_binary.hpp>
 #include <cereal/types/deque.hpp>
 #include <cereal/types/map.hpp>
 #include <cereal/types/memory.hpp>
@@ -29,10 +30,16 @@
 #include <cereal/types/utility.hpp>
 #include <cereal/types/vector.hpp>
 
+#include "StreamBuffer.hpp"
 #include "cereal_optional_nvp.hpp"
 
 namespace ecf {
 
+/// The archive used when serialising to/from a string.
+/// JSON is human readable and is always used for files. PORTABLE_BINARY is a compact
+/// alternative used on the wire, between a client and server that both support it.
+enum class ArchiveFormat { JSON, PORTABLE_BINARY };
+
 template <typename T>
 void save(const std::string& fileName, const T& t) {
     std::ofstream os(fileName);
@@ -52,9 +59,15 @@ void restore(const std::string& fileName, T& restored) {
 }
 
 template <typename T>
-void save_as_string(std::string& outbound_data, const T& t) {
-    std::ostringstream archive_stream;
-    {
+void save_as_string(std::string& outbound_data, const T& t, ArchiveFormat format = ArchiveFormat::JSON) {
+    // Write directly into outbound_data, reusing its capacity, rather than copying from a std::ostringstream
+    StringOutputBuffer archive_buffer(outbound_data);
+    std::ostream archive_stream(&archive_buffer);
+    if (format == ArchiveFormat::PORTABLE_BINARY) {
+        cereal::PortableBinaryOutputArchive oarchive(archive_stream);
+        oarchive(t);
+    }
+    else {
 #ifdef DEBUG
         cereal::JSONOutputArchive oarchive(archive_stream); // Use default Indent can be very slow
 #else
@@ -65,14 +78,30 @@ void save_as_string(std::string& outbound_data, const T& t) {
         // contents to its stream.
         oarchive(cereal::make_nvp(typeid(t).name(), t)); // Write the data to the archive
     }
-    outbound_data = archive_stream.str();
+    archive_buffer.finish();
+}
+
+/// Restore from a character array, which is read in place, i.e. without taking a copy
+template <typename T>
+void restore_from_buffer(const char* archive_data,
+                         std::size_t archive_size,
+                         T& restored,
+                         ArchiveFormat format = ArchiveFormat::JSON) {
+    CharArrayInputBuffer archive_buffer(archive_data, archive_size);
+    std::istream archive_stream(&archive_buffer);
+    if (format == ArchiveFormat::PORTABLE_BINARY) {
+        cereal::PortableBinaryInputArchive iarchive(archive_stream);
+        iarchive(restored);
+    }
+    else {
+        cereal::JSONInputArchive iarchive(archive_stream); // Create an input archive
+        iarchive(restored);                                // Read the data from the archive
+    }
 }
 
 template <typename T>
-void restore_from_string(const std::string& archive_data, T& restored) {
-    std::istringstream archive_stream(archive_data);
-    cereal::JSONInputArchive iarchive(archive_stream); // Create an input archive
-    iarchive(restored);                                // Read the data from the archive
+void restore_from_string(const std::string& archive_data, T& restored, ArchiveFormat format = ArchiveFormat::JSON) {
+    restore_from_buffer(archive_data.data(), archive_data.size(), restored, format);
 }
 
 } // namespace ecf
@@ -80,13 +109,20 @@ void restore_from_string(const std::string& archive_data, T& restored) {
 //// Place archive in CPP file requires we template specialize the archives
 //// Note that we need to instantiate for both loading and saving, even
 //// if we use a single serialize function
-#define CEREAL_TEMPLATE_SPECIALIZE(T)                                                  \
-    template void T::serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&); \
-    template void T::serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&)
+#define CEREAL_TEMPLATE_SPECIALIZE(T)                                                                      \
+    template void T::serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&);                     \
+    template void T::serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&);                       \
+    template void T::serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&); \
+    template void T::serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&)
 
-#define CEREAL_TEMPLATE_SPECIALIZE_V(T)                                                     \
-    template void T::serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&,       \
-                                                          std::uint32_t const /*version*/); \
-    template void T::serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&, std::uint32_t const /*version*/)
+#define CEREAL_TEMPLATE_SPECIALIZE_V(T)                                                                    \
+    template void T::serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&,                      \
+                                                          std::uint32_t const /*version*/);                \
+    template void T::serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&,                        \
+                                                         std::uint32_t const /*version*/);                 \
+    template void T::serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&,  \
+                                                                    std::uint32_t const /*version*/);      \
+    template void T::serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&,    \
+                                                                   std::uint32_t const /*version*/)
 
 #endif
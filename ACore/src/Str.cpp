@@ -165,6 +165,14 @@ const std::string& Str::ECF_JOB_CMD() {
     static std::string ECF_JOB_CMD = "ECF_JOB_CMD";
     return ECF_JOB_CMD;
 }
+const std::string& Str::ECF_JOB_BATCH_CMD() {
+    static std::string ECF_JOB_BATCH_CMD = "ECF_JOB_BATCH_CMD";
+    return ECF_JOB_BATCH_CMD;
+}
+const std::string& Str::ECF_JOB_HOST() {
+    static std::string ECF_JOB_HOST = "ECF_JOB_HOST";
+    return ECF_JOB_HOST;
+}
 const std::string& Str::ECF_OUT() {
     static std::string ECF_OUT = "ECF_OUT";
     return ECF_OUT;
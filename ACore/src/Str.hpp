@@ -177,6 +177,8 @@ public:
     static const std::string& ECF_HOME();
     static const std::string& ECF_INCLUDE();
     static const std::string& ECF_JOB_CMD();
+    static const std::string& ECF_JOB_BATCH_CMD();
+    static const std::string& ECF_JOB_HOST();
     static const std::string& ECF_OUT();
     static const std::string& ECF_EXTN();
     static const std::string& ECF_LOG();
@@ -0,0 +1,114 @@
+#ifndef STREAM_BUFFER_HPP_
+#define STREAM_BUFFER_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Stream buffers that read from/write to existing memory.
+//               std::istringstream/std::ostringstream always take a copy of
+//               their data, which for large definitions is expensive.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <algorithm>
+#include <cstring>
+#include <streambuf>
+#include <string>
+
+namespace ecf {
+
+/// Read only stream buffer over a character array. The array is *not* copied,
+/// hence it must outlive the buffer.
+class CharArrayInputBuffer : public std::streambuf {
+public:
+    CharArrayInputBuffer(const char* data, std::size_t size) {
+        char* begin = const_cast<char*>(data); // the get area is never written to
+        setg(begin, begin, begin + size);
+    }
+    CharArrayInputBuffer(const CharArrayInputBuffer&)            = delete;
+    CharArrayInputBuffer& operator=(const CharArrayInputBuffer&) = delete;
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+        char* pos = gptr();
+        if (dir == std::ios_base::beg)
+            pos = eback();
+        else if (dir == std::ios_base::end)
+            pos = egptr();
+        if (off < eback() - pos || off > egptr() - pos)
+            return pos_type(off_type(-1));
+        setg(eback(), pos + off, egptr());
+        return pos_type(gptr() - eback());
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+/// Stream buffer that writes directly into a std::string. Any existing content is
+/// discarded, but the capacity of the string is reused. The string has the correct
+/// size after finish() is called, or when the buffer is destroyed.
+class StringOutputBuffer : public std::streambuf {
+public:
+    explicit StringOutputBuffer(std::string& str)
+        : str_(str) {
+        str_.resize(str_.capacity());
+        setp(&str_[0], &str_[0] + str_.size());
+    }
+    ~StringOutputBuffer() override { finish(); }
+    StringOutputBuffer(const StringOutputBuffer&)            = delete;
+    StringOutputBuffer& operator=(const StringOutputBuffer&) = delete;
+
+    /// Trim the string to the characters written so far. Further writes are appended.
+    void finish() {
+        committed_ += pptr() - pbase();
+        str_.resize(committed_);
+        setp(&str_[0] + committed_, &str_[0] + committed_);
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+        grow(1);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (epptr() - pptr() < n)
+            grow(static_cast<std::size_t>(n));
+        std::memcpy(pptr(), s, static_cast<std::size_t>(n));
+        setp(pptr() + n, epptr()); // n may exceed the range of pbump()
+        committed_ = pbase() - &str_[0];
+        return n;
+    }
+
+private:
+    /// Ensure there is room for at least n more characters in the put area
+    void grow(std::size_t n) {
+        std::size_t used = committed_ + (pptr() - pbase());
+        str_.resize(std::max(used + n, std::max<std::size_t>(2 * str_.size(), 256)));
+        committed_ = used;
+        setp(&str_[0] + used, &str_[0] + str_.size());
+    }
+
+    std::string& str_;
+    std::size_t committed_{0}; /// Number of characters written before pbase()
+};
+
+} // namespace ecf
+
+#endif
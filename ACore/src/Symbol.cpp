@@ -0,0 +1,78 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "Symbol.hpp"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+
+namespace ecf {
+
+// Keyed by a view of the string held in the entry. The entries are heap allocated, hence the
+// pointers held by Symbols stay valid on re-hash. Symbols may be created concurrently, hence the mutex.
+// An entry is only ever removed, or its count raised from zero, with the mutex held.
+struct SymbolTable {
+    std::mutex mutex_;
+    std::unordered_map<std::string_view, std::unique_ptr<Symbol::Entry>> entries_;
+};
+
+static SymbolTable& table() {
+    // Never destroyed, since Symbols with static storage may out live it
+    static SymbolTable* the_table = new SymbolTable;
+    return *the_table;
+}
+
+const std::string& Symbol::empty_string() {
+    static const std::string the_empty_string;
+    return the_empty_string;
+}
+
+const Symbol::Entry* Symbol::intern(const std::string& s) {
+    if (s.empty())
+        return nullptr;
+
+    SymbolTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex_);
+    auto i = t.entries_.find(std::string_view(s));
+    if (i == t.entries_.end()) {
+        auto entry = std::make_unique<Entry>(s);
+        i          = t.entries_.emplace(std::string_view(entry->str_), std::move(entry)).first;
+    }
+    i->second->refs_.fetch_add(1, std::memory_order_relaxed);
+    return i->second.get();
+}
+
+void Symbol::release_last(const Entry* e) {
+    SymbolTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex_);
+    // The count may have been raised by intern(), while waiting for the lock
+    if (e->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        t.entries_.erase(t.entries_.find(std::string_view(e->str_)));
+}
+
+std::size_t Symbol::table_size() {
+    SymbolTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex_);
+    return t.entries_.size();
+}
+
+std::ostream& operator<<(std::ostream& os, const Symbol& s) {
+    return os << s.str();
+}
+
+} // namespace ecf
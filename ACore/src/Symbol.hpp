@@ -0,0 +1,123 @@
+#ifndef SYMBOL_HPP_
+#define SYMBOL_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Interned string, used for the names of nodes and attributes.
+//               Each distinct string is stored once in a process wide table,
+//               a Symbol only holds a pointer to it. Hence equal Symbols have
+//               the same pointer, and comparison does not look at the characters.
+//               The table entries are reference counted, an entry is removed
+//               when the last Symbol referring to it goes away. Hence the table
+//               only holds the distinct names currently in use.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace ecf {
+
+class Symbol {
+public:
+    Symbol() = default;
+    explicit Symbol(const std::string& s) : e_(intern(s)) {}
+    Symbol(const Symbol& rhs) : e_(rhs.e_) { acquire(e_); }
+    Symbol(Symbol&& rhs) noexcept : e_(rhs.e_) { rhs.e_ = nullptr; }
+    ~Symbol() { release(e_); }
+
+    Symbol& operator=(const Symbol& rhs) {
+        acquire(rhs.e_);
+        release(e_);
+        e_ = rhs.e_;
+        return *this;
+    }
+    Symbol& operator=(Symbol&& rhs) noexcept {
+        if (this != &rhs) {
+            release(e_);
+            e_     = rhs.e_;
+            rhs.e_ = nullptr;
+        }
+        return *this;
+    }
+    Symbol& operator=(const std::string& s) {
+        const Entry* e = intern(s);
+        release(e_);
+        e_ = e;
+        return *this;
+    }
+
+    const std::string& str() const { return e_ ? e_->str_ : empty_string(); }
+    bool empty() const { return !e_; }
+    std::size_t size() const { return e_ ? e_->str_.size() : 0; }
+    void clear() {
+        release(e_);
+        e_ = nullptr;
+    }
+
+    bool operator==(const Symbol& rhs) const { return e_ == rhs.e_; }
+    bool operator!=(const Symbol& rhs) const { return e_ != rhs.e_; }
+    bool operator<(const Symbol& rhs) const { return str() < rhs.str(); }
+
+    /// The number of distinct strings in the table
+    static std::size_t table_size();
+
+    // Serialised as a plain string, hence the format is the same as for a std::string member
+    template <class Archive>
+    std::string save_minimal(const Archive&) const {
+        return str();
+    }
+    template <class Archive>
+    void load_minimal(const Archive&, const std::string& s) {
+        *this = s;
+    }
+
+private:
+    struct Entry
+    {
+        explicit Entry(const std::string& s) : str_(s) {}
+        const std::string str_;
+        mutable std::atomic<std::size_t> refs_{0}; // number of Symbols referring to this entry
+    };
+
+    static const Entry* intern(const std::string&);
+    static const std::string& empty_string();
+
+    static void acquire(const Entry* e) {
+        if (e)
+            e->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    static void release(const Entry* e) {
+        if (!e)
+            return;
+        // Only the last reference needs the table lock, to remove the entry
+        std::size_t refs = e->refs_.load(std::memory_order_relaxed);
+        while (refs > 1) {
+            if (e->refs_.compare_exchange_weak(refs, refs - 1, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+        release_last(e);
+    }
+    static void release_last(const Entry*);
+
+private:
+    const Entry* e_{nullptr}; // nullptr for the empty string
+    friend struct SymbolTable;
+};
+
+std::ostream& operator<<(std::ostream& os, const Symbol&);
+
+} // namespace ecf
+
+#endif
@@ -23,15 +23,16 @@
 #include <cereal/details/traits.hpp>
 
 namespace cereal {
+// The boost time types are always stored in their simple string form, for both the text and
+// binary archives. This keeps the representation independent of the boost internals.
 // ===================================================================================
 // Handle boost::posix_time::time_duration
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void save(Archive& ar, boost::posix_time::time_duration const& d) {
     ar(cereal::make_nvp("duration", to_simple_string(d)));
 }
 
-//! Loading for std::map<std::string, std::string> for text based archives
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void load(Archive& ar, boost::posix_time::time_duration& d) {
     std::string value;
     ar(value);
@@ -40,13 +41,12 @@ inline void load(Archive& ar, boost::posix_time::time_duration& d) {
 
 // ===================================================================================
 // Handle boost::posix_time::ptime
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void save(Archive& ar, boost::posix_time::ptime const& d) {
     ar(cereal::make_nvp("ptime", to_simple_string(d)));
 }
 
-//! Loading for std::map<std::string, std::string> for text based archives
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void load(Archive& ar, boost::posix_time::ptime& d) {
     std::string value;
     ar(value);
@@ -55,13 +55,12 @@ inline void load(Archive& ar, boost::posix_time::ptime& d) {
 
 // ===================================================================================
 // Handle boost::gregorian::date
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void save(Archive& ar, boost::gregorian::date const& d) {
     ar(cereal::make_nvp("date", to_simple_string(d)));
 }
 
-//! Loading for std::map<std::string, std::string> for text based archives
-template <class Archive, traits::EnableIf<traits::is_text_archive<Archive>::value> = traits::sfinae>
+template <class Archive>
 inline void load(Archive& ar, boost::gregorian::date& d) {
     std::string value;
     ar(value);
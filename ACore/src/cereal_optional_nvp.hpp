@@ -64,14 +64,15 @@ make_optional_nvp(Archive& ar, const char* name, T&& value) {
     return false;
 }
 
-template <class Archive, class T>
-void make_optional_nvp(OutputArchive<Archive>& ar, const char* name, T&& value) {
+template <class Archive, std::uint32_t Flags, class T>
+void make_optional_nvp(OutputArchive<Archive, Flags>& ar, const char* name, T&& value) {
     ar(make_nvp(name, std::forward<T>(value)));
 }
 
 // Saves NVP if predicate is true. Useful for avoiding splitting into save & load if also saving optionally.
-template <class Archive, class T, class Predicate>
-void make_optional_nvp(OutputArchive<Archive>& ar, const char* name, T&& value, Predicate predicate) {
+template <class Archive, std::uint32_t Flags, class T, class Predicate>
+typename std::enable_if_t<traits::is_text_archive<Archive>::value>
+make_optional_nvp(OutputArchive<Archive, Flags>& ar, const char* name, T&& value, Predicate predicate) {
     if (predicate())
         ar(make_nvp(name, std::forward<T>(value)));
 }
@@ -83,6 +84,37 @@ typename std::enable_if_t<traits::is_same_archive<Archive, JSONInputArchive>::va
 make_optional_nvp(Archive& ar, const char* name, T&& value, Predicate predicate) {
     return make_optional_nvp(ar, name, std::forward<T>(value));
 }
+
+// Binary archives have no node names, hence a conditionally saved NVP is preceded by a presence flag.
+template <class Archive, std::uint32_t Flags, class T, class Predicate>
+typename std::enable_if_t<!traits::is_text_archive<Archive>::value>
+make_optional_nvp(OutputArchive<Archive, Flags>& ar, const char* name, T&& value, Predicate predicate) {
+    const bool present = static_cast<bool>(predicate());
+    ar(present);
+    if (present)
+        ar(make_nvp(name, std::forward<T>(value)));
+}
+
+template <class Archive, class T>
+typename std::enable_if_t<!traits::is_text_archive<Archive>::value &&
+                              std::is_base_of<detail::InputArchiveBase, Archive>::value,
+                          bool>
+make_optional_nvp(Archive& ar, const char* name, T&& value) {
+    ar(make_nvp(name, std::forward<T>(value))); // always saved, see above
+    return true;
+}
+
+template <class Archive, class T, class Predicate>
+typename std::enable_if_t<!traits::is_text_archive<Archive>::value &&
+                              std::is_base_of<detail::InputArchiveBase, Archive>::value,
+                          bool>
+make_optional_nvp(Archive& ar, const char* name, T&& value, Predicate predicate) {
+    bool present = false;
+    ar(present);
+    if (present)
+        ar(make_nvp(name, std::forward<T>(value)));
+    return present;
+}
 } // namespace cereal
 
 // Macros for using the variable name as the NVP name
@@ -86,4 +86,21 @@ BOOST_AUTO_TEST_CASE(test_cereal_optional) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_cereal_optional_binary) {
+    cout << "ACore:: ...test_cereal_optional_binary\n";
+    std::vector<Base> original = {Base(), Base(true), Base(), Base(true)};
+
+    std::string archive_data;
+    ecf::save_as_string(archive_data, original, ArchiveFormat::PORTABLE_BINARY);
+
+    std::vector<Base> restored;
+    ecf::restore_from_string(archive_data, restored, ArchiveFormat::PORTABLE_BINARY);
+    BOOST_REQUIRE_MESSAGE(restored.size() == original.size(),
+                          "Expected " << original.size() << " but found " << restored.size());
+    for (size_t i = 0; i < original.size(); i++) {
+        BOOST_CHECK_MESSAGE(restored[i] == original[i],
+                            "restored(" << restored[i] << ") != original(" << original[i] << ")");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+//============================================================================
+// Name        :
+// Author      :
+// Revision    :
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Tests the functionality provided by Compression
+//============================================================================
+
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Compression.hpp"
+
+using namespace ecf;
+
+BOOST_AUTO_TEST_SUITE(CoreTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_compression) {
+    std::cout << "ACore:: ...test_compression\n";
+    if (!Compression::available()) {
+        std::string compressed;
+        BOOST_REQUIRE_THROW(Compression::compress("data", compressed), std::runtime_error);
+        return;
+    }
+
+    std::string data;
+    for (int i = 0; i < 1000; i++) {
+        data += "suite s" + std::to_string(i) + "\n  family f\n    task t # state:queued\n  endfamily\nendsuite\n";
+    }
+
+    std::string compressed;
+    BOOST_REQUIRE_NO_THROW(Compression::compress(data, compressed));
+    BOOST_CHECK_MESSAGE(compressed.size() < data.size(),
+                        "Expected compressed size " << compressed.size() << " < " << data.size());
+
+    const std::size_t max_size = data.size();
+    std::string uncompressed;
+    BOOST_REQUIRE_NO_THROW(Compression::decompress(compressed.data(), compressed.size(), uncompressed, max_size));
+    BOOST_CHECK_MESSAGE(uncompressed == data, "Data does not match after compress/decompress");
+
+    // corrupt/truncated data must throw
+    BOOST_CHECK_THROW(Compression::decompress(compressed.data(), 4, uncompressed, max_size), std::runtime_error);
+    BOOST_CHECK_THROW(Compression::decompress(compressed.data(), compressed.size() / 2, uncompressed, max_size),
+                      std::runtime_error);
+
+    // an uncompressed size above the limit must throw, before any allocation
+    BOOST_CHECK_THROW(Compression::decompress(compressed.data(), compressed.size(), uncompressed, max_size - 1),
+                      std::runtime_error);
+    std::string oversize = compressed;
+    for (std::size_t i = 0; i < 8; i++) {
+        oversize[i] = static_cast<char>(0xff);
+    }
+    BOOST_CHECK_THROW(Compression::decompress(oversize.data(), oversize.size(), uncompressed, max_size),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
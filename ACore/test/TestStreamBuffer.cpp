@@ -0,0 +1,85 @@
+//============================================================================
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Tests the in place stream buffers
+//============================================================================
+
+#include <iostream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "StreamBuffer.hpp"
+
+using namespace ecf;
+
+BOOST_AUTO_TEST_SUITE(CoreTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_string_output_buffer) {
+    std::cout << "ACore:: ...test_string_output_buffer\n";
+
+    std::string expected;
+    for (int i = 0; i < 10000; i++)
+        expected += "line " + std::to_string(i) + "\n";
+
+    std::string str = "existing content is discarded";
+    {
+        StringOutputBuffer buffer(str);
+        std::ostream os(&buffer);
+        for (int i = 0; i < 10000; i++)
+            os << "line " << i << '\n';
+    }
+    BOOST_CHECK_MESSAGE(str == expected, "Output buffer content does not match");
+
+    // memory is reused, when the content fits
+    const char* memory = str.data();
+    {
+        StringOutputBuffer buffer(str);
+        std::ostream os(&buffer);
+        os.write(expected.data(), expected.size() / 2);
+        buffer.finish();
+        BOOST_CHECK_MESSAGE(str == expected.substr(0, expected.size() / 2), "finish() did not trim the string");
+        os.write(expected.data() + expected.size() / 2, expected.size() - expected.size() / 2);
+    }
+    BOOST_CHECK_MESSAGE(str == expected, "Output buffer content does not match after finish()");
+    BOOST_CHECK_MESSAGE(str.data() == memory, "Expected the string memory to be reused");
+}
+
+BOOST_AUTO_TEST_CASE(test_char_array_input_buffer) {
+    std::cout << "ACore:: ...test_char_array_input_buffer\n";
+
+    std::string data = "10 20 thirty";
+    CharArrayInputBuffer buffer(data.data(), data.size());
+    std::istream is(&buffer);
+
+    int first = 0, second = 0;
+    std::string third;
+    is >> first >> second >> third;
+    BOOST_CHECK(first == 10 && second == 20 && third == "thirty");
+    BOOST_CHECK(is.eof());
+
+    is.clear();
+    is.seekg(3);
+    BOOST_CHECK(is.tellg() == 3);
+    is >> second;
+    BOOST_CHECK(second == 20);
+
+    is.seekg(-6, std::ios_base::end);
+    is >> third;
+    BOOST_CHECK(third == "thirty");
+
+    is.clear();
+    is.seekg(100);
+    BOOST_CHECK(is.fail());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+//============================================================================
+// Name        :
+// Author      :
+// Revision    :
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Tests the functionality provided by Symbol
+//============================================================================
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cereal/archives/json.hpp>
+#include <cereal/types/string.hpp>
+
+#include "Symbol.hpp"
+
+using namespace ecf;
+
+BOOST_AUTO_TEST_SUITE(CoreTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_symbol) {
+    std::cout << "ACore:: ...test_symbol\n";
+
+    Symbol empty;
+    BOOST_CHECK_MESSAGE(empty.empty() && empty.str().empty(), "Expected default Symbol to be empty");
+    BOOST_CHECK_MESSAGE(empty == Symbol(std::string()), "Expected empty Symbols to be equal");
+
+    Symbol a(std::string("fred"));
+    size_t table_size = Symbol::table_size();
+    Symbol b(std::string("fr") + "ed");
+    BOOST_CHECK_MESSAGE(a == b, "Expected Symbols of the same string to be equal");
+    BOOST_CHECK_MESSAGE(&a.str() == &b.str(), "Expected Symbols of the same string to share it");
+    BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size, "Expected no new entry for an existing string");
+
+    b = std::string("bill");
+    BOOST_CHECK_MESSAGE(a != b && b.str() == "bill" && b.size() == 4, "Expected assignment to change the Symbol");
+    BOOST_CHECK_MESSAGE(b < a, "Expected Symbols to be ordered by their string");
+
+    b.clear();
+    BOOST_CHECK_MESSAGE(b == empty, "Expected cleared Symbol to be empty");
+}
+
+BOOST_AUTO_TEST_CASE(test_symbol_reference_count) {
+    std::cout << "ACore:: ...test_symbol_reference_count\n";
+
+    std::string name  = "test_symbol_reference_count";
+    size_t table_size = Symbol::table_size();
+    {
+        Symbol a(name);
+        BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size + 1, "Expected a new entry");
+        BOOST_CHECK_MESSAGE(Symbol(name) == a, "Expected the existing entry to be used");
+        {
+            Symbol copy(a);
+            Symbol assigned;
+            assigned = a;
+            Symbol moved(std::move(copy));
+            BOOST_CHECK_MESSAGE(moved == a && assigned == a && copy.empty(), "Expected copies to share the entry");
+        }
+        BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size + 1, "Expected entry to be kept, while referenced");
+        BOOST_CHECK_MESSAGE(a.str() == name, "Expected " << name << " but found " << a);
+
+        a = std::string("test_symbol_reference_count_other");
+        BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size + 1, "Expected entry to be replaced");
+    }
+    BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size, "Expected entries to be removed, with their last reference");
+}
+
+BOOST_AUTO_TEST_CASE(test_symbol_threads) {
+    std::cout << "ACore:: ...test_symbol_threads\n";
+
+    // Boost test assertions are not thread safe, hence count the mismatches
+    size_t table_size = Symbol::table_size();
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&mismatches]() {
+            for (int i = 0; i < 10000; i++) {
+                Symbol a(std::string("test_symbol_threads_") + std::to_string(i % 10));
+                Symbol b(a);
+                b = a.str();
+                if (b != a || b.str() != a.str())
+                    mismatches++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    BOOST_CHECK_MESSAGE(mismatches == 0, "Expected no mismatches but found " << mismatches);
+    BOOST_CHECK_MESSAGE(Symbol::table_size() == table_size, "Expected all entries to be removed");
+}
+
+BOOST_AUTO_TEST_CASE(test_symbol_serialisation) {
+    std::cout << "ACore:: ...test_symbol_serialisation\n";
+
+    // The format must be the same as for a std::string
+    std::string name = "a_node_name_longer_than_the_short_string_buffer";
+    std::string symbol_json, string_json;
+    {
+        std::ostringstream os;
+        {
+            cereal::JSONOutputArchive oarchive(os);
+            Symbol n_(name);
+            oarchive(CEREAL_NVP(n_));
+        }
+        symbol_json = os.str();
+    }
+    {
+        std::ostringstream os;
+        {
+            cereal::JSONOutputArchive oarchive(os);
+            std::string n_ = name;
+            oarchive(CEREAL_NVP(n_));
+        }
+        string_json = os.str();
+    }
+    BOOST_CHECK_MESSAGE(symbol_json == string_json, "Expected:\n" << string_json << "\nbut found:\n" << symbol_json);
+
+    {
+        std::istringstream is(string_json);
+        cereal::JSONInputArchive iarchive(is);
+        Symbol n_;
+        iarchive(CEREAL_NVP(n_));
+        BOOST_CHECK_MESSAGE(n_ == Symbol(name), "Expected " << name << " but found " << n_);
+    }
+
+    std::ostringstream os;
+    {
+        cereal::BinaryOutputArchive oarchive(os);
+        oarchive(name);
+    }
+    std::istringstream is(os.str());
+    cereal::BinaryInputArchive iarchive(is);
+    Symbol symbol;
+    iarchive(symbol);
+    BOOST_CHECK_MESSAGE(symbol == Symbol(name), "Expected " << name << " but found " << symbol);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -112,12 +112,12 @@ std::string Event::name_or_number() const {
         ss << number_;
         return ss.str();
     }
-    return n_;
+    return n_.str();
 }
 
 bool Event::operator<(const Event& rhs) const {
     if (!n_.empty() && !rhs.name().empty()) {
-        return n_ < rhs.name();
+        return n_ < rhs.n_;
     }
     if (n_.empty() && rhs.name().empty()) {
         return number_ < rhs.number();
@@ -200,11 +200,11 @@ std::string Event::toString() const {
 void Event::write(std::string& ret) const {
     ret += "event ";
     if (number_ == std::numeric_limits<int>::max())
-        ret += n_;
+        ret += n_.str();
     else {
         ret += boost::lexical_cast<std::string>(number_);
         ret += " ";
-        ret += n_;
+        ret += n_.str();
     }
 
     if (iv_)
@@ -315,7 +315,7 @@ std::string Meter::toString() const {
 
 void Meter::write(std::string& ret) const {
     ret += "meter ";
-    ret += n_;
+    ret += n_.str();
     ret += " ";
     ret += boost::lexical_cast<std::string>(min_);
     ret += " ";
@@ -338,8 +338,8 @@ Label::Label(const std::string& name, const std::string& value, const std::strin
       v_(value),
       new_v_(new_value),
       state_change_no_(0) {
-    if (check_name && !Str::valid_name(n_)) {
-        throw std::runtime_error("Label::Label: Invalid Label name :" + n_);
+    if (check_name && !Str::valid_name(name)) {
+        throw std::runtime_error("Label::Label: Invalid Label name :" + name);
     }
 }
 
@@ -378,7 +378,7 @@ std::string Label::toString() const {
 void Label::write(std::string& ret) const {
     // parsing always STRIPS the quotes, hence add them back
     ret += "label ";
-    ret += n_;
+    ret += n_.str();
     ret += " \"";
     if (v_.find("\n") == std::string::npos)
         ret += v_;
@@ -416,7 +416,9 @@ void Label::reset() {
 }
 
 void Label::parse(const std::string& line, std::vector<std::string>& lineTokens, bool parse_state) {
-    parse(line, lineTokens, parse_state, n_, v_, new_v_);
+    std::string the_name;
+    parse(line, lineTokens, parse_state, the_name, v_, new_v_);
+    n_ = the_name;
 }
 
 void Label::parse(const std::string& line,
@@ -21,6 +21,8 @@
 
 #include <boost/operators.hpp>
 
+#include "Symbol.hpp"
+
 namespace cereal {
 class access;
 }
@@ -34,7 +36,7 @@ public:
     Label() = default;
 
     void print(std::string&) const;
-    const std::string& name() const { return n_; }
+    const std::string& name() const { return n_.str(); }
     const std::string& value() const { return v_; }
     const std::string& new_value() const { return new_v_; }
     void set_new_value(const std::string& new_label);
@@ -60,7 +62,7 @@ public:
         }
         return true;
     }
-    bool operator<(const Label& rhs) const { return n_ < rhs.name(); }
+    bool operator<(const Label& rhs) const { return n_ < rhs.n_; }
 
     std::string toString() const;
     std::string dump() const;
@@ -78,7 +80,7 @@ private:
     void write(std::string&) const;
 
 private:
-    std::string n_;
+    ecf::Symbol n_;
     std::string v_;
     std::string new_v_;
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
@@ -102,7 +104,7 @@ public:
     Event() = default;
 
     std::string name_or_number() const; // if name present return, else return number
-    const std::string& name() const { return n_; }
+    const std::string& name() const { return n_.str(); }
     void print(std::string&) const;
     bool value() const { return v_; }
     void reset() { set_value(iv_); }
@@ -132,7 +134,7 @@ private:
     void write(std::string&) const;
 
 private:
-    std::string n_;
+    ecf::Symbol n_;
     int number_{std::numeric_limits<int>::max()};
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
     bool v_{false};
@@ -164,7 +166,7 @@ public:
     void set_value(int v); // can throw throw std::runtime_error if out of range
     bool empty() const { return n_.empty(); }
 
-    const std::string& name() const { return n_; }
+    const std::string& name() const { return n_.str(); }
     int value() const { return v_; }
     int min() const { return min_; }
     int max() const { return max_; }
@@ -174,7 +176,7 @@ public:
     unsigned int state_change_no() const { return state_change_no_; }
 
     bool operator==(const Meter& rhs) const;
-    bool operator<(const Meter& rhs) const { return n_ < rhs.name(); }
+    bool operator<(const Meter& rhs) const { return n_ < rhs.n_; }
 
     bool usedInTrigger() const { return used_; }
     void usedInTrigger(bool b) { used_ = b; }
@@ -191,7 +193,7 @@ private:
     int max_{0};
     int v_{0};                        // value
     int cc_{0};                       // Colour change, used by gui ?
-    std::string n_;                   // name
+    ecf::Symbol n_;                   // name
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
     bool used_{false};                // used by the simulator not persisted
 
@@ -49,8 +49,12 @@ void Variable::set_name(const std::string& v) {
 }
 
 int Variable::value() const {
-    // see if the value is convertible to a integer
-    return Str::to_int(v_, 0 /* value to return if conversion fails*/);
+    if (!int_value_valid_) {
+        // see if the value is convertible to a integer
+        int_value_       = Str::to_int(v_, 0 /* value to return if conversion fails*/);
+        int_value_valid_ = true;
+    }
+    return int_value_;
 }
 
 bool Variable::operator==(const Variable& rhs) const {
@@ -100,7 +104,7 @@ std::string Variable::toString() const {
 
 void Variable::write(std::string& ret) const {
     ret += "edit ";
-    ret += n_;
+    ret += n_.str();
     ret += " '";
     if (v_.find("\n") == std::string::npos)
         ret += v_;
@@ -122,5 +126,8 @@ std::string Variable::dump() const {
 template <class Archive>
 void Variable::serialize(Archive& ar) {
     ar(CEREAL_NVP(n_), CEREAL_NVP(v_));
+    if (Archive::is_loading::value) {
+        int_value_valid_ = false;
+    }
 }
 CEREAL_TEMPLATE_SPECIALIZE(Variable);
@@ -16,6 +16,9 @@
 //============================================================================
 
 #include <string>
+
+#include "Symbol.hpp"
+
 namespace cereal {
 class access;
 }
@@ -33,21 +36,27 @@ public:
     Variable(const std::string& name, const std::string& value);
     Variable() = default;
 
-    const std::string& name() const { return n_; }
+    const std::string& name() const { return n_.str(); }
     void print(std::string&) const;
     void print_server_variable(std::string&) const;
     void print_generated(std::string&) const;
     bool empty() const { return n_.empty(); }
 
-    void set_value(const std::string& v) { v_ = v; }
+    void set_value(const std::string& v) {
+        v_               = v;
+        int_value_valid_ = false;
+    }
     const std::string& theValue() const { return v_; }
     int value() const;
 
     void set_name(const std::string& v);
-    std::string& value_by_ref() { return v_; }
+    std::string& value_by_ref() {
+        int_value_valid_ = false;
+        return v_;
+    }
 
     bool operator==(const Variable& rhs) const;
-    bool operator<(const Variable& rhs) const { return n_ < rhs.name(); }
+    bool operator<(const Variable& rhs) const { return n_ < rhs.n_; }
     std::string toString() const;
     std::string dump() const;
 
@@ -58,8 +67,10 @@ private:
     void write(std::string&) const;
 
 private:
-    std::string n_;
+    ecf::Symbol n_;
     std::string v_;
+    mutable int int_value_{0};            // value() cached, since used in trigger/complete expressions
+    mutable bool int_value_valid_{false}; // reset whenever v_ changes
 
     friend class cereal::access;
     template <class Archive>
@@ -24,6 +24,9 @@
 
 #include "Defs.hpp"
 #include "DefsStructureParser.hpp"
+#include "ExprDuplicate.hpp"
+#include "ExprParser.hpp"
+#include "Expression.hpp"
 #include "Family.hpp"
 #include "File.hpp"
 #include "Jobs.hpp"
@@ -202,6 +205,39 @@ int main(int argc, char* argv[]) {
         cout << " Test all paths can be found. time taken        = " << timer.format(3, Str::cpu_timer_format())
              << endl;
     }
+    {
+        // Time the parsing of the trigger/complete expressions, with spirit and the descent parser.
+        // Bypass the cache of duplicate expressions, so that each expression is parsed.
+        std::vector<std::string> expressions;
+        std::vector<Node*> nodes;
+        defs.getAllNodes(nodes);
+        for (Node* n : nodes) {
+            for (Expression* expr : {n->get_trigger(), n->get_complete()}) {
+                if (expr) {
+                    for (const PartExpression& part : expr->expr())
+                        expressions.push_back(part.expression());
+                }
+            }
+        }
+
+        for (bool descent : {false, true}) {
+            ExprParser::enable_descent(descent);
+            size_t failed = 0;
+            timer.start();
+            for (const std::string& expression : expressions) {
+                ExprDuplicate::clear();
+                ExprParser parser(expression);
+                std::string errorMsg;
+                if (!parser.doParse(errorMsg))
+                    failed++;
+            }
+            cout << (descent ? " Parse expressions, descent parser             = "
+                             : " Parse expressions, spirit                     = ")
+                 << timer.format(3, Str::cpu_timer_format()) << " expressions(" << expressions.size()
+                 << ") failed(" << failed << ")" << endl;
+        }
+        ExprDuplicate::clear();
+    }
     {
         // Time how long it takes for job submission. Must call begin on all suites first.
         timer.start();
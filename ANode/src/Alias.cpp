@@ -136,6 +136,10 @@ const std::string& Alias::script_extension() const {
 }
 
 void Alias::collateChanges(DefsDelta& changes) const {
+    collate_node_changes_only(changes);
+}
+
+void Alias::collate_node_changes_only(DefsDelta& changes) const {
     /// All changes to Alias should be on ONE compound_memento_ptr
     compound_memento_ptr comp;
     Submittable::incremental_changes(changes, comp);
@@ -54,6 +54,7 @@ public:
     const std::string& script_extension() const override;
 
     void collateChanges(DefsDelta&) const override;
+    void collate_node_changes_only(DefsDelta&) const override;
     void set_memento(const SubmittableMemento* m, std::vector<ecf::Aspect::Type>& aspects, bool f) {
         Submittable::set_memento(m, aspects, f);
     }
@@ -0,0 +1,135 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "ChangeJournal.hpp"
+
+#include <algorithm>
+
+#include "DefsDelta.hpp"
+#include "Ecf.hpp"
+#include "Suite.hpp"
+
+namespace ecf {
+
+static Suite* suite_of(const Node* node) {
+    // Can't use Node::suite(), since the node may have been detached from its parent
+    const Node* root = node;
+    while (root->parent())
+        root = root->parent();
+    return root->isSuite();
+}
+
+ChangeJournal::ChangeJournal() : from_change_no_(Ecf::state_change_no()), last_change_no_(from_change_no_) {
+}
+
+ChangeJournal::ChangeJournal(const ChangeJournal&) : ChangeJournal() {
+}
+
+void ChangeJournal::record(const Node* node) {
+    if (!Ecf::server() || !node->parent())
+        return;
+    Suite* suite = suite_of(node);
+    if (suite)
+        suite->change_journal().add(node);
+}
+
+void ChangeJournal::children_removed(const Node* node) {
+    Suite* suite = suite_of(node);
+    if (suite)
+        suite->change_journal().invalidate();
+}
+
+void ChangeJournal::add(const Node* node) {
+    unsigned int change_no = Ecf::state_change_no();
+    if (change_no < last_change_no_)
+        invalidate(); // state change numbers were reset
+    last_change_no_ = change_no;
+
+    auto i = index_.find(node);
+    if (i != index_.end()) {
+        i->second->change_no_ = change_no;
+        entries_.splice(entries_.end(), entries_, i->second);
+        return;
+    }
+
+    entries_.push_back(Entry{node, change_no});
+    index_.emplace(node, std::prev(entries_.end()));
+    if (entries_.size() > max_entries_)
+        pop_oldest();
+}
+
+bool ChangeJournal::collateChanges(const Suite* suite, DefsDelta& changes) {
+    if (Ecf::state_change_no() < last_change_no_)
+        invalidate(); // state change numbers were reset
+
+    unsigned int client_state_change_no = changes.client_state_change_no();
+    if (client_state_change_no < from_change_no_)
+        return false; // client older than the journal
+
+    changed_.clear();
+    for (auto e = entries_.rbegin(); e != entries_.rend() && e->change_no_ > client_state_change_no; ++e) {
+        if (e->node_->node_only_max_state_change_no() <= client_state_change_no)
+            continue;
+
+        // When an ancestor family added/removed children, ChildrenMemento will copy this node
+        size_t depth  = 0;
+        bool   hidden = false;
+        for (Node* parent = e->node_->parent(); parent && parent != suite; parent = parent->parent()) {
+            NodeContainer* container = parent->isNodeContainer();
+            if (container && container->add_remove_state_change_no() > client_state_change_no)
+                hidden = true;
+            depth++;
+        }
+        if (!hidden)
+            changed_.emplace_back(depth, e->node_);
+    }
+
+    // Collate parents before children, as in the traversal
+    std::stable_sort(changed_.begin(), changed_.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& c : changed_) {
+        c.second->collate_node_changes_only(changes);
+    }
+    return true;
+}
+
+void ChangeJournal::invalidate() {
+    entries_.clear();
+    index_.clear();
+    from_change_no_ = Ecf::state_change_no();
+    last_change_no_ = from_change_no_;
+}
+
+void ChangeJournal::set_max_entries(size_t max_entries) {
+    max_entries_ = max_entries;
+    while (entries_.size() > max_entries_)
+        pop_oldest();
+}
+
+void ChangeJournal::pop_oldest() {
+    // Clients older than the change dropped, can not be served from the journal
+    from_change_no_ = entries_.front().change_no_;
+    index_.erase(entries_.front().node_);
+    entries_.pop_front();
+}
+
+NodeChanged::NodeChanged(const Node* node) : node_(node), state_change_no_(Ecf::state_change_no()) {
+}
+
+NodeChanged::~NodeChanged() {
+    if (state_change_no_ != Ecf::state_change_no())
+        ChangeJournal::record(node_);
+}
+
+} // namespace ecf
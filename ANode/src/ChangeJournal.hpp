@@ -0,0 +1,114 @@
+#ifndef CHANGE_JOURNAL_HPP_
+#define CHANGE_JOURNAL_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Journal of the changed nodes of a suite, ordered by change number.
+//               Allows the incremental changes (DefsDelta) to be collated, without
+//               traversing every node of the suite, for each client.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NodeFwd.hpp"
+
+namespace ecf {
+
+// Without a journal, each client sync (SSyncCmd) traverses *every* node and attribute of a
+// changed suite, comparing change numbers against the client_state_change_no. With many
+// clients (viewers), the same traversal is repeated for each of them.
+//
+// Instead, nodes below the suite are recorded at the point of change, (see record()), i.e. when
+// the node, or one of its attributes changes state. Each node is held once, ordered by the state
+// change number of its most recent change. A client sync then only scans the entries newer than
+// the client, and collates the changes of those nodes only.
+//
+// The journal is bounded, only the most recently changed nodes are kept. We fall back to a full
+// traversal, when the client is older than the oldest change kept.
+//
+// The journal is not persisted. The nodes are referenced by raw pointer, hence the journal is
+// invalidated whenever nodes are removed from the suite. (see children_removed())
+class ChangeJournal {
+public:
+    ChangeJournal();
+    // The journal refers to the nodes of the owning suite, hence a copy starts empty.
+    ChangeJournal(const ChangeJournal&);
+    ChangeJournal& operator=(const ChangeJournal&) {
+        invalidate();
+        return *this;
+    }
+
+    /// Record that the node has changed, in the journal of the suite holding the node.
+    /// Does nothing on the client side, for suites, or for nodes not held under a suite.
+    static void record(const Node*);
+
+    /// The children of the node have been removed. Invalidates the journal of the suite holding the node
+    static void children_removed(const Node*);
+
+    /// Add the node, as the most recent change
+    void add(const Node*);
+
+    /// Collate the changes of the nodes *below* the suite, into changes.
+    /// Return false if the client is older than the journal, caller must then do a full traversal
+    bool collateChanges(const Suite*, DefsDelta& changes);
+
+    /// Discard all the entries. Clients older than the current state change number require a full traversal
+    void invalidate();
+
+    /// The number of nodes, currently held in the journal
+    size_t size() const { return entries_.size(); }
+
+    /// Change the maximum number of nodes held in the journal. Used in test
+    void set_max_entries(size_t max_entries);
+
+private:
+    void pop_oldest();
+
+    struct Entry
+    {
+        const Node* node_{nullptr};
+        unsigned int change_no_{0}; // Ecf::state_change_no(), when the node was recorded
+    };
+
+private:
+    std::list<Entry> entries_; // ordered by change number, most recent last
+    std::unordered_map<const Node*, std::list<Entry>::iterator> index_;
+    std::vector<std::pair<size_t, const Node*>> changed_; // (depth,node) re-used for each collation
+    size_t max_entries_{10000};
+    unsigned int from_change_no_{0}; // clients older than this require a full traversal
+    unsigned int last_change_no_{0}; // change number of the most recent entry
+};
+
+/// Records the node in the change journal, when the state change number moved on in the scope.
+/// Used by functions which change the attributes of the node directly.
+class NodeChanged {
+private:
+    NodeChanged(const NodeChanged&)                  = delete;
+    const NodeChanged& operator=(const NodeChanged&) = delete;
+
+public:
+    explicit NodeChanged(const Node* node);
+    ~NodeChanged();
+
+private:
+    const Node* node_;
+    unsigned int state_change_no_;
+};
+
+} // namespace ecf
+
+#endif
@@ -94,6 +94,7 @@ Defs& Defs::operator=(const Defs& rhs) {
         std::swap(server_, tmp.server_);
         std::swap(suiteVec_, tmp.suiteVec_);
         std::swap(flag_, tmp.flag_);
+        path_index_.clear();
 
         // edit history is not copied
         // externs not copied
@@ -977,6 +978,19 @@ bool Defs::operator==(const Defs& rhs) const {
 }
 
 node_ptr Defs::findAbsNode(const std::string& pathToNode) const {
+    if (!path_index_enabled_)
+        return find_abs_node(pathToNode);
+
+    node_ptr node = path_index_.find(this, pathToNode);
+    if (!node) {
+        node = find_abs_node(pathToNode);
+        if (node)
+            path_index_.add(pathToNode, node);
+    }
+    return node;
+}
+
+node_ptr Defs::find_abs_node(const std::string& pathToNode) const {
     //	std::cout << "Defs::findAbsNode " << pathToNode << "\n";
     // The pathToNode is of the form:
     //     /suite
@@ -1452,6 +1466,15 @@ void Defs::save_as_checkpt(const std::string& the_fileName) const {
     save_as_filename(the_fileName, PrintStyle::MIGRATE);
 }
 
+void Defs::save_checkpt_as_string(std::string& the_string) const {
+    // only_save_edit_history_when_check_pointing or if explicitly requested
+    save_edit_history_ = true; // this is reset after edit_history is saved
+
+    PrintStyle printStyle(PrintStyle::MIGRATE);
+    ecf::DisableIndentor disable_indentation;
+    print(the_string);
+}
+
 void Defs::save_as_filename(const std::string& the_fileName, PrintStyle::Type_t p_style) const {
     PrintStyle printStyle(p_style);
 
@@ -1543,6 +1566,8 @@ void Defs::clear() {
     suiteVec_.clear();
     externs_.clear();
     client_suite_mgr_.clear();
+    dependency_index_.invalidate();
+    path_index_.clear();
     state_.setState(NState::UNKNOWN);
     edit_history_.clear();
     save_edit_history_ = false;
@@ -32,8 +32,10 @@
 #include "Aspect.hpp"
 #include "Attr.hpp"
 #include "ClientSuiteMgr.hpp"
+#include "DependencyIndex.hpp"
 #include "Flag.hpp"
 #include "NOrder.hpp"
+#include "NodePathIndex.hpp"
 #include "NState.hpp"
 #include "NodeFwd.hpp"
 #include "PrintStyle.hpp"
@@ -281,6 +283,7 @@ public:
 
     // defs format
     void save_as_checkpt(const std::string& fileName) const;
+    void save_checkpt_as_string(std::string& str) const; // as save_as_checkpt, i.e. to save in the background
     void save_as_filename(const std::string& fileName,
                           PrintStyle::Type_t = PrintStyle::MIGRATE) const; // used in test only
     void save_as_string(std::string& str, PrintStyle::Type_t = PrintStyle::MIGRATE) const;
@@ -328,6 +331,16 @@ public:
 
     ClientSuiteMgr& client_suite_mgr() { return client_suite_mgr_; }
 
+    /// Used during job generation, to avoid resolving dependencies of unchanged suites
+    ecf::DependencyIndex& dependency_index() { return dependency_index_; }
+
+    /// Index the paths found by findAbsNode. Only enabled in the server, the index is not thread safe.
+    void enable_path_index(bool f) {
+        path_index_enabled_ = f;
+        path_index_.clear();
+    }
+    const ecf::NodePathIndex& path_index() const { return path_index_; }
+
     // Provided for python interface
     std::string toString() const;
 
@@ -355,6 +368,7 @@ private:
     /// Removes the suite, from defs returned as suite_ptr, asserts if suite does not exist
     suite_ptr removeSuite(suite_ptr);
     node_ptr removeChild(Node*);
+    node_ptr find_abs_node(const std::string& pathToNode) const;
     bool addChild(const node_ptr&, size_t position = std::numeric_limits<std::size_t>::max());
     friend class Node;
 
@@ -387,6 +401,9 @@ private:
     ecf::Flag flag_;
 
     ClientSuiteMgr client_suite_mgr_{this}; // NOT persisted
+    ecf::DependencyIndex dependency_index_;  // NOT persisted
+    mutable ecf::NodePathIndex path_index_;  // NOT persisted
+    bool path_index_enabled_{false};         // NOT persisted
 
     /// Externs are *NEVER* loaded in the server, since they can be computed and
     /// save on network band with, and check point file size.
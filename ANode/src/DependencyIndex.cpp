@@ -0,0 +1,237 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "DependencyIndex.hpp"
+
+#include <algorithm>
+
+#include "Defs.hpp"
+#include "Ecf.hpp"
+#include "ExprAst.hpp"
+#include "ExprAstVisitor.hpp"
+#include "Limit.hpp"
+#include "Suite.hpp"
+
+namespace ecf {
+
+namespace {
+
+// Collect the nodes referenced by an expression. Determine if the expression
+// references anything whose change is *not* reflected in a state change number.
+class AstCollateDependenciesVisitor : public ExprAstVisitor {
+public:
+    explicit AstCollateDependenciesVisitor(std::vector<Node*>& referenced) : referenced_(referenced) {}
+
+    bool untracked() const { return untracked_; }
+
+    void visitTop(AstTop*) override {}
+    void visitRoot(AstRoot*) override {}
+    void visitAnd(AstAnd*) override {}
+    void visitNot(AstNot*) override {}
+    void visitPlus(AstPlus*) override {}
+    void visitMinus(AstMinus*) override {}
+    void visitDivide(AstDivide*) override {}
+    void visitMultiply(AstMultiply*) override {}
+    void visitModulo(AstModulo*) override {}
+    void visitOr(AstOr*) override {}
+    void visitEqual(AstEqual*) override {}
+    void visitNotEqual(AstNotEqual*) override {}
+    void visitLessEqual(AstLessEqual*) override {}
+    void visitGreaterEqual(AstGreaterEqual*) override {}
+    void visitGreaterThan(AstGreaterThan*) override {}
+    void visitLessThan(AstLessThan*) override {}
+    void visitLeaf(AstLeaf*) override {}
+    void visitInteger(AstInteger*) override {}
+    void visitFunction(AstFunction*) override {}
+    void visitNodeState(AstNodeState*) override {}
+    void visitEventState(AstEventState*) override {}
+    void visitNode(AstNode* ast) override { add(ast->referencedNode()); }
+    void visitFlag(AstFlag* ast) override { add(ast->referencedNode()); }
+    void visitVariable(AstVariable* ast) override { add_variable(ast->referencedNode(), ast->name()); }
+    void visitParentVariable(AstParentVariable* ast) override {
+        add_variable(ast->find_node_which_references_variable(), ast->name());
+    }
+
+private:
+    void add(Node* node) {
+        if (node)
+            referenced_.push_back(node);
+        else
+            untracked_ = true; // extern, or server variable
+    }
+
+    void add_variable(Node* node, const std::string& name) {
+        // The generated variables of a suite, (ECF_DATE, YYYY, DOW, etc) change with the calendar.
+        if (node && node->isSuite() && node->findVariable(name).empty() && node->repeat().name() != name)
+            untracked_ = true;
+        add(node);
+    }
+
+private:
+    std::vector<Node*>& referenced_;
+    bool untracked_{false};
+};
+
+void add_unique(std::vector<size_t>& vec, size_t pos) {
+    if (std::find(vec.begin(), vec.end(), pos) == vec.end())
+        vec.push_back(pos);
+}
+
+} // namespace
+
+void DependencyIndex::begin(const Defs& defs) {
+    const std::vector<suite_ptr>& suiteVec = defs.suiteVec();
+    size_t theSize                         = suiteVec.size();
+
+    // Change numbers are only updated on the server
+    bool resolve_all = !Ecf::server() || !valid_ || suites_.size() != theSize || Ecf::modify_change_no() != modify_change_no_ ||
+                       Ecf::state_change_no() < state_change_no_ ||
+                       defs.server().state_change_no() > state_change_no_;
+    for (size_t i = 0; !resolve_all && i < theSize; i++) {
+        if (suites_[i].suite_ != suiteVec[i].get())
+            resolve_all = true; // suites re-ordered
+    }
+
+    if (!resolve_all && Ecf::state_change_no() != state_change_no_) {
+        // Any change since the last resolve, must be attributable to a suite. Otherwise we can
+        // not determine which suites are affected. i.e. node tree changed directly, in test/simulator
+        resolve_all = std::none_of(suiteVec.begin(), suiteVec.end(), [this](const suite_ptr& s) {
+            return s->state_change_no() > state_change_no_;
+        });
+    }
+
+    if (resolve_all) {
+        suites_.clear();
+        suites_.resize(theSize);
+        for (size_t i = 0; i < theSize; i++) {
+            suites_[i].suite_   = suiteVec[i].get();
+            suites_[i].rebuild_ = true;
+        }
+        valid_           = true;
+        suites_resolved_ = theSize;
+        suites_skipped_  = 0;
+        return;
+    }
+
+    // Suites that reference the same limit, affect each other, i.e. completion of a task in one suite,
+    // will release the limit, and may allow a task in another suite to be submitted.
+    std::vector<std::vector<size_t>> limit_users(theSize);
+    for (size_t i = 0; i < theSize; i++) {
+        for (size_t limit_suite : suites_[i].limit_suites_)
+            limit_users[limit_suite].push_back(i);
+    }
+
+    suites_resolved_ = 0;
+    suites_skipped_  = 0;
+    for (size_t i = 0; i < theSize; i++) {
+        SuiteDeps& deps = suites_[i];
+        unsigned int no = deps.resolved_state_change_no_;
+        deps.rebuild_   = !deps.built_ || changed_since(i, no);
+        deps.resolve_   = deps.rebuild_ || deps.always_resolve_ || deps.pending_;
+        for (size_t j = 0; !deps.resolve_ && j < deps.depends_on_.size(); j++) {
+            deps.resolve_ = changed_since(deps.depends_on_[j], no);
+        }
+        for (size_t j = 0; !deps.resolve_ && j < deps.limit_suites_.size(); j++) {
+            const std::vector<size_t>& users = limit_users[deps.limit_suites_[j]];
+            deps.resolve_                    = changed_since(deps.limit_suites_[j], no) ||
+                            std::any_of(users.begin(), users.end(), [&](size_t u) { return changed_since(u, no); });
+        }
+        if (deps.resolve_)
+            suites_resolved_++;
+        else
+            suites_skipped_++;
+    }
+}
+
+void DependencyIndex::resolved(size_t suite_pos, unsigned int state_change_no, bool pending) {
+    SuiteDeps& deps                = suites_[suite_pos];
+    deps.resolved_state_change_no_ = state_change_no;
+    deps.pending_                  = pending;
+    if (deps.rebuild_) {
+        // Triggers, completes and inlimits are resolved on demand, hence only build after the resolve
+        build(suite_pos);
+        deps.rebuild_ = false;
+    }
+}
+
+void DependencyIndex::end(bool timed_out) {
+    state_change_no_  = Ecf::state_change_no();
+    modify_change_no_ = Ecf::modify_change_no();
+    if (timed_out)
+        valid_ = false; // not all suites were resolved
+}
+
+void DependencyIndex::build(size_t suite_pos) {
+    SuiteDeps& deps = suites_[suite_pos];
+    deps.depends_on_.clear();
+    deps.limit_suites_.clear();
+    deps.always_resolve_ = false;
+    deps.built_          = true;
+
+    std::vector<Node*> nodes;
+    nodes.push_back(const_cast<Suite*>(deps.suite_));
+    deps.suite_->getAllNodes(nodes);
+
+    auto suite_position = [this](const Node* n, size_t& pos) {
+        const Suite* s = n->suite();
+        for (pos = 0; pos < suites_.size(); pos++) {
+            if (suites_[pos].suite_ == s)
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<Node*> referenced;
+    for (Node* n : nodes) {
+        // Only check this node's attributes, the children are in nodes
+        if (n->Node::has_time_based_attributes())
+            deps.always_resolve_ = true;
+
+        referenced.clear();
+        AstCollateDependenciesVisitor astVisitor(referenced);
+        if (n->completeAst())
+            n->completeAst()->accept(astVisitor);
+        if (n->triggerAst())
+            n->triggerAst()->accept(astVisitor);
+        if (astVisitor.untracked())
+            deps.always_resolve_ = true;
+
+        for (Node* ref : referenced) {
+            size_t pos = 0;
+            if (!suite_position(ref, pos)) {
+                deps.always_resolve_ = true;
+                continue;
+            }
+            if (pos != suite_pos)
+                add_unique(deps.depends_on_, pos);
+        }
+
+        for (const auto& inlimit : n->inlimits()) {
+            Limit* limit = n->findLimitViaInLimit(inlimit); // resolve, node may not have been reached
+            size_t pos   = 0;
+            if (!limit || !limit->node() || !suite_position(limit->node(), pos)) {
+                deps.always_resolve_ = true;
+                continue;
+            }
+            add_unique(deps.limit_suites_, pos);
+        }
+    }
+}
+
+bool DependencyIndex::changed_since(size_t suite_pos, unsigned int state_change_no) const {
+    return suites_[suite_pos].suite_->state_change_no() > state_change_no;
+}
+
+} // namespace ecf
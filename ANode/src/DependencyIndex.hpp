@@ -0,0 +1,113 @@
+#ifndef DEPENDENCY_INDEX_HPP_
+#define DEPENDENCY_INDEX_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Suite dependency index, used to avoid dependency resolution
+//               of suites, where nothing that can free a node has changed.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <vector>
+
+#include "NodeFwd.hpp"
+
+namespace ecf {
+
+// Without an index, every job submission interval *all* suites are traversed, and every
+// trigger/complete expression is evaluated, even when nothing has changed.
+//
+// The index records, for each suite, the suites holding the nodes referenced by the trigger/complete
+// expressions (AstNode, AstFlag, AstVariable, AstParentVariable) and the limits referenced by the
+// inlimits. The granularity is the suite, since changes are only tracked per suite, via the suite
+// state change number. A suite then only needs dependency resolution when, since it was last resolved:
+//    o the suite itself changed (state, event, meter, variable, limit, ...)
+//    o a suite it references changed
+//    o a suite, sharing one of its limits changed
+//    o it has free tasks that stayed queued, i.e. deferred by the JobThrottle, or waiting for
+//      their script to be fetched by the ScriptFetcher
+// The change is detected via the suite state change number, updated via SuiteChanged.
+//
+// We fall back to resolving the suite on every call for:
+//    o suites with time based attributes, (time, today, date, day, cron, late, autocancel, ...)
+//    o references that can change without a state change (i.e. calendar based generated
+//      variables on a suite, server variables, externs)
+// and to resolving all suites, when:
+//    o not running in the server, (change numbers are not updated)
+//    o the node tree structure changed (Ecf::modify_change_no)
+//    o the server state changed
+//    o a state change could not be attributed to any suite
+//    o the previous job generation timed out
+//
+// The index is not persisted, and only used when enabled via JobsParam.
+class DependencyIndex {
+public:
+    DependencyIndex() = default;
+    // The index refers to the suites of the owning defs, hence a copy starts empty.
+    DependencyIndex(const DependencyIndex&) {}
+    DependencyIndex& operator=(const DependencyIndex&) {
+        invalidate();
+        return *this;
+    }
+
+    /// Determine the suites that need dependency resolution.
+    void begin(const Defs&);
+
+    /// Return true if suite, at the given position in Defs::suiteVec(), needs dependency resolution
+    bool needs_resolve(size_t suite_pos) const { return suites_[suite_pos].resolve_; }
+
+    /// Record that suite was resolved. state_change_no is Ecf::state_change_no(), before the resolve.
+    /// pending is true if the suite has free tasks, that were not submitted. See JobsParam::pending_submissions()
+    void resolved(size_t suite_pos, unsigned int state_change_no, bool pending = false);
+
+    /// End of dependency resolution. If job generation timed out, resolve all suites next time.
+    void end(bool timed_out);
+
+    /// Force all suites to be resolved on the next call to begin()
+    void invalidate() {
+        suites_.clear();
+        valid_ = false;
+    }
+
+    /// The number of suites resolved and skipped, by the last begin()/end()
+    size_t suites_resolved() const { return suites_resolved_; }
+    size_t suites_skipped() const { return suites_skipped_; }
+
+private:
+    struct SuiteDeps {
+        const Suite* suite_{nullptr};
+        unsigned int resolved_state_change_no_{0}; // Ecf::state_change_no(), prior to last resolve
+        bool built_{false};
+        bool always_resolve_{false}; // time based attributes, or references we can not track
+        bool rebuild_{false};        // suite changed, hence attributes may have been added/deleted
+        bool pending_{false};        // free tasks were not submitted, resolve until they are
+        bool resolve_{true};
+        std::vector<size_t> depends_on_;   // position of referenced suites
+        std::vector<size_t> limit_suites_; // position of suites, holding the limits we reference
+    };
+
+    void build(size_t suite_pos);
+    bool changed_since(size_t suite_pos, unsigned int state_change_no) const;
+
+private:
+    std::vector<SuiteDeps> suites_;
+    unsigned int state_change_no_{0};  // Ecf::state_change_no() at the end of the last resolve
+    unsigned int modify_change_no_{0}; // Ecf::modify_change_no() at the end of the last resolve
+    size_t suites_resolved_{0};
+    size_t suites_skipped_{0};
+    bool valid_{false};
+};
+
+} // namespace ecf
+
+#endif
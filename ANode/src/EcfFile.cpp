@@ -15,6 +15,7 @@
 
 #include "EcfFile.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <memory>
 #include <sstream>
@@ -25,10 +26,14 @@
 #include <sys/stat.h>
 #include <sys/wait.h> // for waitpid
 
+#include "DurationTimer.hpp"
 #include "Ecf.hpp"
 #include "File.hpp"
+#include "JobProfiler.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
+#include "ScriptFetcher.hpp"
+#include "ScriptPathCache.hpp"
 #include "Str.hpp"
 #include "Submittable.hpp"
 
@@ -77,7 +82,7 @@ static void vector_to_string(const std::vector<std::string>& vec, std::string& s
 EcfFile::EcfFile() = default;
 
 EcfFile& EcfFile::operator=(const EcfFile& rhs) {
-    /// This preserves the caches, used to avoid opening/stat of include file more than once.
+    /// This preserves the caches, used to avoid stat of include file more than once.
     // assign in order or declaration
     node_               = rhs.node_;
     ecfMicroCache_      = rhs.ecfMicroCache_;
@@ -86,6 +91,11 @@ EcfFile& EcfFile::operator=(const EcfFile& rhs) {
     job_size_.clear();
     script_origin_             = rhs.script_origin_;
     ecf_file_search_algorithm_ = rhs.ecf_file_search_algorithm_;
+    async_fetch_               = false;
+    start_fetch_               = true;
+    fetch_pending_             = false;
+    pending_fetch_cmd_.clear();
+    fetched_.clear();
     return *this;
 }
 
@@ -320,33 +330,72 @@ const std::string& EcfFile::create_job(JobsParam& jobsParam) {
     // NOTE: When editing pure python jobs, we may have *NO* variable specified, but only user_edit_file
     //       hence whenever we have user_edit_file, we should follow the else part below
     std::string error_msg;
-    { // add scope to limit lifetime of lines variable
-        std::vector<std::string> lines;
-        if (jobsParam.user_edit_variables().empty() && jobsParam.user_edit_file().empty()) {
-            /// The typical *NORMAL* path
-            if (!open_script_file(script_path_or_cmd_, EcfFile::SCRIPT, lines, error_msg)) {
-                throw std::runtime_error("EcfFile::create_job: failed " + error_msg);
+
+    // The output of the fetch commands, used for this job, is no longer needed, unless we have to try again
+    async_fetch_   = jobsParam.async_fetch() && jobsParam.user_edit_variables().empty() &&
+                   jobsParam.user_edit_file().empty();
+    start_fetch_   = !jobsParam.job_creation_thread();
+    fetch_pending_ = false;
+    pending_fetch_cmd_.clear();
+    fetched_.clear();
+    struct ReleaseFetched
+    {
+        const EcfFile& ecf_file_;
+        ~ReleaseFetched() {
+            if (!ecf_file_.fetch_pending_) {
+                for (const auto& cmd : ecf_file_.fetched_)
+                    ScriptFetcher::instance().release(cmd);
             }
         }
-        else {
-            // *USER* edit, two kinds
-            if (jobsParam.user_edit_file().empty()) {
-                // *USE* user variables, but ECF file accessible from the server
-                if (!open_script_file(script_path_or_cmd_, EcfFile::SCRIPT, lines, jobsParam.errorMsg())) {
-                    throw std::runtime_error("EcfFile::create_job: User variables, Could not open script: " +
-                                             error_msg);
+    } release_fetched{*this};
+
+    {
+        // Reads the script and expands the includes
+        JobProfiler::PhaseTimer pre_process(JobProfiler::PRE_PROCESS);
+
+        // Tasks sharing the same script and include files, can re-use the pre-processed script
+        substitution_plan_.reset();
+        FileStamp script_stamp;
+        bool use_script_cache = jobsParam.use_script_cache() && jobsParam.user_edit_variables().empty() &&
+                                jobsParam.user_edit_file().empty() && script_origin_ != ECF_FETCH_CMD &&
+                                script_origin_ != ECF_SCRIPT_CMD && script_stamp.stat(script_path_or_cmd_);
+        bool pre_processed = false;
+        if (use_script_cache) {
+            PreProcessor data(this, "EcfFile::create_job");
+            pre_processed = data.preProcess_from_cache(script_stamp);
+        }
+
+        if (!pre_processed) { // add scope to limit lifetime of lines variable
+            std::vector<std::string> lines;
+            if (jobsParam.user_edit_variables().empty() && jobsParam.user_edit_file().empty()) {
+                /// The typical *NORMAL* path
+                if (!open_script_file(script_path_or_cmd_, EcfFile::SCRIPT, lines, error_msg)) {
+                    throw std::runtime_error("EcfFile::create_job: failed " + error_msg);
                 }
             }
             else {
-                // *USE* the user supplied ECF file *AND* user variables
-                lines = jobsParam.user_edit_file();
+                // *USER* edit, two kinds
+                if (jobsParam.user_edit_file().empty()) {
+                    // *USE* user variables, but ECF file accessible from the server
+                    if (!open_script_file(script_path_or_cmd_, EcfFile::SCRIPT, lines, jobsParam.errorMsg())) {
+                        throw std::runtime_error("EcfFile::create_job: User variables, Could not open script: " +
+                                                 error_msg);
+                    }
+                }
+                else {
+                    // *USE* the user supplied ECF file *AND* user variables
+                    lines = jobsParam.user_edit_file();
+                }
             }
-        }
 
-        // expand all %includes this will expand %includenopp by enclosing in %nopp %end
+            // expand all %includes this will expand %includenopp by enclosing in %nopp %end
 
-        PreProcessor data(this, "EcfFile::create_job");
-        data.preProcess(lines);
+            PreProcessor data(this, "EcfFile::create_job");
+            if (use_script_cache)
+                data.preProcess_and_cache(script_stamp, lines);
+            else
+                data.preProcess(lines);
+        }
     }
 
 #ifdef DEBUG_PRE_PROCESS_OUTPUT
@@ -362,6 +411,7 @@ const std::string& EcfFile::create_job(JobsParam& jobsParam) {
         if (!replaceSmsChildCmdsWithEcf(clientPath, error_msg)) {
             throw std::runtime_error("EcfFile::create_job: ECF_CLIENT replacement failed " + error_msg);
         }
+        substitution_plan_.reset(); // plan no longer matches the job lines
 #ifdef DEBUG_MIGRATE
         std::string err;
         File::create("migrate" + get_extn(), jobLines_, err);
@@ -371,7 +421,17 @@ const std::string& EcfFile::create_job(JobsParam& jobsParam) {
     /// Will use *USER* supplied edit variables in preference to node tree variable *IF* supplied
     /// expand %VAR% or %VAR:sub% & replace %% with %
     // Allow variable substitution in comment and manual blocks. But if it fails, don't report as an error
-    variableSubstitution(jobsParam);
+    {
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+        bool compiled                  = substitution_plan_ && jobsParam.user_edit_variables().empty();
+        if (compiled)
+            variableSubstitution(*substitution_plan_);
+        else
+            variableSubstitution(jobsParam);
+        std::int64_t micro_seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds();
+        JobProfiler::add_variable_substitution(compiled, micro_seconds);
+        JobProfiler::add_phase(JobProfiler::SUBSTITUTE, micro_seconds);
+    }
 
 #ifdef DEBUG_VAR_SUB_OUTPUT
     std::string err1;
@@ -391,6 +451,7 @@ const std::string& EcfFile::create_job(JobsParam& jobsParam) {
 
     remove_comment_manual_and_noop_tokens();
 
+    JobProfiler::PhaseTimer write(JobProfiler::WRITE);
     return doCreateJobFile(jobsParam /* this is only past in for profiling */); // create job on disk
 }
 
@@ -531,16 +592,6 @@ bool EcfFile::open_script_file(const std::string& file_or_cmd,
 }
 
 #define USE_INCLUDE_CACHE 1
-//  ulimit -Hn            # hard limit, of number of open files allowed
-//  ulimit -Sn            # soft limit
-//  ulimit -n <new-limit> # takes affect on current shell only
-//
-//  Check limit of running process:
-//     ps aux | grep process-name
-//     cat /proc/XXX/limits
-//  max open files allowed is:
-//     VM:       cat /proc/sys/fs/file-max:  188086
-//     Desk top: cat /proc/sys/fs/file-max: 3270058
 //  Desktop:
 //     Without cache: real:10.15  user: 5.58  sys: 1.62                                     # opensuse131
 //     With cache:    real: 4.46  user: 3.72  sys: 0.74  Only open/close include file once. # opensuse131
@@ -548,58 +599,11 @@ bool EcfFile::open_script_file(const std::string& file_or_cmd,
 //
 bool EcfFile::open_include_file(const std::string& file, std::vector<std::string>& lines, std::string& errormsg) const {
 #ifdef USE_INCLUDE_CACHE
-    // SEARCH THE CACHE
-    size_t include_file_cache_size = include_file_cache_.size();
-    for (size_t i = 0; i < include_file_cache_size; i++) {
-        if (include_file_cache_[i]->path() == file) {
-            // cout << "found " << file << " in cache, cache size = " << include_file_cache_.size() << "\n";
-            if (!include_file_cache_[i]->lines(lines)) {
-                std::stringstream ss;
-                ss << "Could not open include file: " << file << " (" << strerror(errno)
-                   << ") : include file cache size:" << include_file_cache_.size();
-                errormsg += ss.str();
-                return false;
-            }
-            return true;
-        }
-    }
-
-    // cout << "NOT found " << file << " in cache, cache size = " << include_file_cache_.size() << "\n";
-
-    if (include_file_cache_size > 1000) {
-        // avoid hitting limit for open file descriptors ~1024, valgrind(takes 10 fd). clear cache
-        include_file_cache_.clear();
-    }
-
-    // ADD to cache
-    std::shared_ptr<IncludeFileCache> ptr = std::make_shared<IncludeFileCache>(file);
-    include_file_cache_.push_back(ptr);
-
-    if (!ptr->lines(lines)) {
-        if (errno == EMFILE /*Too many open files*/) {
-
-            log(Log::WAR,
-                "EcfFile::open_include_file: Too many files open(errno=EMFILE), Clearing cache, and trying again. "
-                "Check limits with ulimit -Sn");
-            include_file_cache_.clear();
-
-            std::shared_ptr<IncludeFileCache> a_ptr = std::make_shared<IncludeFileCache>(file);
-            include_file_cache_.push_back(a_ptr);
-            if (!a_ptr->lines(lines)) {
-                std::stringstream ss;
-                ss << "Could not open include file: " << file << " (" << strerror(errno)
-                   << ") include file cache size:" << include_file_cache_.size();
-                errormsg += ss.str();
-                return false;
-            }
-        }
-        else {
-            std::stringstream ss;
-            ss << "Could not open include file: " << file << " (" << strerror(errno)
-               << ") include file cache size:" << include_file_cache_.size();
-            errormsg += ss.str();
-            return false;
-        }
+    if (!IncludeFileCache::instance().lines(file, lines)) {
+        std::stringstream ss;
+        ss << "Could not open include file: " << file << " (" << strerror(errno) << ")";
+        errormsg += ss.str();
+        return false;
     }
 #else
     if (!File::splitFileIntoLines(file, lines)) {
@@ -616,6 +620,45 @@ bool EcfFile::do_popen(const std::string& the_cmd,
                        EcfFile::Type type,
                        std::vector<std::string>& lines,
                        std::string& errormsg) const {
+    if (async_fetch_) {
+        // Only the main thread may start a command, see ScriptFetcher
+        std::string reason;
+        ScriptFetcher& fetcher       = ScriptFetcher::instance();
+        ScriptFetcher::Status status = start_fetch_ ? fetcher.fetch(the_cmd, node_->absNodePath(), lines, reason)
+                                                    : fetcher.fetch_available(the_cmd, lines, reason);
+        switch (status) {
+            case ScriptFetcher::AVAILABLE:
+                fetched_.push_back(the_cmd);
+                return true;
+            case ScriptFetcher::PENDING: {
+                fetch_pending_     = true;
+                pending_fetch_cmd_ = the_cmd;
+                std::stringstream ss;
+                ss << "EcfFile::do_popen: " << fileType(type) << " via cmd " << the_cmd << " for task "
+                   << node_->absNodePath() << " is still being fetched ";
+                errormsg += ss.str();
+                return false;
+            }
+            case ScriptFetcher::FAILED: {
+                std::stringstream ss;
+                ss << "EcfFile::do_popen: " << reason << " : " << fileType(type) << " via cmd " << the_cmd
+                   << " for task " << node_->absNodePath() << " ";
+                errormsg += ss.str();
+                return false;
+            }
+        }
+    }
+
+    DurationTimer timer;
+    bool ok = do_popen_sync(the_cmd, type, lines, errormsg);
+    ScriptFetcher::instance().add_sync_fetch(timer.elapsed().total_milliseconds(), ok);
+    return ok;
+}
+
+bool EcfFile::do_popen_sync(const std::string& the_cmd,
+                            EcfFile::Type type,
+                            std::vector<std::string>& lines,
+                            std::string& errormsg) const {
     FILE* fp = popen(the_cmd.c_str(), "r");
     if (!fp) {
         std::stringstream ss;
@@ -835,6 +878,160 @@ void EcfFile::variableSubstitution(const JobsParam& jobsParam) {
     }
 }
 
+void EcfFile::variableSubstitution(const VariableSubstitutionPlan& plan) {
+    // Same result as variableSubstitution(const JobsParam&), but each variable is only resolved once
+    NameValueMap user_edit_variables; // *NORMAL* flow, no user edit variables
+    std::unordered_map<std::string, std::string> values;
+    std::string line;
+    for (const auto& plan_line : plan.lines_) {
+        std::string& job_line = jobLines_[plan_line.index_];
+
+        bool substituted = !plan_line.legacy_;
+        if (substituted) {
+            line.clear();
+            for (const auto& segment : plan_line.segments_) {
+                if (!segment.variable_) {
+                    line += segment.text_;
+                    continue;
+                }
+                auto it = values.find(segment.text_);
+                if (it == values.end()) {
+                    std::string value;
+                    if (!node_->find_substitution_value(segment.text_, user_edit_variables, value)) {
+                        substituted = false;
+                        break;
+                    }
+                    it = values.emplace(segment.text_, std::move(value)).first;
+                }
+                if (it->second.find(plan_line.micro_) != std::string::npos) {
+                    // value requires recursive substitution
+                    substituted = false;
+                    break;
+                }
+                line += it->second;
+            }
+        }
+
+        if (substituted) {
+            if (plan_line.double_micro_) {
+                // Only %% remain, replace with %
+                node_->variable_substitution(line, user_edit_variables, plan_line.micro_);
+            }
+            job_line.swap(line);
+            continue;
+        }
+
+        // Report errors, as variableSubstitution(const JobsParam&)
+        if (!node_->variable_substitution(job_line, user_edit_variables, plan_line.micro_)) {
+            if (plan_line.ignore_errors_)
+                continue;
+
+            std::stringstream ss;
+            ss << "EcfFile::variableSubstitution: failed : '" << job_line << "'";
+            dump_expanded_script_file(jobLines_);
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
+std::shared_ptr<const VariableSubstitutionPlan> EcfFile::compile_variable_substitution() const {
+    // Follows variableSubstitution(const JobsParam&), to determine the lines that require substitution.
+    // Returns an empty plan, if the lines have errors. These are reported by variableSubstitution(const JobsParam&)
+    string ecfMicro = ecfMicroCache_;
+    char microChar  = ecfMicro[0];
+
+    const int NOPP    = 0;
+    const int COMMENT = 1;
+    const int MANUAL  = 2;
+    std::vector<int> pp_stack;
+
+    auto plan            = std::make_shared<VariableSubstitutionPlan>();
+    bool nopp            = false;
+    size_t jobLines_size = jobLines_.size();
+    for (size_t i = 0; i < jobLines_size; ++i) {
+        const std::string& job_line  = jobLines_[i];
+        string::size_type ecfmicro_pos = job_line.find(ecfMicro);
+        if (ecfmicro_pos == 0) {
+            if (job_line.find(T_MANUAL) == 1) {
+                pp_stack.push_back(MANUAL);
+                continue;
+            }
+            if (job_line.find(T_COMMENT) == 1) {
+                pp_stack.push_back(COMMENT);
+                continue;
+            }
+            if (job_line.find(T_NOOP) == 1) {
+                pp_stack.push_back(NOPP);
+                nopp = true;
+                continue;
+            }
+            if (job_line.find(T_END) == 1) {
+                if (pp_stack.empty())
+                    return std::shared_ptr<const VariableSubstitutionPlan>();
+                int last_directive = pp_stack.back();
+                pp_stack.pop_back();
+                if (last_directive == NOPP)
+                    nopp = false;
+                continue;
+            }
+            if (job_line.find(T_ECFMICRO) == 1) {
+                std::string error_msg;
+                if (!extract_ecfmicro(job_line, ecfMicro, error_msg))
+                    return std::shared_ptr<const VariableSubstitutionPlan>();
+                microChar = ecfMicro[0];
+                continue;
+            }
+        }
+        if (nopp || ecfmicro_pos == string::npos)
+            continue;
+
+        VariableSubstitutionPlan::Line plan_line;
+        plan_line.index_         = i;
+        plan_line.micro_         = microChar;
+        plan_line.ignore_errors_ = !pp_stack.empty() && (pp_stack.back() == COMMENT || pp_stack.back() == MANUAL);
+
+        // Split into literal and variable segments, as Node::variable_substitution would find them
+        size_t variables = 0;
+        std::string literal;
+        std::string::size_type pos = 0;
+        while (true) {
+            size_t firstPercentPos = job_line.find(microChar, pos);
+            if (firstPercentPos == string::npos)
+                break;
+            size_t secondPercentPos = job_line.find(microChar, firstPercentPos + 1);
+            if (secondPercentPos == string::npos)
+                break;
+
+            if (secondPercentPos - firstPercentPos <= 1) {
+                literal.append(job_line, pos, secondPercentPos + 1 - pos);
+                plan_line.double_micro_ = true;
+            }
+            else {
+                literal.append(job_line, pos, firstPercentPos - pos);
+                if (!literal.empty()) {
+                    plan_line.segments_.push_back({std::move(literal), false});
+                    literal.clear();
+                }
+                plan_line.segments_.push_back(
+                    {job_line.substr(firstPercentPos + 1, secondPercentPos - firstPercentPos - 1), true});
+                variables++;
+            }
+            pos = secondPercentPos + 1;
+        }
+        literal.append(job_line, pos, string::npos);
+        if (!literal.empty())
+            plan_line.segments_.push_back({std::move(literal), false});
+
+        // Node::variable_substitution fails, after 1000 substitutions (infinite recursion)
+        if (variables > 1000) {
+            plan_line.legacy_ = true;
+            plan_line.segments_.clear();
+        }
+        plan->lines_.push_back(std::move(plan_line));
+    }
+    return plan;
+}
+
 void EcfFile::get_used_variables(std::string& used_variables) const {
     /// Find Used variables, *after* all %includes expanded
     NameValueMap used_variables_map;
@@ -1027,28 +1224,9 @@ const std::string& EcfFile::doCreateJobFile(JobsParam& jobsParam) const {
         std::string error_msg;
         if (!File::create(ecf_job, jobLines_, error_msg)) {
             std::stringstream ss;
-            if (errno == EMFILE /*Too many open files*/) {
-                // CLEAR cache and try again. Can test with ulimit -n 60, (Base/bin/gcc-5.3.0/release/perf_job_gen
-                // ./metabuilder.def)
-                LogToCout log_to_cout;
-                ss << "EcfFile::doCreateJobFile: Too many files open(errno=EMFILE), include file cache size("
-                   << include_file_cache_.size() << ") Clearing cache. Check limits with ulimit -Sn";
-                log(Log::WAR, ss.str());
-
-                include_file_cache_.clear();
-
-                error_msg.clear();
-                if (!File::create(ecf_job, jobLines_, error_msg)) {
-                    ss << "EcfFile::doCreateJobFile: Could not create job file, even after clearing include cache: "
-                       << error_msg; // error_msg includes strerror(errno)
-                    throw std::runtime_error(ss.str());
-                }
-            }
-            else {
-                ss << "EcfFile::doCreateJobFile: Could not create job file : "
-                   << error_msg; // error_msg includes strerror(errno)
-                throw std::runtime_error(ss.str());
-            }
+            ss << "EcfFile::doCreateJobFile: Could not create job file : "
+               << error_msg; // error_msg includes strerror(errno)
+            throw std::runtime_error(ss.str());
         }
 
         // make the job file executable
@@ -1428,6 +1606,62 @@ void PreProcessor::preProcess(std::vector<std::string>& script_lines) {
         throw std::runtime_error(error_context() + "Unterminated manual, matching 'end' is missing");
 }
 
+bool PreProcessor::preProcess_from_cache(const FileStamp& script_stamp) {
+    auto valid = [this, &script_stamp](const PreProcessedScriptCache::Script& script) {
+        if (script.stamp_ != script_stamp)
+            return false;
+
+        // The include files are located using the variables of *this* task
+        std::string ecf_micro = ecf_micro_;
+        bool unchanged        = true;
+        for (const auto& include : script.includes_) {
+            ecf_micro_ = include.ecf_micro_;
+            try {
+                FileStamp stamp;
+                if (getIncludedFilePath(include.token_, include.token_) != include.path_ ||
+                    !stamp.stat(include.path_) || stamp != include.stamp_) {
+                    unchanged = false;
+                    break;
+                }
+            }
+            catch (std::exception&) {
+                unchanged = false; // report the error, when pre-processing
+                break;
+            }
+        }
+        ecf_micro_ = ecf_micro;
+        return unchanged;
+    };
+
+    std::shared_ptr<const PreProcessedScriptCache::Script> script =
+        PreProcessedScriptCache::instance().find(cache_key(), valid);
+    if (!script)
+        return false;
+    jobLines_                   = script->lines_;
+    ecfile_->substitution_plan_ = script->plan_;
+    return true;
+}
+
+void PreProcessor::preProcess_and_cache(const FileStamp& script_stamp, std::vector<std::string>& script_lines) {
+    auto script    = std::make_shared<PreProcessedScriptCache::Script>();
+    script->stamp_ = script_stamp;
+    includes_      = &script->includes_;
+    preProcess(script_lines);
+    includes_ = nullptr;
+
+    script->lines_ = jobLines_;
+    script->plan_  = ecfile_->compile_variable_substitution();
+    PreProcessedScriptCache::instance().add(cache_key(), script);
+    ecfile_->substitution_plan_ = script->plan_;
+}
+
+std::string PreProcessor::cache_key() const {
+    std::string key = ecfile_->script_path_or_cmd_;
+    key += '\n';
+    key += ecfile_->ecfMicroCache_;
+    return key;
+}
+
 void PreProcessor::preProcess_line() {
     const std::string& script_line = jobLines_.back();
 
@@ -1593,6 +1827,19 @@ void PreProcessor::preProcess_includes() {
 #endif
 
         includedFile = getIncludedFilePath(the_include_token, script_line);
+        if (includes_) {
+            auto fnd_include = std::find_if(includes_->begin(), includes_->end(), [&](const auto& include) {
+                return include.token_ == the_include_token && include.ecf_micro_ == ecf_micro_;
+            });
+            if (fnd_include == includes_->end()) {
+                PreProcessedScriptCache::Include include;
+                include.token_     = the_include_token;
+                include.ecf_micro_ = ecf_micro_;
+                include.path_      = includedFile;
+                include.stamp_.stat(includedFile); // if the file does not exist, pre-processing will fail
+                includes_->push_back(include);
+            }
+        }
 
         // remove %include from the job lines, since were going to expand or ignore it.
         // **** input script_line life_time is tied, jobLines_.back(), hence jobLines_.pop_back() will invalidate
@@ -1699,29 +1946,49 @@ std::string PreProcessor::getIncludedFilePath(const std::string& includedFile1,
         if (node->findParentUserVariableValue(Str::ECF_INCLUDE(), ecf_include) && !ecf_include.empty()) {
 
             // if ECF_INCLUDE is a set a paths, search in order. i.e like $PATH
-            if (ecf_include.find(':') != std::string::npos) {
-                std::vector<std::string> include_paths;
-                Str::split(ecf_include, include_paths, ":");
-                for (const auto& include_path : include_paths) {
-                    ecf_include.clear();
-                    ecf_include = include_path;
-                    ecf_include += '/';
-                    ecf_include += the_include_file;
-
-                    // Don't rely on hard coded paths. Added for testing, but could be generally useful
-                    // since in test scenario ECF_INCLUDE is defined relative to $ECF_HOME
-                    node->variable_dollar_subsitution(ecf_include);
+            std::vector<std::string> include_paths;
+            Str::split(ecf_include, include_paths, ":");
+            for (auto& include_path : include_paths) {
+                include_path += '/';
+                include_path += the_include_file;
+
+                // Don't rely on hard coded paths. Added for testing, but could be generally useful
+                // since in test scenario ECF_INCLUDE is defined relative to $ECF_HOME
+                node->variable_dollar_subsitution(include_path);
+            }
 
-                    if (ecfile_->file_exists(ecf_include))
-                        return ecf_include;
+            // Use the include file found by a previous search, that still exists. See ScriptPathCache
+            bool search = true;
+            std::string path_cache_key;
+            ScriptPathCache& path_cache = ScriptPathCache::instance();
+            if (path_cache.enabled()) {
+                for (const auto& include_path : include_paths) {
+                    path_cache_key += include_path;
+                    path_cache_key += '\n';
+                }
+                ScriptPathCache::Location cached;
+                if (path_cache.find(path_cache_key, cached)) {
+                    if (cached.path_.empty())
+                        search = false;
+                    else if (ecfile_->file_exists(cached.path_))
+                        return cached.path_;
+                    else
+                        path_cache.remove(path_cache_key);
                 }
             }
-            else {
-                ecf_include += '/';
-                ecf_include += the_include_file;
-                node->variable_dollar_subsitution(ecf_include);
-                if (ecfile_->file_exists(ecf_include))
-                    return ecf_include;
+
+            if (search) {
+                ScriptPathCache::Location location;
+                for (const auto& include_path : include_paths) {
+                    if (ecfile_->file_exists(include_path)) {
+                        location.path_ = include_path;
+                        break;
+                    }
+                }
+                if (!path_cache_key.empty())
+                    path_cache.add(path_cache_key, location);
+                if (!location.path_.empty())
+                    return location.path_;
             }
 
             // ECF_INCLUDE is specified *BUT* the file does *NOT* exist, Look in ECF_HOME
@@ -1822,6 +2089,7 @@ bool EcfFile::file_exists(const std::string& ecf_include) const {
             return file_stat_cache_[i].second;
         }
     }
+    JobProfiler::add_file_probes(true, 1);
     if (fs::exists(ecf_include)) {
         // cout << "EcfFile::file_exists " << ecf_include << " exists add to cache\n";
         file_stat_cache_.emplace_back(ecf_include, true);
@@ -1834,32 +2102,260 @@ bool EcfFile::file_exists(const std::string& ecf_include) const {
 
 // **********************************************************************************
 
-IncludeFileCache::IncludeFileCache(const std::string& path)
-    : path_(path),
-      fp_(path.c_str(), std::ios_base::in),
-      no_of_lines_(0) {
+IncludeFileCache& IncludeFileCache::instance() {
+    static IncludeFileCache the_cache;
+    return the_cache;
 }
 
-IncludeFileCache::~IncludeFileCache() {
-    fp_.close();
+bool FileStamp::stat(const std::string& path) {
+    struct stat stat_buf;
+    if (::stat(path.c_str(), &stat_buf) != 0)
+        return false;
+    mtime_ = stat_buf.st_mtime;
+#ifdef __APPLE__
+    mtime_nsec_ = stat_buf.st_mtimespec.tv_nsec;
+#else
+    mtime_nsec_ = stat_buf.st_mtim.tv_nsec;
+#endif
+    size_ = stat_buf.st_size;
+    ino_  = stat_buf.st_ino;
+    dev_  = stat_buf.st_dev;
+    return true;
 }
 
-bool IncludeFileCache::lines(std::vector<std::string>& lns) {
-    if (!fp_)
+// **********************************************************************************
+
+bool IncludeFileCache::lines(const std::string& path, std::vector<std::string>& lns) {
+    FileStamp stamp;
+    if (!stamp.stat(path))
         return false;
 
-    if (no_of_lines_ != 0) {
-        lns.reserve(no_of_lines_);
-        fp_.seekg(0); // Using cache, reset pos back to 0
+    std::shared_ptr<const std::vector<std::string>> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(path);
+        if (it != cache_.end()) {
+            Entry& e = it->second;
+            if (e.stamp_ == stamp) {
+                lru_.splice(lru_.begin(), lru_, e.lru_);
+                cached = e.lines_;
+                hits_++;
+            }
+            else {
+                // include file has changed
+                bytes_ -= e.bytes_;
+                lru_.erase(e.lru_);
+                cache_.erase(it);
+            }
+        }
+        if (!cached)
+            misses_++;
+    }
+    if (cached) {
+        lns.insert(lns.end(), cached->begin(), cached->end());
+        return true;
     }
 
-    // Note if we use: while( getline( theEcfFile, line)), then we will miss the *last* *empty* line
-    string line;
-    while (std::getline(fp_, line)) {
-        lns.push_back(line);
-    }                          // c++11
-    fp_.clear();               // eol fp_ will be in bad state reset. So we can re-use
-    no_of_lines_ = lns.size(); // cache for next time
-
+    auto file_lines = std::make_shared<std::vector<std::string>>();
+    if (!File::splitFileIntoLines(path, *file_lines))
+        return false;
+    lns.insert(lns.end(), file_lines->begin(), file_lines->end());
+
+    Entry e;
+    e.stamp_ = stamp;
+    e.bytes_ = path.size() + file_lines->size() * sizeof(std::string);
+    for (const auto& line : *file_lines)
+        e.bytes_ += line.size();
+    e.lines_ = std::move(file_lines);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (e.bytes_ > max_bytes_ || cache_.find(path) != cache_.end())
+        return true; // too big, or added by another thread
+    evict(max_bytes_ - e.bytes_);
+    lru_.push_front(path);
+    e.lru_ = lru_.begin();
+    bytes_ += e.bytes_;
+    cache_.emplace(path, std::move(e));
     return true;
 }
+
+void IncludeFileCache::evict(size_t max_bytes) {
+    while (bytes_ > max_bytes && !lru_.empty()) {
+        auto it = cache_.find(lru_.back());
+        bytes_ -= it->second.bytes_;
+        cache_.erase(it);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+void IncludeFileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+void IncludeFileCache::set_max_bytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    evict(max_bytes_);
+}
+
+size_t IncludeFileCache::max_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_bytes_;
+}
+
+size_t IncludeFileCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t IncludeFileCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t IncludeFileCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+size_t IncludeFileCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t IncludeFileCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+// **********************************************************************************
+
+PreProcessedScriptCache& PreProcessedScriptCache::instance() {
+    static PreProcessedScriptCache the_cache;
+    return the_cache;
+}
+
+std::shared_ptr<const PreProcessedScriptCache::Script>
+PreProcessedScriptCache::find(const std::string& key, const std::function<bool(const Script&)>& valid) {
+    std::vector<std::shared_ptr<const Script>> scripts;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru_);
+            scripts = it->second.scripts_;
+        }
+    }
+
+    // validate outside of the lock, this will stat the script and include files
+    std::shared_ptr<const Script> script;
+    for (auto i = scripts.rbegin(); i != scripts.rend(); ++i) {
+        if (valid(**i)) {
+            script = *i;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (script)
+        hits_++;
+    else
+        misses_++;
+    return script;
+}
+
+void PreProcessedScriptCache::add(const std::string& key, const std::shared_ptr<const Script>& script) {
+    // Limit the variants, i.e. when the include paths depend on a variable that differs for every task
+    const size_t max_variants = 8;
+
+    auto same_include_paths = [&script](const std::shared_ptr<const Script>& variant) {
+        return std::equal(variant->includes_.begin(),
+                          variant->includes_.end(),
+                          script->includes_.begin(),
+                          script->includes_.end(),
+                          [](const Include& lhs, const Include& rhs) { return lhs.path_ == rhs.path_; });
+    };
+
+    size_t script_bytes = key.size() + bytes(*script);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (script_bytes > max_bytes_)
+        return;
+
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+        lru_.push_front(key);
+        Entry e;
+        e.lru_ = lru_.begin();
+        it     = cache_.emplace(key, std::move(e)).first;
+    }
+    else {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_);
+    }
+
+    // replace the stale variant, or the oldest when there are too many
+    Entry& e                                            = it->second;
+    std::vector<std::shared_ptr<const Script>>& scripts = e.scripts_;
+    for (auto i = scripts.begin(); i != scripts.end();) {
+        if (same_include_paths(*i) || scripts.size() >= max_variants) {
+            size_t variant_bytes = key.size() + bytes(**i);
+            e.bytes_ -= variant_bytes;
+            bytes_ -= variant_bytes;
+            i = scripts.erase(i);
+        }
+        else
+            ++i;
+    }
+    scripts.push_back(script);
+    e.bytes_ += script_bytes;
+    bytes_ += script_bytes;
+
+    evict(max_bytes_);
+}
+
+size_t PreProcessedScriptCache::bytes(const Script& script) {
+    size_t bytes = script.lines_.size() * sizeof(std::string);
+    for (const auto& line : script.lines_)
+        bytes += line.size();
+    return bytes;
+}
+
+void PreProcessedScriptCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+void PreProcessedScriptCache::set_max_bytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    evict(max_bytes_);
+}
+
+void PreProcessedScriptCache::evict(size_t max_bytes) {
+    while (bytes_ > max_bytes && !lru_.empty()) {
+        auto it = cache_.find(lru_.back());
+        bytes_ -= it->second.bytes_;
+        cache_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+size_t PreProcessedScriptCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t PreProcessedScriptCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t PreProcessedScriptCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
@@ -15,31 +15,189 @@
 // Description :
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
-#include <fstream>
+#include <functional>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
 
 #include <boost/filesystem/path.hpp>
 
 #include "NodeFwd.hpp"
 
+// Identifies the contents of a file, without reading it. Changes when the file is modified or replaced.
+struct FileStamp
+{
+    time_t mtime_{0};
+    long mtime_nsec_{0};
+    off_t size_{0};
+    ino_t ino_{0};
+    dev_t dev_{0};
+
+    /// Returns false if the file can not be stat'ed, with errno set
+    bool stat(const std::string& path);
+
+    bool operator==(const FileStamp& rhs) const {
+        return mtime_ == rhs.mtime_ && mtime_nsec_ == rhs.mtime_nsec_ && size_ == rhs.size_ && ino_ == rhs.ino_ &&
+               dev_ == rhs.dev_;
+    }
+    bool operator!=(const FileStamp& rhs) const { return !operator==(rhs); }
+};
+
 // This class is used to minimise file I/0.
-// When job processing the same include file can be opened and closed many time
-// This cache serves to open the include file only once. It halves the job processing time.
+// When job processing the same include file can be read many times, across many tasks.
+// This cache holds the lines of each include file, and is shared by all EcfFile's for
+// the lifetime of the process(server). No file descriptors are held open.
+//
+// Each look up will stat the include file. The cached lines are only used if the
+// modification time, size and inode are unchanged, hence edits to include files are
+// picked up on the next job generation.
+// The cache is bounded by size in bytes, the least recently used files are evicted first.
 class IncludeFileCache {
 private:
     IncludeFileCache(const IncludeFileCache&)                  = delete;
     const IncludeFileCache& operator=(const IncludeFileCache&) = delete;
 
 public:
-    explicit IncludeFileCache(const std::string& path);
-    ~IncludeFileCache();
-    const std::string& path() const { return path_; }
-    bool lines(std::vector<std::string>&);
+    static IncludeFileCache& instance();
+
+    /// Append the lines of the include file. Returns false if file could not be read, with errno set
+    bool lines(const std::string& path, std::vector<std::string>& lns);
+
+    void clear();
+
+    /// Maximum size of all the cached files, files larger than this are not cached
+    void set_max_bytes(size_t max_bytes);
+    size_t max_bytes() const;
+
+    size_t hits() const;
+    size_t misses() const;
+    size_t evictions() const;
+    size_t bytes() const;
+    size_t size() const;
 
 private:
-    std::string path_;
-    std::ifstream fp_; // is not copy constructable
-    size_t no_of_lines_;
+    IncludeFileCache() = default;
+    void evict(size_t max_bytes);
+
+    struct Entry
+    {
+        std::shared_ptr<const std::vector<std::string>> lines_;
+        std::list<std::string>::iterator lru_;
+        FileStamp stamp_;
+        size_t bytes_{0}; // approximate memory used by the lines
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> cache_;
+    std::list<std::string> lru_; // path, most recently used first
+    size_t max_bytes_{64 * 1024 * 1024};
+    size_t bytes_{0};
+    size_t hits_{0};
+    size_t misses_{0};
+    size_t evictions_{0};
+};
+
+// The variable substitution of a pre-processed script, compiled once when the script is cached.
+// Each line that requires substitution is split into literal and variable segments, hence the
+// substitution for each task is a concatenation of the segments, where each variable is only
+// resolved once per job. See EcfFile::compile_variable_substitution()
+struct VariableSubstitutionPlan
+{
+    struct Segment
+    {
+        std::string text_;      // literal text, or the variable i.e. VAR or VAR:substitute
+        bool variable_{false};
+    };
+
+    struct Line
+    {
+        size_t index_{0};           // index of the line, in the pre-processed lines
+        char micro_{'%'};           // ecf micro in effect, at this line
+        bool ignore_errors_{false}; // line is in a %comment or %manual block
+        bool double_micro_{false};  // line has %%, replaced with %
+        bool legacy_{false};        // too many variables, use Node::variable_substitution
+        std::vector<Segment> segments_;
+    };
+
+    std::vector<Line> lines_; // only the lines that require substitution
+};
+
+// Cache of the pre-processed scripts, i.e. with the %includes expanded, shared by all EcfFile's.
+// Many tasks share the same script and include files, and only differ in the variable substitution.
+// Enabled by JobsParam::use_script_cache(), only for scripts read from file.
+//
+// The cache is keyed by the script path and ECF_MICRO. Since the include files are located using
+// the variables of each task (ECF_INCLUDE, ECF_HOME, %include <%VAR%.h>), the includes are
+// re-located for each task, and the cached script is only used if each include resolves to the
+// same file, and the script and include files are unchanged. Tasks that locate different include
+// files for the same script (i.e. different ECF_INCLUDE) are held as separate variants of the script.
+// Note: A *new* include file, which would be found earlier in the ECF_INCLUDE search path, is only
+// picked up once the script, or one of its include files is modified.
+class PreProcessedScriptCache {
+private:
+    PreProcessedScriptCache(const PreProcessedScriptCache&)                  = delete;
+    const PreProcessedScriptCache& operator=(const PreProcessedScriptCache&) = delete;
+
+public:
+    struct Include
+    {
+        std::string token_;     // i.e <head.h>, "../tail.h", <%VAR%.h>
+        std::string ecf_micro_; // ecf micro in effect, when the include was found
+        std::string path_;      // resolved path of the include file
+        FileStamp stamp_;
+    };
+
+    struct Script
+    {
+        FileStamp stamp_;
+        std::vector<Include> includes_;
+        std::vector<std::string> lines_;                       // pre-processed lines
+        std::shared_ptr<const VariableSubstitutionPlan> plan_; // empty if the lines could not be compiled
+    };
+
+    static PreProcessedScriptCache& instance();
+
+    /// Return the most recently added variant of the script, for which valid() returns true
+    std::shared_ptr<const Script>
+    find(const std::string& key, const std::function<bool(const Script&)>& valid);
+
+    /// Add the script, replacing the variant with the same include file paths
+    void add(const std::string& key, const std::shared_ptr<const Script>& script);
+
+    void clear();
+
+    /// Maximum size of all the cached scripts, scripts larger than this are not cached
+    void set_max_bytes(size_t max_bytes);
+
+    size_t hits() const;
+    size_t misses() const;
+    size_t size() const;
+
+private:
+    PreProcessedScriptCache() = default;
+    void evict(size_t max_bytes);
+
+    struct Entry
+    {
+        std::vector<std::shared_ptr<const Script>> scripts_; // variants, most recently added last
+        std::list<std::string>::iterator lru_;
+        size_t bytes_{0}; // approximate memory used by the lines, of all variants
+    };
+
+    static size_t bytes(const Script& script);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> cache_;
+    std::list<std::string> lru_; // key, most recently used first
+    size_t max_bytes_{128 * 1024 * 1024};
+    size_t bytes_{0};
+    size_t hits_{0};
+    size_t misses_{0};
 };
 
 /// This class is used in the pre-processing of files( .ecf or .usr or .man typically)
@@ -135,6 +293,11 @@ public:
     static void extract_used_variables(NameValueMap& used_variables_as_map,
                                        const std::vector<std::string>& script_lines);
 
+    /// Returns true, if create_job() failed, because the script or an include file is still being fetched
+    /// in the background. See JobsParam::async_fetch()
+    bool fetch_pending() const { return fetch_pending_; }
+    const std::string& pending_fetch_cmd() const { return pending_fetch_cmd_; }
+
 private:
     friend class PreProcessor;
     enum Type { SCRIPT, INCLUDE, MANUAL, COMMENT };
@@ -148,6 +311,8 @@ private:
 
     bool replaceSmsChildCmdsWithEcf(const std::string& clientPath, std::string& errormsg);
     void variableSubstitution(const JobsParam&);
+    void variableSubstitution(const VariableSubstitutionPlan&);
+    std::shared_ptr<const VariableSubstitutionPlan> compile_variable_substitution() const;
     const std::string& doCreateJobFile(JobsParam&) const;
     bool doCreateManFile(std::string& errormsg);
     bool extractManual(const std::vector<std::string>& lines,
@@ -164,6 +329,10 @@ private:
 
     bool
     do_popen(const std::string& the_cmd, EcfFile::Type, std::vector<std::string>& lines, std::string& errormsg) const;
+    bool do_popen_sync(const std::string& the_cmd,
+                       EcfFile::Type,
+                       std::vector<std::string>& lines,
+                       std::string& errormsg) const;
 
     boost::filesystem::path file_creation_path() const;
     std::string script_or_job_path() const;
@@ -180,13 +349,18 @@ private:
     std::string ecfMicroCache_;         // cache value of ECF_MICRO
     std::string script_path_or_cmd_;    // path to .ecf, .usr file or command
     std::vector<std::string> jobLines_; // Lines that will form the job file.
+    std::shared_ptr<const VariableSubstitutionPlan> substitution_plan_; // of cached pre-processed jobLines_
 
-    mutable std::vector<std::shared_ptr<IncludeFileCache>> include_file_cache_; // only open include file once
     mutable std::vector<std::pair<std::string, bool>> file_stat_cache_;         // Minimise calls to stat/kernel calls
     mutable std::string job_size_;                       // to be placed in log file during job submission
     EcfFile::Origin script_origin_{EcfFile::ECF_SCRIPT}; // get script from a file, or from running a command
     EcfFile::EcfFileSearchAlgorithm ecf_file_search_algorithm_{
         EcfFile::PRUNE_ROOT}; // only used for ECF_FILES and ECF_HOME
+    bool async_fetch_{false};                    // run ECF_FETCH/ECF_SCRIPT_CMD via ScriptFetcher
+    bool start_fetch_{true};                     // false on the job creation threads
+    mutable bool fetch_pending_{false};          // a command is still running, or is not started
+    mutable std::string pending_fetch_cmd_;      // the command, when fetch_pending_
+    mutable std::vector<std::string> fetched_;   // commands whose output was used, released after create_job
 };
 
 // This class is used in expanding(pre-processing) the includes.
@@ -202,7 +376,16 @@ public:
 
     void preProcess(std::vector<std::string>& script_lines);
 
+    /// Use the cached pre-processed script, if the script(stamp) and its include files are unchanged
+    /// Returns false if not cached, caller must then pre-process the script
+    bool preProcess_from_cache(const FileStamp& script_stamp);
+
+    /// pre-process the script, and cache the result
+    void preProcess_and_cache(const FileStamp& script_stamp, std::vector<std::string>& script_lines);
+
 private:
+    std::string cache_key() const;
+
     std::string error_context() const;
 
     // include pre-processing on the included file.
@@ -227,6 +410,7 @@ private:
     std::vector<std::pair<std::string, int>>
         globalIncludedFileSet_; // test for recursive includes, <no _of times it was included>
     std::vector<std::string> include_once_set_;
+    std::vector<PreProcessedScriptCache::Include>* includes_{nullptr}; // when caching, record includes found
 
     bool nopp_{false};
     bool comment_{false};
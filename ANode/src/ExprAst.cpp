@@ -19,6 +19,7 @@
 
 #include "Cal.hpp"
 #include "Defs.hpp"
+#include "Ecf.hpp"
 #include "ExprAstVisitor.hpp"
 #include "Indentor.hpp"
 #include "Log.hpp"
@@ -1722,15 +1723,36 @@ Node* AstVariable::referencedNode(std::string& errorMsg) const {
 ////////////////////////////////////////////////////////////////////////////////////
 
 Node* AstParentVariable::find_node_which_references_variable() const {
+    // The change numbers are only updated in the server
+    if (Ecf::server() && searched_is_valid())
+        return searched_.back().first;
+
+    searched_.clear();
     Node* parent = parentNode_;
     while (parent) {
+        searched_.emplace_back(parent, parent->attr_change_no());
         if (parent->findExprVariable(name_))
             return parent;
         parent = parent->parent();
     }
+    searched_.clear();
     return nullptr;
 }
 
+bool AstParentVariable::searched_is_valid() const {
+    // The searched nodes can be moved, or a variable added to a node we have searched
+    size_t size = searched_.size();
+    if (size == 0 || searched_[0].first != parentNode_)
+        return false;
+    for (size_t i = 0; i < size; i++) {
+        if (searched_[i].first->attr_change_no() != searched_[i].second)
+            return false;
+        if (i + 1 < size && searched_[i].first->parent() != searched_[i + 1].first)
+            return false;
+    }
+    return true;
+}
+
 void AstParentVariable::accept(ExprAstVisitor& v) {
     v.visitParentVariable(this); // Not calling base
 }
@@ -19,6 +19,7 @@
 
 #include <cassert>
 #include <iosfwd>
+#include <vector>
 
 #include "DState.hpp"
 #include "Flag.hpp"
@@ -635,8 +636,11 @@ public:
     std::string type() const override { return stype(); }
     std::string expression() const override;
     std::string why_expression(bool html = false) const override;
-    void setParentNode(Node* n) override { parentNode_ = n; }
-    void invalidate_trigger_references() const override { ref_node_.reset(); }
+    void setParentNode(Node* n) override {
+        parentNode_ = n;
+        searched_.clear();
+    }
+    void invalidate_trigger_references() const override { searched_.clear(); }
 
     int minus(Ast* right) const override;
     int plus(Ast* right) const override;
@@ -647,10 +651,15 @@ public:
     Node* find_node_which_references_variable() const;
     Node* referencedNode() const { return find_node_which_references_variable(); }
 
+private:
+    bool searched_is_valid() const;
+
 private:
     Node* parentNode_;
     std::string name_;
-    mutable weak_node_ptr ref_node_;
+    // The nodes searched by the last find_node_which_references_variable(), with their attr_change_no
+    // The last node references the variable. Empty if not searched, or the variable was not found
+    mutable std::vector<std::pair<Node*, unsigned int>> searched_;
 };
 
 // Helper class
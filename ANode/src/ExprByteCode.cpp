@@ -0,0 +1,496 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "ExprByteCode.hpp"
+
+#include <algorithm>
+
+#include "Ecf.hpp"
+#include "ExprAst.hpp"
+#include "Log.hpp"
+#include "Node.hpp"
+
+namespace ecf {
+
+bool ExprByteCode::enabled_               = true;
+std::uint64_t ExprByteCode::binds_        = 0;
+std::uint64_t ExprByteCode::cache_hits_   = 0;
+std::uint64_t ExprByteCode::cache_misses_ = 0;
+
+ExprByteCode::ExprByteCode(const AstTop* top) {
+    compile_bool(top->left());
+}
+
+void ExprByteCode::emit(OpCode op, int arg) {
+    code_.push_back({op, arg});
+    switch (op) {
+        case PUSH:
+        case SLOT:
+        case AST_VALUE:
+        case AST_EVALUATE:
+            depth_++;
+            break;
+        case SLOT_PLUS:
+        case SLOT_MINUS:
+        case NOT:
+        case TO_BOOL:
+            break;
+        default:
+            depth_--; // binary operators, and/or when not short circuited
+            break;
+    }
+    if (depth_ > stack_.size())
+        stack_.resize(depth_);
+}
+
+int ExprByteCode::add_slot(const Ast* leaf, bool parent_variable) {
+    Slot slot;
+    slot.leaf_            = leaf;
+    slot.name_            = leaf->name();
+    slot.parent_variable_ = parent_variable;
+    slots_.push_back(slot);
+    return static_cast<int>(slots_.size() - 1);
+}
+
+int ExprByteCode::add_fallback(const Ast* ast) {
+    fallbacks_.push_back(ast);
+    return static_cast<int>(fallbacks_.size() - 1);
+}
+
+// Mirrors Ast::evaluate()
+void ExprByteCode::compile_bool(const Ast* ast) {
+    if (dynamic_cast<const AstAnd*>(ast) || dynamic_cast<const AstOr*>(ast)) {
+        compile_bool(ast->left());
+        size_t jump = code_.size();
+        emit(dynamic_cast<const AstAnd*>(ast) ? AND : OR);
+        compile_bool(ast->right());
+        code_[jump].arg_ = static_cast<int>(code_.size());
+        return;
+    }
+    if (dynamic_cast<const AstNot*>(ast)) {
+        compile_bool(ast->left());
+        emit(NOT);
+        return;
+    }
+
+    OpCode op = PUSH;
+    if (dynamic_cast<const AstEqual*>(ast))
+        op = EQUAL;
+    else if (dynamic_cast<const AstNotEqual*>(ast))
+        op = NOT_EQUAL;
+    else if (dynamic_cast<const AstLessEqual*>(ast))
+        op = LESS_EQUAL;
+    else if (dynamic_cast<const AstGreaterEqual*>(ast))
+        op = GREATER_EQUAL;
+    else if (dynamic_cast<const AstGreaterThan*>(ast))
+        op = GREATER_THAN;
+    else if (dynamic_cast<const AstLessThan*>(ast))
+        op = LESS_THAN;
+    if (op != PUSH) {
+        compile_int(ast->left());
+        compile_int(ast->right());
+        emit(op);
+        return;
+    }
+
+    if (ast->isRoot()) {
+        emit(PUSH, 1); // arithmetic operators always evaluate to true
+    }
+    else if (dynamic_cast<const AstInteger*>(ast)) {
+        emit(PUSH, ast->value() != 0 ? 1 : 0);
+    }
+    else if (dynamic_cast<const AstVariable*>(ast) || dynamic_cast<const AstParentVariable*>(ast)) {
+        emit(SLOT, add_slot(ast, dynamic_cast<const AstParentVariable*>(ast) != nullptr));
+        emit(TO_BOOL);
+    }
+    else {
+        emit(AST_EVALUATE, add_fallback(ast));
+    }
+}
+
+// Mirrors Ast::value()
+void ExprByteCode::compile_int(const Ast* ast) {
+    if (dynamic_cast<const AstNot*>(ast)) {
+        compile_int(ast->left());
+        emit(NOT);
+        return;
+    }
+
+    bool plus = dynamic_cast<const AstPlus*>(ast) != nullptr;
+    if (plus || dynamic_cast<const AstMinus*>(ast)) {
+        // A variable on the left may reference a repeat date, which uses date arithmetic
+        const Ast* left = ast->left();
+        if (dynamic_cast<const AstVariable*>(left) || dynamic_cast<const AstParentVariable*>(left)) {
+            int slot = add_slot(left, dynamic_cast<const AstParentVariable*>(left) != nullptr);
+            compile_int(ast->right());
+            emit(plus ? SLOT_PLUS : SLOT_MINUS, slot);
+            return;
+        }
+        compile_int(left);
+        compile_int(ast->right());
+        emit(plus ? PLUS : MINUS);
+        return;
+    }
+
+    OpCode op = PUSH;
+    if (dynamic_cast<const AstMultiply*>(ast))
+        op = MULTIPLY;
+    else if (dynamic_cast<const AstDivide*>(ast))
+        op = DIVIDE;
+    else if (dynamic_cast<const AstModulo*>(ast))
+        op = MODULO;
+    if (op != PUSH) {
+        compile_int(ast->left());
+        compile_int(ast->right());
+        emit(op);
+        return;
+    }
+
+    if (dynamic_cast<const AstInteger*>(ast) || dynamic_cast<const AstNodeState*>(ast) ||
+        dynamic_cast<const AstEventState*>(ast)) {
+        emit(PUSH, ast->value());
+    }
+    else if (dynamic_cast<const AstNode*>(ast) || dynamic_cast<const AstVariable*>(ast)) {
+        emit(SLOT, add_slot(ast, false));
+    }
+    else if (dynamic_cast<const AstParentVariable*>(ast)) {
+        emit(SLOT, add_slot(ast, true));
+    }
+    else {
+        emit(AST_VALUE, add_fallback(ast));
+    }
+}
+
+bool ExprByteCode::evaluate() const {
+    if (!bound_ || modify_change_no_ != Ecf::modify_change_no()) {
+        for (Slot& s : slots_) {
+            bind(s);
+        }
+        modify_change_no_ = Ecf::modify_change_no();
+        bound_            = true;
+        memoized_         = false;
+    }
+
+    unsigned int change_no = 0;
+    bool cacheable         = dependencies_change_no(change_no);
+    if (cacheable && memoized_ && change_no == result_change_no_) {
+        cache_hits_++;
+        return result_;
+    }
+
+    cache_misses_++;
+    bool result = run();
+    memoized_   = cacheable; // all slots were valid, hence not bound again by run()
+    if (cacheable) {
+        result_           = result;
+        result_change_no_ = change_no;
+    }
+    return result;
+}
+
+bool ExprByteCode::run() const {
+    int* sp           = stack_.data(); // next free position
+    const size_t size = code_.size();
+    for (size_t pc = 0; pc < size; ++pc) {
+        const Instruction& instruction = code_[pc];
+        switch (instruction.op_) {
+            case PUSH:
+                *sp++ = instruction.arg_;
+                break;
+            case SLOT:
+                *sp++ = value(slot(instruction.arg_));
+                break;
+            case SLOT_PLUS:
+                sp[-1] = plus(slot(instruction.arg_), sp[-1]);
+                break;
+            case SLOT_MINUS:
+                sp[-1] = minus(slot(instruction.arg_), sp[-1]);
+                break;
+            case AST_VALUE:
+                *sp++ = fallbacks_[instruction.arg_]->value();
+                break;
+            case AST_EVALUATE:
+                *sp++ = fallbacks_[instruction.arg_]->evaluate() ? 1 : 0;
+                break;
+            case NOT:
+                sp[-1] = !sp[-1];
+                break;
+            case TO_BOOL:
+                sp[-1] = (sp[-1] != 0) ? 1 : 0;
+                break;
+            case PLUS:
+                --sp;
+                sp[-1] = sp[-1] + sp[0];
+                break;
+            case MINUS:
+                --sp;
+                sp[-1] = sp[-1] - sp[0];
+                break;
+            case MULTIPLY:
+                --sp;
+                sp[-1] = sp[-1] * sp[0];
+                break;
+            case DIVIDE:
+                --sp;
+                if (sp[0] == 0) {
+                    log(Log::ERR, "Divide by zero in trigger/complete expression");
+                    sp[-1] = 0;
+                }
+                else
+                    sp[-1] = sp[-1] / sp[0];
+                break;
+            case MODULO:
+                --sp;
+                if (sp[0] == 0) {
+                    log(Log::ERR, "Modulo by zero in trigger/complete expression");
+                    sp[-1] = 0;
+                }
+                else
+                    sp[-1] = sp[-1] % sp[0];
+                break;
+            case EQUAL:
+                --sp;
+                sp[-1] = sp[-1] == sp[0];
+                break;
+            case NOT_EQUAL:
+                --sp;
+                sp[-1] = sp[-1] != sp[0];
+                break;
+            case LESS_EQUAL:
+                --sp;
+                sp[-1] = sp[-1] <= sp[0];
+                break;
+            case GREATER_EQUAL:
+                --sp;
+                sp[-1] = sp[-1] >= sp[0];
+                break;
+            case GREATER_THAN:
+                --sp;
+                sp[-1] = sp[-1] > sp[0];
+                break;
+            case LESS_THAN:
+                --sp;
+                sp[-1] = sp[-1] < sp[0];
+                break;
+            case AND:
+                if (sp[-1] == 0)
+                    pc = instruction.arg_ - 1; // leave false on the stack
+                else
+                    --sp;
+                break;
+            case OR:
+                if (sp[-1] != 0)
+                    pc = instruction.arg_ - 1; // leave true on the stack
+                else
+                    --sp;
+                break;
+        }
+    }
+    return stack_[0] != 0;
+}
+
+const ExprByteCode::Slot& ExprByteCode::slot(int i) const {
+    Slot& s = slots_[i];
+    if (!valid(s))
+        bind(s);
+    return s;
+}
+
+bool ExprByteCode::valid(const Slot& s) const {
+    switch (s.kind_) {
+        case UNRESOLVED:
+            return false;
+        case NODE_STATE:
+            return !s.ref_.expired();
+        default:
+            break;
+    }
+
+    if (s.parent_variable_) {
+        // The owning node can be moved, or a variable added to a node we have searched
+        size_t size = s.parents_.size();
+        for (size_t i = 0; i < size; i++) {
+            if (s.parents_[i].first->attr_change_no() != s.parents_[i].second)
+                return false;
+            if (i + 1 < size && s.parents_[i].first->parent() != s.parents_[i + 1].first)
+                return false;
+        }
+        return true;
+    }
+    return !s.ref_.expired() && s.node_->attr_change_no() == s.attr_change_no_;
+}
+
+// The maximum change number of the node states and attributes referenced by the bound slots.
+// Returns false, if the result can not be memoized
+bool ExprByteCode::dependencies_change_no(unsigned int& change_no) const {
+    if (!fallbacks_.empty())
+        return false;
+
+    for (const Slot& s : slots_) {
+        if (!valid(s))
+            return false;
+
+        const Node* node = s.node_;
+        unsigned int no  = 0;
+        switch (s.kind_) {
+            case UNRESOLVED:
+                return false;
+            case NODE_STATE:
+                no = std::max(node->st_.first.state_change_no(), node->suspended_change_no_);
+                break;
+            case EVENT:
+                no = node->events()[s.index_].state_change_no();
+                break;
+            case METER:
+                no = node->meters()[s.index_].state_change_no();
+                break;
+            case VARIABLE:
+                no = node->variable_change_no_;
+                break;
+            case REPEAT:
+                no = node->repeat().state_change_no();
+                break;
+            case BY_NAME:
+                // The generated variables of a suite change with the calendar, without a change number
+                if (node->isSuite())
+                    return false;
+                no = node->node_only_max_state_change_no();
+                break;
+        }
+        change_no = std::max(change_no, no);
+    }
+    return true;
+}
+
+void ExprByteCode::bind(Slot& s) const {
+    binds_++;
+    s.kind_ = UNRESOLVED;
+    s.node_ = nullptr;
+    s.ref_.reset();
+    s.parents_.clear();
+
+    if (s.parent_variable_) {
+        // Same search as AstParentVariable::find_node_which_references_variable()
+        Node* parent = static_cast<const AstParentVariable*>(s.leaf_)->parentNode();
+        while (parent) {
+            s.parents_.emplace_back(parent, parent->attr_change_no());
+            if (parent->findExprVariable(s.name_)) {
+                s.node_ = parent;
+                bind_attribute(s);
+                return;
+            }
+            parent = parent->parent();
+        }
+        s.parents_.clear();
+        return;
+    }
+
+    // Use the node referenced by the AST, since it is cached there
+    if (auto node = dynamic_cast<const AstNode*>(s.leaf_)) {
+        s.node_ = node->referencedNode();
+        if (s.node_) {
+            s.ref_ = s.node_->weak_from_this();
+            if (!s.ref_.expired())
+                s.kind_ = NODE_STATE;
+        }
+        return;
+    }
+
+    s.node_ = static_cast<const AstVariable*>(s.leaf_)->referencedNode();
+    if (s.node_) {
+        s.ref_ = s.node_->weak_from_this();
+        if (!s.ref_.expired())
+            bind_attribute(s);
+    }
+}
+
+// Same order as Node::findExprVariableValue()
+void ExprByteCode::bind_attribute(Slot& s) const {
+    const Node* node  = s.node_;
+    s.attr_change_no_ = node->attr_change_no();
+
+    const Event& event = node->findEventByNameOrNumber(s.name_);
+    if (!event.empty()) {
+        s.kind_  = EVENT;
+        s.index_ = &event - node->events().data();
+        return;
+    }
+
+    const Meter& meter = node->findMeter(s.name_);
+    if (!meter.empty()) {
+        s.kind_  = METER;
+        s.index_ = &meter - node->meters().data();
+        return;
+    }
+
+    const Variable& variable = node->findVariable(s.name_);
+    if (!variable.empty()) {
+        s.kind_  = VARIABLE;
+        s.index_ = &variable - node->variables().data();
+        return;
+    }
+
+    if (!node->findRepeat(s.name_).empty()) {
+        s.kind_ = REPEAT;
+        return;
+    }
+
+    // generated variables, limits and queues
+    s.kind_ = BY_NAME;
+}
+
+int ExprByteCode::value(const Slot& s) const {
+    switch (s.kind_) {
+        case UNRESOLVED:
+            return s.leaf_->value();
+        case NODE_STATE:
+            return static_cast<int>(s.node_->dstate());
+        case EVENT:
+            return s.node_->events()[s.index_].value() ? 1 : 0;
+        case METER:
+            return s.node_->meters()[s.index_].value();
+        case VARIABLE:
+            return s.node_->variables()[s.index_].value();
+        case REPEAT:
+            return s.node_->repeat().last_valid_value();
+        case BY_NAME:
+            return s.node_->findExprVariableValue(s.name_);
+    }
+    return 0;
+}
+
+int ExprByteCode::plus(const Slot& s, int val) const {
+    switch (s.kind_) {
+        case UNRESOLVED:
+            return val;
+        case REPEAT:
+            return s.node_->repeat().last_valid_value_plus(val);
+        default:
+            return value(s) + val;
+    }
+}
+
+int ExprByteCode::minus(const Slot& s, int val) const {
+    switch (s.kind_) {
+        case UNRESOLVED:
+            return s.parent_variable_ ? val : -val; // as AstParentVariable::minus() and VariableHelper::minus()
+        case REPEAT:
+            return s.node_->repeat().last_valid_value_minus(val);
+        default:
+            return value(s) - val;
+    }
+}
+
+} // namespace ecf
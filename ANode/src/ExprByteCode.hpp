@@ -0,0 +1,165 @@
+#ifndef EXPR_BYTE_CODE_HPP_
+#define EXPR_BYTE_CODE_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Trigger/complete expression, compiled to byte code for a stack machine
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "NodeFwd.hpp"
+
+class Ast;
+class AstTop;
+
+namespace ecf {
+
+// Evaluating the AST is a walk of virtual calls. Each AstNode locks a weak pointer, and each
+// variable (AstVariable, AstParentVariable) searches the events, meters, user variables, repeat,
+// generated variables, limits and queues of the referenced node by name.
+//
+// The byte code is a flat array of instructions, evaluated with a stack of integers. The leaves
+// are bound to slots, that hold the referenced node and the position of the attribute:
+//    o AstNode           -> node, evaluates to Node::dstate()
+//    o AstVariable       -> node + event/meter/user variable index, or the repeat
+//    o AstParentVariable -> as AstVariable, the node is found by searching up the node tree
+// The remaining attributes (generated variables, limits, queues) are found by name on the bound
+// node. A slot is re-bound when:
+//    o the node tree structure changed (Ecf::modify_change_no)
+//    o the referenced node was deleted
+//    o attributes were added/deleted on the referenced node (or its parents for AstParentVariable)
+// Unresolved references are re-resolved on each evaluation, like the AST.
+//
+// Flags and functions are evaluated via the AST.
+//
+// The result of the last evaluation is memoized, with the maximum change number of the referenced
+// node states and attributes. When none of these changed, the expression is not evaluated again.
+// Expressions with unresolved references, flags, functions, or generated variables of a suite
+// (which change with the calendar) are always evaluated.
+//
+// The change numbers are only updated on the server, hence the byte code is only used there.
+// It must evaluate exactly as the AST.
+class ExprByteCode {
+public:
+    explicit ExprByteCode(const AstTop*);
+    ExprByteCode(const ExprByteCode&)            = delete;
+    ExprByteCode& operator=(const ExprByteCode&) = delete;
+
+    bool evaluate() const;
+
+    /// Force the slots to be bound again, and the expression to be evaluated, on the next evaluation
+    void invalidate() const {
+        bound_    = false;
+        memoized_ = false;
+    }
+
+    /// Used by the server, to compare with the AST walk. Enabled by default
+    static void enable(bool f) { enabled_ = f; }
+    static bool enabled() { return enabled_; }
+
+    /// The number of instructions, and of the leaves evaluated via the AST. Used in test
+    size_t size() const { return code_.size(); }
+    size_t ast_fallbacks() const { return fallbacks_.size(); }
+
+    /// The number of times the slots were bound. Used in test
+    static std::uint64_t binds() { return binds_; }
+
+    /// The number of evaluations, answered by the memoized result, and otherwise. Since server start
+    static std::uint64_t cache_hits() { return cache_hits_; }
+    static std::uint64_t cache_misses() { return cache_misses_; }
+
+private:
+    enum OpCode : std::uint8_t {
+        PUSH,          // constant
+        SLOT,          // value of bound leaf
+        SLOT_PLUS,     // value of bound leaf + pop, allows for date arithmetic on repeat date
+        SLOT_MINUS,    // value of bound leaf - pop
+        AST_VALUE,     // Ast::value() of fallback
+        AST_EVALUATE,  // Ast::evaluate() of fallback
+        NOT,
+        TO_BOOL,
+        PLUS,
+        MINUS,
+        MULTIPLY,
+        DIVIDE,
+        MODULO,
+        EQUAL,
+        NOT_EQUAL,
+        LESS_EQUAL,
+        GREATER_EQUAL,
+        GREATER_THAN,
+        LESS_THAN,
+        AND, // short circuit, if top of stack is false, jump to arg_
+        OR   // short circuit, if top of stack is true,  jump to arg_
+    };
+
+    struct Instruction {
+        OpCode op_;
+        int arg_;
+    };
+
+    enum SlotKind : std::uint8_t { UNRESOLVED, NODE_STATE, EVENT, METER, VARIABLE, REPEAT, BY_NAME };
+
+    struct Slot {
+        const Ast* leaf_{nullptr}; // AstNode, AstVariable, AstParentVariable
+        std::string name_;         // of the attribute
+        Node* node_{nullptr};
+        weak_node_ptr ref_;              // detects deletion of node_, not used for AstParentVariable
+        unsigned int attr_change_no_{0}; // node_->attr_change_no(), when bound
+        std::vector<std::pair<Node*, unsigned int>> parents_; // AstParentVariable, the searched nodes
+        size_t index_{0};
+        SlotKind kind_{UNRESOLVED};
+        bool parent_variable_{false};
+    };
+
+    void compile_bool(const Ast*);
+    void compile_int(const Ast*);
+    void emit(OpCode op, int arg = 0);
+    int add_slot(const Ast* leaf, bool parent_variable);
+    int add_fallback(const Ast*);
+
+    const Slot& slot(int) const;
+    void bind(Slot&) const;
+    void bind_attribute(Slot&) const;
+    bool valid(const Slot&) const;
+    bool dependencies_change_no(unsigned int& change_no) const;
+    bool run() const;
+    int value(const Slot&) const;
+    int plus(const Slot&, int val) const;
+    int minus(const Slot&, int val) const;
+
+private:
+    std::vector<Instruction> code_;
+    mutable std::vector<Slot> slots_;
+    std::vector<const Ast*> fallbacks_;
+    mutable std::vector<int> stack_; // sized to the maximum depth
+    size_t depth_{0};                // depth of stack, whilst compiling
+    mutable unsigned int modify_change_no_{0}; // Ecf::modify_change_no() when slots were bound
+    mutable unsigned int result_change_no_{0}; // dependencies_change_no(), of the memoized result
+    mutable bool result_{false};
+    mutable bool memoized_{false};
+    mutable bool bound_{false};
+
+    static bool enabled_;
+    static std::uint64_t binds_;
+    static std::uint64_t cache_hits_;
+    static std::uint64_t cache_misses_;
+};
+
+} // namespace ecf
+
+#endif
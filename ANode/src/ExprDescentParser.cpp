@@ -0,0 +1,684 @@
+//============================================================================
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+//============================================================================
+
+#include "ExprDescentParser.hpp"
+
+#include <cctype>
+#include <climits>
+#include <cstring>
+
+#include "ExprAst.hpp"
+
+using namespace std;
+
+namespace {
+
+using ast_ptr = std::unique_ptr<Ast>;
+
+// The rules mirror the ExpressionGrammer in ExprParser.cpp. Each rule returns NULL when it does
+// not match, leaving the position unchanged. Whitespace is skipped before each token, except
+// within a node name, as with the spirit space_p skipper.
+class Descent {
+public:
+    explicit Descent(const std::string& expr) : s_(expr.c_str()), size_(expr.size()) {}
+
+    Ast* expression();
+
+private:
+    enum NotKind { NO_NOT, NOT_1, NOT_2, NOT_3 }; // "not ", "~", "!"
+
+    void skip() {
+        while (pos_ < size_ && std::isspace(static_cast<unsigned char>(s_[pos_])))
+            ++pos_;
+    }
+    bool starts_with(const char* token) const {
+        size_t len = std::strlen(token);
+        return size_ - pos_ >= len && std::strncmp(s_ + pos_, token, len) == 0;
+    }
+    bool lit(const char* token);
+    bool raw(const char* token);  // lit() without skipping whitespace
+    bool peek(const char* token); // lit() without consuming
+
+    bool name(std::string& theName);
+    bool nodepath(std::string& path);
+    bool slashes();
+    bool integer(int& value);
+    bool variable_path(std::string& path, std::string& theName);
+    NotKind not_r();
+    bool and_r();
+    bool or_r();
+    AstRoot* equality_comparible();
+    AstRoot* less_than_comparable();
+    AstRoot* arithmetic_operator();
+    bool node_state(DState::State& state);
+    bool event_state(bool& state);
+
+    ast_ptr calc_subexpression();
+    ast_ptr and_expr();
+    ast_ptr calc_grouping();
+    ast_ptr not_compare_expression();
+    ast_ptr compare_expression();
+    ast_ptr calc_expression();
+    ast_ptr calc_factor();
+    ast_ptr flag_path();
+    ast_ptr cal_function();
+
+    static ast_ptr make_root(AstRoot* root, ast_ptr left, ast_ptr right);
+    static ast_ptr make_not(NotKind, ast_ptr child);
+    static bool is_arithmetic(const Ast*);
+
+private:
+    const char* s_;
+    size_t size_;
+    size_t pos_{0};
+    bool abort_{false}; // expression must be parsed by spirit
+};
+
+bool Descent::lit(const char* token) {
+    size_t save = pos_;
+    skip();
+    if (starts_with(token)) {
+        pos_ += std::strlen(token);
+        return true;
+    }
+    pos_ = save;
+    return false;
+}
+
+bool Descent::raw(const char* token) {
+    if (starts_with(token)) {
+        pos_ += std::strlen(token);
+        return true;
+    }
+    return false;
+}
+
+bool Descent::peek(const char* token) {
+    size_t save = pos_;
+    bool found  = lit(token);
+    pos_        = save;
+    return found;
+}
+
+// nodename = lexeme_d[(alnum_p || ch_p('_')) >> *(alnum_p || ch_p('_') || ch_p('.'))]
+bool Descent::name(std::string& theName) {
+    size_t save = pos_;
+    skip();
+    size_t start = pos_;
+    if (pos_ < size_ && (std::isalnum(static_cast<unsigned char>(s_[pos_])) || s_[pos_] == '_')) {
+        ++pos_;
+        while (pos_ < size_ &&
+               (std::isalnum(static_cast<unsigned char>(s_[pos_])) || s_[pos_] == '_' || s_[pos_] == '.'))
+            ++pos_;
+        theName.assign(s_ + start, pos_ - start);
+        return true;
+    }
+    pos_ = save;
+    return false;
+}
+
+// +str_p("/")
+bool Descent::slashes() {
+    if (!raw("/"))
+        return false;
+    while (raw("/")) {
+    }
+    return true;
+}
+
+// absolutepath | dotdotpath | dotpath
+// The path is the matched text. Like spirit, within the path white space is allowed before a
+// node name, but not before "/", ".." or "."
+bool Descent::nodepath(std::string& path) {
+    size_t save = pos_;
+    skip();
+    size_t start = pos_;
+    std::string ignore;
+
+    // absolutepath = !(str_p("/")) >> nodename >> *(+str_p("/") >> nodename)
+    (void)raw("/");
+    if (name(ignore)) {
+        while (true) {
+            size_t mark = pos_;
+            if (slashes() && name(ignore))
+                continue;
+            pos_ = mark;
+            break;
+        }
+        path.assign(s_ + start, pos_ - start);
+        return true;
+    }
+    pos_ = start;
+
+    // dotdotpath = str_p("..") >> *(+str_p("/") >> str_p("..")) >> +(+str_p("/") >> nodename)
+    if (raw("..")) {
+        while (true) {
+            size_t mark = pos_;
+            if (slashes() && raw(".."))
+                continue;
+            pos_ = mark;
+            break;
+        }
+        int names = 0;
+        while (true) {
+            size_t mark = pos_;
+            if (slashes() && name(ignore)) {
+                names++;
+                continue;
+            }
+            pos_ = mark;
+            break;
+        }
+        if (names > 0) {
+            path.assign(s_ + start, pos_ - start);
+            return true;
+        }
+    }
+    pos_ = start;
+
+    // dotpath = str_p(".") >> +(str_p("/") >> nodename)
+    if (raw(".")) {
+        int names = 0;
+        while (true) {
+            size_t mark = pos_;
+            if (raw("/") && name(ignore)) {
+                names++;
+                continue;
+            }
+            pos_ = mark;
+            break;
+        }
+        if (names > 0) {
+            path.assign(s_ + start, pos_ - start);
+            return true;
+        }
+    }
+    pos_ = save;
+    return false;
+}
+
+// uint_p
+bool Descent::integer(int& value) {
+    size_t save = pos_;
+    skip();
+    unsigned long long result = 0;
+    size_t start              = pos_;
+    while (pos_ < size_ && std::isdigit(static_cast<unsigned char>(s_[pos_]))) {
+        result = result * 10 + (s_[pos_] - '0');
+        if (result > UINT_MAX) {
+            // spirit tries the next alternative
+            pos_ = save;
+            return false;
+        }
+        ++pos_;
+    }
+    if (pos_ == start) {
+        pos_ = save;
+        return false;
+    }
+    if (result > INT_MAX) {
+        // spirit matches, but fails to convert to an int
+        abort_ = true;
+        pos_   = save;
+        return false;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+
+// basic_variable_path = nodepath >> ':' >> variable
+bool Descent::variable_path(std::string& path, std::string& theName) {
+    size_t save = pos_;
+    if (nodepath(path) && lit(":") && name(theName))
+        return true;
+    pos_ = save;
+    return false;
+}
+
+// not_r = not1_r | not3_r | not2_r
+Descent::NotKind Descent::not_r() {
+    if (lit("not "))
+        return NOT_1;
+    if (lit("!"))
+        return NOT_3;
+    if (lit("~"))
+        return NOT_2;
+    return NO_NOT;
+}
+
+// and_r = "and" || "&&" || "AND"
+// The sequential-or will also match the consecutive tokens, i.e. "and AND"
+bool Descent::and_r() {
+    if (lit("and")) {
+        if (peek("&&") || peek("AND"))
+            abort_ = true;
+        return !abort_;
+    }
+    if (lit("&&")) {
+        if (peek("AND"))
+            abort_ = true;
+        return !abort_;
+    }
+    return lit("AND");
+}
+
+// or_r = "or" || "||" || "OR"
+bool Descent::or_r() {
+    if (lit("or")) {
+        if (peek("||") || peek("OR"))
+            abort_ = true;
+        return !abort_;
+    }
+    if (lit("||")) {
+        if (peek("OR"))
+            abort_ = true;
+        return !abort_;
+    }
+    return lit("OR");
+}
+
+AstRoot* Descent::equality_comparible() {
+    if (lit("==") || lit("eq"))
+        return new AstEqual();
+    if (lit("ne") || lit("!="))
+        return new AstNotEqual();
+    return nullptr;
+}
+
+AstRoot* Descent::less_than_comparable() {
+    if (lit("ge"))
+        return new AstGreaterEqual();
+    if (lit("le"))
+        return new AstLessEqual();
+    if (lit("gt"))
+        return new AstGreaterThan();
+    if (lit("lt"))
+        return new AstLessThan();
+    if (lit(">="))
+        return new AstGreaterEqual();
+    if (lit("<="))
+        return new AstLessEqual();
+    if (lit("<"))
+        return new AstLessThan();
+    if (lit(">"))
+        return new AstGreaterThan();
+    return nullptr;
+}
+
+AstRoot* Descent::arithmetic_operator() {
+    if (lit("+"))
+        return new AstPlus();
+    if (lit("-"))
+        return new AstMinus();
+    if (lit("/"))
+        return new AstDivide();
+    if (lit("*"))
+        return new AstMultiply();
+    if (lit("%"))
+        return new AstModulo();
+    return nullptr;
+}
+
+bool Descent::node_state(DState::State& state) {
+    if (lit("complete"))
+        state = DState::COMPLETE;
+    else if (lit("aborted"))
+        state = DState::ABORTED;
+    else if (lit("queued"))
+        state = DState::QUEUED;
+    else if (lit("active"))
+        state = DState::ACTIVE;
+    else if (lit("submitted"))
+        state = DState::SUBMITTED;
+    else if (lit("unknown"))
+        state = DState::UNKNOWN;
+    else
+        return false;
+    return true;
+}
+
+// event_state = "set" || "clear"
+bool Descent::event_state(bool& state) {
+    if (lit("set")) {
+        if (peek("clear"))
+            abort_ = true;
+        state = true;
+        return !abort_;
+    }
+    state = false;
+    return lit("clear");
+}
+
+ast_ptr Descent::make_root(AstRoot* root, ast_ptr left, ast_ptr right) {
+    ast_ptr result(root);
+    root->addChild(left.release());
+    root->addChild(right.release());
+    return result;
+}
+
+// i.e. 1 + 2
+bool Descent::is_arithmetic(const Ast* ast) {
+    return dynamic_cast<const AstPlus*>(ast) || dynamic_cast<const AstMinus*>(ast) ||
+           dynamic_cast<const AstMultiply*>(ast) || dynamic_cast<const AstDivide*>(ast) ||
+           dynamic_cast<const AstModulo*>(ast);
+}
+
+ast_ptr Descent::make_not(NotKind kind, ast_ptr child) {
+    if (kind == NO_NOT)
+        return child;
+
+    // Needed so that testing , when recreating expression uses same name for not.
+    auto* astnot = new AstNot();
+    ast_ptr result(astnot);
+    if (kind == NOT_1)
+        astnot->set_root_name("not ");
+    else if (kind == NOT_2)
+        astnot->set_root_name("~ ");
+    else
+        astnot->set_root_name("! ");
+    astnot->addChild(child.release());
+    return result;
+}
+
+// expression = calc_subexpression >> end_p
+Ast* Descent::expression() {
+    ast_ptr ast = calc_subexpression();
+    skip();
+    if (abort_ || !ast || pos_ != size_)
+        return nullptr;
+    return ast.release();
+}
+
+// calc_subexpression = (andExpr | calc_grouping) >> *((and_r | or_r) >> calc_subexpression)
+ast_ptr Descent::calc_subexpression() {
+    ast_ptr left = and_expr();
+    if (!left)
+        left = calc_grouping();
+    if (!left || abort_)
+        return nullptr;
+
+    while (!abort_) {
+        size_t mark = pos_;
+        std::unique_ptr<AstRoot> root;
+        if (and_r())
+            root = std::make_unique<AstAnd>();
+        else if (!abort_ && or_r())
+            root = std::make_unique<AstOr>();
+        if (root) {
+            ast_ptr right = calc_subexpression();
+            if (right) {
+                left = make_root(root.release(), std::move(left), std::move(right));
+                continue;
+            }
+        }
+        pos_ = mark;
+        break;
+    }
+    return left;
+}
+
+// andExpr = !not_r >> compare_expression >> *(and_r >> !not_r >> compare_expression)
+ast_ptr Descent::and_expr() {
+    ast_ptr left = not_compare_expression();
+    if (!left)
+        return nullptr;
+
+    size_t operands     = 1;
+    bool has_arithmetic = is_arithmetic(left.get());
+    bool not_arithmetic = left->is_not() && is_arithmetic(left->left());
+    while (!abort_) {
+        size_t mark = pos_;
+        if (and_r()) {
+            ast_ptr right = not_compare_expression();
+            if (right) {
+                operands++;
+                has_arithmetic |= is_arithmetic(right.get());
+                not_arithmetic |= right->is_not() && is_arithmetic(right->left());
+                left = make_root(new AstAnd(), std::move(left), std::move(right));
+                continue;
+            }
+        }
+        pos_ = mark;
+        break;
+    }
+
+    // spirit drops operands, when three or more are and'ed, and one is arithmetic: "1 == 1 and 1 - 2 and 3 == 3"
+    // or when an and'ed operand is negated arithmetic: "1 == 1 and !1 + 2"
+    if ((operands >= 3 && has_arithmetic) || (operands >= 2 && not_arithmetic))
+        abort_ = true;
+    return left;
+}
+
+ast_ptr Descent::not_compare_expression() {
+    size_t save      = pos_;
+    NotKind not_kind = not_r();
+    ast_ptr compare  = compare_expression();
+    if (!compare) {
+        pos_ = save;
+        return nullptr;
+    }
+    return make_not(not_kind, std::move(compare));
+}
+
+// calc_grouping = !not_r >> '(' >> calc_subexpression >> ')'
+ast_ptr Descent::calc_grouping() {
+    size_t save      = pos_;
+    NotKind not_kind = not_r();
+    if (lit("(")) {
+        ast_ptr sub = calc_subexpression();
+        if (sub && lit(")"))
+            return make_not(not_kind, std::move(sub));
+    }
+    pos_ = save;
+    return nullptr;
+}
+
+// compare_expression = nodepathstate |
+//                      basic_variable_path >> equality_comparible >> event_state |
+//                      calc_expression >> *((equality_comparible | less_than_comparable) >> (!not_r >> calc_expression))
+ast_ptr Descent::compare_expression() {
+    size_t save = pos_;
+    std::string path;
+    {
+        DState::State state;
+        if (nodepath(path)) {
+            std::unique_ptr<AstRoot> root(equality_comparible());
+            if (root && node_state(state)) {
+                return make_root(
+                    root.release(), std::make_unique<AstNode>(path), std::make_unique<AstNodeState>(state));
+            }
+        }
+        pos_ = save;
+    }
+    {
+        std::string theName;
+        bool state = false;
+        if (variable_path(path, theName)) {
+            std::unique_ptr<AstRoot> root(equality_comparible());
+            if (root && event_state(state)) {
+                return make_root(root.release(),
+                                 std::make_unique<AstVariable>(path, theName),
+                                 std::make_unique<AstEventState>(state));
+            }
+        }
+        pos_ = save;
+        if (abort_)
+            return nullptr;
+    }
+
+    ast_ptr left = calc_expression();
+    if (!left)
+        return nullptr;
+
+    size_t comparisons = 0;
+    while (!abort_) {
+        size_t mark = pos_;
+        std::unique_ptr<AstRoot> root(equality_comparible());
+        if (!root)
+            root.reset(less_than_comparable());
+        if (root) {
+            NotKind not_kind = not_r();
+            ast_ptr right    = calc_expression();
+            if (right) {
+                comparisons++;
+                left = make_root(root.release(), std::move(left), make_not(not_kind, std::move(right)));
+                continue;
+            }
+        }
+        pos_ = mark;
+        break;
+    }
+
+    // spirit drops operands of chained comparisons: "a:v le b:v le 1 + 2"
+    if (comparisons >= 2)
+        abort_ = true;
+    return left;
+}
+
+// calc_expression = calc_term >> *(operators >> calc_term)
+// calc_term       = calc_factor >> *(operators >> calc_factor)
+// Since both use the same operators, this is a single left associative chain of factors
+ast_ptr Descent::calc_expression() {
+    ast_ptr left = calc_factor();
+    if (!left)
+        return nullptr;
+    while (!abort_) {
+        size_t mark = pos_;
+        std::unique_ptr<AstRoot> root(arithmetic_operator());
+        if (root) {
+            ast_ptr right = calc_factor();
+            if (right) {
+                left = make_root(root.release(), std::move(left), std::move(right));
+                continue;
+            }
+        }
+        pos_ = mark;
+        break;
+    }
+    return left;
+}
+
+// calc_factor = integer | basic_variable_path | '(' >> calc_expression >> ')' | flag_path |
+//               parent_variable | operators >> calc_factor | cal_date_to_julian | cal_julian_to_date
+ast_ptr Descent::calc_factor() {
+    size_t save = pos_;
+
+    int value = 0;
+    if (integer(value))
+        return std::make_unique<AstInteger>(value);
+    if (abort_)
+        return nullptr;
+
+    std::string path, theName;
+    if (variable_path(path, theName))
+        return std::make_unique<AstVariable>(path, theName);
+
+    if (lit("(")) {
+        ast_ptr calc = calc_expression();
+        if (calc && lit(")"))
+            return calc;
+        pos_ = save;
+        if (abort_)
+            return nullptr;
+    }
+
+    ast_ptr flag = flag_path();
+    if (flag)
+        return flag;
+
+    if (lit(":") && name(theName))
+        return std::make_unique<AstParentVariable>(theName);
+    pos_ = save;
+
+    std::unique_ptr<AstRoot> unary(arithmetic_operator());
+    if (unary) {
+        // spirit creates a root with a single child, which fails AST validation
+        if (calc_factor())
+            abort_ = true;
+        pos_ = save;
+        if (abort_)
+            return nullptr;
+    }
+
+    return cal_function();
+}
+
+// flag_path = (nodepath | root_path) >> "<flag>" >> flag
+ast_ptr Descent::flag_path() {
+    size_t save = pos_;
+    std::string path;
+    if (!nodepath(path)) {
+        if (!lit("/"))
+            return nullptr;
+        path = "/";
+    }
+    if (lit("<flag>")) {
+        if (lit("late"))
+            return std::make_unique<AstFlag>(path, ecf::Flag::LATE);
+        if (lit("zombie"))
+            return std::make_unique<AstFlag>(path, ecf::Flag::ZOMBIE);
+        if (lit("archived"))
+            return std::make_unique<AstFlag>(path, ecf::Flag::ARCHIVED);
+    }
+    pos_ = save;
+    return nullptr;
+}
+
+// cal_date_to_julian = "cal::date_to_julian" >> '(' >> cal_argument >> ')'
+// cal_julian_to_date = "cal::julian_to_date" >> '(' >> cal_argument >> ')'
+// cal_argument       = basic_variable_path | integer
+ast_ptr Descent::cal_function() {
+    size_t save = pos_;
+    AstFunction::FuncType func_type;
+    if (lit("cal::date_to_julian"))
+        func_type = AstFunction::DATE_TO_JULIAN;
+    else if (lit("cal::julian_to_date"))
+        func_type = AstFunction::JULIAN_TO_DATE;
+    else
+        return nullptr;
+
+    if (lit("(")) {
+        ast_ptr arg;
+        std::string path, theName;
+        int value = 0;
+        if (variable_path(path, theName))
+            arg = std::make_unique<AstVariable>(path, theName);
+        else if (integer(value))
+            arg = std::make_unique<AstInteger>(value);
+        if (arg && lit(")"))
+            return std::make_unique<AstFunction>(func_type, arg.release());
+    }
+    pos_ = save;
+    return nullptr;
+}
+
+} // namespace
+
+bool ExprDescentParser::doParse() {
+    Descent descent(expr_);
+    Ast* root = descent.expression();
+    if (!root)
+        return false;
+
+    ast_ = std::make_unique<AstTop>();
+    ast_->addChild(root);
+
+    std::string error_msg;
+    if (!ast_->is_valid_ast(error_msg)) {
+        ast_.reset();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef EXPR_DESCENT_PARSER_HPP_
+#define EXPR_DESCENT_PARSER_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Hand written recursive descent parser, for trigger/complete expressions
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <memory> // for unique_ptr
+#include <string>
+
+class AstTop;
+
+// The spirit classic grammar (see ExprParser.cpp) is a parsing expression grammar, i.e. the
+// alternatives are ordered, and there is no backtracking into an alternative that matched.
+// This parser follows the same rules in the same order, and creates the same AST, but without
+// the intermediate spirit parse tree and without the heap allocation per character.
+//
+// Hence the AST has the quirks of the spirit grammar:
+//    o arithmetic operators have equal precedence, and are left associative: 1 + 2 * 3 -> (1 + 2) * 3
+//    o consecutive 'and' are left associative, unless the first operand is bracketed:
+//        a and b and c   -> (a and b) and c
+//        (a) and b and c -> (a) and (b and c)
+//    o 'or' is right associative
+//    o keywords do not require a word boundary, i.e. "a == completeand b == complete"
+//
+// The expressions, where the spirit grammar produces an unusual AST, are *not* handled:
+//    o unary operators, i.e. -1, (spirit creates an invalid AST)
+//    o consecutive keywords matched by the spirit sequential-or, i.e. "and AND", "set clear"
+//    o integers that do not fit in an int
+// doParse() then returns false, and the expression must be parsed with spirit, which also
+// provides the error message for invalid expressions.
+class ExprDescentParser {
+private:
+    ExprDescentParser(const ExprDescentParser&)                  = delete;
+    const ExprDescentParser& operator=(const ExprDescentParser&) = delete;
+
+public:
+    explicit ExprDescentParser(const std::string& expression) : expr_(expression) {}
+
+    /// Parse the expression, return true if parse OK and the AST is valid, false otherwise
+    bool doParse();
+
+    /// return the Abstract syntax tree, and release memory
+    std::unique_ptr<AstTop> ast() { return std::move(ast_); }
+
+private:
+    const std::string& expr_;
+    std::unique_ptr<AstTop> ast_;
+};
+
+#endif
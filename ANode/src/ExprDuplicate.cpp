@@ -31,6 +31,10 @@ typedef std::unordered_map<std::string, AstTop*> my_map;
 ExprDuplicate::~ExprDuplicate() {
     // cout << "ExprDuplicate::~ExprDuplicate: server(" << Ecf::server() << ") " << duplicate_expr.size() << "
     // *****************************************************************\n";
+    clear();
+}
+
+void ExprDuplicate::clear() {
     for (my_map::value_type i : duplicate_expr) {
         // cout << " deleting: " << i.first << " :" << i.second << "\n";
         delete i.second;
@@ -40,6 +40,9 @@ public:
     // for debug only
     static void dump(const std::string& msg);
 
+    // Remove all the cached ast's. Used in test/timing, to force expressions to be parsed again
+    static void clear();
+
     // Find the expr in the map, if found returns a CLONED ast, else NULL
     static std::unique_ptr<AstTop> find(const std::string& expr);
 
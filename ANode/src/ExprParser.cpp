@@ -45,6 +45,7 @@
 #include <boost/spirit/include/phoenix1_binders.hpp>
 
 #include "ExprAst.hpp"
+#include "ExprDescentParser.hpp"
 #include "ExprDuplicate.hpp"
 #include "Indentor.hpp"
 #include "Log.hpp"
@@ -370,6 +371,8 @@ AstTop* createTopAst(tree_parse_info<> info,
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 
+bool ExprParser::descent_enabled_ = true;
+
 ExprParser::ExprParser(const std::string& expression) : expr_(expression) {
 }
 
@@ -452,6 +455,16 @@ bool ExprParser::doParse(std::string& errorMsg) {
         return true;
     }
 
+    if (descent_enabled_) {
+        ExprDescentParser descentParser(expr_);
+        if (descentParser.doParse()) {
+            ast_ = descentParser.ast();
+            ExprDuplicate::add(expr_, ast_.get());
+            return true;
+        }
+        // Invalid expression, or one the descent parser does not handle. Let spirit report the error
+    }
+
     // SPIRIT CLASSIC parsing: very slooooow....
     ExpressionGrammer grammer;
     BOOST_SPIRIT_DEBUG_NODE(grammer);
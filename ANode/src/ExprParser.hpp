@@ -41,9 +41,16 @@ public:
     /// return the Abstract syntax tree, without release memory
     AstTop* getAst() const { return ast_.get(); }
 
+    /// When enabled, expressions are parsed with ExprDescentParser, and only use spirit when that fails.
+    /// Used to compare the parsers, in test and timing. Enabled by default
+    static void enable_descent(bool f) { descent_enabled_ = f; }
+    static bool descent_enabled() { return descent_enabled_; }
+
 private:
     std::unique_ptr<AstTop> ast_;
     std::string expr_;
+
+    static bool descent_enabled_;
 };
 
 // This class was added to mitigate the slowness of the boost classic spirit parser
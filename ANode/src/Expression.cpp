@@ -258,6 +258,22 @@ void Expression::createAST(Node* node, const std::string& exprType, std::string&
     }
 }
 
+bool Expression::evaluate() const {
+    if (Ecf::server() && ExprByteCode::enabled()) {
+        if (!byte_code_)
+            byte_code_ = std::make_unique<ExprByteCode>(theCombinedAst_.get());
+        return byte_code_->evaluate();
+    }
+    return theCombinedAst_->evaluate();
+}
+
+void Expression::invalidate_trigger_references() const {
+    if (theCombinedAst_)
+        theCombinedAst_->invalidate_trigger_references();
+    if (byte_code_)
+        byte_code_->invalidate();
+}
+
 void Expression::setFree() {
     // Only update for a real change
     if (!free_) {
@@ -19,6 +19,7 @@
 #include <memory> // for unique_ptr
 
 #include "ExprAst.hpp"
+#include "ExprByteCode.hpp"
 class Node;
 namespace cereal {
 class access;
@@ -118,6 +119,10 @@ public:
     void createAST(Node* parent_node, const std::string& exprType, std::string& errorMsg) const;
     AstTop* get_ast() const { return theCombinedAst_.get(); } // can return NULL
 
+    /// Evaluate the AST, *must* have been created. On the server the AST is compiled to byte code
+    bool evaluate() const;
+    void invalidate_trigger_references() const;
+
     /// Placed here rather than the expression tree. Since the expression
     /// tree is created on demand, and is not persisted
     void setFree();   // hence must be used before evaluate
@@ -140,7 +145,8 @@ private:
     // They are created on demand. reasons:
     // 1/ Help with AIX serialisation
     // 2/ Help to reduce network traffic
-    mutable std::unique_ptr<AstTop> theCombinedAst_; // *not* persisted, demand created
+    mutable std::unique_ptr<AstTop> theCombinedAst_;        // *not* persisted, demand created
+    mutable std::unique_ptr<ecf::ExprByteCode> byte_code_; // *not* persisted, demand created, server only
     std::vector<PartExpression> vec_;
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
     bool free_{false};
@@ -137,14 +137,18 @@ std::ostream& operator<<(std::ostream& os, const Family& d) {
 }
 
 void Family::collateChanges(DefsDelta& changes) const {
-    /// All changes to family should be on ONE compound_memento_ptr
-    compound_memento_ptr compound;
-    NodeContainer::incremental_changes(changes, compound);
+    collate_node_changes_only(changes);
 
     // Traversal
     NodeContainer::collateChanges(changes);
 }
 
+void Family::collate_node_changes_only(DefsDelta& changes) const {
+    /// All changes to family should be on ONE compound_memento_ptr
+    compound_memento_ptr compound;
+    NodeContainer::incremental_changes(changes, compound);
+}
+
 // generated variables --------------------------------------------------------------------------
 
 void Family::update_generated_variables() const {
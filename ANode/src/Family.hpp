@@ -57,6 +57,7 @@ public:
     bool operator==(const Family& rhs) const;
 
     void collateChanges(DefsDelta&) const override;
+    void collate_node_changes_only(DefsDelta&) const override;
     void set_memento(const OrderMemento* m, std::vector<ecf::Aspect::Type>& aspects, bool f) {
         NodeContainer::set_memento(m, aspects, f);
     }
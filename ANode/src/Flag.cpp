@@ -17,6 +17,7 @@
 
 #include <stdexcept>
 
+#include "ChangeJournal.hpp"
 #include "Ecf.hpp"
 #include "Serialization.hpp"
 #include "Str.hpp"
@@ -28,6 +29,8 @@ void Flag::set(Flag::Type flag) {
         // minimize changes to state_change_no_
         flag_ |= (1 << flag);
         state_change_no_ = Ecf::incr_state_change_no();
+        if (node_)
+            ChangeJournal::record(node_);
     }
 }
 
@@ -36,12 +39,16 @@ void Flag::clear(Flag::Type flag) {
         // minimize changes to state_change_no_
         flag_ &= ~(1 << flag);
         state_change_no_ = Ecf::incr_state_change_no();
+        if (node_)
+            ChangeJournal::record(node_);
     }
 }
 
 void Flag::reset() {
     flag_            = 0;
     state_change_no_ = Ecf::incr_state_change_no();
+    if (node_)
+        ChangeJournal::record(node_);
 }
 
 std::vector<Flag::Type> Flag::list() {
@@ -19,6 +19,9 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+
+#include "NodeFwd.hpp"
+
 namespace cereal {
 class access;
 }
@@ -26,7 +29,7 @@ class access;
 namespace ecf {
 
 /// Flag are used store what has happened to a node. These are shown as icon in ecFlowview
-/// Uses compiler generated copy constructor, assignment operator and destructor
+/// The copy constructor and assignment operator do *not* copy the owning node
 
 /// During interactive use. A Node can be *forced to complete*, or forced to *run*
 /// Typically the user may want to force a node to complete, if they are trying
@@ -47,6 +50,15 @@ namespace ecf {
 class Flag {
 public:
     Flag() = default;
+    explicit Flag(Node* n) : node_(n) {}
+    Flag(const Flag& rhs) : flag_(rhs.flag_), state_change_no_(rhs.state_change_no_) {}
+    Flag& operator=(const Flag& rhs) {
+        flag_            = rhs.flag_;
+        state_change_no_ = rhs.state_change_no_;
+        return *this;
+    }
+
+    void set_node(Node* n) { node_ = n; }
 
     /// The BYRULE is used to distinguish between tasks that have RUN and completed
     /// and those that have completed by complete expression.
@@ -115,6 +127,7 @@ public:
 private:
     int flag_{0};
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
+    Node* node_{nullptr};             // *not* persisted, the owning node, if any
 
     friend class cereal::access;
     template <class Archive>
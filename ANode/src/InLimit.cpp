@@ -144,11 +144,11 @@ void InLimit::write(std::string& ret) const {
     if (limit_submission_)
         ret += "-s ";
     if (path_.empty())
-        ret += n_;
+        ret += n_.str();
     else {
         ret += path_;
         ret += Str::COLON();
-        ret += n_;
+        ret += n_.str();
     }
     if (tokens_ != 1) {
         ret += " ";
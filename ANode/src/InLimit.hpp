@@ -18,6 +18,7 @@
 #include <string>
 
 #include "LimitFwd.hpp"
+#include "Symbol.hpp"
 
 namespace cereal {
 class access;
@@ -47,9 +48,9 @@ public:
 
     void print(std::string&) const;
     bool operator==(const InLimit& rhs) const;
-    bool operator<(const InLimit& rhs) const { return n_ < rhs.name(); }
+    bool operator<(const InLimit& rhs) const { return n_ < rhs.n_; }
 
-    const std::string& name() const { return n_; } // must be defined
+    const std::string& name() const { return n_.str(); } // must be defined
     const std::string& pathToNode() const {
         return path_;
     } // can be empty,the node referenced by the In-Limit, this should hold the Limit.
@@ -71,7 +72,7 @@ private:
 
 private:
     std::weak_ptr<Limit> limit_; // NOT persisted since computed on the fly
-    std::string n_;
+    ecf::Symbol n_;
     std::string path_;
     int tokens_{1};
     bool limit_this_node_only_{
@@ -116,7 +116,7 @@ bool InLimitMgr::deleteInlimit(const std::string& name) {
 }
 
 Limit* InLimitMgr::findLimitViaInLimit(const InLimit& theInLimit) const {
-    // Use in *test* only
+    // Use in test, and DependencyIndex
     size_t theSize = vec_.size();
     for (size_t i = 0; i < theSize; i++) {
         if (vec_[i].name() == theInLimit.name() && vec_[i].pathToNode() == theInLimit.pathToNode()) {
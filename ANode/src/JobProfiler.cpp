@@ -15,6 +15,14 @@
 
 #include "JobProfiler.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
 #include "JobsParam.hpp"
 #include "Log.hpp"
 #include "Task.hpp"
@@ -28,6 +36,56 @@ using namespace std;
 
 static size_t task_threshold_ = 4000;
 
+// Jobs may be generated in parallel, hence atomic. index 0 line by line, 1 compiled
+static std::atomic<std::uint64_t> variable_substitutions_[2];
+static std::atomic<std::uint64_t> variable_substitution_time_[2];
+
+// index 0 scripts, 1 include files
+static std::atomic<std::uint64_t> file_probes_[2];
+
+namespace {
+
+struct PhaseLatency
+{
+    std::uint64_t count_{0};
+    std::uint64_t total_us_{0};
+    std::uint64_t max_us_{0};
+    std::uint64_t buckets_[JobProfiler::NO_OF_BUCKETS] = {0};
+
+    void add(std::uint64_t us) {
+        count_++;
+        total_us_ += us;
+        max_us_    = std::max(max_us_, us);
+        int bucket = 0;
+        for (std::uint64_t limit = 10; us >= limit && bucket < JobProfiler::NO_OF_BUCKETS - 1; limit *= 10)
+            bucket++;
+        buckets_[bucket]++;
+    }
+
+    void merge(const PhaseLatency& rhs) {
+        count_ += rhs.count_;
+        total_us_ += rhs.total_us_;
+        max_us_ = std::max(max_us_, rhs.max_us_);
+        for (int i = 0; i < JobProfiler::NO_OF_BUCKETS; i++)
+            buckets_[i] += rhs.buckets_[i];
+    }
+};
+using PollLatency = std::array<PhaseLatency, JobProfiler::NO_OF_PHASES>;
+
+// Only the enabled check is made, when profiling is disabled, or outside of job generation
+std::atomic<bool> profiling_(false);
+std::atomic<size_t> profile_polls_(0);
+std::mutex phase_mutex_;
+PollLatency current_poll_;
+std::uint64_t current_job_phases_us_ = 0; // excluded from DEPENDENCIES
+std::chrono::steady_clock::time_point poll_start_;
+std::deque<PollLatency> polls_; // the last profile_polls_
+
+const char* bucket_names_[JobProfiler::NO_OF_BUCKETS] =
+    {"<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", "<10s", ">=10s"};
+
+} // namespace
+
 namespace ecf {
 
 int JobProfiler::task_threshold_default() {
@@ -59,15 +117,19 @@ JobProfiler::~JobProfiler() {
         }
 
         if (time_taken > threshold_) {
-            std::stringstream ss;
-            ss << "Job generation for task " << node_->absNodePath() << " took " << time_taken
-               << "ms, Exceeds ECF_TASK_THRESHOLD(" << threshold_ << "ms)";
-            log(Log::WAR, ss.str());
-            node_->flag().set(ecf::Flag::THRESHOLD);
+            task_threshold_exceeded(node_, time_taken, threshold_);
         }
     }
 }
 
+void JobProfiler::task_threshold_exceeded(Task* task, size_t time_taken, size_t threshold) {
+    std::stringstream ss;
+    ss << "Job generation for task " << task->absNodePath() << " took " << time_taken
+       << "ms, Exceeds ECF_TASK_THRESHOLD(" << threshold << "ms)";
+    log(Log::WAR, ss.str());
+    task->flag().set(ecf::Flag::THRESHOLD);
+}
+
 void JobProfiler::set_task_threshold(size_t threshold) {
     task_threshold_ = threshold;
 }
@@ -75,4 +137,183 @@ size_t JobProfiler::task_threshold() {
     return task_threshold_;
 }
 
+void JobProfiler::add_variable_substitution(bool compiled, std::int64_t micro_seconds) {
+    variable_substitutions_[compiled]++;
+    variable_substitution_time_[compiled] += micro_seconds;
+}
+
+std::uint64_t JobProfiler::variable_substitutions(bool compiled) {
+    return variable_substitutions_[compiled];
+}
+
+std::uint64_t JobProfiler::variable_substitution_time(bool compiled) {
+    return variable_substitution_time_[compiled];
+}
+
+void JobProfiler::reset_variable_substitution() {
+    for (int i = 0; i < 2; i++) {
+        variable_substitutions_[i]     = 0;
+        variable_substitution_time_[i] = 0;
+    }
+}
+
+std::string JobProfiler::variable_substitution_report() {
+    std::stringstream ss;
+    ss << "Variable substitution:";
+    double average[2] = {0, 0};
+    for (int compiled = 1; compiled >= 0; compiled--) {
+        std::uint64_t jobs = variable_substitutions_[compiled];
+        if (jobs != 0)
+            average[compiled] = static_cast<double>(variable_substitution_time_[compiled]) / (1000.0 * jobs);
+        ss << (compiled ? " compiled " : ", line by line ") << jobs << " jobs, average " << std::setprecision(3)
+           << std::fixed << average[compiled] << "ms";
+    }
+    if (average[0] != 0 && average[1] != 0)
+        ss << ", speed up " << std::setprecision(1) << average[0] / average[1] << "x";
+    return ss.str();
+}
+
+void JobProfiler::add_file_probes(bool include, size_t probes) {
+    file_probes_[include] += probes;
+}
+
+std::uint64_t JobProfiler::file_probes(bool include) {
+    return file_probes_[include];
+}
+
+void JobProfiler::reset_file_probes() {
+    file_probes_[0] = 0;
+    file_probes_[1] = 0;
+}
+
+const char* JobProfiler::to_string(Phase phase) {
+    switch (phase) {
+        case DEPENDENCIES:
+            return "dependencies";
+        case LOCATE:
+            return "locate";
+        case PRE_PROCESS:
+            return "pre_process";
+        case SUBSTITUTE:
+            return "substitute";
+        case WRITE:
+            return "write";
+        case SPAWN:
+            return "spawn";
+        case POLL:
+            return "poll";
+    }
+    return "";
+}
+
+void JobProfiler::set_profile_polls(size_t polls) {
+    std::lock_guard<std::mutex> lock(phase_mutex_);
+    profile_polls_ = polls;
+    while (polls_.size() > polls)
+        polls_.pop_front();
+}
+
+size_t JobProfiler::profile_polls() {
+    return profile_polls_;
+}
+
+void JobProfiler::begin_poll() {
+    if (profile_polls_ == 0)
+        return;
+    std::lock_guard<std::mutex> lock(phase_mutex_);
+    current_poll_          = PollLatency();
+    current_job_phases_us_ = 0;
+    poll_start_            = std::chrono::steady_clock::now();
+    profiling_             = true;
+}
+
+void JobProfiler::end_poll() {
+    if (!profiling_)
+        return;
+    profiling_ = false;
+    std::lock_guard<std::mutex> lock(phase_mutex_);
+    current_poll_[POLL].add(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - poll_start_).count());
+    polls_.push_back(current_poll_);
+    while (polls_.size() > profile_polls_)
+        polls_.pop_front();
+}
+
+bool JobProfiler::profiling() {
+    return profiling_;
+}
+
+void JobProfiler::add_phase(Phase phase, std::int64_t micro_seconds) {
+    if (!profiling_)
+        return;
+    std::uint64_t us = std::max<std::int64_t>(micro_seconds, 0);
+    std::lock_guard<std::mutex> lock(phase_mutex_);
+    if (phase == DEPENDENCIES) {
+        // Jobs submitted whilst resolving the dependencies, are recorded in their own phases
+        us = (us > current_job_phases_us_) ? us - current_job_phases_us_ : 0;
+    }
+    else if (phase != POLL) {
+        current_job_phases_us_ += us;
+    }
+    current_poll_[phase].add(us);
+}
+
+std::vector<JobPhaseHistogram> JobProfiler::phase_histograms(size_t& polls) {
+    PollLatency merged;
+    {
+        std::lock_guard<std::mutex> lock(phase_mutex_);
+        polls = polls_.size();
+        for (const PollLatency& poll : polls_) {
+            for (int phase = 0; phase < NO_OF_PHASES; phase++)
+                merged[phase].merge(poll[phase]);
+        }
+    }
+
+    std::vector<JobPhaseHistogram> histograms(NO_OF_PHASES);
+    for (int phase = 0; phase < NO_OF_PHASES; phase++) {
+        JobPhaseHistogram& histogram = histograms[phase];
+        histogram.phase_             = to_string(static_cast<Phase>(phase));
+        histogram.count_             = merged[phase].count_;
+        histogram.total_us_          = merged[phase].total_us_;
+        histogram.max_us_            = merged[phase].max_us_;
+        histogram.buckets_.assign(merged[phase].buckets_, merged[phase].buckets_ + NO_OF_BUCKETS);
+    }
+    return histograms;
+}
+
+std::string JobProfiler::phase_report() {
+    size_t polls                              = 0;
+    std::vector<JobPhaseHistogram> histograms = phase_histograms(polls);
+    return phase_report(polls, histograms);
+}
+
+std::string JobProfiler::phase_report(size_t polls, const std::vector<JobPhaseHistogram>& histograms) {
+    std::stringstream ss;
+    if (polls == 0) {
+        ss << "No job generation profile. Enable with ECF_JOB_PROFILE=<number of polls>\n";
+        return ss.str();
+    }
+    ss << "Job generation profile of the last " << polls << " polls\n";
+    ss << left << setw(14) << "phase" << right << setw(9) << "count" << setw(12) << "total(ms)" << setw(12)
+       << "average(ms)" << setw(10) << "max(ms)";
+    for (const char* bucket : bucket_names_)
+        ss << setw(8) << bucket;
+    ss << "\n";
+    for (const JobPhaseHistogram& histogram : histograms) {
+        double average = histogram.count_ ? static_cast<double>(histogram.total_us_) / histogram.count_ : 0;
+        ss << left << setw(14) << histogram.phase_ << right << setw(9) << histogram.count_ << fixed
+           << setprecision(3) << setw(12) << histogram.total_us_ / 1000.0 << setw(12) << average / 1000.0 << setw(10)
+           << histogram.max_us_ / 1000.0;
+        for (std::uint64_t bucket : histogram.buckets_)
+            ss << setw(8) << bucket;
+        ss << "\n";
+    }
+    return ss.str();
+}
+
+void JobProfiler::reset_phases() {
+    std::lock_guard<std::mutex> lock(phase_mutex_);
+    polls_.clear();
+}
+
 } // namespace ecf
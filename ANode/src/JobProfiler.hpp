@@ -19,7 +19,15 @@
 //  In particular if we have output that is many megabtyes, it can affect
 //  the performance of the server, especially when the server is running
 //  on virtual machines
+//
+//  When enabled (ECF_JOB_PROFILE), the latency of each phase of job generation is also
+//  recorded as a histogram, for the last N polls. See JobProfiler::phase_report()
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 
 class JobsParam;
@@ -27,6 +35,16 @@ class Task;
 
 namespace ecf {
 
+/// The latencies of a phase of job generation, over the profiled polls
+struct JobPhaseHistogram
+{
+    std::string phase_;
+    std::uint64_t count_{0};
+    std::uint64_t total_us_{0};
+    std::uint64_t max_us_{0};
+    std::vector<std::uint64_t> buckets_; // <10us, <100us, <1ms, <10ms, <100ms, <1s, <10s, >=10s
+};
+
 class JobProfiler {
 private:
     JobProfiler(const JobProfiler&)                  = delete;
@@ -42,6 +60,75 @@ public:
 
     static int task_threshold_default();
 
+    /// Log that job generation for the task, exceeded the threshold, and flag the task
+    static void task_threshold_exceeded(Task*, size_t time_taken, size_t threshold);
+
+    /// Record the time taken for the variable substitution of a job. compiled is true when the
+    /// substitution used the compiled plan of a cached script. (See VariableSubstitutionPlan)
+    static void add_variable_substitution(bool compiled, std::int64_t micro_seconds);
+
+    /// The number of jobs, and total time of variable substitution, since start or reset
+    static std::uint64_t variable_substitutions(bool compiled);
+    static std::uint64_t variable_substitution_time(bool compiled); // micro seconds
+    static void reset_variable_substitution();
+
+    /// Compares the average time of variable substitution, with and without compiled plans
+    static std::string variable_substitution_report();
+
+    /// Record the file system probes (stat), made to locate a script (ECF_SCRIPT, ECF_FILES, ECF_HOME),
+    /// or an include file (ECF_INCLUDE). See ScriptPathCache
+    static void add_file_probes(bool include, size_t probes);
+    static std::uint64_t file_probes(bool include);
+    static void reset_file_probes();
+
+    /// The phases of job generation. DEPENDENCIES is recorded once per poll, and excludes the
+    /// time taken by the other phases. POLL is the total time of each poll
+    enum Phase { DEPENDENCIES, LOCATE, PRE_PROCESS, SUBSTITUTE, WRITE, SPAWN, POLL };
+    static constexpr int NO_OF_PHASES  = POLL + 1;
+    static constexpr int NO_OF_BUCKETS = 8;
+    static const char* to_string(Phase);
+
+    /// Keep the phase latencies of the last 'polls' job generations. 0 disables the profiling
+    static void set_profile_polls(size_t polls);
+    static size_t profile_polls();
+
+    /// The phases are only recorded between begin_poll() and end_poll(). See Jobs::generate
+    static void begin_poll();
+    static void end_poll();
+    static bool profiling();
+
+    /// Record the latency of a phase. May be called from the job creation threads
+    static void add_phase(Phase, std::int64_t micro_seconds);
+
+    /// The histograms of each phase, merged over the profiled polls
+    static std::vector<JobPhaseHistogram> phase_histograms(size_t& polls);
+    static std::string phase_report();
+    static std::string phase_report(size_t polls, const std::vector<JobPhaseHistogram>&);
+    static void reset_phases();
+
+    /// Times a phase of job generation, does nothing unless the poll is profiled
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(Phase phase) : phase_(phase), profiling_(JobProfiler::profiling()) {
+            if (profiling_)
+                start_ = std::chrono::steady_clock::now();
+        }
+        ~PhaseTimer() {
+            if (profiling_)
+                JobProfiler::add_phase(
+                    phase_,
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_)
+                        .count());
+        }
+        PhaseTimer(const PhaseTimer&)            = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        Phase phase_;
+        bool profiling_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
 private:
     Task* node_;
     JobsParam& jobsParam_;
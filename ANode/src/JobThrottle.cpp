@@ -0,0 +1,84 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "JobThrottle.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "Str.hpp"
+#include "Submittable.hpp"
+#include "System.hpp"
+
+JobThrottle& JobThrottle::instance() {
+    static JobThrottle the_throttle;
+    return the_throttle;
+}
+
+void JobThrottle::begin() {
+    std::vector<std::string> running;
+    ecf::System::instance()->running_jobs(running);
+    backlog_ = running.size();
+
+    // The running commands count against the limits. Forget the tasks, whose command has terminated
+    allowed_ = rate_ - static_cast<int>(backlog_);
+    host_allowed_.clear();
+    std::unordered_map<std::string, std::string> still_running;
+    for (const auto& path : running) {
+        auto it = submitted_hosts_.find(path);
+        if (it != submitted_hosts_.end()) {
+            host_allowed_.emplace(it->second, host_rate_).first->second--;
+            still_running.insert(*it);
+        }
+    }
+    submitted_hosts_.swap(still_running);
+    queue_depth_ = 0;
+}
+
+bool JobThrottle::submit(const Submittable* t) {
+    std::string host;
+    if (host_rate_ > 0)
+        t->findParentUserVariableValue(ecf::Str::ECF_JOB_HOST(), host);
+
+    int* host_allowed = nullptr;
+    if (!host.empty())
+        host_allowed = &host_allowed_.emplace(host, host_rate_).first->second;
+
+    if ((rate_ > 0 && allowed_ <= 0) || (host_allowed && *host_allowed <= 0)) {
+        queue_depth_++;
+        deferrals_++;
+        return false;
+    }
+
+    allowed_--;
+    if (host_allowed) {
+        (*host_allowed)--;
+        submitted_hosts_[t->absNodePath()] = host;
+    }
+    return true;
+}
+
+void JobThrottle::end() {
+    max_queue_depth_ = std::max(max_queue_depth_, queue_depth_);
+}
+
+void JobThrottle::clear() {
+    host_allowed_.clear();
+    submitted_hosts_.clear();
+    queue_depth_     = 0;
+    max_queue_depth_ = 0;
+    backlog_         = 0;
+    deferrals_       = 0;
+}
@@ -0,0 +1,97 @@
+#ifndef JOB_THROTTLE_HPP_
+#define JOB_THROTTLE_HPP_
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Limits the number of jobs submitted by each job generation
+//
+// Without a limit, every task that becomes free is submitted by the same job generation.
+// A burst of free tasks, with ECF_JOB_CMD going to a busy batch system, then overloads
+// the submit host.
+//
+// The limit applies to the server (ECF_JOB_RATE), and to the tasks sharing the same
+// ECF_JOB_HOST variable (ECF_JOB_HOST_RATE). ECF_JOB_HOST is typically referenced in
+// ECF_JOB_CMD, i.e. ECF_JOB_CMD = ssh %ECF_JOB_HOST% qsub %ECF_JOB%
+//
+// The limits adapt to the spawn backlog: the ECF_JOB_CMD commands still running, from
+// earlier job generations, are deducted. Hence a slow submit host is given fewer jobs.
+//
+// The tasks over the limit are deferred: they stay queued, and are submitted by a later
+// job generation, in the order of the node tree. They are not aborted.
+//
+// Disabled by default. Only used on the main thread, during job generation.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+class Submittable;
+
+class JobThrottle {
+private:
+    JobThrottle(const JobThrottle&)                  = delete;
+    const JobThrottle& operator=(const JobThrottle&) = delete;
+
+public:
+    static JobThrottle& instance();
+
+    /// The maximum number of jobs submitted by a job generation. 0 means no limit
+    void set_rate(int jobs) { rate_ = jobs; }
+    void set_host_rate(int jobs) { host_rate_ = jobs; }
+    int rate() const { return rate_; }
+    int host_rate() const { return host_rate_; }
+    bool enabled() const { return rate_ > 0 || host_rate_ > 0; }
+
+    /// Start of a job generation, determines the spawn backlog
+    void begin();
+
+    /// Return true if the job of the task can be submitted, otherwise the task is deferred
+    bool submit(const Submittable*);
+
+    /// End of a job generation
+    void end();
+
+    /// The tasks deferred by the last job generation, i.e. waiting to be submitted
+    size_t queue_depth() const { return queue_depth_; }
+    size_t max_queue_depth() const { return max_queue_depth_; }
+
+    /// The ECF_JOB_CMD commands still running, at the start of the last job generation
+    size_t backlog() const { return backlog_; }
+
+    /// The number of times a task was deferred
+    std::uint64_t deferrals() const { return deferrals_; }
+
+    void clear();
+
+private:
+    JobThrottle() = default;
+
+    int rate_{0};
+    int host_rate_{0};
+
+    // The jobs that can still be submitted, by this job generation
+    int allowed_{0};
+    std::map<std::string, int> host_allowed_;
+
+    // The ECF_JOB_HOST of the submitted tasks, whose ECF_JOB_CMD may still be running
+    std::unordered_map<std::string, std::string> submitted_hosts_;
+
+    size_t queue_depth_{0};
+    size_t max_queue_depth_{0};
+    size_t backlog_{0};
+    std::uint64_t deferrals_{0};
+};
+
+#endif
@@ -14,12 +14,21 @@
 //============================================================================
 #include "Jobs.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "Defs.hpp"
 #include "DurationTimer.hpp"
+#include "Ecf.hpp"
+#include "JobProfiler.hpp"
+#include "JobThrottle.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
+#include "ScriptFetcher.hpp"
 #include "Signal.hpp"
 #include "Suite.hpp"
+#include "Submittable.hpp"
 #include "SuiteChanged.hpp"
 #include "System.hpp"
 
@@ -28,6 +37,72 @@ using namespace std;
 
 // #define DEBUG_JOB_SUBMISSION 1
 
+namespace {
+
+/// Create the job files of the deferred tasks in parallel, then submit them in order. The job
+/// creation (locating the script, pre-processing, variable substitution and writing the job file)
+/// only reads the node tree. The state changes and spawning of the jobs, are done on this thread.
+void submit_deferred_jobs(JobsParam& jobsParam) {
+    std::vector<Submittable::DeferredJob>& deferred = jobsParam.deferred();
+
+    std::atomic<size_t> next(0);
+    auto create_jobs = [&]() {
+        for (size_t i = next++; i < deferred.size(); i = next++)
+            deferred[i].submittable_->create_deferred_job(deferred[i], jobsParam);
+    };
+
+    size_t no_of_threads = std::min(jobsParam.job_threads(), deferred.size());
+    std::vector<std::thread> threads;
+    threads.reserve(no_of_threads - 1);
+    for (size_t t = 1; t < no_of_threads; t++)
+        threads.emplace_back(create_jobs);
+    create_jobs();
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& job : deferred) {
+        SuiteChanged1 changed(job.submittable_->suite());
+        job.submittable_->submit_deferred_job(jobsParam, job);
+    }
+    deferred.clear();
+}
+
+/// Spawn one ECF_JOB_BATCH_CMD, for each batch of tasks. The tasks are already submitted. If the
+/// command can not be spawned, they are aborted, as when ECF_JOB_CMD can not be spawned.
+void spawn_job_batches(JobsParam& jobsParam) {
+    for (JobsParam::JobBatch& batch : jobsParam.job_batches()) {
+        std::vector<std::string> paths;
+        paths.reserve(batch.submittables_.size());
+        for (Submittable* t : batch.submittables_)
+            paths.push_back(t->absNodePath());
+
+        std::string errorMsg;
+        bool spawned = false;
+        {
+            JobProfiler::PhaseTimer spawn(JobProfiler::SPAWN);
+            spawned = System::instance()->spawn_batch(batch.cmd_, paths, batch.job_files_, errorMsg);
+        }
+        if (!spawned) {
+            jobsParam.errorMsg() += errorMsg;
+            for (Submittable* t : batch.submittables_) {
+                SuiteChanged1 changed(t->suite());
+                t->flag().set(ecf::Flag::JOBCMD_FAILED);
+                t->aborted(errorMsg);
+            }
+        }
+    }
+    jobsParam.job_batches().clear();
+}
+
+/// Profiles the phases of a job generation, when enabled. See JobProfiler::phase_report()
+struct ProfilePoll
+{
+    ProfilePoll() { JobProfiler::begin_poll(); }
+    ~ProfilePoll() { JobProfiler::end_poll(); }
+};
+
+} // namespace
+
 bool Jobs::generate(JobsParam& jobsParam) const {
 #ifdef DEBUG_JOB_SUBMISSION
     cout << "\n"
@@ -39,6 +114,7 @@ bool Jobs::generate(JobsParam& jobsParam) const {
     // dependency resolving and job submission must be less than submitJobsInterval seconds
     // Note: Duration timer makes a system call
     DurationTimer durationTimer;
+    ProfilePoll profile_poll;
 
 #ifdef DEBUG_JOB_SUBMISSION
     LogToCout toCoutAsWell;
@@ -50,6 +126,13 @@ bool Jobs::generate(JobsParam& jobsParam) const {
         // The desctructor will then re-block SIGCHLD
         Signal unblock_on_desctruction_then_reblock;
 
+        // Kill the background fetch commands that have timed out
+        if (jobsParam.async_fetch())
+            ScriptFetcher::instance().check();
+
+        if (jobsParam.throttle_jobs())
+            JobThrottle::instance().begin();
+
         // *******************************************************************
         // **** JOB submission *MUST* be done sequentially, as each task could
         // **** be affected by a resource/limit, and hence affect subsequent
@@ -57,24 +140,51 @@ bool Jobs::generate(JobsParam& jobsParam) const {
         // *******************************************************************
 
         if (defs_) {
+            JobProfiler::PhaseTimer resolve(JobProfiler::DEPENDENCIES);
             if (defs_->server().get_state() == SState::RUNNING) {
                 const std::vector<suite_ptr>& suiteVec = defs_->suiteVec();
                 size_t theSize                         = suiteVec.size();
-                for (size_t i = 0; i < theSize; i++) {
-                    // SuiteChanged moved internal to Suite::resolveDependencies. i.e on fast path
-                    // and when suites not begun we save a constructor/destructor calls
-                    (void)suiteVec[i]->resolveDependencies(jobsParam);
+                if (jobsParam.use_dependency_index()) {
+                    // Only resolve suites that changed, or that depend on suites that changed
+                    DependencyIndex& index = defs_->dependency_index();
+                    index.begin(*defs_);
+                    for (size_t i = 0; i < theSize; i++) {
+                        if (index.needs_resolve(i)) {
+                            unsigned int state_change_no = Ecf::state_change_no();
+                            size_t pending               = jobsParam.pending_submissions();
+                            (void)suiteVec[i]->resolveDependencies(jobsParam);
+                            index.resolved(i, state_change_no, jobsParam.pending_submissions() != pending);
+                        }
+                    }
+                    index.end(jobsParam.timed_out_of_job_generation());
+                }
+                else {
+                    for (size_t i = 0; i < theSize; i++) {
+                        // SuiteChanged moved internal to Suite::resolveDependencies. i.e on fast path
+                        // and when suites not begun we save a constructor/destructor calls
+                        (void)suiteVec[i]->resolveDependencies(jobsParam);
+                    }
                 }
             }
         }
         else {
             if (!node_->isParentSuspended()) {
                 // suite, family, task
+                JobProfiler::PhaseTimer resolve(JobProfiler::DEPENDENCIES);
                 SuiteChanged1 changed(node_->suite());
                 (void)node_->resolveDependencies(jobsParam);
             }
         }
 
+        if (!jobsParam.deferred().empty())
+            submit_deferred_jobs(jobsParam);
+
+        if (jobsParam.spawnJobs() && !jobsParam.job_batches().empty())
+            spawn_job_batches(jobsParam);
+
+        if (jobsParam.throttle_jobs())
+            JobThrottle::instance().end();
+
         // *****************************************************************
         // Should end up calling signal handler here for any pending SIGCHLD
         // *****************************************************************
@@ -33,6 +33,13 @@
 ///
 ///  Job submission *MUST* be done sequentially,as each job submission could
 ///  consume a resource(i.e like a limit), which can affect subsequent jobs.
+///  However the job files can be created in parallel (see JobsParam::job_threads).
+///  The free tasks then consume their limits during the traversal, and the jobs
+///  are created on a pool of threads, and then submitted in traversal order.
+///  Note: A task that is triggered by the submission of another task, is then
+///  only submitted in the next traversal.
+///  Tasks with ECF_JOB_BATCH_CMD are spawned last, one invocation per batch
+///  command, see JobsParam::job_batches.
 ///
 /// The process of resolving dependencies and submitting all the tasks, must take
 /// less than 60 seconds. As this is resolution of the clock.
@@ -15,6 +15,8 @@
 
 #include "JobsParam.hpp"
 
+#include <algorithm>
+
 bool JobsParam::check_for_job_generation_timeout() {
     if (timed_out_of_job_generation_)
         return true;
@@ -32,10 +34,26 @@ bool JobsParam::check_for_job_generation_timeout(const boost::posix_time::ptime&
     return false;
 }
 
+void JobsParam::add_to_job_batch(const std::string& batch_cmd, Submittable* t, const std::string& job_file) {
+    // Expect few distinct batch commands
+    auto it = std::find_if(
+        job_batches_.begin(), job_batches_.end(), [&batch_cmd](const JobBatch& b) { return b.cmd_ == batch_cmd; });
+    if (it == job_batches_.end()) {
+        job_batches_.emplace_back();
+        it       = job_batches_.end() - 1;
+        it->cmd_ = batch_cmd;
+    }
+    it->submittables_.push_back(t);
+    it->job_files_.push_back(job_file);
+}
+
 void JobsParam::clear() {
     errorMsg_.clear();
     debugMsg_.clear();
     submitted_.clear();
+    deferred_.clear();
+    job_batches_.clear();
     user_edit_file_.clear();
     user_edit_variables_.clear();
+    pending_submissions_ = 0;
 }
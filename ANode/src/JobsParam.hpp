@@ -19,6 +19,7 @@
 
 #include "EcfFile.hpp"
 #include "NodeFwd.hpp"
+#include "Submittable.hpp"
 
 // Used as a utility class for controlling job creation.
 // Collates data during the node tree traversal
@@ -85,17 +86,83 @@ public:
     bool check_for_job_generation_timeout();
     bool check_for_job_generation_timeout(const boost::posix_time::ptime& time_now);
 
+    // When enabled only suites that have changed, or depend on suites that have changed, are resolved.
+    // See DependencyIndex. Enabled by the server, tests that change the node tree directly resolve all suites.
+    void set_use_dependency_index(bool f) { use_dependency_index_ = f; }
+    bool use_dependency_index() const { return use_dependency_index_; }
+
+    // When enabled, the pre-processed scripts (%includes expanded) are shared between tasks, with the same script.
+    // See PreProcessedScriptCache. Enabled by the server with ECF_SCRIPT_CACHE.
+    void set_use_script_cache(bool f) { use_script_cache_ = f; }
+    bool use_script_cache() const { return use_script_cache_; }
+
+    // When true, ECF_FETCH and ECF_SCRIPT_CMD are run in the background, see ScriptFetcher. The task stays
+    // queued until the output is available.
+    void set_async_fetch(bool f) { async_fetch_ = f; }
+    bool async_fetch() const { return async_fetch_; }
+
+    // True when creating a deferred job, on a job creation thread. The fetch commands are then only
+    // started later, on the main thread. See Submittable::create_deferred_job()
+    void set_job_creation_thread(bool f) { job_creation_thread_ = f; }
+    bool job_creation_thread() const { return job_creation_thread_; }
+
+    // When > 1, the job files are created in parallel, on this number of threads. The tasks that are free
+    // are collected during the node tree traversal, and submitted afterwards, in the same order.
+    // See Jobs::generate. Enabled by the server with ECF_JOB_THREADS.
+    void set_job_threads(size_t n) { job_threads_ = n; }
+    size_t job_threads() const { return job_threads_; }
+    bool defer_job_creation() const {
+        return job_threads_ > 1 && createJobs_ && user_edit_variables_.empty() && user_edit_file_.empty();
+    }
+    void push_back_deferred(Submittable* t) {
+        deferred_.emplace_back();
+        deferred_.back().submittable_ = t;
+    }
+    std::vector<Submittable::DeferredJob>& deferred() { return deferred_; }
+
+    // Tasks with a ECF_JOB_BATCH_CMD variable, are not spawned individually. Instead the tasks, with the same
+    // (substituted) batch command, are collected during job generation, and handed to a single invocation of
+    // that command, at the end of Jobs::generate. See System::spawn_batch
+    struct JobBatch
+    {
+        std::string cmd_;
+        std::vector<Submittable*> submittables_;
+        std::vector<std::string> job_files_;
+    };
+    void add_to_job_batch(const std::string& batch_cmd, Submittable* t, const std::string& job_file);
+    std::vector<JobBatch>& job_batches() { return job_batches_; }
+
+    // When true, the number of jobs submitted is limited, the tasks over the limit stay queued.
+    // See JobThrottle. Enabled by the server with ECF_JOB_RATE or ECF_JOB_HOST_RATE.
+    void set_throttle_jobs(bool f) { throttle_jobs_ = f; }
+    bool throttle_jobs() const { return throttle_jobs_ && createJobs_; }
+
+    // The free tasks that stayed queued, i.e. deferred by the JobThrottle, or waiting for their script to be
+    // fetched, see ScriptFetcher. Their state is unchanged, hence this is used by the DependencyIndex, to
+    // resolve their suite again on the next job generation.
+    void add_pending_submission() { pending_submissions_++; }
+    size_t pending_submissions() const { return pending_submissions_; }
+
     void set_ecf_file(const EcfFile& ecf_file) { ecf_file_ = ecf_file; }
     EcfFile& ecf_file() { return ecf_file_; }
 
 private:
     bool timed_out_of_job_generation_{false};
+    bool use_dependency_index_{false};
+    bool use_script_cache_{false};
+    bool async_fetch_{false};
+    bool job_creation_thread_{false};
+    bool throttle_jobs_{false};
     bool createJobs_;
     bool spawnJobs_{false};
     int submitJobsInterval_{60};
+    size_t job_threads_{0};
+    size_t pending_submissions_{0};
     std::string errorMsg_;
     std::string debugMsg_;
     std::vector<Submittable*> submitted_;
+    std::vector<Submittable::DeferredJob> deferred_; // job creation deferred, to create the job files in parallel
+    std::vector<JobBatch> job_batches_;
     std::vector<std::string> user_edit_file_;
     NameValueMap user_edit_variables_;        // Used for User edit
     boost::posix_time::ptime next_poll_time_; // Aid early exit from job generation, if it takes to long
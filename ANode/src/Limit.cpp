@@ -17,6 +17,7 @@
 
 #include <stdexcept>
 
+#include "ChangeJournal.hpp"
 #include "Ecf.hpp"
 #include "Indentor.hpp"
 #include "PrintStyle.hpp"
@@ -111,7 +112,7 @@ std::string Limit::toString() const {
 
 void Limit::write(std::string& ret) const {
     ret += "limit ";
-    ret += n_;
+    ret += n_.str();
     ret += " ";
     ret += boost::lexical_cast<std::string>(lim_);
 }
@@ -213,6 +214,7 @@ void Limit::update_change_no() {
         Suite* suite = node_->suite();
         if (suite)
             suite->set_state_change_no(state_change_no_);
+        ChangeJournal::record(node_);
     }
 }
 
@@ -23,6 +23,9 @@
 
 #include <set>
 #include <string>
+
+#include "Symbol.hpp"
+
 namespace cereal {
 class access;
 }
@@ -38,8 +41,8 @@ public:
 
     void print(std::string&) const;
     bool operator==(const Limit& rhs) const;
-    bool operator<(const Limit& rhs) const { return n_ < rhs.name(); }
-    const std::string& name() const { return n_; }
+    bool operator<(const Limit& rhs) const { return n_ < rhs.n_; }
+    const std::string& name() const { return n_.str(); }
 
     Node* node() const { return node_; }
     void set_node(Node* n) { node_ = n; }
@@ -76,7 +79,7 @@ private:
     void write(std::string&) const;
 
 private:
-    std::string n_;
+    ecf::Symbol n_;
     Node* node_{nullptr};             // The parent NOT persisted
     unsigned int state_change_no_{0}; // *not* persisted, only used on server side
     int lim_{0};
@@ -191,7 +191,7 @@ void MiscAttrs::addZombie(const ZombieAttr& z) {
         throw std::runtime_error(ss.str());
     }
     zombies_.push_back(z);
-    node_->state_change_no_ = Ecf::incr_state_change_no(); // Only add where used in AlterCmd
+    node_->state_change_no_ = node_->incr_state_change_no(); // Only add where used in AlterCmd
 
 #ifdef DEBUG_STATE_CHANGE_NO
     std::cout << "MiscAttrs::addZombie()\n";
@@ -201,7 +201,7 @@ void MiscAttrs::addZombie(const ZombieAttr& z) {
 void MiscAttrs::deleteZombie(const std::string& zombie_type) {
     if (zombie_type.empty()) {
         zombies_.clear();
-        node_->state_change_no_ = Ecf::incr_state_change_no();
+        node_->state_change_no_ = node_->incr_state_change_no();
         return;
     }
 
@@ -217,7 +217,7 @@ void MiscAttrs::delete_zombie(Child::ZombieType zt) {
     for (size_t i = 0; i < zombies_.size(); ++i) {
         if (zombies_[i].zombie_type() == zt) {
             zombies_.erase(zombies_.begin() + i);
-            node_->state_change_no_ = Ecf::incr_state_change_no();
+            node_->state_change_no_ = node_->incr_state_change_no();
             return;
         }
     }
@@ -242,7 +242,7 @@ void MiscAttrs::add_generic(const GenericAttr& z) {
         throw std::runtime_error(ss.str());
     }
     generics_.push_back(z);
-    node_->state_change_no_ = Ecf::incr_state_change_no(); // Only add where used in AlterCmd
+    node_->state_change_no_ = node_->incr_state_change_no(); // Only add where used in AlterCmd
 }
 
 void MiscAttrs::addVerify(const VerifyAttr& v) {
@@ -252,7 +252,7 @@ void MiscAttrs::addVerify(const VerifyAttr& v) {
         throw std::runtime_error(ss.str());
     }
     verifys_.push_back(v);
-    node_->state_change_no_ = Ecf::incr_state_change_no();
+    node_->state_change_no_ = node_->incr_state_change_no();
 }
 
 bool MiscAttrs::findVerify(const VerifyAttr& v) const {
@@ -274,19 +274,19 @@ void MiscAttrs::add_queue(const QueueAttr& q) {
         throw std::runtime_error(ss.str());
     }
     queues_.push_back(q);
-    node_->state_change_no_ = Ecf::incr_state_change_no(); // Only add where used in AlterCmd
+    node_->state_change_no_ = node_->incr_state_change_no(); // Only add where used in AlterCmd
 }
 
 void MiscAttrs::delete_queue(const std::string& name) {
     if (name.empty()) {
         queues_.clear();
-        node_->state_change_no_ = Ecf::incr_state_change_no();
+        node_->state_change_no_ = node_->incr_state_change_no();
         return;
     }
     for (size_t i = 0; i < queues_.size(); ++i) {
         if (queues_[i].name() == name) {
             queues_.erase(queues_.begin() + i);
-            node_->state_change_no_ = Ecf::incr_state_change_no();
+            node_->state_change_no_ = node_->incr_state_change_no();
             return;
         }
     }
@@ -313,13 +313,13 @@ QueueAttr& MiscAttrs::findQueue(const std::string& name) {
 void MiscAttrs::delete_generic(const std::string& name) {
     if (name.empty()) {
         generics_.clear();
-        node_->state_change_no_ = Ecf::incr_state_change_no();
+        node_->state_change_no_ = node_->incr_state_change_no();
         return;
     }
     for (size_t i = 0; i < generics_.size(); ++i) {
         if (generics_[i].name() == name) {
             generics_.erase(generics_.begin() + i);
-            node_->state_change_no_ = Ecf::incr_state_change_no();
+            node_->state_change_no_ = node_->incr_state_change_no();
             return;
         }
     }
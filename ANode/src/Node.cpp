@@ -19,6 +19,7 @@
 #include "AutoArchiveAttr.hpp"
 #include "AutoCancelAttr.hpp"
 #include "AutoRestoreAttr.hpp"
+#include "ChangeJournal.hpp"
 #include "CmdContext.hpp"
 #include "Defs.hpp"
 #include "DefsStructureParser.hpp"
@@ -89,6 +90,7 @@ Node::Node(const Node& rhs)
       auto_restore_((rhs.auto_restore_) ? new AutoRestoreAttr(*rhs.auto_restore_) : nullptr),
       suspended_(rhs.suspended_) {
     inLimitMgr_.set_node(this);
+    flag_.set_node(this);
     if (misc_attrs_)
         misc_attrs_->set_node(this);
 
@@ -223,17 +225,24 @@ void Node::resume() {
     /// Guard against unnecessary creation of memento's
     if (suspended_) {
         suspended_           = false;
-        suspended_change_no_ = Ecf::incr_state_change_no();
+        suspended_change_no_ = incr_state_change_no();
     }
 }
 
 void Node::suspend() {
     // Typically called via user action or via defstatus
     suspended_           = true;
-    suspended_change_no_ = Ecf::incr_state_change_no();
+    suspended_change_no_ = incr_state_change_no();
+}
+
+unsigned int Node::incr_state_change_no() {
+    unsigned int state_change_no = Ecf::incr_state_change_no();
+    ChangeJournal::record(this);
+    return state_change_no;
 }
 
 void Node::begin() {
+    NodeChanged changed(this);
     // record effect of defstatus for node changes, for verify attributes
     if (misc_attrs_)
         misc_attrs_->begin();
@@ -295,6 +304,7 @@ void Node::begin() {
 }
 
 void Node::requeue(Requeue_args& args) {
+    NodeChanged changed(this);
 #ifdef DEBUG_REQUEUE
     LOG(Log::DBG, "      Node::requeue() " << absNodePath() << " resetRepeats = " << args.resetRepeats_);
 #endif
@@ -380,6 +390,7 @@ void Node::requeue(Requeue_args& args) {
 }
 
 void Node::reset_late_event_meters() {
+    NodeChanged changed(this);
     if (late_)
         late_->reset();
     for (auto& meter : meters_) {
@@ -391,6 +402,7 @@ void Node::reset_late_event_meters() {
 }
 
 void Node::reset() {
+    NodeChanged changed(this);
     // Set the state without causing any side effects
     initState(1);
 
@@ -456,6 +468,7 @@ void Node::requeue_time_attrs() {
 }
 
 void Node::requeue_labels() {
+    NodeChanged changed(this);
     // ECFLOW-195, clear labels before a task is run.
     for (auto& label : labels_) {
         label.reset();
@@ -499,6 +512,7 @@ bool Node::calendarChanged(const ecf::Calendar& c,
 }
 
 void Node::check_for_lateness(const ecf::Calendar& c, const ecf::LateAttr* inherited_late) {
+    NodeChanged changed(this);
     // Late flag should ONLY be set on Submittable
     if (late_) {
         // Only check for lateness if we are not late.
@@ -524,6 +538,7 @@ void Node::check_for_lateness(const ecf::Calendar& c, const ecf::LateAttr* inher
 }
 
 void Node::checkForLateness(const ecf::Calendar& c) {
+    NodeChanged changed(this);
     if (late_ && late_->check_for_lateness(st_, c)) {
         late_->setLate(true);
         flag().set(ecf::Flag::LATE);
@@ -563,6 +578,7 @@ void Node::initState(int clear_suspended_in_child_nodes, bool log_state_changes)
 }
 
 void Node::requeueOrSetMostSignificantStateUpNodeTree() {
+    NodeChanged changed(this);
     // Get the computed state of my immediate children
     // *** A family can be marked as complete, via complete trigger when not all its children
     // *** are complete, hence computedState() *MUST* first check the immediate state  ,
@@ -791,21 +807,25 @@ bool Node::has_time_based_attributes() const {
 }
 
 void Node::freeTrigger() const {
+    NodeChanged changed(this);
     if (t_expr_)
         t_expr_->setFree();
 }
 
 void Node::clearTrigger() const {
+    NodeChanged changed(this);
     if (t_expr_)
         t_expr_->clearFree();
 }
 
 void Node::freeComplete() const {
+    NodeChanged changed(this);
     if (c_expr_)
         c_expr_->setFree();
 }
 
 void Node::clearComplete() const {
+    NodeChanged changed(this);
     if (c_expr_)
         c_expr_->clearFree();
 }
@@ -817,7 +837,7 @@ bool Node::evaluateComplete() const {
         // *NOTE* if we have a non NULL complete ast, we must have complete expression
         // The freed state is stored on the expression ( i.e not on the ast)
         // ISSUE: Complete expression cannot be by-passed in the GUI
-        if (c_expr_->isFree() || theCompeteAst->evaluate()) {
+        if (c_expr_->isFree() || c_expr_->evaluate()) {
 
             // Note: if a task has been set complete, the use may decide to place into queued state( via GUI)
             //       In which case, we *want* this complete expression to be re-evaluated.
@@ -872,7 +892,7 @@ bool Node::evaluateTrigger() const {
         // Note 1: A trigger can be freed by the ForceCmd
         // Note 2: if we have a non NULL trigger ast, we must have trigger expression
         // Note 3: The freed state is stored on the expression ( i.e *NOT* on the ast (abstract syntax tree) )
-        if (t_expr_->isFree() || theTriggerAst->evaluate()) {
+        if (t_expr_->isFree() || t_expr_->evaluate()) {
 
             // *ALWAYS* evaluate trigger expression unless user has forcibly removed trigger dependencies
             // ******** This allows force queued functionality, to work as expected, since trigger's will be honoured
@@ -933,6 +953,7 @@ void Node::setStateOnly(NState::State newState,
                         bool force,
                         const std::string& additional_info_to_log,
                         bool do_log_state_changes) {
+    NodeChanged changed(this);
     if (st_.first.state() == newState) {
         return; // if old and new state the same don't do anything
     }
@@ -1096,6 +1117,7 @@ DState::State Node::dstate() const {
 }
 
 bool Node::set_event(const std::string& event_name_or_number) {
+    NodeChanged changed(this);
     for (Event& e : events_) {
         if (e.name_or_number() == event_name_or_number) {
             e.set_value(true);
@@ -1105,6 +1127,7 @@ bool Node::set_event(const std::string& event_name_or_number) {
     return false;
 }
 bool Node::clear_event(const std::string& event_name_or_number) {
+    NodeChanged changed(this);
     for (Event& e : events_) {
         if (e.name_or_number() == event_name_or_number) {
             e.set_value(false);
@@ -1115,6 +1138,7 @@ bool Node::clear_event(const std::string& event_name_or_number) {
 }
 
 void Node::setRepeatToLastValue() {
+    NodeChanged changed(this);
     repeat_.setToLastValue(); // no op for empty repeat
     repeat_.increment();      // make repeat invalid
 }
@@ -1222,7 +1246,6 @@ bool Node::variable_substitution(std::string& cmd, const NameValueMap& user_edit
     bool double_micro_found    = false;
     std::string::size_type pos = 0;
     int count                  = 0;
-    Alias* is_a_alias          = isAlias();
     while (true) {
         // A while loop here is used to:
         //		a/ Allow for multiple substitution on a single line. i.e %ECF_FILES% -I %ECF_INCLUDE%"
@@ -1251,98 +1274,12 @@ bool Node::variable_substitution(std::string& cmd, const NameValueMap& user_edit
         cout << "   Found percentVar " << percentVar << "\n";
 #endif
 
-        // ****************************************************************************************
-        // Look for generated variables that should NOT be overridden first:
-        //    Variable like ECF_PASS can be overridden, i.e. with FREE_JOBS_PASSWORD
-        //    However for job file generation we should use use the generated variables first.
-        //    if the user removes ECF_PASS then we are stuck with the wrong value in the script file
-        //    FREE_JOBS_PASSWORD is left for the server to deal with
-        // Leave ECF_JOB and ECF_JOBOUT out of this list: As user may legitamly override these. ECFLOW-999
-        bool generated_variable = false;
-        if (percentVar.find("ECF_") == 0) {
-            if (percentVar.find(Str::ECF_HOST()) != std::string::npos)
-                generated_variable = true;
-            else if (percentVar.find(Str::ECF_PORT()) != std::string::npos)
-                generated_variable = true;
-            else if (percentVar.find(Str::ECF_TRYNO()) != std::string::npos)
-                generated_variable = true;
-            else if (percentVar.find(Str::ECF_NAME()) != std::string::npos)
-                generated_variable = true;
-            else if (percentVar.find(Str::ECF_PASS()) != std::string::npos)
-                generated_variable = true;
-        }
-
-        size_t firstColon = percentVar.find(':');
-
-        // First search user variable (*ONLY* set user edit's the script)
-        // Handle case: cmd = "%fred:bill% and where we have user variable "fred:bill"
-        // Handle case: cmd = "%fred%      and where we have user variable "fred"
-        // If we fail to find the variable we return false.
-        // Note: When a variable is found, it can have an empty value  which is still valid
         std::string varValue;
-        if (!user_edit_variables.empty() && search_user_edit_variables(percentVar, varValue, user_edit_variables)) {
-            cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-        }
-        else if (generated_variable && firstColon == string::npos &&
-                 find_parent_gen_variable_value(percentVar, varValue)) {
-            cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-        }
-        else {
-            if (firstColon != string::npos) {
-
-                if (is_a_alias && findParentVariableValue(percentVar, varValue)) {
-                    // For alias we could have added variables with %A:0%, %A:1%. Aliases allow variables with ':' in
-                    // the name
-                    cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-                }
-                else {
-                    // ':' is not a valid in variables, hence split, and search, if search fails use replacement
-                    string var(percentVar.begin(), percentVar.begin() + firstColon);
-#ifdef DEBUG_S
-                    cout << "   var " << var << "\n";
-#endif
-                    if (!user_edit_variables.empty() &&
-                        search_user_edit_variables(var, varValue, user_edit_variables)) {
-#ifdef DEBUG_S
-                        cout << "   user var value = " << varValue << "\n";
-#endif
-                        cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-                    }
-                    else if (generated_variable && find_parent_gen_variable_value(var, varValue)) {
-#ifdef DEBUG_S
-                        cout << "   generated var value = " << varValue << "\n";
-#endif
-                        cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-                    }
-                    else if (findParentVariableValue(var, varValue)) {
-                        // Note: variable can exist, but have an empty value
-#ifdef DEBUG_S
-                        cout << "   var value = " << varValue << "\n";
-#endif
-                        // replace the "%VAR:fred --f%" with var
-                        cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-                    }
-                    else {
-                        string substitute(percentVar.begin() + firstColon + 1, percentVar.end());
-#ifdef DEBUG_S
-                        cout << "  substitute value = " << substitute << "\n";
-#endif
-                        cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, substitute);
-                    }
-#ifdef DEBUG_S
-                    cout << "   cmd = " << cmd << "\n";
-#endif
-                }
-            }
-            else if (findParentVariableValue(percentVar, varValue)) {
-                // No ':' search user variables, repeat, and then generated variables.
-                cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
-            }
-            else {
-                // Can't find in user variables, or node variable, hence can't go any further
-                return false;
-            }
+        if (!find_substitution_value(percentVar, user_edit_variables, varValue)) {
+            // Can't find in user variables, or node variable, hence can't go any further
+            return false;
         }
+        cmd.replace(firstPercentPos, secondPercentPos - firstPercentPos + 1, varValue);
 
         // Simple Check for infinite recursion
         if (count > 1000)
@@ -1372,6 +1309,72 @@ bool Node::variable_substitution(std::string& cmd, const NameValueMap& user_edit
     return true;
 }
 
+bool Node::find_substitution_value(const std::string& percentVar,
+                                   const NameValueMap& user_edit_variables,
+                                   std::string& varValue) const {
+    // ****************************************************************************************
+    // Look for generated variables that should NOT be overridden first:
+    //    Variable like ECF_PASS can be overridden, i.e. with FREE_JOBS_PASSWORD
+    //    However for job file generation we should use use the generated variables first.
+    //    if the user removes ECF_PASS then we are stuck with the wrong value in the script file
+    //    FREE_JOBS_PASSWORD is left for the server to deal with
+    // Leave ECF_JOB and ECF_JOBOUT out of this list: As user may legitamly override these. ECFLOW-999
+    bool generated_variable = false;
+    if (percentVar.find("ECF_") == 0) {
+        if (percentVar.find(Str::ECF_HOST()) != std::string::npos)
+            generated_variable = true;
+        else if (percentVar.find(Str::ECF_PORT()) != std::string::npos)
+            generated_variable = true;
+        else if (percentVar.find(Str::ECF_TRYNO()) != std::string::npos)
+            generated_variable = true;
+        else if (percentVar.find(Str::ECF_NAME()) != std::string::npos)
+            generated_variable = true;
+        else if (percentVar.find(Str::ECF_PASS()) != std::string::npos)
+            generated_variable = true;
+    }
+
+    size_t firstColon = percentVar.find(':');
+
+    // First search user variable (*ONLY* set user edit's the script)
+    // Handle case: cmd = "%fred:bill% and where we have user variable "fred:bill"
+    // Handle case: cmd = "%fred%      and where we have user variable "fred"
+    // If we fail to find the variable we return false.
+    // Note: When a variable is found, it can have an empty value  which is still valid
+    if (!user_edit_variables.empty() && search_user_edit_variables(percentVar, varValue, user_edit_variables)) {
+        return true;
+    }
+    if (generated_variable && firstColon == string::npos && find_parent_gen_variable_value(percentVar, varValue)) {
+        return true;
+    }
+    if (firstColon != string::npos) {
+        if (isAlias() && findParentVariableValue(percentVar, varValue)) {
+            // For alias we could have added variables with %A:0%, %A:1%. Aliases allow variables with ':' in
+            // the name
+            return true;
+        }
+
+        // ':' is not a valid in variables, hence split, and search, if search fails use replacement
+        string var(percentVar.begin(), percentVar.begin() + firstColon);
+        if (!user_edit_variables.empty() && search_user_edit_variables(var, varValue, user_edit_variables)) {
+            return true;
+        }
+        if (generated_variable && find_parent_gen_variable_value(var, varValue)) {
+            return true;
+        }
+        if (findParentVariableValue(var, varValue)) {
+            // Note: variable can exist, but have an empty value
+            return true;
+        }
+
+        // use the substitute, i.e. "%VAR:fred --f%" -> "fred --f"
+        varValue.assign(percentVar.begin() + firstColon + 1, percentVar.end());
+        return true;
+    }
+
+    // No ':' search user variables, repeat, and then generated variables.
+    return findParentVariableValue(percentVar, varValue);
+}
+
 bool Node::find_all_used_variables(std::string& cmd, NameValueMap& used_variables, char micro) const {
 #ifdef DEBUG_S
     cout << "cmd  = " << cmd << "\n";
@@ -2543,14 +2546,10 @@ AstTop* Node::triggerAst(std::string& errorMsg) const {
 
 void Node::invalidate_trigger_references() const {
     if (t_expr_) {
-        if (t_expr_->get_ast()) {
-            t_expr_->get_ast()->invalidate_trigger_references();
-        }
+        t_expr_->invalidate_trigger_references();
     }
     if (c_expr_) {
-        if (c_expr_->get_ast()) {
-            c_expr_->get_ast()->invalidate_trigger_references();
-        }
+        c_expr_->invalidate_trigger_references();
     }
 }
 
@@ -2687,7 +2686,7 @@ void Node::sort_attributes(ecf::Attr::Type attr, bool recursive, const std::vect
     }
     auto caseInsen   = [](const auto& a, const auto& b) { return Str::caseInsLess(a.name(), b.name()); };
 
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
     switch (attr) {
         case Attr::EVENT:
             sort(events_.begin(), events_.end(), [](const Event& a, const Event& b) {
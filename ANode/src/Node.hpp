@@ -47,6 +47,7 @@
 #include "NodeFwd.hpp"
 #include "PrintStyle.hpp"
 #include "RepeatAttr.hpp"
+#include "Symbol.hpp"
 #include "TimeAttr.hpp"
 #include "TodayAttr.hpp"
 #include "Variable.hpp"
@@ -56,6 +57,7 @@ class Simulator;
 class SimulatorVisitor;
 class DefsAnalyserVisitor;
 class FlatAnalyserVisitor;
+class ExprByteCode;
 } // namespace ecf
 namespace ecf {
 class Calendar;
@@ -245,6 +247,12 @@ public:
 
     bool variable_substitution(std::string& cmd, const NameValueMap& user_edit_variables, char micro = '%') const;
 
+    /// Find the value that replaces %percentVar% in variable_substitution, i.e. for %VAR% or %VAR:substitute%
+    /// Returns false if the variable can't be found, and there is no substitute.
+    bool find_substitution_value(const std::string& percentVar,
+                                 const NameValueMap& user_edit_variables,
+                                 std::string& value) const;
+
     /// Find all %VAR% and add to the list, there can be more than one. i.e %ECF_FILES% -I %ECF_INCLUDE%"
     bool find_all_used_variables(std::string& cmd, NameValueMap& used_variables, char micro = '%') const;
 
@@ -381,7 +389,7 @@ public:
     virtual void invalidate_trigger_references() const;
 
     // Access functions: ======================================================
-    const std::string& name() const { return n_; }
+    const std::string& name() const { return n_.str(); }
     const Repeat& repeat() const { return repeat_; } // can be empty()
     const std::vector<Variable>& variables() const { return vars_; }
     const std::vector<limit_ptr>& limits() const { return limits_; }
@@ -391,6 +399,9 @@ public:
     const std::vector<Event>& events() const { return events_; }
     const std::vector<Label>& labels() const { return labels_; }
 
+    /// Updated on addition or deletion of attributes. Only updated on the server
+    unsigned int attr_change_no() const { return state_change_no_; }
+
     const std::vector<ecf::TimeAttr>& timeVec() const { return times_; }
     const std::vector<ecf::TodayAttr>& todayVec() const { return todays_; }
     const std::vector<DateAttr>& dates() const { return dates_; }
@@ -555,6 +566,14 @@ public:
     virtual void collateChanges(DefsDelta&) const = 0;
     void incremental_changes(DefsDelta&, compound_memento_ptr& comp) const;
 
+    /// Collect the state changes of this node *only*, i.e. without traversing the children
+    /// Used by ChangeJournal, which determines the changed nodes, without a traversal.
+    virtual void collate_node_changes_only(DefsDelta&) const = 0;
+
+    /// Return the max state change no, of this node *only*, i.e. excluding children
+    /// *Must* be kept in sync with incremental_changes()
+    virtual unsigned int node_only_max_state_change_no() const;
+
     void set_memento(const NodeStateMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
     void set_memento(const NodeDefStatusDeltaMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
     void set_memento(const SuspendedMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
@@ -619,6 +638,9 @@ public:
     virtual std::string find_node_path(const std::string& /*type*/, const std::string& /*name*/) const {
         return std::string();
     }
+    // The name lookups (variables, meters, events, ...) compare strings. Interning the query would
+    // lock the process wide symbol table for each lookup, including those made concurrently by the
+    // job generation threads. Trigger evaluation caches the attribute found. (see ExprByteCode)
     const Variable& findVariable(const std::string& name) const;
     std::string find_parent_variable_sub_value(const std::string& name) const;
     const Variable& find_parent_variable(const std::string& name) const;
@@ -638,7 +660,7 @@ public:
     limit_ptr findLimitUpNodeTree(const std::string& name) const;
     Limit* findLimitViaInLimit(const InLimit& l) const {
         return inLimitMgr_.findLimitViaInLimit(l);
-    } // used in *test* only
+    } // used in test, and DependencyIndex
     bool findInLimitByNameAndPath(const InLimit& l) const {
         return inLimitMgr_.findInLimitByNameAndPath(l);
     } // use name,path,token,
@@ -700,6 +722,9 @@ public:
 protected:
     void set_runtime(const boost::posix_time::time_duration& rt) { sc_rt_ = rt; }
 
+    /// Increment the state change number, and record this node in the change journal of its suite
+    unsigned int incr_state_change_no();
+
     /// Used in conjunction with Node::position()
     /// returns std::numeric_limits<std::size_t>::max() if child not found
     virtual size_t child_position(const Node*) const = 0;
@@ -776,6 +801,7 @@ private:
     void findExprVariableAndPrint(const std::string& name, std::ostream& os) const;
     friend class VariableHelper;
     friend class AstParentVariable;
+    friend class ecf::ExprByteCode;
     bool update_variable(const std::string& name, const std::string& value);
 
 private:
@@ -869,7 +895,7 @@ private: /// For use by python interface,
 
 private:
     Node* parent_{nullptr}; // *NOT* persisted must be set by the parent class
-    std::string n_;
+    ecf::Symbol n_;
     boost::posix_time::time_duration
         sc_rt_; // state change runtime, Used to order peers, no persistence in cereal only defs.
     std::pair<NState, boost::posix_time::time_duration> st_{
@@ -898,7 +924,7 @@ private:
     std::vector<limit_ptr> limits_; // Ptrs since many in-limits can point to a single limit
     InLimitMgr inLimitMgr_{this};   // manages the inlimit
 
-    ecf::Flag flag_;
+    ecf::Flag flag_{this};
 
     std::unique_ptr<ecf::AutoCancelAttr> auto_cancel_;   // Can only have 1 auto cancel per node
     std::unique_ptr<ecf::AutoArchiveAttr> auto_archive_; // Can only have 1 auto archive per node
@@ -45,7 +45,7 @@ bool Node::update_variable(const std::string& name, const std::string& value) {
 }
 
 void Node::addVariable(const Variable& v) {
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
     if (update_variable(v.name(), v.theValue()))
         return;
     if (vars_.capacity() == 0)
@@ -54,7 +54,7 @@ void Node::addVariable(const Variable& v) {
 }
 
 void Node::add_variable(const std::string& name, const std::string& value) {
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
     if (update_variable(name, value))
         return;
     if (vars_.capacity() == 0)
@@ -63,7 +63,7 @@ void Node::add_variable(const std::string& name, const std::string& value) {
 }
 
 void Node::add_variable_bypass_name_check(const std::string& name, const std::string& value) {
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
     if (update_variable(name, value))
         return;
     if (vars_.capacity() == 0)
@@ -99,7 +99,7 @@ void Node::add_trigger_expression(const Expression& t) {
         throw std::runtime_error("Cannot add trigger on a suite");
 
     t_expr_          = std::make_unique<Expression>(t);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::add_complete_expression(const Expression& t) {
@@ -114,7 +114,7 @@ void Node::add_complete_expression(const Expression& t) {
         throw std::runtime_error("Cannot add complete trigger on a suite");
 
     c_expr_          = std::make_unique<Expression>(t);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::py_add_trigger_expr(const std::vector<PartExpression>& vec) {
@@ -122,7 +122,7 @@ void Node::py_add_trigger_expr(const std::vector<PartExpression>& vec) {
         if (isSuite())
             throw std::runtime_error("Cannot add trigger on a suite");
         t_expr_->add_expr(vec);
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
     }
     else {
         Expression expr;
@@ -137,7 +137,7 @@ void Node::py_add_complete_expr(const std::vector<PartExpression>& vec) {
         if (isSuite())
             throw std::runtime_error("Cannot add complete on a suite");
         c_expr_->add_expr(vec);
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
     }
     else {
         Expression expr;
@@ -154,7 +154,7 @@ void Node::add_part_trigger(const PartExpression& part) {
     if (!t_expr_)
         t_expr_ = std::make_unique<Expression>();
     t_expr_->add(part);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 void Node::add_part_complete(const PartExpression& part) {
     if (isSuite())
@@ -163,7 +163,7 @@ void Node::add_part_complete(const PartExpression& part) {
     if (!c_expr_)
         c_expr_ = std::make_unique<Expression>();
     c_expr_->add(part);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addTime(const ecf::TimeAttr& t) {
@@ -176,7 +176,7 @@ void Node::addTime(const ecf::TimeAttr& t) {
     }
 
     times_.push_back(t);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addToday(const ecf::TodayAttr& t) {
@@ -189,7 +189,7 @@ void Node::addToday(const ecf::TodayAttr& t) {
     }
 
     todays_.push_back(t);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addDate(const DateAttr& d) {
@@ -203,7 +203,7 @@ void Node::addDate(const DateAttr& d) {
     }
 
     dates_.push_back(d);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addDay(const DayAttr& d) {
@@ -217,7 +217,7 @@ void Node::addDay(const DayAttr& d) {
     }
 
     days_.push_back(d);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addCron(const CronAttr& d) {
@@ -236,7 +236,7 @@ void Node::addCron(const CronAttr& d) {
     }
 
     crons_.push_back(d);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addLabel(const Label& l) {
@@ -247,7 +247,7 @@ void Node::addLabel(const Label& l) {
         throw std::runtime_error(ss.str());
     }
     labels_.push_back(l);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::add_label(const std::string& name, const std::string& value, const std::string& new_value, bool check) {
@@ -257,7 +257,7 @@ void Node::add_label(const std::string& name, const std::string& value, const st
         throw std::runtime_error(ss.str());
     }
     labels_.emplace_back(name, value, new_value, check);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addMeter(const Meter& m, bool check) {
@@ -271,7 +271,7 @@ void Node::addMeter(const Meter& m, bool check) {
         }
     }
     meters_.push_back(m);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::add_meter(const std::string& name, int min, int max, int color_change, int value, bool check) {
@@ -285,7 +285,7 @@ void Node::add_meter(const std::string& name, int min, int max, int color_change
         }
     }
     meters_.emplace_back(name, min, max, color_change, value, check);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addEvent(const Event& e, bool check) {
@@ -299,7 +299,7 @@ void Node::addEvent(const Event& e, bool check) {
         }
     }
     events_.push_back(e);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addLimit(const Limit& l, bool check) {
@@ -312,12 +312,12 @@ void Node::addLimit(const Limit& l, bool check) {
     limit_ptr the_limit = std::make_shared<Limit>(l);
     the_limit->set_node(this);
     limits_.push_back(the_limit);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addInLimit(const InLimit& l, bool check) {
     inLimitMgr_.addInLimit(l, check);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 static void throwIfRepeatAllreadyExists(Node* node) {
@@ -339,13 +339,13 @@ void Node::addRepeat(Repeat&& r) {
     throwIfRepeatAllreadyExists(this);
     repeat_ = std::move(r);
     repeat_.update_repeat_genvar();
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 void Node::addRepeat(const Repeat& r) {
     throwIfRepeatAllreadyExists(this);
     repeat_ = r;
     repeat_.update_repeat_genvar();
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::addAutoCancel(const ecf::AutoCancelAttr& ac) {
@@ -360,7 +360,7 @@ void Node::addAutoCancel(const ecf::AutoCancelAttr& ac) {
         throw std::runtime_error(ss.str());
     }
     auto_cancel_     = std::make_unique<ecf::AutoCancelAttr>(ac);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::add_autoarchive(const ecf::AutoArchiveAttr& aa) {
@@ -375,7 +375,7 @@ void Node::add_autoarchive(const ecf::AutoArchiveAttr& aa) {
         throw std::runtime_error(ss.str());
     }
     auto_archive_    = std::make_unique<ecf::AutoArchiveAttr>(aa);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::add_autorestore(const ecf::AutoRestoreAttr& ar) {
@@ -386,13 +386,13 @@ void Node::add_autorestore(const ecf::AutoRestoreAttr& ar) {
     }
     auto_restore_ = std::make_unique<ecf::AutoRestoreAttr>(ar);
     auto_restore_->set_node(this);
-    state_change_no_ = Ecf::incr_state_change_no(); // Only add where used in AlterCmd
+    state_change_no_ = incr_state_change_no(); // Only add where used in AlterCmd
 }
 
 void Node::addLate(const ecf::LateAttr& l) {
     if (!late_) {
         late_            = std::make_unique<ecf::LateAttr>(l);
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
         return;
     }
     throw std::runtime_error("Add Late failed: A node can only have one Late attribute, see node " + debugNodePath());
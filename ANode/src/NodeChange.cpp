@@ -16,7 +16,7 @@
 
 #include <boost/lexical_cast.hpp>
 
-#include "Ecf.hpp"
+#include "ChangeJournal.hpp"
 #include "ExprAst.hpp"
 #include "LateAttr.hpp"
 #include "Limit.hpp"
@@ -31,7 +31,7 @@ void Node::changeVariable(const std::string& name, const std::string& value) {
     for (size_t i = 0; i < theSize; i++) {
         if (vars_[i].name() == name) {
             vars_[i].set_value(value);
-            variable_change_no_ = Ecf::incr_state_change_no();
+            variable_change_no_ = incr_state_change_no();
             return;
         }
     }
@@ -39,6 +39,7 @@ void Node::changeVariable(const std::string& name, const std::string& value) {
 }
 
 bool Node::set_event(const std::string& event_name_or_number, bool value) {
+    NodeChanged changed(this);
     if (events_.empty()) {
         return false;
     }
@@ -122,6 +123,7 @@ void Node::changeEvent(const std::string& event_name_or_number, bool value) {
 }
 
 bool Node::set_meter(const std::string& meter_name, int value) {
+    NodeChanged changed(this);
     size_t the_meter_size = meters_.size();
     for (size_t i = 0; i < the_meter_size; ++i) {
         if (meters_[i].name() == meter_name) {
@@ -158,6 +160,7 @@ void Node::changeMeter(const std::string& meter_name, int value) {
 }
 
 void Node::changeLabel(const std::string& name, const std::string& value) {
+    NodeChanged changed(this);
     size_t theSize = labels_.size();
     for (size_t i = 0; i < theSize; i++) {
         if (labels_[i].name() == name) {
@@ -181,12 +184,14 @@ void Node::changeComplete(const std::string& expression) {
 }
 
 void Node::changeRepeat(const std::string& value) {
+    NodeChanged changed(this);
     if (repeat_.empty())
         throw std::runtime_error("Node::changeRepeat: Could not find repeat on " + absNodePath());
     repeat_.change(value); // this can throw std::runtime_error
 }
 
 void Node::increment_repeat() {
+    NodeChanged changed(this);
     if (repeat_.empty())
         throw std::runtime_error("Node::increment_repeat: Could not find repeat on " + absNodePath());
     repeat_.increment();
@@ -229,6 +234,7 @@ void Node::changeLimitValue(const std::string& name, int value) {
 }
 
 void Node::changeDefstatus(const std::string& theState) {
+    NodeChanged changed(this);
     if (!DState::isValid(theState)) {
         throw std::runtime_error("Node::changeDefstatus expected a state but found " + theState);
     }
@@ -239,7 +245,7 @@ void Node::changeDefstatus(const std::string& theState) {
 
 void Node::changeLate(const ecf::LateAttr& late) {
     late_            = std::make_unique<ecf::LateAttr>(late);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::change_time(const std::string& old, const std::string& new_time) {
@@ -251,7 +257,7 @@ void Node::change_time(const std::string& old, const std::string& new_time) {
         // Dont use '==' since that compares additional state like free_
         if (times_[i].structureEquals(old_attr)) {
             times_[i]        = new_attr;
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
             return;
         }
     }
@@ -267,7 +273,7 @@ void Node::change_today(const std::string& old, const std::string& new_time) {
         // Dont use '==' since that compares additional state like free_
         if (todays_[i].structureEquals(old_attr)) {
             todays_[i]       = new_attr;
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
             return;
         }
     }
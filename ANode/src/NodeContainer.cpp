@@ -15,6 +15,7 @@
 
 #include "NodeContainer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <sstream>
@@ -22,6 +23,7 @@
 
 #include <boost/filesystem/operations.hpp>
 
+#include "ChangeJournal.hpp"
 #include "Defs.hpp"
 #include "DefsDelta.hpp"
 #include "Ecf.hpp"
@@ -79,6 +81,7 @@ NodeContainer& NodeContainer::operator=(const NodeContainer& rhs) {
     if (this != &rhs) {
         Node::operator=(rhs);
         nodes_.clear();
+        ChangeJournal::children_removed(this);
         copy(rhs);
         order_state_change_no_      = 0;
         add_remove_state_change_no_ = Ecf::incr_state_change_no();
@@ -249,6 +252,12 @@ void NodeContainer::incremental_changes(DefsDelta& changes, compound_memento_ptr
     Node::incremental_changes(changes, comp);
 }
 
+unsigned int NodeContainer::node_only_max_state_change_no() const {
+    // *make* sure this is in sync with NodeContainer::incremental_changes()
+    unsigned int max_change_no = std::max(add_remove_state_change_no_, order_state_change_no_);
+    return std::max(max_change_no, Node::node_only_max_state_change_no());
+}
+
 void NodeContainer::set_memento(const OrderMemento* memento,
                                 std::vector<ecf::Aspect::Type>& aspects,
                                 bool aspect_only) {
@@ -327,7 +336,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
                     node_ptr node = (*i);
                     nodes_.erase(i);
                     nodes_.insert(nodes_.begin(), node);
-                    order_state_change_no_ = Ecf::incr_state_change_no();
+                    order_state_change_no_ = incr_state_change_no();
                     return;
                 }
             }
@@ -339,7 +348,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
                     node_ptr node = (*i);
                     nodes_.erase(i);
                     nodes_.push_back(node);
-                    order_state_change_no_ = Ecf::incr_state_change_no();
+                    order_state_change_no_ = incr_state_change_no();
                     return;
                 }
             }
@@ -357,14 +366,14 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
 
                 return Str::caseInsLess(a->name(), b->name());
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
         case NOrder::ORDER: {
             std::sort(nodes_.begin(), nodes_.end(), [](const node_ptr& a, const node_ptr& b) {
                 return Str::caseInsGreater(a->name(), b->name());
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
         case NOrder::UP: {
@@ -375,7 +384,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
                         nodes_.erase(nodes_.begin() + t);
                         t--;
                         nodes_.insert(nodes_.begin() + t, node);
-                        order_state_change_no_ = Ecf::incr_state_change_no();
+                        order_state_change_no_ = incr_state_change_no();
                     }
                     return;
                 }
@@ -390,7 +399,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
                         nodes_.erase(nodes_.begin() + t);
                         t++;
                         nodes_.insert(nodes_.begin() + t, node);
-                        order_state_change_no_ = Ecf::incr_state_change_no();
+                        order_state_change_no_ = incr_state_change_no();
                     }
                     return;
                 }
@@ -407,7 +416,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
             std::sort(nodes_.begin(), nodes_.end(), [](const node_ptr& a, const node_ptr& b) {
                 return a->state_change_runtime() > b->state_change_runtime();
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
     }
@@ -415,7 +424,7 @@ void NodeContainer::order(Node* immediateChild, NOrder::Order ord) {
 
 void NodeContainer::move_peer(Node* src, Node* dest) {
     move_peer_node(nodes_, src, dest, "NodeContainer");
-    order_state_change_no_ = Ecf::incr_state_change_no();
+    order_state_change_no_ = incr_state_change_no();
 }
 
 boost::posix_time::time_duration NodeContainer::sum_runtime() {
@@ -541,7 +550,7 @@ NState::State NodeContainer::computedState(Node::TraverseType traverseType) cons
 }
 
 void NodeContainer::force_sync() {
-    add_remove_state_change_no_ = Ecf::incr_state_change_no();
+    add_remove_state_change_no_ = incr_state_change_no();
 }
 
 node_ptr NodeContainer::removeChild(Node* child) {
@@ -551,7 +560,8 @@ node_ptr NodeContainer::removeChild(Node* child) {
             node_ptr node = std::dynamic_pointer_cast<Node>(nodes_[t]);
             child->set_parent(nullptr); // must set to NULL, allows it to be re-added to different parent
             nodes_.erase(nodes_.begin() + t);
-            add_remove_state_change_no_ = Ecf::incr_state_change_no();
+            add_remove_state_change_no_ = incr_state_change_no();
+            ChangeJournal::children_removed(this);
             return node;
         }
     }
@@ -685,7 +695,7 @@ void NodeContainer::add_task_only(const task_ptr& t, size_t position) {
     else {
         nodes_.insert(nodes_.begin() + position, t);
     }
-    add_remove_state_change_no_ = Ecf::incr_state_change_no();
+    add_remove_state_change_no_ = incr_state_change_no();
 }
 
 void NodeContainer::add_family_only(const family_ptr& f, size_t position) {
@@ -703,7 +713,7 @@ void NodeContainer::add_family_only(const family_ptr& f, size_t position) {
     else {
         nodes_.insert(nodes_.begin() + position, f);
     }
-    add_remove_state_change_no_ = Ecf::incr_state_change_no();
+    add_remove_state_change_no_ = incr_state_change_no();
 }
 
 void NodeContainer::addFamily(const family_ptr& f, size_t position) {
@@ -1213,7 +1223,8 @@ void NodeContainer::archive() {
     nodes_.clear();
 
     std::vector<node_ptr>().swap(nodes_);                      // reclaim vector memory
-    add_remove_state_change_no_ = Ecf::incr_state_change_no(); // For sync
+    add_remove_state_change_no_ = incr_state_change_no();      // For sync
+    ChangeJournal::children_removed(this);
     string msg                  = " autoarchive ";
     msg += debugNodePath(); // inform user via log
     ecf::log(Log::LOG, msg);
@@ -1224,6 +1235,7 @@ void NodeContainer::swap(NodeContainer& rhs) {
     for (auto& n : nodes_) {
         n->set_parent(this);
     }
+    ChangeJournal::children_removed(this);
 }
 
 void NodeContainer::restore_on_begin_or_requeue() {
@@ -1289,7 +1301,7 @@ void NodeContainer::restore() {
     swap(*archived_node_container);                            // swap the children, and set parent pointers
     flag().clear(ecf::Flag::ARCHIVED);                         // clear flag archived
     flag().set(ecf::Flag::RESTORED);                           // set restored flag, to stop automatic autoarchive
-    add_remove_state_change_no_ = Ecf::incr_state_change_no(); // For sync
+    add_remove_state_change_no_ = incr_state_change_no();      // For sync
 
     string msg                  = " autorestore ";
     msg += debugNodePath(); // inform user via log
@@ -1382,7 +1394,8 @@ bool NodeContainer::doDeleteChild(Node* child) {
 
             child->set_parent(nullptr); // must set to NULL, allow it to be re-added to different parent
             nodes_.erase(t);
-            add_remove_state_change_no_ = Ecf::incr_state_change_no();
+            add_remove_state_change_no_ = incr_state_change_no();
+            ChangeJournal::children_removed(this);
             set_most_significant_state_up_node_tree();
             return true;
         }
@@ -45,6 +45,8 @@ public:
     void status() override;
     bool top_down_why(std::vector<std::string>& theReasonWhy, bool html_tags = false) const override;
     void collateChanges(DefsDelta&) const override;
+    unsigned int node_only_max_state_change_no() const override;
+    unsigned int add_remove_state_change_no() const { return add_remove_state_change_no_; }
     void set_memento(const OrderMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
     void set_memento(const ChildrenMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
     void order(Node* immediateChild, NOrder::Order) override;
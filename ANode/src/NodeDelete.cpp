@@ -17,7 +17,6 @@
 #include "AutoArchiveAttr.hpp"
 #include "AutoCancelAttr.hpp"
 #include "AutoRestoreAttr.hpp"
-#include "Ecf.hpp"
 #include "Expression.hpp"
 #include "LateAttr.hpp"
 #include "Limit.hpp"
@@ -30,7 +29,7 @@ using namespace std;
 void Node::deleteTime(const std::string& name) {
     if (name.empty()) {
         times_.clear(); // delete all
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteTime\n";
 #endif
@@ -46,7 +45,7 @@ void Node::delete_time(const ecf::TimeAttr& attr) {
         // Dont use '==' since that compares additional state like free_
         if (times_[i].structureEquals(attr)) {
             times_.erase(times_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_time\n";
@@ -60,7 +59,7 @@ void Node::delete_time(const ecf::TimeAttr& attr) {
 void Node::deleteToday(const std::string& name) {
     if (name.empty()) {
         todays_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteToday\n";
 #endif
@@ -77,7 +76,7 @@ void Node::delete_today(const ecf::TodayAttr& attr) {
         // Dont use '==' since that compares additional state like free_
         if (todays_[i].structureEquals(attr)) {
             todays_.erase(todays_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_today\n";
 #endif
@@ -90,7 +89,7 @@ void Node::delete_today(const ecf::TodayAttr& attr) {
 void Node::deleteDate(const std::string& name) {
     if (name.empty()) {
         dates_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteDate\n";
 #endif
@@ -106,7 +105,7 @@ void Node::delete_date(const DateAttr& attr) {
         // Dont use '==' since that compares additional state like free_
         if (attr.structureEquals(dates_[i])) {
             dates_.erase(dates_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_date\n";
 #endif
@@ -119,7 +118,7 @@ void Node::delete_date(const DateAttr& attr) {
 void Node::deleteDay(const std::string& name) {
     if (name.empty()) {
         days_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteDay\n";
 #endif
@@ -135,7 +134,7 @@ void Node::delete_day(const DayAttr& attr) {
         // Dont use '==' since that compares additional state like free_
         if (attr.structureEquals(days_[i])) {
             days_.erase(days_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_day\n";
 #endif
@@ -148,7 +147,7 @@ void Node::delete_day(const DayAttr& attr) {
 void Node::deleteCron(const std::string& name) {
     if (name.empty()) {
         crons_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteCron\n";
 #endif
@@ -164,7 +163,7 @@ void Node::delete_cron(const ecf::CronAttr& attr) {
         // Dont use '==' since that compares additional state like free_
         if (attr.structureEquals(crons_[i])) {
             crons_.erase(crons_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_cron\n";
 #endif
@@ -177,7 +176,7 @@ void Node::delete_cron(const ecf::CronAttr& attr) {
 void Node::deleteVariable(const std::string& name) {
     if (name.empty()) {
         vars_.clear(); // delete all
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteVariable\n";
@@ -189,7 +188,7 @@ void Node::deleteVariable(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (vars_[i].name() == name) {
             vars_.erase(vars_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::deleteVariable\n";
@@ -212,7 +211,7 @@ void Node::delete_variable_no_error(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (vars_[i].name() == name) {
             vars_.erase(vars_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::delete_variable_no_error\n";
@@ -225,7 +224,7 @@ void Node::delete_variable_no_error(const std::string& name) {
 void Node::deleteEvent(const std::string& name) {
     if (name.empty()) {
         events_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteEvent\n";
 #endif
@@ -236,7 +235,7 @@ void Node::deleteEvent(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (events_[i].name_or_number() == name) {
             events_.erase(events_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::deleteEvent\n";
 #endif
@@ -249,7 +248,7 @@ void Node::deleteEvent(const std::string& name) {
 void Node::deleteMeter(const std::string& name) {
     if (name.empty()) {
         meters_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Expression::clearFree()\n";
 #endif
@@ -260,7 +259,7 @@ void Node::deleteMeter(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (meters_[i].name() == name) {
             meters_.erase(meters_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Expression::clearFree()\n";
 #endif
@@ -273,7 +272,7 @@ void Node::deleteMeter(const std::string& name) {
 void Node::deleteLabel(const std::string& name) {
     if (name.empty()) {
         labels_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteLabel\n";
 #endif
@@ -284,7 +283,7 @@ void Node::deleteLabel(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (labels_[i].name() == name) {
             labels_.erase(labels_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::deleteLabel\n";
 #endif
@@ -313,7 +312,7 @@ void Node::delete_generic(const std::string& name) {
 void Node::deleteTrigger() {
     if (t_expr_) {
         t_expr_.reset(nullptr);
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteTrigger()\n";
 #endif
@@ -323,7 +322,7 @@ void Node::deleteTrigger() {
 void Node::deleteComplete() {
     if (c_expr_) {
         c_expr_.reset(nullptr);
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteComplete()\n";
 #endif
@@ -333,7 +332,7 @@ void Node::deleteComplete() {
 void Node::deleteRepeat() {
     if (!repeat_.empty()) {
         repeat_.clear(); // will delete the pimple
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteRepeat())\n";
 #endif
@@ -343,7 +342,7 @@ void Node::deleteRepeat() {
 void Node::deleteLimit(const std::string& name) {
     if (name.empty()) {
         limits_.clear();
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteLimit\n";
 #endif
@@ -354,7 +353,7 @@ void Node::deleteLimit(const std::string& name) {
     for (size_t i = 0; i < theSize; i++) {
         if (limits_[i]->name() == name) {
             limits_.erase(limits_.begin() + i);
-            state_change_no_ = Ecf::incr_state_change_no();
+            state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
             std::cout << "Node::deleteLimit\n";
 #endif
@@ -385,7 +384,7 @@ void Node::delete_limit_path(const std::string& name, const std::string& path) {
 void Node::deleteInlimit(const std::string& name) {
     // if name exists but no corresponding in limit found raises an exception
     if (inLimitMgr_.deleteInlimit(name)) {
-        state_change_no_ = Ecf::incr_state_change_no();
+        state_change_no_ = incr_state_change_no();
 #ifdef DEBUG_STATE_CHANGE_NO
         std::cout << "Node::deleteInlimit\n";
 #endif
@@ -414,20 +413,20 @@ void Node::delete_zombie(Child::ZombieType zt) {
 
 void Node::deleteLate() {
     late_.reset(nullptr);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::deleteAutoCancel() {
     auto_cancel_.reset(nullptr);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::deleteAutoArchive() {
     auto_archive_.reset(nullptr);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 void Node::deleteAutoRestore() {
     auto_restore_.reset(nullptr);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
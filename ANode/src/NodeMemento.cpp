@@ -12,6 +12,8 @@
 //
 // Description :
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <algorithm>
+
 #include "DefsDelta.hpp"
 #include "Memento.hpp"
 #include "MiscAttrs.hpp"
@@ -312,6 +314,53 @@ void Node::incremental_changes(DefsDelta& changes, compound_memento_ptr& comp) c
     }
 }
 
+unsigned int Node::node_only_max_state_change_no() const {
+    // *make* sure this is in sync with Node::incremental_changes()
+    unsigned int max_change_no = std::max(st_.first.state_change_no(), d_st_.state_change_no());
+    max_change_no              = std::max(max_change_no, suspended_change_no_);
+    max_change_no              = std::max(max_change_no, state_change_no_);
+    max_change_no              = std::max(max_change_no, variable_change_no_);
+    max_change_no              = std::max(max_change_no, flag_.state_change_no());
+
+    for (const Event& e : events_)
+        max_change_no = std::max(max_change_no, e.state_change_no());
+    for (const Meter& m : meters_)
+        max_change_no = std::max(max_change_no, m.state_change_no());
+    for (const Label& l : labels_)
+        max_change_no = std::max(max_change_no, l.state_change_no());
+
+    for (const TodayAttr& attr : todays_)
+        max_change_no = std::max(max_change_no, attr.state_change_no());
+    for (const TimeAttr& attr : times_)
+        max_change_no = std::max(max_change_no, attr.state_change_no());
+    for (const DayAttr& attr : days_)
+        max_change_no = std::max(max_change_no, attr.state_change_no());
+    for (const DateAttr& attr : dates_)
+        max_change_no = std::max(max_change_no, attr.state_change_no());
+    for (const CronAttr& attr : crons_)
+        max_change_no = std::max(max_change_no, attr.state_change_no());
+
+    if (misc_attrs_) {
+        for (const QueueAttr& attr : misc_attrs_->queues())
+            max_change_no = std::max(max_change_no, attr.state_change_no());
+        for (const VerifyAttr& v : misc_attrs_->verifys())
+            max_change_no = std::max(max_change_no, v.state_change_no());
+    }
+
+    if (t_expr_)
+        max_change_no = std::max(max_change_no, t_expr_->state_change_no());
+    if (c_expr_)
+        max_change_no = std::max(max_change_no, c_expr_->state_change_no());
+    if (!repeat_.empty())
+        max_change_no = std::max(max_change_no, repeat_.state_change_no());
+    for (limit_ptr l : limits_)
+        max_change_no = std::max(max_change_no, l->state_change_no());
+    if (late_)
+        max_change_no = std::max(max_change_no, late_->state_change_no());
+
+    return max_change_no;
+}
+
 void Node::set_memento(const NodeStateMemento* memento, std::vector<ecf::Aspect::Type>& aspects, bool aspect_only) {
 
 #ifdef DEBUG_MEMENTO
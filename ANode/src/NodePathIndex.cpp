@@ -0,0 +1,67 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "NodePathIndex.hpp"
+
+#include "Ecf.hpp"
+#include "Node.hpp"
+
+namespace ecf {
+
+namespace {
+
+/// Return true if the node is at path in defs, i.e. walking up the parents, the node names match the path
+bool at_path(const Node* node, const Defs* defs, const std::string& path) {
+    size_t end = path.size();
+    while (node) {
+        const std::string& name = node->name();
+        if (end <= name.size())
+            return false;
+        size_t start = end - name.size();
+        if (path[start - 1] != '/' || path.compare(start, name.size(), name) != 0)
+            return false;
+        end = start - 1;
+        if (!node->parent())
+            return end == 0 && node->defs() == defs; // suite must still be in defs
+        node = node->parent();
+    }
+    return false;
+}
+
+} // namespace
+
+node_ptr NodePathIndex::find(const Defs* defs, const std::string& path) {
+    if (modify_change_no_ != Ecf::modify_change_no()) {
+        clear();
+        modify_change_no_ = Ecf::modify_change_no();
+    }
+
+    auto it = index_.find(path);
+    if (it != index_.end()) {
+        node_ptr node = it->second.lock();
+        if (node && at_path(node.get(), defs, path)) {
+            hits_++;
+            return node;
+        }
+    }
+    misses_++;
+    return node_ptr();
+}
+
+void NodePathIndex::add(const std::string& path, const node_ptr& node) {
+    index_[path] = node;
+}
+
+} // namespace ecf
@@ -0,0 +1,79 @@
+#ifndef NODE_PATH_INDEX_HPP_
+#define NODE_PATH_INDEX_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Hash index of absolute node path to node, used by Defs::findAbsNode
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "NodeFwd.hpp"
+
+namespace ecf {
+
+// Without the index, Defs::findAbsNode splits the path, and at each level linearly searches
+// the suites/children by name. This is called for every child command (init, event, meter,
+// label, complete, ...) and many user commands. For wide families this is measurable.
+//
+// The index is filled lazily, i.e. on a miss, the node found by the search is added. The
+// nodes are held by weak pointer, and each hit is verified by walking up the parents comparing
+// the node names with the path. Hence a hit on a node that has since been deleted, replaced or
+// moved (plug), is treated as a miss. This makes the index safe on the client side, where
+// Ecf::modify_change_no() is not updated.
+//
+// On the server, the index is cleared whenever the node tree structure changes
+// (Ecf::modify_change_no), so that the stale entries do not accumulate.
+//
+// The index is *not* thread safe, it relies on the callers of findAbsNode being serialised.
+// Hence it is only enabled on the server, see Defs::enable_path_index.
+class NodePathIndex {
+public:
+    NodePathIndex() = default;
+    // The index refers to the nodes of the owning defs, hence a copy starts empty.
+    NodePathIndex(const NodePathIndex&) {}
+    NodePathIndex& operator=(const NodePathIndex&) {
+        clear();
+        return *this;
+    }
+
+    /// Return the node for the path, if the path is indexed and still refers to a node of defs
+    node_ptr find(const Defs* defs, const std::string& path);
+
+    /// Add the node found by searching the node tree
+    void add(const std::string& path, const node_ptr& node);
+
+    /// Clear the index, the entries are added on subsequent searches
+    void clear() {
+        index_.clear();
+        hits_   = 0;
+        misses_ = 0;
+    }
+
+    /// The number of indexed paths, and hits/misses since last cleared. Used in test
+    size_t size() const { return index_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    std::unordered_map<std::string, weak_node_ptr> index_;
+    unsigned int modify_change_no_{0}; // Ecf::modify_change_no() when index last cleared
+    size_t hits_{0};
+    size_t misses_{0};
+};
+
+} // namespace ecf
+
+#endif
@@ -13,6 +13,7 @@
 // Description :
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
+#include "ChangeJournal.hpp"
 #include "CmdContext.hpp"
 #include "Suite.hpp"
 #include "SuiteChanged.hpp"
@@ -27,6 +28,7 @@ using namespace boost::posix_time;
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 void Node::do_requeue_time_attrs(bool reset_next_time_slot, bool reset_relative_duartion, Requeue_args::Requeue_t rt) {
+    NodeChanged changed(this);
     // must be done before the re-queue
     if (reset_relative_duartion) {
         for (auto& cron : crons_) {
@@ -98,6 +100,7 @@ void Node::do_requeue_time_attrs(bool reset_next_time_slot, bool reset_relative_
 }
 
 bool Node::calendar_changed_timeattrs(const ecf::Calendar& c, Node::Calendar_args& cal_args) {
+    NodeChanged changed(this);
 #ifdef DEBUG_DAY
     cout << "Node::calendar_changed_timeattrs " << debugNodePath() << " " << c.suite_time_str() << "\n";
 #endif
@@ -361,6 +364,7 @@ void Node::markHybridTimeDependentsAsComplete() {
 // #define DEBUG_REQUEUE 1
 // #include "Log.hpp"
 bool Node::testTimeDependenciesForRequeue() {
+    NodeChanged changed(this);
     // This function is called as a part of handling state change.
     // We only get here if the Node has *COMPLETED* ( either automatically, or manually i.e force complete)
     // We are now determining if the node should be re-queued due to time dependency in the *FUTURE*
@@ -541,6 +545,7 @@ void Node::miss_next_time_slot() {
 }
 
 void Node::freeHoldingDateDependencies() {
+    NodeChanged changed(this);
     // Multiple time dependencies of the same type are *ORed*
     // Multiple time dependencies of different types are *ANDed*
     //
@@ -556,6 +561,7 @@ void Node::freeHoldingDateDependencies() {
 }
 
 void Node::freeHoldingTimeDependencies() {
+    NodeChanged changed(this);
     // Multiple time dependencies of the same type are *ORed*
     // Multiple time dependencies of different types are *ANDed*
     //
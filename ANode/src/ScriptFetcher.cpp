@@ -0,0 +1,240 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "ScriptFetcher.hpp"
+
+#include <algorithm>
+#include <csignal>
+
+#include <sys/wait.h> // for WIFEXITED
+
+#include "System.hpp"
+
+namespace {
+
+// Output that was not released, i.e. task suspended or deleted whilst its script was fetched
+const int EXPIRE_OUTPUT_SECONDS = 600;
+
+boost::posix_time::ptime now() {
+    return boost::posix_time::microsec_clock::universal_time();
+}
+
+} // namespace
+
+ScriptFetcher& ScriptFetcher::instance() {
+    static ScriptFetcher the_fetcher;
+    return the_fetcher;
+}
+
+ScriptFetcher::Status ScriptFetcher::fetch(const std::string& cmd,
+                                           const std::string& task_path,
+                                           std::vector<std::string>& lines,
+                                           std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(cmd);
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        if (entry.running_) {
+            pending_tasks_[task_path] = cmd;
+            return PENDING;
+        }
+        if (entry.ok_) {
+            lines = entry.lines_;
+            return AVAILABLE;
+        }
+        // The next request re-runs the command
+        reason = entry.reason_;
+        entries_.erase(it);
+        return FAILED;
+    }
+
+    if (running_ >= max_fetches_) {
+        pending_tasks_[task_path] = cmd;
+        return PENDING;
+    }
+
+    std::string errorMsg;
+    pid_t pid = ecf::System::instance()->spawn_fetch(cmd, errorMsg);
+    if (pid == -1) {
+        reason = errorMsg;
+        return FAILED;
+    }
+
+    Entry& entry = entries_[cmd];
+    entry.start_ = now();
+    entry.pid_   = pid;
+    running_++;
+    pending_tasks_[task_path] = cmd;
+    return PENDING;
+}
+
+ScriptFetcher::Status ScriptFetcher::fetch_available(const std::string& cmd,
+                                                     std::vector<std::string>& lines,
+                                                     std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(cmd);
+    if (it == entries_.end() || it->second.running_)
+        return PENDING;
+
+    if (it->second.ok_) {
+        lines = it->second.lines_;
+        return AVAILABLE;
+    }
+    // As fetch(), the next request re-runs the command
+    reason = it->second.reason_;
+    entries_.erase(it);
+    return FAILED;
+}
+
+bool ScriptFetcher::pending(const std::string& task_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_tasks_.find(task_path);
+    if (it == pending_tasks_.end())
+        return false;
+
+    auto entry = entries_.find(it->second);
+    if (entry != entries_.end() ? entry->second.running_ : running_ >= max_fetches_)
+        return true;
+
+    // The output is available, the command failed, or it can now be started. Let job creation try again
+    pending_tasks_.erase(it);
+    return false;
+}
+
+void ScriptFetcher::release(const std::string& cmd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(cmd);
+    if (it != entries_.end() && !it->second.running_)
+        entries_.erase(it);
+}
+
+void ScriptFetcher::fetched(const std::string& cmd, int status, const std::string& output) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(cmd);
+    if (it == entries_.end() || !it->second.running_)
+        return; // cleared
+
+    Entry& entry   = it->second;
+    entry.end_     = now();
+    entry.running_ = false;
+    running_--;
+
+    if (entry.timed_out_) {
+        entry.reason_ = "timed out after " + std::to_string(timeout_) + " seconds";
+        timeouts_++;
+    }
+    else if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        entry.ok_ = true;
+        size_t pos = 0;
+        while (pos < output.size()) {
+            size_t end = output.find('\n', pos);
+            if (end == std::string::npos)
+                end = output.size();
+            entry.lines_.emplace_back(output, pos, end - pos);
+            pos = end + 1;
+        }
+    }
+    else if (WIFEXITED(status)) {
+        entry.reason_ = "non-zero exit " + std::to_string(WEXITSTATUS(status));
+    }
+    else {
+        entry.reason_ = "child process terminated by signal " + std::to_string(WTERMSIG(status));
+    }
+    add_fetch((entry.end_ - entry.start_).total_milliseconds(), entry.ok_);
+}
+
+void ScriptFetcher::check() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    boost::posix_time::ptime time_now = now();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        Entry& entry = it->second;
+        if (entry.running_) {
+            if (timeout_ > 0 && !entry.timed_out_ && (time_now - entry.start_).total_seconds() >= timeout_) {
+                // The termination is handled by System::processTerminatedChildren
+                ::kill(entry.pid_, SIGKILL);
+                entry.timed_out_ = true;
+            }
+        }
+        else if ((time_now - entry.end_).total_seconds() >= EXPIRE_OUTPUT_SECONDS) {
+            it = entries_.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    // Forget the tasks, whose command has expired, or could have been started. i.e. task suspended or deleted
+    for (auto it = pending_tasks_.begin(); it != pending_tasks_.end();) {
+        if (entries_.find(it->second) == entries_.end() && running_ < max_fetches_)
+            it = pending_tasks_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ScriptFetcher::add_sync_fetch(size_t latency_ms, bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    add_fetch(latency_ms, ok);
+}
+
+void ScriptFetcher::add_fetch(size_t latency_ms, bool ok) {
+    fetches_++;
+    if (!ok)
+        failures_++;
+    latency_ms_ += latency_ms;
+    max_latency_ms_ = std::max<std::uint64_t>(max_latency_ms_, latency_ms);
+}
+
+void ScriptFetcher::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Running commands are still reaped by System, their output is then ignored
+    entries_.clear();
+    pending_tasks_.clear();
+    running_        = 0;
+    fetches_        = 0;
+    failures_       = 0;
+    timeouts_       = 0;
+    latency_ms_     = 0;
+    max_latency_ms_ = 0;
+}
+
+size_t ScriptFetcher::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+std::uint64_t ScriptFetcher::fetches() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fetches_;
+}
+
+std::uint64_t ScriptFetcher::failures() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failures_;
+}
+
+std::uint64_t ScriptFetcher::timeouts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timeouts_;
+}
+
+std::uint64_t ScriptFetcher::latency_ms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latency_ms_;
+}
+
+std::uint64_t ScriptFetcher::max_latency_ms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_latency_ms_;
+}
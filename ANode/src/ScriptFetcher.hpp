@@ -0,0 +1,135 @@
+#ifndef SCRIPT_FETCHER_HPP_
+#define SCRIPT_FETCHER_HPP_
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Asynchronous retrieval of scripts, via ECF_FETCH and ECF_SCRIPT_CMD
+//
+// Without this, the fetch command is run with popen(), during job generation. A slow
+// fetch (i.e. from a remote version control system) then blocks the server.
+//
+// When enabled (JobsParam::async_fetch()), the first request for a command spawns it
+// in the background, and the task stays queued. The command is spawned and reaped by
+// ecf::System, in the same way as ECF_JOB_CMD, i.e. its termination is only handled in
+// System::processTerminatedChildren, at the end of job generation. Hence the output is
+// available on a later traversal, when the task is re-submitted.
+//
+// The number of commands running at once is limited, further requests are left pending.
+// Commands that run for longer than the timeout are killed, and the request fails.
+//
+// The tasks waiting for a command are recorded, hence a task can check it is still waiting,
+// before its try number is incremented, and its state is reset for a new job.
+//
+// The output of a command is kept, until released by a successful (or failed) job creation.
+// Each job creation therefore uses a fresh fetch, as with popen(). Output that is not
+// released (i.e. the task was suspended or deleted, whilst its script was fetched) expires.
+//
+// The commands are only started on the main thread. When the job files are created in parallel
+// (ECF_JOB_THREADS), the job creation threads only use the output of completed commands. A task,
+// whose command is not yet available, stays queued, and the command is started on the main thread,
+// when the deferred job is submitted. See Submittable::submit_deferred_job. The statistics are also
+// updated by synchronous fetches, which may run on the job creation threads, hence the mutex.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h> // for pid_t
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+class ScriptFetcher {
+private:
+    ScriptFetcher(const ScriptFetcher&)                  = delete;
+    const ScriptFetcher& operator=(const ScriptFetcher&) = delete;
+
+public:
+    static ScriptFetcher& instance();
+
+    enum Status { AVAILABLE, PENDING, FAILED };
+
+    /// Return AVAILABLE and the output of the command, if it has completed successfully.
+    /// Return PENDING, if the command was started, is still running, or too many commands are running.
+    /// Return FAILED and the reason, if the command failed, or timed out.
+    /// The task_path is recorded, for a PENDING command. See pending()
+    Status fetch(const std::string& cmd,
+                 const std::string& task_path,
+                 std::vector<std::string>& lines,
+                 std::string& reason);
+
+    /// As fetch(), but never starts the command, PENDING is returned instead, and the task is not recorded.
+    /// Used on the job creation threads, since commands are only started on the main thread.
+    Status fetch_available(const std::string& cmd, std::vector<std::string>& lines, std::string& reason);
+
+    /// Return true if the task is still waiting for a command, that is running, or waiting to be started
+    bool pending(const std::string& task_path);
+
+    /// The output of the command is no longer needed
+    void release(const std::string& cmd);
+
+    /// Called by System, when the command has terminated. status is from waitpid
+    void fetched(const std::string& cmd, int status, const std::string& output);
+
+    /// Kill the commands that have timed out, and expire output that was not released.
+    /// Called at the start of job generation.
+    void check();
+
+    /// Record the latency of a synchronous fetch (popen)
+    void add_sync_fetch(size_t latency_ms, bool ok);
+
+    /// The maximum number of commands run at once, and timeout in seconds (0 means no timeout)
+    void set_max_fetches(size_t n) { max_fetches_ = n; }
+    void set_timeout(int seconds) { timeout_ = seconds; }
+
+    void clear();
+
+    size_t running() const;
+    std::uint64_t fetches() const;
+    std::uint64_t failures() const;
+    std::uint64_t timeouts() const;
+    std::uint64_t latency_ms() const; // total, of all fetches
+    std::uint64_t max_latency_ms() const;
+
+private:
+    ScriptFetcher() = default;
+    void add_fetch(size_t latency_ms, bool ok);
+
+    struct Entry
+    {
+        boost::posix_time::ptime start_;
+        boost::posix_time::ptime end_;
+        std::vector<std::string> lines_;
+        std::string reason_; // why the command failed
+        pid_t pid_{-1};
+        bool running_{true};
+        bool ok_{false};
+        bool timed_out_{false};
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<std::string, std::string> pending_tasks_; // task path, command
+    size_t running_{0};
+    size_t max_fetches_{8};
+    int timeout_{60};
+    std::uint64_t fetches_{0};
+    std::uint64_t failures_{0};
+    std::uint64_t timeouts_{0};
+    std::uint64_t latency_ms_{0};
+    std::uint64_t max_latency_ms_{0};
+};
+
+#endif
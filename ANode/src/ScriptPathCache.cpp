@@ -0,0 +1,75 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include "ScriptPathCache.hpp"
+
+ScriptPathCache& ScriptPathCache::instance() {
+    static ScriptPathCache the_cache;
+    return the_cache;
+}
+
+void ScriptPathCache::set_negative_ttl(int seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    negative_ttl_ = seconds;
+}
+
+bool ScriptPathCache::find(const std::string& key, Location& location) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        if (!it->second.location_.path_.empty() || time(nullptr) < it->second.expires_) {
+            location = it->second.location_;
+            hits_++;
+            return true;
+        }
+        cache_.erase(it);
+    }
+    misses_++;
+    return false;
+}
+
+void ScriptPathCache::add(const std::string& key, const Location& location) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (location.path_.empty() && negative_ttl_ == 0)
+        return;
+    Entry& entry    = cache_[key];
+    entry.location_ = location;
+    entry.expires_  = time(nullptr) + negative_ttl_;
+}
+
+void ScriptPathCache::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.erase(key);
+}
+
+void ScriptPathCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
+
+size_t ScriptPathCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t ScriptPathCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t ScriptPathCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
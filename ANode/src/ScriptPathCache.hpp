@@ -0,0 +1,94 @@
+#ifndef SCRIPT_PATH_CACHE_HPP_
+#define SCRIPT_PATH_CACHE_HPP_
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Cache of the resolved location of scripts and include files
+//
+// Locating the script of a task checks ECF_SCRIPT, then searches ECF_FILES and ECF_HOME,
+// (prune_root or prune_leaf) and each %include <file> searches the ECF_INCLUDE directories.
+// Each candidate is a stat(), which is slow on network file systems, and is repeated
+// for every job.
+//
+// The key of a script holds the task path, ECF_SCRIPT, ECF_FILES (variable substituted),
+// ECF_HOME, ECF_FILES_LOOKUP and the extension. The key of an include file holds each of
+// its candidate paths, in search order, hence is shared by tasks with the same ECF_INCLUDE.
+//
+// A cached location is checked to exist before it is used (a single stat), otherwise it
+// is removed and the search repeated. A failed search is cached for negative_ttl seconds.
+// A new file, that would be found earlier in the search, is only picked up once the
+// cache is cleared (ecflow_client --clear_path_cache).
+//
+// Disabled by default. Used by job creation, which may run on several threads.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "EcfFile.hpp"
+
+class ScriptPathCache {
+private:
+    ScriptPathCache(const ScriptPathCache&)                  = delete;
+    const ScriptPathCache& operator=(const ScriptPathCache&) = delete;
+
+public:
+    struct Location
+    {
+        std::string path_;   // empty if the search failed
+        std::string reason_; // why the search failed
+        EcfFile::Origin origin_{EcfFile::ECF_SCRIPT};
+        EcfFile::EcfFileSearchAlgorithm search_algo_{EcfFile::PRUNE_ROOT};
+    };
+
+    static ScriptPathCache& instance();
+
+    void enable(bool f) { enabled_ = f; }
+    bool enabled() const { return enabled_; }
+
+    /// The number of seconds a failed search is cached. 0 means failed searches are not cached
+    void set_negative_ttl(int seconds);
+
+    /// Return true and the location, if the key is cached. Failed searches expire after negative_ttl
+    bool find(const std::string& key, Location& location);
+
+    void add(const std::string& key, const Location& location);
+    void remove(const std::string& key);
+
+    /// Invalidate all the cached locations
+    void clear();
+
+    size_t hits() const;
+    size_t misses() const;
+    size_t size() const;
+
+private:
+    ScriptPathCache() = default;
+
+    struct Entry
+    {
+        Location location_;
+        time_t expires_{0}; // failed searches only
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> cache_;
+    int negative_ttl_{60};
+    bool enabled_{false};
+    size_t hits_{0};
+    size_t misses_{0};
+};
+
+#endif
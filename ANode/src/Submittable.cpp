@@ -15,6 +15,7 @@
 
 #include "Submittable.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -27,10 +28,13 @@
 #include "Extract.hpp"
 #include "File.hpp"
 #include "JobCreationCtrl.hpp"
+#include "JobProfiler.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
 #include "Memento.hpp"
 #include "Passwd.hpp"
+#include "ScriptFetcher.hpp"
+#include "ScriptPathCache.hpp"
 #include "Serialization.hpp"
 #include "Str.hpp"
 #include "System.hpp"
@@ -122,7 +126,7 @@ void Submittable::aborted(const std::string& reason) {
 void Submittable::set_process_or_remote_id(const std::string& id) {
     rid_ = id;
     set_genvar_ecfrid(rid_);
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG
     if (tryNo_ == 0 && rid_ != Submittable::DUMMY_PROCESS_OR_REMOTE_ID()) {
@@ -350,16 +354,80 @@ EcfFile Submittable::locatedEcfFile() const {
 
     const Variable& genvar_ecfscript = get_genvar_ecfscript();
 
+    // Count the file system look ups, made to locate the script
+    size_t probes = 0;
+    struct RecordProbes
+    {
+        const size_t& probes_;
+        ~RecordProbes() { JobProfiler::add_file_probes(false, probes_); }
+    } record_probes{probes};
+
+    // Use the location found by a previous search, that still exists. A cached failure is only
+    // reported after checking ECF_FETCH and ECF_SCRIPT_CMD, which do not require a look up
+    ScriptPathCache& path_cache = ScriptPathCache::instance();
+    std::string path_cache_key;
+    ScriptPathCache::Location cached;
+    bool is_cached = false;
+    if (path_cache.enabled()) {
+        std::string ecf_files, ecf_files_lookup;
+        findParentUserVariableValue(Str::ECF_FILES(), ecf_files);
+        variableSubsitution(ecf_files);
+        findParentUserVariableValue("ECF_FILES_LOOKUP", ecf_files_lookup);
+        path_cache_key = theAbsNodePath;
+        path_cache_key += '\n';
+        path_cache_key += genvar_ecfscript.theValue();
+        path_cache_key += '\n';
+        path_cache_key += ecf_files;
+        path_cache_key += '\n';
+        path_cache_key += ecf_home;
+        path_cache_key += '\n';
+        path_cache_key += ecf_files_lookup;
+        path_cache_key += '\n';
+        path_cache_key += script_extension();
+        is_cached = path_cache.find(path_cache_key, cached);
+        if (is_cached && !cached.path_.empty()) {
+            probes++;
+            if (!fs::exists(cached.path_)) {
+                path_cache.remove(path_cache_key);
+                is_cached = false;
+            }
+        }
+    }
+    auto located = [&](const std::string& path, EcfFile::Origin origin, EcfFile::EcfFileSearchAlgorithm algo) {
+        if (!path_cache_key.empty()) {
+            ScriptPathCache::Location location;
+            location.path_        = path;
+            location.origin_      = origin;
+            location.search_algo_ = algo;
+            path_cache.add(path_cache_key, location);
+        }
+        return EcfFile(const_cast<Submittable*>(this), path, origin, algo);
+    };
+    auto is_directory = [&probes](const std::string& dir) {
+        probes++;
+        return fs::is_directory(dir);
+    };
+
 #ifdef DEBUG_TASK_LOCATION
     std::cout << "Submittable::locatedEcfFile() Submittable " << name() << " searching ECF_SCRIPT = '"
               << genvar_ecfscript.theValue() << "'\n";
 #endif
-    if (fs::exists(genvar_ecfscript.theValue())) {
+    bool ecf_script_exists = false;
+    if (is_cached) {
+        ecf_script_exists = !cached.path_.empty() && cached.origin_ == EcfFile::ECF_SCRIPT;
+    }
+    else {
+        probes++;
+        ecf_script_exists = fs::exists(genvar_ecfscript.theValue());
+    }
+    if (ecf_script_exists) {
 #ifdef DEBUG_TASK_LOCATION
         std::cout << "Submittable::locatedEcfFile() Submittable " << name() << " ECF_SCRIPT = '"
                   << genvar_ecfscript.theValue() << "' exists\n";
 #endif
-        return EcfFile(const_cast<Submittable*>(this), genvar_ecfscript.theValue(), EcfFile::ECF_SCRIPT);
+        if (is_cached)
+            return EcfFile(const_cast<Submittable*>(this), genvar_ecfscript.theValue(), EcfFile::ECF_SCRIPT);
+        return located(genvar_ecfscript.theValue(), EcfFile::ECF_SCRIPT, EcfFile::PRUNE_ROOT);
     }
     else {
         reasonEcfFileNotFound += "   ECF_SCRIPT(";
@@ -410,6 +478,12 @@ EcfFile Submittable::locatedEcfFile() const {
         reasonEcfFileNotFound += "   Variable ECF_SCRIPT_CMD not defined:\n";
     }
 
+    if (is_cached) {
+        if (cached.path_.empty())
+            throw std::runtime_error(cached.reason_);
+        return EcfFile(const_cast<Submittable*>(this), cached.path_, cached.origin_, cached.search_algo_);
+    }
+
     EcfFile::EcfFileSearchAlgorithm file_search_algo = EcfFile::PRUNE_ROOT;
     std::string ecf_files_lookup;
     if (findParentUserVariableValue("ECF_FILES_LOOKUP", ecf_files_lookup)) {
@@ -423,14 +497,14 @@ EcfFile Submittable::locatedEcfFile() const {
         std::cout << "Submittable::locatedEcfFile() Submittable " << name() << " searching ECF_FILES = '"
                   << ecf_filesDirectory << "' backwards\n";
 #endif
-        if (!ecf_filesDirectory.empty() && fs::is_directory(ecf_filesDirectory)) {
+        if (!ecf_filesDirectory.empty() && is_directory(ecf_filesDirectory)) {
             // If File::backwardSearch fails it returns an empty string, i.e failure to locate script (Task/.ecf ||
             // Alias/.usr) file
             std::string searchResult;
             if (file_search_algo == EcfFile::PRUNE_ROOT)
-                searchResult = File::backwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension());
+                searchResult = File::backwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension(), &probes);
             else
-                searchResult = File::forwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension());
+                searchResult = File::forwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension(), &probes);
             if (searchResult.empty()) {
                 reasonEcfFileNotFound += "   Search of directory ECF_FILES(";
                 reasonEcfFileNotFound += ecf_filesDirectory;
@@ -441,20 +515,22 @@ EcfFile Submittable::locatedEcfFile() const {
                     reasonEcfFileNotFound += "using prune_leaf:\n";
             }
             else
-                return EcfFile(const_cast<Submittable*>(this), searchResult, EcfFile::ECF_FILES, file_search_algo);
+                return located(searchResult, EcfFile::ECF_FILES, file_search_algo);
         }
         else {
             // Before failing try again but with variable Subsitution. ECFLOW-788
             std::string original_ecf_filesDirectory = ecf_filesDirectory;
             variableSubsitution(ecf_filesDirectory);
-            if (!ecf_filesDirectory.empty() && fs::is_directory(ecf_filesDirectory)) {
+            if (!ecf_filesDirectory.empty() && is_directory(ecf_filesDirectory)) {
                 // If search fails it returns an empty string, i.e failure to locate script (Task/.ecf || Alias/.usr)
                 // file
                 std::string searchResult;
                 if (file_search_algo == EcfFile::PRUNE_ROOT)
-                    searchResult = File::backwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension());
+                    searchResult =
+                        File::backwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension(), &probes);
                 else
-                    searchResult = File::forwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension());
+                    searchResult =
+                        File::forwardSearch(ecf_filesDirectory, theAbsNodePath, script_extension(), &probes);
                 if (searchResult.empty()) {
                     std::stringstream ss;
                     ss << "   Search of directory ECF_FILES(variable substituted)(" << ecf_filesDirectory
@@ -462,7 +538,7 @@ EcfFile Submittable::locatedEcfFile() const {
                     reasonEcfFileNotFound += ss.str();
                 }
                 else
-                    return EcfFile(const_cast<Submittable*>(this), searchResult, EcfFile::ECF_FILES, file_search_algo);
+                    return located(searchResult, EcfFile::ECF_FILES, file_search_algo);
             }
             else {
                 std::stringstream ss;
@@ -482,13 +558,13 @@ EcfFile Submittable::locatedEcfFile() const {
     std::cout << "Submittable::locatedEcfFile() Submittable " << name() << " searching ECF_HOME = '" << ecf_home
               << "' backwards\n";
 #endif
-    if (!ecf_home.empty() && fs::is_directory(ecf_home)) {
+    if (!ecf_home.empty() && is_directory(ecf_home)) {
         // If search fails it returns an empty string, i.e failure to locate script (Task/.ecf || Alias/.usr) file
         std::string searchResult;
         if (file_search_algo == EcfFile::PRUNE_ROOT)
-            searchResult = File::backwardSearch(ecf_home, theAbsNodePath, script_extension());
+            searchResult = File::backwardSearch(ecf_home, theAbsNodePath, script_extension(), &probes);
         else
-            searchResult = File::forwardSearch(ecf_home, theAbsNodePath, script_extension());
+            searchResult = File::forwardSearch(ecf_home, theAbsNodePath, script_extension(), &probes);
         if (searchResult.empty()) {
             reasonEcfFileNotFound += "   Search of directory ECF_HOME(";
             reasonEcfFileNotFound += ecf_home;
@@ -499,7 +575,7 @@ EcfFile Submittable::locatedEcfFile() const {
                 reasonEcfFileNotFound += "using prune_leaf:\n";
         }
         else {
-            return EcfFile(const_cast<Submittable*>(this), searchResult, EcfFile::ECF_HOME, file_search_algo);
+            return located(searchResult, EcfFile::ECF_HOME, file_search_algo);
         }
     }
     else {
@@ -513,12 +589,17 @@ EcfFile Submittable::locatedEcfFile() const {
     error_msg += theAbsNodePath;
     error_msg += " cannot be found:\n";
     error_msg += reasonEcfFileNotFound;
+    if (!path_cache_key.empty()) {
+        ScriptPathCache::Location failed;
+        failed.reason_ = error_msg;
+        path_cache.add(path_cache_key, failed);
+    }
     throw std::runtime_error(error_msg);
 }
 
 void Submittable::set_jobs_password(const std::string& p) {
     paswd_           = p;
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 
 #ifdef DEBUG_STATE_CHANGE_NO
     std::cout << "Submittable::set_jobs_password\n";
@@ -538,7 +619,7 @@ void Submittable::increment_try_no() {
     rid_.clear();
     abr_.clear();
     paswd_           = Passwd::generate();
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
     update_generated_variables();
 }
 
@@ -546,7 +627,7 @@ void Submittable::clear() {
     abr_.clear();   // reset reason aborted
     paswd_.clear(); // reset password, it will be regenerated before submission
     rid_.clear();   // reset process id
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 }
 
 bool Submittable::submitJob(JobsParam& jobsParam) {
@@ -595,11 +676,29 @@ bool Submittable::submit_job_only(JobsParam& jobsParam) {
 }
 
 bool Submittable::script_based_job_submission(JobsParam& jobsParam) {
+    if (jobsParam.defer_job_creation()) {
+        // The job file is created later, in parallel with the other free tasks. See Jobs::generate
+        // Consume the limits now, since this affects whether subsequent tasks are free
+        std::set<Limit*> limitSet;
+        incrementInLimit(limitSet);
+
+        // The generated variables are created on demand. Create them now, since the job file is
+        // created on a worker thread, which must only read the node tree
+        for (Node* parent = this->parent(); parent; parent = parent->parent())
+            (void)parent->findGenVariable(Str::EMPTY());
+
+        jobsParam.push_back_deferred(this);
+        return true;
+    }
+
     try {
         // Locate the ecf files corresponding to the task.
         // Assign lifetime of EcfFile to JobsParam.
         // Minimise memory allocation/deallocation with Job lines and allow include file caching
-        jobsParam.set_ecf_file(locatedEcfFile());
+        {
+            JobProfiler::PhaseTimer locate(JobProfiler::LOCATE);
+            jobsParam.set_ecf_file(locatedEcfFile());
+        }
 
         // Pre-process ecf file (i.e expand includes, remove comments,manual) and perform
         // variable substitution. This will then form the '.job' files.
@@ -611,34 +710,106 @@ bool Submittable::script_based_job_submission(JobsParam& jobsParam) {
             //... make sure ECF_PASS is set on the task, This is substituted in <head.h> file
             //... and hence must be done before variable substitution in ECF_/JOB file
             //... This is used by client->server authentication
-            if (createChildProcess(jobsParam)) {
-                set_state(NState::SUBMITTED, false, job_size);
-                return true;
-            }
-            // Fall through job submission failed.
+            return submit_created_job(jobsParam, job_size);
         }
         catch (std::exception& e) {
-            flag().set(ecf::Flag::EDIT_FAILED);
-            std::string reason = "Submittable::submit_job_only: Job creation failed for task ";
-            reason += absNodePath();
-            reason += " : \n   ";
-            reason += e.what();
-            reason += "\n";
-            jobsParam.errorMsg() += reason;
-            set_aborted_only(reason);
+            if (jobsParam.ecf_file().fetch_pending()) {
+                script_fetch_pending(jobsParam);
+                return false;
+            }
+            job_creation_failed(jobsParam, e.what());
             return false;
         }
     }
     catch (std::exception& e) {
-        flag().set(ecf::Flag::NO_SCRIPT);
-        std::stringstream ss;
-        ss << "Submittable::submit_job_only: Script location failed for task " << absNodePath() << " :\n"
-           << e.what() << "\n";
-        jobsParam.errorMsg() += ss.str();
-        set_aborted_only(e.what()); // remember jobsParam.errorMsg() is accumulated
+        script_location_failed(jobsParam, e.what());
         return false;
     }
+}
+
+void Submittable::create_deferred_job(DeferredJob& job, const JobsParam& jobsParam) const {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+    JobsParam job_param(jobsParam.submitJobsInterval(), true /*createJobs*/, false /*spawn jobs*/);
+    job_param.set_use_script_cache(jobsParam.use_script_cache());
+    job_param.set_async_fetch(jobsParam.async_fetch());
+    job_param.set_job_creation_thread(true);
+    try {
+        EcfFile ecf_file = [this]() {
+            JobProfiler::PhaseTimer locate(JobProfiler::LOCATE);
+            return locatedEcfFile();
+        }();
+        try {
+            job.job_size_ = ecf_file.create_job(job_param);
+            job.result_   = DeferredJob::CREATED;
+        }
+        catch (std::exception& e) {
+            if (ecf_file.fetch_pending()) {
+                job.result_    = DeferredJob::FETCH_PENDING;
+                job.fetch_cmd_ = ecf_file.pending_fetch_cmd();
+            }
+            else {
+                job.result_ = DeferredJob::EDIT_FAILED;
+            }
+            job.reason_ = e.what();
+        }
+    }
+    catch (std::exception& e) {
+        job.result_ = DeferredJob::NO_SCRIPT;
+        job.reason_ = e.what();
+    }
+    job.error_msg_  = job_param.getErrorMsg();
+    job.time_taken_ = (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds();
+}
+
+bool Submittable::submit_deferred_job(JobsParam& jobsParam, const DeferredJob& job) {
+    jobsParam.errorMsg() += job.error_msg_;
+
+    Task* task = isTask();
+    if (task && job.time_taken_ > JobProfiler::task_threshold())
+        JobProfiler::task_threshold_exceeded(task, job.time_taken_, JobProfiler::task_threshold());
+
+    switch (job.result_) {
+        case DeferredJob::CREATED:
+            return submit_created_job(jobsParam, job.job_size_);
+        case DeferredJob::EDIT_FAILED:
+            job_creation_failed(jobsParam, job.reason_);
+            break;
+        case DeferredJob::NO_SCRIPT:
+            script_location_failed(jobsParam, job.reason_);
+            break;
+        case DeferredJob::FETCH_PENDING:
+            deferred_fetch_pending(jobsParam, job);
+            break;
+    }
+    return false;
+}
+
+void Submittable::deferred_fetch_pending(JobsParam& jobsParam, const DeferredJob& job) {
+    // The fetch command could not be started on the job creation thread. Start it now
+    std::vector<std::string> lines;
+    std::string reason;
+    if (ScriptFetcher::instance().fetch(job.fetch_cmd_, absNodePath(), lines, reason) == ScriptFetcher::FAILED) {
+        job_creation_failed(jobsParam, reason + " : via cmd " + job.fetch_cmd_);
+        return;
+    }
+
+    // Stay queued, as on the main thread. The output may already be available, the job is then
+    // created on the next job generation. Give back the limits consumed, when the job was deferred
+    std::set<Limit*> limitSet;
+    decrementInLimit(limitSet);
+    if (job.submit_state_saved_)
+        restore_submit_state(job.submit_state_);
+    script_fetch_pending(jobsParam);
+}
+
+bool Submittable::submit_created_job(JobsParam& jobsParam, const std::string& job_size) {
+    if (createChildProcess(jobsParam, true /* job file */)) {
+        set_state(NState::SUBMITTED, false, job_size);
+        return true;
+    }
 
+    // Fall through job submission failed.
     flag().set(ecf::Flag::JOBCMD_FAILED);
     std::string reason = " Job creation failed for task ";
     reason += absNodePath();
@@ -648,6 +819,58 @@ bool Submittable::script_based_job_submission(JobsParam& jobsParam) {
     return false;
 }
 
+void Submittable::script_fetch_pending(JobsParam& jobsParam) {
+    // The script (ECF_FETCH/ECF_SCRIPT_CMD) is still being fetched in the background. Stay queued, the
+    // job is created on a later traversal. The caller restores the state, see restore_submit_state()
+    jobsParam.add_pending_submission();
+}
+
+void Submittable::save_submit_state(SubmitState& s) const {
+    s.paswd_           = paswd_;
+    s.rid_             = rid_;
+    s.abr_             = abr_;
+    s.flag_            = get_flag();
+    s.tryNo_           = tryNo_;
+    s.state_change_no_ = state_change_no_;
+}
+
+void Submittable::restore_submit_state(const SubmitState& s) {
+    // The job was not submitted, hence nothing has changed
+    paswd_           = s.paswd_;
+    rid_             = s.rid_;
+    abr_             = s.abr_;
+    flag()           = s.flag_;
+    tryNo_           = s.tryNo_;
+    state_change_no_ = s.state_change_no_;
+    update_generated_variables();
+}
+
+void Submittable::submission_throttled(JobsParam& jobsParam) {
+    // Stay queued, the state is unchanged. The suite is resolved again by the next job generation,
+    // even when nothing else changed. See DependencyIndex
+    jobsParam.add_pending_submission();
+}
+
+void Submittable::job_creation_failed(JobsParam& jobsParam, const std::string& what) {
+    flag().set(ecf::Flag::EDIT_FAILED);
+    std::string reason = "Submittable::submit_job_only: Job creation failed for task ";
+    reason += absNodePath();
+    reason += " : \n   ";
+    reason += what;
+    reason += "\n";
+    jobsParam.errorMsg() += reason;
+    set_aborted_only(reason);
+}
+
+void Submittable::script_location_failed(JobsParam& jobsParam, const std::string& what) {
+    flag().set(ecf::Flag::NO_SCRIPT);
+    std::stringstream ss;
+    ss << "Submittable::submit_job_only: Script location failed for task " << absNodePath() << " :\n"
+       << what << "\n";
+    jobsParam.errorMsg() += ss.str();
+    set_aborted_only(what); // remember jobsParam.errorMsg() is accumulated
+}
+
 bool Submittable::non_script_based_job_submission(JobsParam& jobsParam) {
     // No script(i.e .ecf file), hence it is assumed the ECF_JOB_CMD will call:
     //  ECF_PASS=%ECF_PASS%;ECF_PORT=%ECF_PORT%;ECF_HOST=%ECF_HOST%;ECF_NAME=%ECF_NAME%;ECF_TRYNO=%ECF_TRYNO%;
@@ -656,7 +879,7 @@ bool Submittable::non_script_based_job_submission(JobsParam& jobsParam) {
     //     ecflow_client (--meter,--event,--label);
     //  ecflow_client --hcomplete
 
-    if (createChildProcess(jobsParam)) {
+    if (createChildProcess(jobsParam, false /* job file */)) {
         set_state(NState::SUBMITTED, false, Str::EMPTY() /*job size*/);
         return true;
     }
@@ -895,10 +1118,27 @@ void Submittable::status() {
     flag().set(ecf::Flag::STATUS);
 }
 
-bool Submittable::createChildProcess(JobsParam& jobsParam) {
+bool Submittable::createChildProcess(JobsParam& jobsParam, bool job_file) {
 #ifdef DEBUG_JOB_SUBMISSION
     cout << "Submittable::createChildProcess for task " << name() << endl;
 #endif
+    if (job_file) {
+        // Opt in: Jobs with the same batch command, are spawned together at the end of job generation
+        std::string ecf_job_batch_cmd;
+        findParentUserVariableValue(Str::ECF_JOB_BATCH_CMD(), ecf_job_batch_cmd);
+        if (!ecf_job_batch_cmd.empty()) {
+            if (!variableSubsitution(ecf_job_batch_cmd)) {
+                jobsParam.errorMsg() += "Submittable::createChildProcess: Variable substitution failed for "
+                                        "ECF_JOB_BATCH_CMD(" +
+                                        ecf_job_batch_cmd + ") :";
+                return false;
+            }
+            jobsParam.push_back_submittable(this);
+            jobsParam.add_to_job_batch(ecf_job_batch_cmd, this, findGenVariable(Str::ECF_JOB()).theValue());
+            return true;
+        }
+    }
+
     std::string ecf_job_cmd;
     findParentUserVariableValue(Str::ECF_JOB_CMD(), ecf_job_cmd);
     if (ecf_job_cmd.empty()) {
@@ -918,6 +1158,7 @@ bool Submittable::createChildProcess(JobsParam& jobsParam) {
     if (jobsParam.spawnJobs()) {
 
         // SPAWN process, attach signal to monitor process. returns true
+        JobProfiler::PhaseTimer spawn(JobProfiler::SPAWN);
         return System::instance()->spawn(System::ECF_JOB_CMD, ecf_job_cmd, absNodePath(), jobsParam.errorMsg());
     }
 
@@ -931,7 +1172,7 @@ void Submittable::set_aborted_only(const std::string& reason) {
 #endif
 
     abr_             = reason;
-    state_change_no_ = Ecf::incr_state_change_no();
+    state_change_no_ = incr_state_change_no();
 
     // Do not use "\n" | ';' in abr_, as this can mess up, --migrate output
     // Which would then affect --load.
@@ -984,6 +1225,11 @@ void Submittable::incremental_changes(DefsDelta& changes, compound_memento_ptr&
     Node::incremental_changes(changes, comp);
 }
 
+unsigned int Submittable::node_only_max_state_change_no() const {
+    // *make* sure this is in sync with Submittable::incremental_changes()
+    return std::max(state_change_no_, Node::node_only_max_state_change_no());
+}
+
 void Submittable::set_memento(const SubmittableMemento* memento,
                               std::vector<ecf::Aspect::Type>& aspects,
                               bool aspect_only) {
@@ -82,6 +82,41 @@ public:
     /// Will increment try no first, and then update generated varaibles
     bool submitJob(JobsParam&);
 
+    /// The state reset by increment_try_no() and submit_job_only(). Restored when the job is not
+    /// submitted, since the script is still being fetched in the background. See ScriptFetcher
+    struct SubmitState
+    {
+        std::string paswd_;
+        std::string rid_;
+        std::string abr_;
+        ecf::Flag flag_;
+        int tryNo_{0};
+        unsigned int state_change_no_{0};
+    };
+
+    /// Job creation is deferred, when the job files of the free tasks are created in parallel. See Jobs::generate
+    ///   o create_deferred_job() is called on a worker thread, hence must only read the node tree.
+    ///     The fetch commands (ECF_FETCH/ECF_SCRIPT_CMD) are not started there. See ScriptFetcher
+    ///   o submit_deferred_job() is then called for each task in turn, to spawn the job, abort the task,
+    ///     or leave it queued, whilst its script is fetched in the background
+    struct DeferredJob
+    {
+        enum Result { CREATED, NO_SCRIPT, EDIT_FAILED, FETCH_PENDING };
+        Submittable* submittable_{nullptr};
+        Result result_{CREATED};
+        std::string job_size_;
+        std::string error_msg_; // JobsParam::errorMsg(), during job creation
+        std::string reason_;    // why job creation failed
+        std::string fetch_cmd_; // FETCH_PENDING, the command to start
+        size_t time_taken_{0};  // milli seconds
+
+        // The state before the submission, restored for FETCH_PENDING. See Task::resolveDependencies
+        SubmitState submit_state_;
+        bool submit_state_saved_{false};
+    };
+    void create_deferred_job(DeferredJob&, const JobsParam&) const;
+    bool submit_deferred_job(JobsParam&, const DeferredJob&);
+
     /// generates job file independent of dependencies, resets the try Number
     void check_job_creation(job_creation_ctrl_ptr jobCtrl) override;
 
@@ -113,6 +148,7 @@ public:
 
     // Memento functions:
     void incremental_changes(DefsDelta&, compound_memento_ptr& comp) const;
+    unsigned int node_only_max_state_change_no() const override;
     void set_memento(const SubmittableMemento*, std::vector<ecf::Aspect::Type>& aspects, bool f);
 
     void read_state(const std::string& line, const std::vector<std::string>& lineTokens) override;
@@ -126,6 +162,16 @@ protected:
     /// Submits the job *WITHOUT* incrementing the try number
     bool submit_job_only(JobsParam&);
 
+    /// The job was not submitted, since the limit of jobs per job generation was reached. See JobThrottle
+    void submission_throttled(JobsParam&);
+
+    /// The job was not submitted, since the script is still being fetched in the background. See ScriptFetcher
+    void script_fetch_pending(JobsParam&);
+    void deferred_fetch_pending(JobsParam&, const DeferredJob&);
+
+    void save_submit_state(SubmitState&) const;
+    void restore_submit_state(const SubmitState&);
+
     // Overridden from Node to increment/decrement limits
     void update_limits() override;
 
@@ -138,11 +184,15 @@ private:
 
     // Use when we _only_ want to set the state,
     void set_aborted_only(const std::string& reason);
-    bool createChildProcess(JobsParam& jobsParam);
+    // job_file is false, for tasks without a script (ECF_NO_SCRIPT), these do not use ECF_JOB_BATCH_CMD
+    bool createChildProcess(JobsParam& jobsParam, bool job_file);
     void clear(); // process_id password and aborted reason
 
     bool script_based_job_submission(JobsParam& jobsParam);
     bool non_script_based_job_submission(JobsParam& jobsParam);
+    bool submit_created_job(JobsParam& jobsParam, const std::string& job_size);
+    void job_creation_failed(JobsParam& jobsParam, const std::string& what);
+    void script_location_failed(JobsParam& jobsParam, const std::string& what);
 
     void update_static_generated_variables(const std::string& ecf_home, const std::string& theAbsNodePath) const;
     const Variable& get_genvar_ecfrid() const;
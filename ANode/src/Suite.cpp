@@ -15,6 +15,7 @@
 
 #include "Suite.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -74,6 +75,8 @@ Suite& Suite::operator=(const Suite& rhs) {
 
         delete suite_gen_variables_;
         suite_gen_variables_ = nullptr;
+
+        change_journal_.invalidate();
     }
     return *this;
 }
@@ -649,24 +652,17 @@ void Suite::collateChanges(DefsDelta& changes) const {
         // *TREAT* All changes to *a* Node, in a single compound_memento_ptr
         size_t before = changes.size();
 
-        compound_memento_ptr suite_compound_mememto;
-        if (clockAttr_.get() && clockAttr_->state_change_no() > changes.client_state_change_no()) {
-            if (!suite_compound_mememto.get())
-                suite_compound_mememto = std::make_shared<CompoundMemento>(absNodePath());
-            suite_compound_mememto->add(std::make_shared<SuiteClockMemento>(*clockAttr_));
-        }
-        if (begun_change_no_ > changes.client_state_change_no()) {
-            if (!suite_compound_mememto.get())
-                suite_compound_mememto = std::make_shared<CompoundMemento>(absNodePath());
-            suite_compound_mememto->add(std::make_shared<SuiteBeginDeltaMemento>(begun_));
-        }
-
-        /// Collate NodeContainer and Node changes into *SAME* compound_memento_ptr
-        NodeContainer::incremental_changes(changes, suite_compound_mememto);
+        collate_node_changes_only(changes);
 
         // Traversal, we have finished with this node:
         // Traverse children : *SEPARATE* compound_memento_ptr created on demand
-        NodeContainer::collateChanges(changes);
+        // The change journal determines the changed nodes, without traversing every node. When the
+        // client is older than the journal, fall back to a full traversal. Note: There's no point
+        // in traversing children if we have added/removed children, since ChildrenMemento copies all.
+        if (add_remove_state_change_no_ > changes.client_state_change_no() ||
+            !change_journal_.collateChanges(this, changes)) {
+            NodeContainer::collateChanges(changes);
+        }
 
         /// *ONLY* create SuiteCalendarMemento, if something changed in the suite.
         /// *OR* if it has been specifically requested. see ECFLOW-631
@@ -685,6 +681,31 @@ void Suite::collateChanges(DefsDelta& changes) const {
     }
 }
 
+void Suite::collate_node_changes_only(DefsDelta& changes) const {
+    compound_memento_ptr suite_compound_mememto;
+    if (clockAttr_.get() && clockAttr_->state_change_no() > changes.client_state_change_no()) {
+        if (!suite_compound_mememto.get())
+            suite_compound_mememto = std::make_shared<CompoundMemento>(absNodePath());
+        suite_compound_mememto->add(std::make_shared<SuiteClockMemento>(*clockAttr_));
+    }
+    if (begun_change_no_ > changes.client_state_change_no()) {
+        if (!suite_compound_mememto.get())
+            suite_compound_mememto = std::make_shared<CompoundMemento>(absNodePath());
+        suite_compound_mememto->add(std::make_shared<SuiteBeginDeltaMemento>(begun_));
+    }
+
+    /// Collate NodeContainer and Node changes into *SAME* compound_memento_ptr
+    NodeContainer::incremental_changes(changes, suite_compound_mememto);
+}
+
+unsigned int Suite::node_only_max_state_change_no() const {
+    // *make* sure this is in sync with Suite::collate_node_changes_only()
+    unsigned int max_change_no = std::max(begun_change_no_, NodeContainer::node_only_max_state_change_no());
+    if (clockAttr_.get())
+        max_change_no = std::max(max_change_no, clockAttr_->state_change_no());
+    return max_change_no;
+}
+
 void Suite::set_memento(const SuiteClockMemento* memento, std::vector<ecf::Aspect::Type>& aspects, bool aspect_only) {
 #ifdef DEBUG_MEMENTO
     std::cout << "Suite::set_memento( const SuiteClockMemento*) " << debugNodePath() << "\n";
@@ -16,6 +16,7 @@
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
 #include "Calendar.hpp"
+#include "ChangeJournal.hpp"
 #include "ClockAttr.hpp" // IWYU pragma: keep
 #include "NodeContainer.hpp"
 
@@ -86,10 +87,15 @@ public:
     clock_ptr clockAttr() const { return clockAttr_; }
     clock_ptr clock_end_attr() const { return clock_end_attr_; }
 
+    /// The journal of changed nodes, used by collateChanges()
+    ecf::ChangeJournal& change_journal() { return change_journal_; }
+
     bool checkInvariants(std::string& errorMsg) const override;
 
     // Memento functions
     void collateChanges(DefsDelta&) const override;
+    void collate_node_changes_only(DefsDelta&) const override;
+    unsigned int node_only_max_state_change_no() const override;
     void set_memento(const SuiteClockMemento*, std::vector<ecf::Aspect::Type>& aspects, bool);
     void set_memento(const SuiteBeginDeltaMemento*, std::vector<ecf::Aspect::Type>& aspects, bool);
     void set_memento(const SuiteCalendarMemento*, std::vector<ecf::Aspect::Type>& aspects, bool);
@@ -129,6 +135,7 @@ private:
     unsigned int calendar_change_no_{0}; // no need to persist,
     mutable SuiteGenVariables* suite_gen_variables_{
         nullptr}; // NOT persisted can be generated by calling update_generated_variables()
+    mutable ecf::ChangeJournal change_journal_; // NOT persisted, changed nodes used by collateChanges()
     bool begun_{false};
     friend class SuiteGenVariables;
 };
@@ -18,6 +18,7 @@
     #include <iostream>
 #endif
 
+#include "ChangeJournal.hpp"
 #include "Ecf.hpp"
 #include "Suite.hpp"
 #include "SuiteChanged.hpp"
@@ -59,6 +60,7 @@ SuiteChanged0::~SuiteChanged0() {
         }
         if (state_change_no_ != Ecf::state_change_no()) {
             suite_->set_state_change_no(Ecf::state_change_no());
+            ChangeJournal::record(node.get());
             // std::cout << "SuiteChanged0::~SuiteChanged0() state changed \n";
         }
     }
@@ -66,7 +68,8 @@ SuiteChanged0::~SuiteChanged0() {
 
 // ============================================================================
 SuiteChangedPtr::SuiteChangedPtr(Node* s)
-    : suite_(s->suite()),
+    : node_(s),
+      suite_(s->suite()),
       state_change_no_(Ecf::state_change_no()),
       modify_change_no_(Ecf::modify_change_no()) {
 }
@@ -79,6 +82,7 @@ SuiteChangedPtr::~SuiteChangedPtr() {
         }
         if (state_change_no_ != Ecf::state_change_no()) {
             suite_->set_state_change_no(Ecf::state_change_no());
+            ChangeJournal::record(node_);
             // std::cout << "SuiteChangedPtr::~SuiteChangedPtr() state changed \n";
         }
     }
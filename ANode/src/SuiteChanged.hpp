@@ -73,6 +73,7 @@ public:
     ~SuiteChangedPtr();
 
 private:
+    Node* node_;   // caller must keep the node alive, for the lifetime of this object
     Suite* suite_; // if node is removed suite pointer is not accessible, hence store first
     unsigned int state_change_no_;
     unsigned int modify_change_no_;
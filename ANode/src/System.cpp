@@ -14,8 +14,14 @@
 //============================================================================
 #include <cerrno>
 #include <csignal>
+#include <cstring>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
 
+#include <spawn.h>    // for posix_spawn
 #include <sys/wait.h> // for waitpid
+#include <unistd.h>
 
 #ifndef O_WRONLY
     #include <fcntl.h>
@@ -23,6 +29,7 @@
 
 #include "Defs.hpp"
 #include "Log.hpp"
+#include "ScriptFetcher.hpp"
 #include "Signal.hpp"
 #include "Submittable.hpp"
 #include "SuiteChanged.hpp"
@@ -37,6 +44,15 @@
     #include <iostream>
 #endif
 
+// posix_spawn_file_actions_addclosefrom_np() is needed to close the server file descriptors in the child
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+    #if __GLIBC_PREREQ(2, 34)
+        #define ECF_HAVE_POSIX_SPAWN_CLOSEFROM 1
+    #endif
+#endif
+
+extern char** environ;
+
 using namespace std;
 
 namespace ecf {
@@ -44,6 +60,33 @@ namespace ecf {
 // ===========================================================================
 // Process
 // ===========================================================================
+// The output of a command, closed with the Process, i.e. also when the command is never reaped
+class OutputFile {
+public:
+    OutputFile() = default;
+    OutputFile(const OutputFile&)            = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+    OutputFile(OutputFile&& rhs) noexcept : fd_(rhs.fd_) { rhs.fd_ = -1; }
+    OutputFile& operator=(OutputFile&& rhs) noexcept {
+        if (this != &rhs) {
+            reset(rhs.fd_);
+            rhs.fd_ = -1;
+        }
+        return *this;
+    }
+    ~OutputFile() { reset(-1); }
+
+    void reset(int fd) {
+        if (fd_ != -1)
+            close(fd_);
+        fd_ = fd;
+    }
+    int fd() const { return fd_; }
+
+private:
+    int fd_{-1};
+};
+
 struct Process
 {
 public:
@@ -62,6 +105,13 @@ public:
     pid_t pid_;                // The process ID of this child.
     int status_;               // The status of this child; 0 if running,
                                // otherwise a status value from waitpid
+
+    // ECF_JOB_BATCH_CMD only:
+    std::vector<std::string> batch_paths_; // Path to each Task in the batch
+    std::vector<std::string> batch_jobs_;  // Job file of each Task in the batch
+    OutputFile output_;                    // unlinked temporary file, holding the stdout of the command
+
+    bool fetch_{false}; // ECF_FETCH or ECF_SCRIPT_CMD, see ScriptFetcher
 };
 std::vector<Process> processVec_;
 
@@ -99,7 +149,10 @@ void System::destroy() {
 }
 
 System::System()  = default;
-System::~System() = default;
+System::~System() {
+    // Close the output of the commands, that were not reaped
+    processVec_.clear();
+}
 
 bool System::spawn(System::CmdType cmd_type,
                    const std::string& cmdToSpawn,
@@ -139,6 +192,28 @@ int System::sys(System::CmdType cmd_type,
      |  The stdin, stdout and stderr are closed (or redirected to /dev/null)
      =  PID in case of success or 0 in case of errors.
      ************************************o*************************************/
+    pid_t child_pid = spawn_child(cmdToSpawn, errorMsg);
+    if (child_pid == -1) {
+        return 1;
+    }
+
+    // Store the process pid, so that we can wait for it. ho ho.
+    processVec_.emplace_back(absPath, cmdToSpawn, cmd_type, child_pid);
+
+#ifdef DEBUG_FORK
+    // LogToCout logToCoutAsWell;
+    LOG(Log::DBG, "   submit: Path(" << absPath << ") child_pid(" << child_pid << ") cmd(" << cmdToSpawn << ")");
+#endif
+    return 0;
+}
+
+pid_t System::spawn_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd, int stdout_fd) {
+    if (use_posix_spawn_ && posix_spawn_supported())
+        return posix_spawn_child(cmdToSpawn, errorMsg, stdin_fd, stdout_fd);
+    return fork_child(cmdToSpawn, errorMsg, stdin_fd, stdout_fd);
+}
+
+pid_t System::fork_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd, int stdout_fd) {
     pid_t child_pid;
     if ((child_pid = fork()) == 0) { /* The child */
 
@@ -147,13 +222,23 @@ int System::sys(System::CmdType cmd_type,
         if ((f = open("/dev/null", O_WRONLY)) != 2)
             close(f);
 
-        close(1);
-        if ((f = open("/dev/null", O_WRONLY)) != 1)
-            close(f);
+        if (stdout_fd != -1) {
+            dup2(stdout_fd, 1);
+        }
+        else {
+            close(1);
+            if ((f = open("/dev/null", O_WRONLY)) != 1)
+                close(f);
+        }
 
-        close(0);
-        if ((f = open("/dev/null", O_RDONLY)) != 0)
-            close(f);
+        if (stdin_fd != -1) {
+            dup2(stdin_fd, 0);
+        }
+        else {
+            close(0);
+            if ((f = open("/dev/null", O_RDONLY)) != 0)
+                close(f);
+        }
 
         // ==============================================================================
         // Ideally we should close all open file descriptors in the child process
@@ -181,17 +266,221 @@ int System::sys(System::CmdType cmd_type,
         std::stringstream ss;
         ss << "fork() error(" << strerror(errno) << ")";
         errorMsg = ss.str();
-        return 1;
     }
+    return child_pid;
+}
 
-    // Store the process pid, so that we can wait for it. ho ho.
-    processVec_.emplace_back(absPath, cmdToSpawn, cmd_type, child_pid);
+bool System::posix_spawn_supported() {
+#ifdef ECF_HAVE_POSIX_SPAWN_CLOSEFROM
+    return true;
+#else
+    return false;
+#endif
+}
 
-#ifdef DEBUG_FORK
-    // LogToCout logToCoutAsWell;
-    LOG(Log::DBG, "   submit: Path(" << absPath << ") child_pid(" << child_pid << ") cmd(" << cmdToSpawn << ")");
+pid_t System::posix_spawn_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd, int stdout_fd) {
+#ifdef ECF_HAVE_POSIX_SPAWN_CLOSEFROM
+    // Same as fork_child(), but the child does not copy the page tables of the server.
+    // The file actions are performed in the child, before exec().
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    if (stdin_fd != -1)
+        posix_spawn_file_actions_adddup2(&file_actions, stdin_fd, 0);
+    else
+        posix_spawn_file_actions_addopen(&file_actions, 0, "/dev/null", O_RDONLY, 0);
+    if (stdout_fd != -1)
+        posix_spawn_file_actions_adddup2(&file_actions, stdout_fd, 1);
+    else
+        posix_spawn_file_actions_addopen(&file_actions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&file_actions, 2, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addclosefrom_np(&file_actions, 3);
+
+    char* argv[] = {const_cast<char*>("sh"), const_cast<char*>("-c"), const_cast<char*>(cmdToSpawn.c_str()), nullptr};
+
+    pid_t child_pid = -1;
+    int err         = ::posix_spawn(&child_pid, "/bin/sh", &file_actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&file_actions);
+    if (err != 0) {
+        std::stringstream ss;
+        ss << "posix_spawn() error(" << strerror(err) << ")";
+        errorMsg = ss.str();
+        return -1;
+    }
+    return child_pid;
+#else
+    return fork_child(cmdToSpawn, errorMsg, stdin_fd, stdout_fd);
 #endif
-    return 0;
+}
+
+namespace {
+
+/// Return an unlinked temporary file, not inherited by child processes, or -1 on error
+int temporary_file(std::string& errorMsg) {
+    const char* tmp_dir = getenv("TMPDIR");
+    std::string path    = (tmp_dir && *tmp_dir) ? tmp_dir : "/tmp";
+    path += "/ecf_job_batch_XXXXXX";
+    int fd = mkostemp(&path[0], O_CLOEXEC);
+    if (fd == -1) {
+        errorMsg = "mkostemp(" + path + ") error(" + strerror(errno) + ")";
+        return -1;
+    }
+    unlink(path.c_str());
+    return fd;
+}
+
+bool write_all(int fd, const std::string& contents) {
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+std::string read_all(int fd) {
+    std::string contents;
+    char buffer[4096];
+    off_t offset = 0;
+    ssize_t n;
+    while ((n = ::pread(fd, buffer, sizeof(buffer), offset)) != 0) {
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        contents.append(buffer, n);
+        offset += n;
+    }
+    return contents;
+}
+
+} // namespace
+
+bool System::spawn_batch(const std::string& cmdToSpawn,
+                         const std::vector<std::string>& absPaths,
+                         const std::vector<std::string>& jobFiles,
+                         std::string& errorMsg) {
+    // The job files and the output of the command, are held in temporary files rather than pipes.
+    // Hence the server never blocks writing the job files, and the output is read once the command terminates.
+    std::string msg;
+    int stdin_fd = temporary_file(msg);
+    if (stdin_fd == -1) {
+        errorMsg = "Child process creation failed( " + msg + ") for command " + cmdToSpawn;
+        return false;
+    }
+    std::string job_files;
+    for (const auto& job_file : jobFiles) {
+        job_files += job_file;
+        job_files += '\n';
+    }
+    if (!write_all(stdin_fd, job_files) || lseek(stdin_fd, 0, SEEK_SET) == -1) {
+        errorMsg = "Child process creation failed( write error(" + std::string(strerror(errno)) + ")) for command " +
+                   cmdToSpawn;
+        close(stdin_fd);
+        return false;
+    }
+
+    int stdout_fd = temporary_file(msg);
+    if (stdout_fd == -1) {
+        errorMsg = "Child process creation failed( " + msg + ") for command " + cmdToSpawn;
+        close(stdin_fd);
+        return false;
+    }
+
+    pid_t child_pid = spawn_child(cmdToSpawn, msg, stdin_fd, stdout_fd);
+    close(stdin_fd);
+    if (child_pid == -1) {
+        errorMsg = "Child process creation failed( " + msg + ") for command " + cmdToSpawn;
+        close(stdout_fd);
+        return false;
+    }
+
+    processVec_.emplace_back("", cmdToSpawn, ECF_JOB_CMD, child_pid);
+    processVec_.back().batch_paths_ = absPaths;
+    processVec_.back().batch_jobs_  = jobFiles;
+    processVec_.back().output_.reset(stdout_fd);
+    return true;
+}
+
+pid_t System::spawn_fetch(const std::string& cmdToSpawn, std::string& errorMsg) {
+    std::string msg;
+    int stdout_fd = temporary_file(msg);
+    if (stdout_fd == -1) {
+        errorMsg = "Child process creation failed( " + msg + ") for command " + cmdToSpawn;
+        return -1;
+    }
+
+    pid_t child_pid = spawn_child(cmdToSpawn, msg, -1, stdout_fd);
+    if (child_pid == -1) {
+        errorMsg = "Child process creation failed( " + msg + ") for command " + cmdToSpawn;
+        close(stdout_fd);
+        return -1;
+    }
+
+    processVec_.emplace_back("", cmdToSpawn, ECF_JOB_CMD, child_pid);
+    processVec_.back().output_.reset(stdout_fd);
+    processVec_.back().fetch_ = true;
+    return child_pid;
+}
+
+void System::batch_terminated(const Process& p) {
+    std::stringstream ss;
+    ss << "ECF_JOB_BATCH_CMD PID(" << p.pid_ << ") ";
+    std::string prefix = ss.str();
+
+    if (WIFEXITED(p.status_) && WEXITSTATUS(p.status_) == 0) {
+        // The output lists the jobs that were not submitted
+        std::string output = read_all(p.output_.fd());
+        std::istringstream lines(output);
+        std::string line;
+
+        // Index the job files once, rather than searching the batch for each line of output
+        std::unordered_map<std::string_view, size_t> job_index;
+        if (!output.empty()) {
+            job_index.reserve(p.batch_jobs_.size());
+            for (size_t i = 0; i < p.batch_jobs_.size(); i++) {
+                job_index.emplace(p.batch_jobs_[i], i);
+            }
+        }
+
+        while (std::getline(lines, line)) {
+            if (line.empty())
+                continue;
+
+            // "<job file>\t<reason>" or "<job file>". The job file may contain spaces, hence only a tab
+            // separates the reason. Try the whole line first, then split at the last tab.
+            size_t end = line.size();
+            auto it    = job_index.find(line);
+            if (it == job_index.end() && (end = line.rfind('\t')) != std::string::npos)
+                it = job_index.find(std::string_view(line).substr(0, end));
+            if (it == job_index.end()) {
+                ecf::log(Log::ERR, prefix + "unexpected output, does not match a job file of the batch: " + line +
+                                       " [ " + p.cmd_ + " ]");
+                continue;
+            }
+
+            const std::string& path = p.batch_paths_[it->second];
+            std::string reason      = (end < line.size()) ? line.substr(end + 1) : std::string();
+            died(path, ECF_JOB_CMD, prefix + "path(" + path + ") job not submitted: " + reason + " [ " + p.cmd_ + " ]");
+        }
+    }
+    else {
+        std::string how;
+        if (WIFEXITED(p.status_))
+            how = "exited with status " + std::to_string(WEXITSTATUS(p.status_));
+        else
+            how = "died of signal " + std::to_string(WTERMSIG(p.status_));
+        for (const auto& path : p.batch_paths_) {
+            died(path, ECF_JOB_CMD, prefix + "path(" + path + ") " + how + " [ " + p.cmd_ + " ]");
+        }
+    }
 }
 
 static void catch_child(int sig)
@@ -262,6 +551,17 @@ void System::processTerminatedChildren() {
 
         if ((*i).have_status_) {
 
+            if ((*i).fetch_ && (WIFEXITED((*i).status_) || WIFSIGNALED((*i).status_))) {
+                ScriptFetcher::instance().fetched((*i).cmd_, (*i).status_, read_all((*i).output_.fd()));
+                processVec_.erase(i--);
+                continue;
+            }
+            if ((*i).output_.fd() != -1 && (WIFEXITED((*i).status_) || WIFSIGNALED((*i).status_))) {
+                batch_terminated(*i);
+                processVec_.erase(i--);
+                continue;
+            }
+
 #ifdef DEBUG_TERMINATED_CHILD
             std::cout << "System::processTerminatedChildren(): " << System::cmd_type((*i).cmd_type_) << " path("
                       << (*i).absNodePath_ << ") pid(" << (*i).pid_ << ") has status(stopped or terminated)" << endl;
@@ -332,6 +632,14 @@ int System::process() const {
     return static_cast<int>(processVec_.size());
 }
 
+void System::running_jobs(std::vector<std::string>& absPaths) const {
+    for (const Process& p : processVec_) {
+        // Excludes ECF_JOB_BATCH_CMD and the background fetch commands, which have no path
+        if (p.cmd_type_ == ECF_JOB_CMD && !p.have_status_ && !p.absNodePath_.empty())
+            absPaths.push_back(p.absNodePath_);
+    }
+}
+
 // ============================================================================
 // See: Advanced programming in the UNIX environment: Page 328
 // Note: with sigaction the handle stays installed, until changed
@@ -31,11 +31,16 @@
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
 #include <string>
+#include <vector>
+
+#include <sys/types.h> // for pid_t
 
 #include "NodeFwd.hpp"
 
 namespace ecf {
 
+struct Process;
+
 /// Job submission in ECF is a two phase step.
 /// phase 1: Spawn of ECF_JOB_CMD
 /// phase 2: Invocation of ECF_JOB_CMD, this creates the *real* job which communicates with the server
@@ -71,6 +76,33 @@ public:
     enum CmdType { ECF_JOB_CMD, ECF_KILL_CMD, ECF_STATUS_CMD };
     bool spawn(CmdType, const std::string& cmdToSpawn, const std::string& absPath, std::string& errorMsg);
 
+    // Spawn a single ECF_JOB_BATCH_CMD, for many jobs. The job files are written to the stdin of the command,
+    // one per line. The stdout of the command is read when the command terminates:
+    //    o exit status 0: The jobs were submitted, except those listed in the output, one per line, as
+    //                     "<job file>\t<reason>" or "<job file>". Lines that match no job file are logged.
+    //    o otherwise    : None of the jobs were submitted
+    // Each job that was not submitted is handled as for a failed ECF_JOB_CMD. absPaths and jobFiles are parallel.
+    bool spawn_batch(const std::string& cmdToSpawn,
+                     const std::vector<std::string>& absPaths,
+                     const std::vector<std::string>& jobFiles,
+                     std::string& errorMsg);
+
+    // Spawn a ECF_FETCH or ECF_SCRIPT_CMD command, in the background. Its stdout is passed to the
+    // ScriptFetcher, when the command terminates. Returns the pid, or -1 on error
+    pid_t spawn_fetch(const std::string& cmdToSpawn, std::string& errorMsg);
+
+    // By default the commands are started with fork() and exec(). For a large server process, fork() must
+    // copy the page tables, which takes time and memory for each command. posix_spawn() avoids this, since
+    // the child shares the memory of the parent, until it calls exec(). Set by the server, see ECF_POSIX_SPAWN.
+    // The spawned process is recorded, and its termination handled, in the same way.
+    // Only used if posix_spawn_supported(), otherwise fork() is used.
+    void set_use_posix_spawn(bool f) { use_posix_spawn_ = f; }
+    bool use_posix_spawn() const { return use_posix_spawn_; }
+
+    // posix_spawn() requires closing the inherited file descriptors (i.e server sockets) in the child.
+    // Returns false, if this is not available on this platform
+    static bool posix_spawn_supported();
+
     // Handle children that have stopped,aborted or terminated, etc
     // The signal handler is kept as light as possible, since it is re-entrant.
     // So Signal handles stores the termination state which handled later
@@ -81,6 +113,9 @@ public:
     /// for debug only
     int process() const;
 
+    /// Return the paths of the tasks, whose ECF_JOB_CMD is still running. See JobThrottle
+    void running_jobs(std::vector<std::string>& absPaths) const;
+
 private:
     ~System();
     System();
@@ -96,10 +131,20 @@ private:
     /// Does the real work of spawning children
     int sys(CmdType, const std::string& cmdToSpawn, const std::string& absPath, std::string& errorMsg);
 
+    /// Start "/bin/sh -c cmdToSpawn", return the pid of the child, or -1 on error
+    /// The stdin and stdout of the child are /dev/null, unless the file descriptors are given.
+    static pid_t fork_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd, int stdout_fd);
+    static pid_t posix_spawn_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd, int stdout_fd);
+    pid_t spawn_child(const std::string& cmdToSpawn, std::string& errorMsg, int stdin_fd = -1, int stdout_fd = -1);
+
+    /// Report the jobs of a terminated ECF_JOB_BATCH_CMD, that were not submitted
+    void batch_terminated(const Process&);
+
     static std::string cmd_type(CmdType);
 
 private:
     weak_defs_ptr defs_; // weak_ptr is an observer of a shared_ptr
+    bool use_posix_spawn_{false};
     static System* instance_;
 };
 
@@ -15,23 +15,27 @@
 
 #include "Task.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
 #include <boost/lexical_cast.hpp>
 
 #include "Alias.hpp"
+#include "ChangeJournal.hpp"
 #include "DefsDelta.hpp"
 #include "Ecf.hpp"
 #include "Extract.hpp"
 #include "File.hpp"
 #include "Indentor.hpp"
 #include "JobProfiler.hpp"
+#include "JobThrottle.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
 #include "Memento.hpp"
 #include "NodeTreeVisitor.hpp"
 #include "PrintStyle.hpp"
+#include "ScriptFetcher.hpp"
 #include "Serialization.hpp"
 #include "Str.hpp"
 #include "SuiteChanged.hpp"
@@ -75,6 +79,7 @@ Task& Task::operator=(const Task& rhs) {
     if (this != &rhs) {
         Submittable::operator=(rhs);
         aliases_.clear();
+        ChangeJournal::children_removed(this);
         alias_no_ = rhs.alias_no_;
         copy(rhs);
 
@@ -276,7 +281,7 @@ alias_ptr Task::add_alias(std::vector<std::string>& user_file_contents,
     alias_no_++; // Alias number must be set to next valid alias number
     aliases_.push_back(alias);
 
-    alias_change_no_            = Ecf::incr_state_change_no();
+    alias_change_no_            = incr_state_change_no();
     add_remove_state_change_no_ = alias_change_no_;
     return alias;
 }
@@ -307,7 +312,7 @@ alias_ptr Task::find_alias(const std::string& name) const {
 
 void Task::reset_alias_number() {
     alias_no_        = 0;
-    alias_change_no_ = Ecf::incr_state_change_no();
+    alias_change_no_ = incr_state_change_no();
 }
 
 node_ptr Task::findImmediateChild(const std::string& name, size_t& child_pos) const {
@@ -593,6 +598,26 @@ bool Task::resolveDependencies(JobsParam& jobsParam) {
         return false;
     }
 
+    // The script is still being fetched in the background. The task stays queued, and is left unchanged
+    // until the script is available. See ScriptFetcher
+    bool async_fetch = jobsParam.async_fetch() && jobsParam.createJobs();
+    if (async_fetch && ScriptFetcher::instance().pending(absNodePath())) {
+        script_fetch_pending(jobsParam);
+        return false;
+    }
+
+    // The number of jobs submitted by a job generation may be limited. The task stays queued,
+    // and is submitted by a later job generation. See JobThrottle
+    if (jobsParam.throttle_jobs() && !JobThrottle::instance().submit(this)) {
+        submission_throttled(jobsParam);
+        return false;
+    }
+
+    // Restored, if job creation has to wait for a script to be fetched in the background
+    SubmitState submit_state;
+    if (async_fetch)
+        save_submit_state(submit_state);
+
     // call just before job submission, reset data members, update try_no, and generate variable
     // *PLACED* outside of submitJob() so that we can configure job generation file ECF_JOB for test/python
     increment_try_no(); // will increment state_change_no
@@ -603,7 +628,19 @@ bool Task::resolveDependencies(JobsParam& jobsParam) {
         // them(i.e expand includes, remove comments,manual) and perform
         // variable substitution. This will then form the jobs file.
         // If the job file already exist it is overridden
+        size_t pending  = jobsParam.pending_submissions();
+        size_t deferred = jobsParam.deferred().size();
         submit_job_only(jobsParam);
+        if (async_fetch && jobsParam.pending_submissions() != pending) {
+            restore_submit_state(submit_state);
+            return false;
+        }
+        if (async_fetch && jobsParam.deferred().size() != deferred) {
+            // The job is created later, the state is restored if the script is still being fetched
+            Submittable::DeferredJob& job = jobsParam.deferred().back();
+            job.submit_state_             = submit_state;
+            job.submit_state_saved_       = true;
+        }
     }
     else {
         // *************************************************************************************
@@ -642,7 +679,8 @@ node_ptr Task::removeChild(Node* child) {
             child->set_parent(nullptr);
             node_ptr node = std::dynamic_pointer_cast<Alias>(aliases_[t]);
             aliases_.erase(aliases_.begin() + t);
-            add_remove_state_change_no_ = Ecf::incr_state_change_no();
+            add_remove_state_change_no_ = incr_state_change_no();
+            ChangeJournal::children_removed(this);
             return node;
         }
     }
@@ -659,7 +697,8 @@ bool Task::doDeleteChild(Node* child) {
             if (child && child->parent())
                 child->set_parent(nullptr);
             aliases_.erase(t);
-            add_remove_state_change_no_ = Ecf::incr_state_change_no();
+            add_remove_state_change_no_ = incr_state_change_no();
+            ChangeJournal::children_removed(this);
             return true;
         }
     }
@@ -697,7 +736,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
                     alias_ptr node = (*i);
                     aliases_.erase(i);
                     aliases_.insert(aliases_.begin(), node);
-                    order_state_change_no_ = Ecf::incr_state_change_no();
+                    order_state_change_no_ = incr_state_change_no();
                     return;
                 }
             }
@@ -709,7 +748,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
                     alias_ptr node = (*i);
                     aliases_.erase(i);
                     aliases_.push_back(node);
-                    order_state_change_no_ = Ecf::incr_state_change_no();
+                    order_state_change_no_ = incr_state_change_no();
                     return;
                 }
             }
@@ -719,14 +758,14 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
             std::sort(aliases_.begin(), aliases_.end(), [](const alias_ptr& a, const alias_ptr& b) {
                 return Str::caseInsLess(a->name(), b->name());
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
         case NOrder::ORDER: {
             std::sort(aliases_.begin(), aliases_.end(), [](const alias_ptr& a, const alias_ptr& b) {
                 return Str::caseInsGreater(a->name(), b->name());
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
         case NOrder::UP: {
@@ -737,7 +776,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
                         aliases_.erase(aliases_.begin() + t);
                         t--;
                         aliases_.insert(aliases_.begin() + t, node);
-                        order_state_change_no_ = Ecf::incr_state_change_no();
+                        order_state_change_no_ = incr_state_change_no();
                     }
                     return;
                 }
@@ -752,7 +791,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
                         aliases_.erase(aliases_.begin() + t);
                         t++;
                         aliases_.insert(aliases_.begin() + t, node);
-                        order_state_change_no_ = Ecf::incr_state_change_no();
+                        order_state_change_no_ = incr_state_change_no();
                     }
                     return;
                 }
@@ -769,7 +808,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
             std::sort(aliases_.begin(), aliases_.end(), [](const alias_ptr& a, const alias_ptr& b) {
                 return a->state_change_runtime() > b->state_change_runtime();
             });
-            order_state_change_no_ = Ecf::incr_state_change_no();
+            order_state_change_no_ = incr_state_change_no();
             break;
         }
     }
@@ -777,7 +816,7 @@ void Task::order(Node* immediateChild, NOrder::Order ord) {
 
 void Task::move_peer(Node* src, Node* dest) {
     move_peer_node(aliases_, src, dest, "Task");
-    order_state_change_no_ = Ecf::incr_state_change_no();
+    order_state_change_no_ = incr_state_change_no();
 }
 
 bool Task::checkInvariants(std::string& errorMsg) const {
@@ -829,6 +868,16 @@ const std::string& Task::script_extension() const {
 }
 
 void Task::collateChanges(DefsDelta& changes) const {
+    collate_node_changes_only(changes);
+
+    // Traversal to children
+    size_t vec_size = aliases_.size();
+    for (size_t t = 0; t < vec_size; t++) {
+        aliases_[t]->collateChanges(changes);
+    }
+}
+
+void Task::collate_node_changes_only(DefsDelta& changes) const {
     //   std::cout << "Task::collateChanges " << debugNodePath()
     //             << " changes.client_state_change_no() = " << changes.client_state_change_no()
     //             << " add_remove_state_change_no_ = " << add_remove_state_change_no_
@@ -864,12 +913,13 @@ void Task::collateChanges(DefsDelta& changes) const {
 
     // ** base class will add compound memento into changes.
     Submittable::incremental_changes(changes, comp);
+}
 
-    // Traversal to children
-    size_t vec_size = aliases_.size();
-    for (size_t t = 0; t < vec_size; t++) {
-        aliases_[t]->collateChanges(changes);
-    }
+unsigned int Task::node_only_max_state_change_no() const {
+    // *make* sure this is in sync with Task::collate_node_changes_only()
+    unsigned int max_change_no = std::max(add_remove_state_change_no_, order_state_change_no_);
+    max_change_no              = std::max(max_change_no, alias_change_no_);
+    return std::max(max_change_no, Submittable::node_only_max_state_change_no());
 }
 
 void Task::set_memento(const OrderMemento* memento, std::vector<ecf::Aspect::Type>& aspects, bool aspect_only) {
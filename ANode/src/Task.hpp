@@ -108,6 +108,8 @@ public:
     bool checkInvariants(std::string& errorMsg) const override;
 
     void collateChanges(DefsDelta&) const override;
+    void collate_node_changes_only(DefsDelta&) const override;
+    unsigned int node_only_max_state_change_no() const override;
     void set_memento(const OrderMemento* m, std::vector<ecf::Aspect::Type>& aspects, bool);
     void set_memento(const AliasChildrenMemento* m, std::vector<ecf::Aspect::Type>& aspects, bool);
     void set_memento(const AliasNumberMemento* m, std::vector<ecf::Aspect::Type>& aspects, bool);
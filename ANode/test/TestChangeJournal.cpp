@@ -0,0 +1,154 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "DefsDelta.hpp"
+#include "Ecf.hpp"
+#include "Family.hpp"
+#include "Serialization.hpp"
+#include "Suite.hpp"
+#include "SuiteChanged.hpp"
+#include "Task.hpp"
+
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+defs_ptr create_defs() {
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("s");
+    for (int f = 0; f < 5; f++) {
+        family_ptr family = suite->add_family("f" + std::to_string(f));
+        for (int t = 0; t < 5; t++) {
+            task_ptr task = family->add_task("t" + std::to_string(t));
+            task->addEvent(Event("event"));
+            task->addMeter(Meter("meter", 0, 100));
+        }
+    }
+    return defs;
+}
+
+// Collate the changes in the server defs, and apply them to the client defs
+size_t sync(defs_ptr server_defs, defs_ptr client_defs, unsigned int client_state_change_no, const std::string& msg) {
+    DefsDelta server_changes(client_state_change_no);
+    server_defs->collateChanges(0, server_changes);
+
+    // The mementos refer to the server nodes, hence transfer as if between client and server
+    std::string archive_data;
+    ecf::save_as_string(archive_data, server_changes);
+    DefsDelta changes(0);
+    ecf::restore_from_string(archive_data, changes);
+
+    Ecf::set_server(false); // apply changes, as if on the client side
+    std::vector<std::string> changed_nodes;
+    changes.incremental_sync(client_defs, changed_nodes, 0);
+    Ecf::set_server(true);
+
+    DebugEquality debug_equality; // only has affect in DEBUG build
+    BOOST_CHECK_MESSAGE(*server_defs == *client_defs, msg << " : Server and client should be same after sync");
+    return changes.size();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_change_journal) {
+    cout << "ANode:: ...test_change_journal\n";
+
+    Ecf::set_server(true); // needed for state change numbers
+
+    defs_ptr server_defs = create_defs();
+    defs_ptr client_defs = create_defs();
+    BOOST_REQUIRE_MESSAGE(*server_defs == *client_defs, "Starting point client and server defs should be the same");
+    suite_ptr suite = server_defs->findSuite("s");
+
+    unsigned int client_state_change_no = Ecf::state_change_no();
+    {
+        SuiteChanged1 changed(suite.get());
+        server_defs->findAbsNode("/s/f1/t2")->set_event("event", true);
+        server_defs->findAbsNode("/s/f3/t0")->set_meter("meter", 10);
+        server_defs->findAbsNode("/s/f4/t4")->set_state(NState::ACTIVE);
+    }
+    size_t journal_changes = sync(server_defs, client_defs, client_state_change_no, "Sync via journal");
+    BOOST_CHECK_MESSAGE(journal_changes != 0, "Expected changes");
+    BOOST_CHECK_MESSAGE(suite->change_journal().size() != 0, "Expected journal to hold the changed nodes");
+
+    // No changes since the last sync
+    client_state_change_no = Ecf::state_change_no();
+    BOOST_CHECK_MESSAGE(sync(server_defs, client_defs, client_state_change_no, "No changes") == 0,
+                        "Expected no changes");
+
+    // Children added to a family, ChildrenMemento will copy all the children
+    {
+        SuiteChanged1 changed(suite.get());
+        server_defs->findAbsNode("/s/f2/t1")->set_meter("meter", 20);
+        server_defs->findAbsNode("/s/f2")->isFamily()->add_task("t5");
+        server_defs->findAbsNode("/s/f0/t0")->set_state(NState::ABORTED);
+    }
+    sync(server_defs, client_defs, client_state_change_no, "Sync via journal, children added");
+
+    // Changes since the client state change no, via the journal and full traversal, must be the same
+    {
+        SuiteChanged1 changed(suite.get());
+        server_defs->findAbsNode("/s/f1/t3")->set_event("event", true);
+        server_defs->findAbsNode("/s/f2/t4")->set_meter("meter", 30);
+    }
+    DefsDelta journal_delta(client_state_change_no);
+    server_defs->collateChanges(0, journal_delta);
+
+    // Client is older than the journal, fall back to a full traversal
+    suite->change_journal().set_max_entries(1);
+    DefsDelta full_delta(client_state_change_no);
+    server_defs->collateChanges(0, full_delta);
+    BOOST_CHECK_MESSAGE(suite->change_journal().size() == 1, "Expected journal to be bounded");
+    BOOST_CHECK_MESSAGE(journal_delta.size() == full_delta.size(),
+                        "Expected same changes via journal " << journal_delta.size() << " and full traversal "
+                                                             << full_delta.size());
+    sync(server_defs, client_defs, client_state_change_no, "Sync via full traversal");
+
+    // Nodes recorded at the point of change
+    suite->change_journal().set_max_entries(10000);
+    client_state_change_no = Ecf::state_change_no();
+    {
+        SuiteChanged1 changed(suite.get());
+        server_defs->findAbsNode("/s/f0/t3")->set_meter("meter", 40);
+        server_defs->findAbsNode("/s/f0/t3")->flag().set(ecf::Flag::LATE);
+        server_defs->findAbsNode("/s/f4/t2")->set_event("event", true);
+    }
+    BOOST_CHECK_MESSAGE(suite->change_journal().size() == 3,
+                        "Expected 3 nodes in the journal but found " << suite->change_journal().size());
+    sync(server_defs, client_defs, client_state_change_no, "Sync via journal, after bounding");
+
+    // Nodes removed, the journal refers to the nodes by pointer, hence must be invalidated
+    client_state_change_no = Ecf::state_change_no();
+    {
+        SuiteChanged1 changed(suite.get());
+        server_defs->findAbsNode("/s/f3/t1")->remove();
+    }
+    BOOST_CHECK_MESSAGE(suite->change_journal().size() == 0, "Expected journal to be invalidated, when nodes removed");
+    sync(server_defs, client_defs, client_state_change_no, "Sync via full traversal, node removed");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
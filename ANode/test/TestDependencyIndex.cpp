@@ -0,0 +1,142 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "Ecf.hpp"
+#include "Jobs.hpp"
+#include "JobsParam.hpp"
+#include "Limit.hpp"
+#include "Suite.hpp"
+#include "SuiteChanged.hpp"
+#include "Task.hpp"
+#include "TimeAttr.hpp"
+
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+void resolve(defs_ptr defs, size_t expected_resolved, size_t expected_skipped, const std::string& msg) {
+    Jobs jobs(defs);
+    JobsParam jobsParam; // create jobs = false, i.e. simulate job submission
+    jobsParam.set_use_dependency_index(true);
+    BOOST_CHECK_MESSAGE(jobs.generate(jobsParam), msg << " : " << jobsParam.getErrorMsg());
+
+    const DependencyIndex& index = defs->dependency_index();
+    BOOST_CHECK_MESSAGE(index.suites_resolved() == expected_resolved && index.suites_skipped() == expected_skipped,
+                        msg << " : expected " << expected_resolved << " suites resolved and " << expected_skipped
+                            << " skipped but found " << index.suites_resolved() << " resolved and "
+                            << index.suites_skipped() << " skipped");
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_dependency_index) {
+    cout << "ANode:: ...test_dependency_index\n";
+
+    Ecf::set_server(true); // needed for state change numbers
+
+    // s2 depends on s1, s3 is independent, s4 has time dependencies and hence is always resolved.
+    defs_ptr defs = Defs::create();
+    suite_ptr s1  = defs->add_suite("s1");
+    task_ptr t1   = s1->add_task("t1");
+    t1->add_trigger("1 == 0");
+    suite_ptr s2 = defs->add_suite("s2");
+    task_ptr t2  = s2->add_task("t2");
+    t2->add_trigger("/s1/t1 == complete");
+    suite_ptr s3 = defs->add_suite("s3");
+    task_ptr t3  = s3->add_task("t3");
+    t3->add_trigger("1 == 0");
+    suite_ptr s4 = defs->add_suite("s4");
+    task_ptr t4  = s4->add_task("t4");
+    t4->add_trigger("1 == 0");
+    t4->addTime(TimeAttr(10, 0));
+    defs->beginAll();
+
+    resolve(defs, 4, 0, "First job generation should resolve all suites");
+    resolve(defs, 1, 3, "Nothing changed, only suite with time dependencies should be resolved");
+
+    {
+        // mimic a command, changing state of /s1/t1
+        SuiteChanged1 changed(s1.get());
+        t1->set_state(NState::COMPLETE);
+    }
+    resolve(defs, 3, 1, "Expected s1, the dependent suite s2, and s4 to be resolved");
+    BOOST_CHECK_MESSAGE(t2->state() == NState::ACTIVE, "Expected /s2/t2 to be submitted, and active");
+
+    // The submission of t2, changed suite s2
+    resolve(defs, 2, 2, "Expected s2 and s4 to be resolved");
+    resolve(defs, 1, 3, "Nothing changed, only suite with time dependencies should be resolved");
+
+    // Change node tree directly, i.e. change *not* attributed to a suite
+    t3->set_state(NState::QUEUED);
+    t3->set_state(NState::COMPLETE);
+    resolve(defs, 4, 0, "Change not attributable to a suite, expected all suites to be resolved");
+
+    // Add a suite, this changes the node tree structure
+    resolve(defs, 1, 3, "Nothing changed, only suite with time dependencies should be resolved");
+    defs->add_suite("s5");
+    resolve(defs, 5, 0, "Node tree changed, expected all suites to be resolved");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_index_limits) {
+    cout << "ANode:: ...test_dependency_index_limits\n";
+
+    Ecf::set_server(true); // needed for state change numbers
+
+    // s1 holds the limit, s2 and s3 consume the limit, s4 is independent
+    defs_ptr defs = Defs::create();
+    suite_ptr s1  = defs->add_suite("s1");
+    s1->addLimit(Limit("limit", 1));
+    suite_ptr s2 = defs->add_suite("s2");
+    task_ptr t2  = s2->add_task("t2");
+    t2->addInLimit(InLimit("limit", "/s1"));
+    t2->add_trigger("1 == 0");
+    suite_ptr s3 = defs->add_suite("s3");
+    task_ptr t3  = s3->add_task("t3");
+    t3->addInLimit(InLimit("limit", "/s1"));
+    t3->add_trigger("1 == 0");
+    suite_ptr s4 = defs->add_suite("s4");
+    task_ptr t4  = s4->add_task("t4");
+    t4->add_trigger("1 == 0");
+    defs->beginAll();
+
+    resolve(defs, 4, 0, "First job generation should resolve all suites");
+    resolve(defs, 0, 4, "Nothing changed, no suites should be resolved");
+
+    {
+        // A change in s3, may release the limit, and affect s2
+        SuiteChanged1 changed(s3.get());
+        t3->set_state(NState::ABORTED);
+    }
+    resolve(defs, 2, 2, "Expected suites sharing the limit, s2 and s3, to be resolved");
+    resolve(defs, 0, 4, "Nothing changed, no suites should be resolved");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
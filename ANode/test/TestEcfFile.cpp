@@ -23,6 +23,7 @@
 #include "EcfFile.hpp"
 #include "Family.hpp"
 #include "File.hpp"
+#include "JobProfiler.hpp"
 #include "JobsParam.hpp"
 #include "Pid.hpp"
 #include "Str.hpp"
@@ -152,6 +153,208 @@ BOOST_AUTO_TEST_CASE(test_ecf_simple_include_file) {
     boost::filesystem::remove_all(ecf_home + suite->absNodePath());
 }
 
+BOOST_AUTO_TEST_CASE(test_include_file_cache) {
+    cout << "ANode:: ...test_include_file_cache\n";
+
+    std::string dir = File::test_data("ANode/test/data", "ANode") + "/" + Pid::unique_name("test_include_file_cache");
+    std::string a_h = dir + "/a.h";
+    std::string b_h = dir + "/b.h";
+    BOOST_REQUIRE_MESSAGE(File::createMissingDirectories(a_h), "Could not create missing dir\n");
+    std::string errormsg;
+    BOOST_REQUIRE_MESSAGE(File::create(a_h, "#a1\n#a2\n", errormsg), errormsg);
+    BOOST_REQUIRE_MESSAGE(File::create(b_h, "#b1\n", errormsg), errormsg);
+
+    IncludeFileCache& cache = IncludeFileCache::instance();
+    size_t hits             = cache.hits();
+    size_t misses           = cache.misses();
+
+    std::vector<std::string> lines;
+    BOOST_CHECK_MESSAGE(cache.lines(a_h, lines) && lines.size() == 2, "Expected 2 lines");
+    BOOST_CHECK_MESSAGE(cache.misses() == misses + 1, "Expected a miss on first read");
+    lines.clear();
+    BOOST_CHECK_MESSAGE(cache.lines(a_h, lines) && lines.size() == 2 && lines[1] == "#a2", "Expected cached lines");
+    BOOST_CHECK_MESSAGE(cache.hits() == hits + 1, "Expected a hit on second read");
+
+    // Modifying the include file, must invalidate the cached lines
+    BOOST_REQUIRE_MESSAGE(File::create(a_h, "#a3\n", errormsg), errormsg);
+    lines.clear();
+    BOOST_CHECK_MESSAGE(cache.lines(a_h, lines) && lines.size() == 1 && lines[0] == "#a3",
+                        "Expected lines of modified include file");
+    BOOST_CHECK_MESSAGE(cache.misses() == misses + 2, "Expected a miss after include file modified");
+
+    // Only room for one of the files, least recently used is evicted
+    size_t max_bytes = cache.max_bytes();
+    size_t evictions = cache.evictions();
+    cache.set_max_bytes(cache.bytes() + 10);
+    lines.clear();
+    BOOST_CHECK_MESSAGE(cache.lines(b_h, lines) && lines.size() == 1, "Expected 1 line");
+    BOOST_CHECK_MESSAGE(cache.evictions() > evictions, "Expected eviction when cache is full");
+    cache.set_max_bytes(max_bytes);
+
+    lines.clear();
+    BOOST_CHECK_MESSAGE(!cache.lines(dir + "/c.h", lines), "Expected failure for missing include file");
+
+    fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_pre_processed_script_cache) {
+    cout << "ANode:: ...test_pre_processed_script_cache\n";
+
+    // suite suite
+    //  edit ECF_INCLUDE $ECF_HOME/<suite>/include
+    //  task t1
+    //  task t2
+    //  family f
+    //    edit ECF_INCLUDE $ECF_HOME/<suite>/include2
+    //    task t3
+    // endsuite
+    // All tasks share the same script, but t3 uses a different include file
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite(Pid::unique_name("test_pre_processed_script_cache"));
+    suite->addVariable(Variable(Str::ECF_INCLUDE(), "$ECF_HOME/" + suite->name() + "/include"));
+    task_ptr t1    = suite->add_task("t1");
+    task_ptr t2    = suite->add_task("t2");
+    family_ptr fam = suite->add_family("f");
+    fam->addVariable(Variable(Str::ECF_INCLUDE(), "$ECF_HOME/" + suite->name() + "/include2"));
+    task_ptr t3 = fam->add_task("t3");
+
+    std::string ecf_home = File::test_data("ANode/test/data", "ANode");
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    std::string suite_dir = ecf_home + suite->absNodePath();
+    std::string script    = suite_dir + "/shared" + File::ECF_EXTN();
+    std::string head_h    = suite_dir + "/include/head.h";
+    std::string head2_h   = suite_dir + "/include2/head.h";
+    BOOST_REQUIRE_MESSAGE(File::createMissingDirectories(head_h), "Could not create missing dir\n");
+    BOOST_REQUIRE_MESSAGE(File::createMissingDirectories(head2_h), "Could not create missing dir\n");
+    std::string errormsg;
+    BOOST_REQUIRE_MESSAGE(File::create(script, "%include <head.h>\necho %TASK%\n", errormsg), errormsg);
+    BOOST_REQUIRE_MESSAGE(File::create(head_h, "#head1\n", errormsg), errormsg);
+    BOOST_REQUIRE_MESSAGE(File::create(head2_h, "#head2\n", errormsg), errormsg);
+
+    PreProcessedScriptCache& cache = PreProcessedScriptCache::instance();
+    size_t hits                    = cache.hits();
+    size_t misses                  = cache.misses();
+
+    auto create_job = [&](const task_ptr& task, const std::string& expected) {
+        task->update_generated_variables();
+        EcfFile ecfFile(task.get(), script);
+        JobsParam jobsParam(true); // spawn_jobs = false
+        jobsParam.set_use_script_cache(true);
+        try {
+            ecfFile.create_job(jobsParam);
+        }
+        catch (std::exception& e) {
+            BOOST_CHECK_MESSAGE(false, "Expected job creation to succeed " << e.what());
+        }
+
+        std::string job_file_location = ecf_home + task->absNodePath() + File::JOB_EXTN() + task->tryNo();
+        std::string job_file_contents;
+        BOOST_CHECK_MESSAGE(File::open(job_file_location, job_file_contents),
+                            "Could not open job file " << job_file_location);
+        BOOST_CHECK_MESSAGE(job_file_contents == expected,
+                            "Expected\n'" << expected << "' but found \n'" << job_file_contents << "'");
+    };
+
+    create_job(t1, "#head1\necho t1");
+    BOOST_CHECK_MESSAGE(cache.misses() == misses + 1 && cache.hits() == hits, "Expected a miss for first job");
+    create_job(t2, "#head1\necho t2");
+    BOOST_CHECK_MESSAGE(cache.hits() == hits + 1, "Expected a hit, for task sharing the script");
+
+    // t3 locates a different include file, hence can not use the cached script
+    create_job(t3, "#head2\necho t3");
+    BOOST_CHECK_MESSAGE(cache.misses() == misses + 2, "Expected a miss, when include file is located elsewhere");
+
+    // Modifying the include file, must invalidate the cached script
+    BOOST_REQUIRE_MESSAGE(File::create(head_h, "#head1 modified\n", errormsg), errormsg);
+    create_job(t1, "#head1 modified\necho t1");
+    BOOST_CHECK_MESSAGE(cache.misses() == misses + 3, "Expected a miss after include file modified");
+    create_job(t2, "#head1 modified\necho t2");
+    BOOST_CHECK_MESSAGE(cache.hits() == hits + 2, "Expected a hit, for the modified script");
+
+    // The variant for t3 is still cached
+    create_job(t3, "#head2\necho t3");
+    BOOST_CHECK_MESSAGE(cache.hits() == hits + 3, "Expected a hit, for the variant with a different include file");
+
+    /// Remove all the generated files
+    boost::filesystem::remove_all(suite_dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_variable_substitution_plan) {
+    cout << "ANode:: ...test_variable_substitution_plan\n";
+
+    // The compiled variable substitution (used with the script cache), must match the line by line substitution
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite(Pid::unique_name("test_variable_substitution_plan"));
+    suite->addVariable(Variable("RECURSE", "%TASK%-%SUITE%"));
+    suite->addVariable(Variable("HAS_COLON", "a:b"));
+    family_ptr fam = suite->add_family("f");
+    task_ptr t1    = fam->add_task("t1");
+    task_ptr t2    = suite->add_task("t2");
+
+    std::string ecf_home = File::test_data("ANode/test/data", "ANode");
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    std::string suite_dir = ecf_home + suite->absNodePath();
+    std::string script    = suite_dir + "/shared" + File::ECF_EXTN();
+    BOOST_REQUIRE_MESSAGE(File::createMissingDirectories(script), "Could not create missing dir\n");
+    std::string script_contents = "%manual\n"
+                                  "manual %UNDEFINED% %TASK%\n"
+                                  "%end\n"
+                                  "%comment\n"
+                                  "comment %UNDEFINED% %SUITE%\n"
+                                  "%end\n"
+                                  "echo %TASK% %FAMILY:nofam% %%d 100%% %HAS_COLON%\n"
+                                  "date +%%Y%%m%%d %%%%\n"
+                                  "echo %ECF_TRYNO% %ECF_NAME% %ECF_PASS%\n"
+                                  "echo %RECURSE% %RECURSE%\n"
+                                  "%nopp\n"
+                                  "echo %UNDEFINED%\n"
+                                  "%end\n"
+                                  "%ecfmicro ^\n"
+                                  "echo ^TASK^ %TASK% ^^\n"
+                                  "^ecfmicro %\n"
+                                  "echo %TASK% %%\n";
+    std::string errormsg;
+    BOOST_REQUIRE_MESSAGE(File::create(script, script_contents, errormsg), errormsg);
+
+    auto create_job = [&](const task_ptr& task, bool use_script_cache) {
+        task->update_generated_variables();
+        EcfFile ecfFile(task.get(), script);
+        JobsParam jobsParam(true); // spawn_jobs = false
+        jobsParam.set_use_script_cache(use_script_cache);
+        try {
+            ecfFile.create_job(jobsParam);
+        }
+        catch (std::exception& e) {
+            BOOST_CHECK_MESSAGE(false, "Expected job creation to succeed " << e.what());
+        }
+
+        std::string job_file_location = ecf_home + task->absNodePath() + File::JOB_EXTN() + task->tryNo();
+        std::string job_file_contents;
+        BOOST_CHECK_MESSAGE(File::open(job_file_location, job_file_contents),
+                            "Could not open job file " << job_file_location);
+        return job_file_contents;
+    };
+
+    for (const task_ptr& task : {t1, t2}) {
+        std::string expected = create_job(task, false);
+        BOOST_CHECK_MESSAGE(expected.find("echo " + task->name() + " ") != std::string::npos,
+                            "Expected variable substitution in\n" << expected);
+
+        size_t compiled = JobProfiler::variable_substitutions(true);
+        std::string job = create_job(task, true);
+        BOOST_CHECK_MESSAGE(job == expected, "Expected\n'" << expected << "' but found \n'" << job << "'");
+        BOOST_CHECK_MESSAGE(JobProfiler::variable_substitutions(true) == compiled + 1,
+                            "Expected compiled variable substitution");
+    }
+
+    /// Remove all the generated files
+    boost::filesystem::remove_all(suite_dir);
+}
+
 BOOST_AUTO_TEST_CASE(test_ECFLOW_495) {
     // This tests for a regression where, *NOT* all the include file were processed.
     cout << "ANode:: ...test_ECFLOW_495";
@@ -0,0 +1,283 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "DurationTimer.hpp"
+#include "Ecf.hpp"
+#include "ExprByteCode.hpp"
+#include "Expression.hpp"
+#include "Family.hpp"
+#include "Limit.hpp"
+#include "Suite.hpp"
+#include "Task.hpp"
+
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+// The byte code must evaluate exactly as the AST
+void check(const std::vector<std::unique_ptr<Expression>>& exprs, const std::string& msg) {
+    for (const auto& expr : exprs) {
+        bool ast       = expr->get_ast()->evaluate();
+        bool byte_code = expr->evaluate();
+        BOOST_CHECK_MESSAGE(ast == byte_code,
+                            msg << " : '" << expr->expression() << "' AST evaluates " << ast << " but byte code "
+                                << byte_code);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_expr_byte_code) {
+    cout << "ANode:: ...test_expr_byte_code\n";
+
+    Ecf::set_server(true); // byte code is only used on the server
+
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("s");
+    suite->addLimit(Limit("lim", 10));
+    suite->addVariable(Variable("VAR", "5"));
+    family_ptr f = suite->add_family("f");
+    f->addVariable(Variable("VAR2", "6"));
+    f->addRepeat(RepeatDate("YMD", 20200101, 20200110));
+    std::vector<task_ptr> tasks;
+    for (int i = 0; i < 2; i++) {
+        task_ptr t = f->add_task("t" + std::to_string(i));
+        t->addEvent(Event("ev"));
+        t->addMeter(Meter("m", 0, 100));
+        t->addVariable(Variable("TV", "7"));
+        tasks.push_back(t);
+    }
+    task_ptr x = f->add_task("x");
+    defs->beginAll();
+
+    std::vector<std::string> expressions = {"t0 == complete",
+                                            "t0 != complete and t1 == queued",
+                                            "t0 == complete or t1 == complete",
+                                            "t0:ev",
+                                            "t0:ev == set",
+                                            "!t0:ev",
+                                            "not t0:ev and t1:ev == clear",
+                                            "t0:m >= 10",
+                                            "t0:m + 2 == 12",
+                                            "t0:m - 2 == 8",
+                                            "(t0:m * 3) / 2 % 7 == 1",
+                                            "t0:m",
+                                            "t0:m + 1",
+                                            "t0:TV == 7",
+                                            ":VAR == 5",
+                                            ":VAR2 > 3 or t0 == aborted",
+                                            ":VAR + :VAR2 == 11",
+                                            ":VAR - 5",
+                                            "/s/f:YMD == 20200101",
+                                            "/s/f:YMD - 1 == 20191231",
+                                            "/s/f:YMD + 1 == 20200102",
+                                            "/s:lim == 0",
+                                            "t0:ECF_TRYNO == 0",
+                                            "/s/f/t0<flag>late == 0",
+                                            "cal::date_to_julian( /s/f:YMD ) == 2458850",
+                                            "missing == unknown",
+                                            "missing:ev == 0",
+                                            ":MISSING == 0",
+                                            "1",
+                                            "0 or 1 + 1"};
+    std::vector<std::unique_ptr<Expression>> exprs;
+    for (const auto& e : expressions) {
+        auto expr = std::make_unique<Expression>(e);
+        std::string errorMsg;
+        expr->createAST(x.get(), "trigger", errorMsg);
+        BOOST_REQUIRE_MESSAGE(errorMsg.empty() && expr->get_ast(), "Failed to parse " << e << " " << errorMsg);
+        exprs.push_back(std::move(expr));
+    }
+    check(exprs, "Initial");
+
+    tasks[0]->set_state(NState::COMPLETE);
+    tasks[0]->set_event("ev", true);
+    tasks[0]->set_meter("m", 10);
+    check(exprs, "Change state, event and meter");
+
+    f->increment_repeat();
+    check(exprs, "Increment repeat");
+
+    // Slots are only bound again, when attributes are added or deleted
+    Expression meter("t0:m >= 10");
+    std::string errorMsg;
+    meter.createAST(x.get(), "trigger", errorMsg);
+    BOOST_CHECK_MESSAGE(meter.evaluate(), "Expected meter expression to evaluate");
+    std::uint64_t binds = ExprByteCode::binds();
+    tasks[0]->set_meter("m", 20);
+    BOOST_CHECK_MESSAGE(meter.evaluate() && ExprByteCode::binds() == binds, "Expected no binding on value change");
+    tasks[0]->deleteMeter("m");
+    tasks[0]->addMeter(Meter("m", 0, 100, 100, 3));
+    BOOST_CHECK_MESSAGE(!meter.evaluate() && ExprByteCode::binds() == binds + 1,
+                        "Expected the slot to be bound, after the meter was replaced");
+
+    // Variable of the same name, added to a parent
+    tasks[0]->deleteEvent("ev");
+    tasks[0]->addEvent(Event("ev2"));
+    f->addVariable(Variable("VAR", "4"));
+    check(exprs, "Add/delete attributes");
+
+    // Delete a referenced node, and add it back
+    node_ptr t1 = tasks[1]->remove();
+    tasks[1].reset();
+    t1.reset();
+    check(exprs, "Delete node");
+    f->add_task("t1");
+    check(exprs, "Add node");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_CASE(test_expr_byte_code_memoized) {
+    cout << "ANode:: ...test_expr_byte_code_memoized\n";
+
+    Ecf::set_server(true);
+
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("s");
+    family_ptr f    = suite->add_family("f");
+    f->addVariable(Variable("VAR", "1"));
+    f->addRepeat(RepeatInteger("RI", 0, 10, 1));
+    task_ptr t0 = f->add_task("t0");
+    t0->addEvent(Event("ev"));
+    t0->addMeter(Meter("m", 0, 100));
+    task_ptr t1 = f->add_task("t1");
+    task_ptr x  = f->add_task("x");
+    defs->beginAll();
+
+    auto create = [&](const std::string& e) {
+        auto expr = std::make_unique<Expression>(e);
+        std::string errorMsg;
+        expr->createAST(x.get(), "trigger", errorMsg);
+        BOOST_REQUIRE_MESSAGE(errorMsg.empty() && expr->get_ast(), "Failed to parse " << e << " " << errorMsg);
+        return expr;
+    };
+    std::unique_ptr<Expression> memoized  = create("t0 == complete and t0:ev and t0:m > 5 and :VAR == 2 and :RI > 0");
+    std::unique_ptr<Expression> fallback  = create("t0<flag>late == 0");
+    std::unique_ptr<Expression> suite_gen = create("/s:YYYY > 0");
+
+    // Each change of a referenced node or attribute, is seen by the next evaluation
+    std::uint64_t misses = ExprByteCode::cache_misses();
+    BOOST_CHECK_MESSAGE(!memoized->evaluate(), "Expected expression to evaluate false");
+    std::uint64_t hits = ExprByteCode::cache_hits();
+    BOOST_CHECK_MESSAGE(!memoized->evaluate() && ExprByteCode::cache_hits() == hits + 1,
+                        "Expected the memoized result to be used, when nothing changed");
+    t1->set_state(NState::COMPLETE);
+    BOOST_CHECK_MESSAGE(!memoized->evaluate() && ExprByteCode::cache_hits() == hits + 2,
+                        "Expected the memoized result to be used, when a node not referenced changed");
+
+    t0->set_state(NState::COMPLETE);
+    t0->set_event("ev", true);
+    t0->set_meter("m", 6);
+    f->changeVariable("VAR", "2");
+    BOOST_CHECK_MESSAGE(!memoized->evaluate(), "Expected expression to evaluate false, repeat not incremented");
+    f->increment_repeat();
+    BOOST_CHECK_MESSAGE(memoized->evaluate(), "Expected expression to evaluate true");
+    BOOST_CHECK_MESSAGE(memoized->evaluate() && ExprByteCode::cache_hits() == hits + 3,
+                        "Expected the memoized result to be used");
+    t0->suspend();
+    BOOST_CHECK_MESSAGE(!memoized->evaluate(), "Expected expression to evaluate false, when t0 suspended");
+    t0->resume();
+    t0->set_meter("m", 5);
+    BOOST_CHECK_MESSAGE(!memoized->evaluate(), "Expected expression to evaluate false, after meter change");
+    BOOST_CHECK_MESSAGE(ExprByteCode::cache_misses() == misses + 5,
+                        "Expected 5 evaluations but found " << ExprByteCode::cache_misses() - misses);
+
+    // Flags and the generated variables of a suite, are always evaluated
+    hits = ExprByteCode::cache_hits();
+    fallback->evaluate();
+    fallback->evaluate();
+    suite_gen->evaluate();
+    suite_gen->evaluate();
+    BOOST_CHECK_MESSAGE(ExprByteCode::cache_hits() == hits, "Expected no memoized results");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+// Compare evaluation of a large set of triggers, via the AST walk and the byte code
+BOOST_AUTO_TEST_CASE(test_expr_byte_code_perf) {
+    cout << "ANode:: ...test_expr_byte_code_perf\n";
+
+    Ecf::set_server(true);
+
+    // Each task depends on the task of the same name, in the previous family
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("suite");
+    suite->addVariable(Variable("VAR", "5"));
+    std::vector<Expression*> triggers;
+    for (int f = 0; f < 20; f++) {
+        family_ptr fam = suite->add_family("f" + std::to_string(f));
+        for (int t = 0; t < 200; t++) {
+            task_ptr task = fam->add_task("t" + std::to_string(t));
+            task->addEvent(Event("ev"));
+            task->addMeter(Meter("m", 0, 100));
+            if (f > 0) {
+                std::string prev = "../f" + std::to_string(f - 1) + "/t" + std::to_string(t);
+                task->add_trigger("(" + prev + " == complete and " + prev + ":ev) or (" + prev +
+                                  ":m >= 0 and :VAR == 5)");
+                task->triggerAst(); // create AST
+                triggers.push_back(task->get_trigger());
+            }
+        }
+    }
+    defs->beginAll();
+
+    const int rounds = 50;
+    size_t ast_free  = 0;
+    {
+        DurationTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            for (Expression* trigger : triggers) {
+                if (trigger->get_ast()->evaluate())
+                    ast_free++;
+            }
+        }
+        cout << " Time for " << rounds * triggers.size() << " trigger evaluations, AST walk:  " << timer.elapsed()
+             << "\n";
+    }
+
+    size_t byte_code_free = 0;
+    {
+        DurationTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            for (Expression* trigger : triggers) {
+                if (trigger->evaluate())
+                    byte_code_free++;
+            }
+        }
+        cout << " Time for " << rounds * triggers.size() << " trigger evaluations, byte code: " << timer.elapsed()
+             << "\n";
+    }
+    BOOST_CHECK_MESSAGE(ast_free == byte_code_free && ast_free == rounds * triggers.size(),
+                        "Expected all triggers to evaluate, AST " << ast_free << " byte code " << byte_code_free);
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,8 @@
 
 #include "Defs.hpp"
 #include "ExprAst.hpp"
+#include "ExprDescentParser.hpp"
+#include "ExprDuplicate.hpp"
 #include "ExprParser.hpp"
 #include "Expression.hpp"
 #include "Suite.hpp"
@@ -739,4 +741,68 @@ BOOST_AUTO_TEST_CASE(test_parser_bad_expressions) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_descent_parser) {
+    std::cout << "ANode:: ...test_descent_parser\n";
+
+    // The descent parser must create the same AST as spirit, including its quirks
+    vector<string> exprvec;
+    exprvec.emplace_back("a == complete");
+    exprvec.emplace_back("  a==complete  ");
+    exprvec.emplace_back("0 == complete");
+    exprvec.emplace_back("/a//b eq complete and ./c ne aborted or ../../d/e == unknown");
+    exprvec.emplace_back("../../a/ b == queued");
+    exprvec.emplace_back("a == completeand b == complete");
+    exprvec.emplace_back("a == complete && b == complete || c == complete");
+    exprvec.emplace_back("a == complete AND b == complete OR c == complete");
+    exprvec.emplace_back("a == complete and b == complete and c == complete");
+    exprvec.emplace_back("(a == complete) and b == complete and c == complete");
+    exprvec.emplace_back("a == complete or b == complete and c == complete or d == complete");
+    exprvec.emplace_back("a == complete and (b == complete or c == complete) and d == complete");
+    exprvec.emplace_back("!a == complete and not b == complete and ~ c == complete");
+    exprvec.emplace_back("not (a == complete) or ! (b == complete)");
+    exprvec.emplace_back("notme == complete and nota:v == 1");
+    exprvec.emplace_back("a:ev == set and b:ev != clear and a:ev and !b:ev");
+    exprvec.emplace_back("a : v == 1 and :v > 2 and :  v < 3");
+    exprvec.emplace_back("a:v == 1 + 2 * 3 - 4 / 5 % 6");
+    exprvec.emplace_back("a:v == (1 + 2) * (3 + 4) and (a:v)");
+    exprvec.emplace_back("a:v ge 1 and a:v le 2 and a:v gt 0 and a:v lt 3");
+    exprvec.emplace_back("a:v == ! 1 and b:v + 1 == 2");
+    exprvec.emplace_back("1 - 2 and 3 == 3");
+    exprvec.emplace_back("/<flag>late and ../a<flag>zombie == 0 or a/b<flag>archived");
+    exprvec.emplace_back("cal::date_to_julian( a:YMD ) > cal::julian_to_date( 20200101 )");
+    exprvec.emplace_back("(../../trigger:FIRE_YMD > ../daily:YMD) or (./a:YMD - ./b:YMD < 5)");
+    for (const string& expr : exprvec) {
+        ExprParser::enable_descent(false);
+        ExprDuplicate::clear();
+        ExprParser theExprParser(expr);
+        std::string errorMsg;
+        BOOST_REQUIRE_MESSAGE(theExprParser.doParse(errorMsg), "Spirit failed to parse " << expr << " " << errorMsg);
+        std::stringstream spirit_ast;
+        theExprParser.getAst()->print_flat(spirit_ast, true /*add_brackets*/);
+
+        ExprDescentParser descentParser(expr);
+        BOOST_REQUIRE_MESSAGE(descentParser.doParse(), "Descent parser failed to parse " << expr);
+        std::stringstream descent_ast;
+        descentParser.ast()->print_flat(descent_ast, true /*add_brackets*/);
+        BOOST_CHECK_MESSAGE(spirit_ast.str() == descent_ast.str(),
+                            expr << " spirit '" << spirit_ast.str() << "' != descent '" << descent_ast.str() << "'");
+    }
+    ExprParser::enable_descent(true);
+
+    // Where spirit creates an unusual AST, the expression is left to spirit
+    exprvec.clear();
+    exprvec.emplace_back("a:v == -1");
+    exprvec.emplace_back("a == complete and AND b == complete");
+    exprvec.emplace_back("a:ev == set clear");
+    exprvec.emplace_back("a:v == 4294967295");
+    exprvec.emplace_back("a:v le b:v le 1 + 2");
+    exprvec.emplace_back("1 == 1 and 1 - 2 and 3 == 3");
+    exprvec.emplace_back("1 == 1 and !1 + 2");
+    exprvec.emplace_back("a /b == complete");
+    for (const string& expr : exprvec) {
+        ExprDescentParser descentParser(expr);
+        BOOST_CHECK_MESSAGE(!descentParser.doParse(), expr << " expected to be left to spirit");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "DurationTimer.hpp"
+#include "Ecf.hpp"
+#include "ExprAst.hpp"
+#include "Expression.hpp"
+#include "Family.hpp"
+#include "Str.hpp"
+#include "Suite.hpp"
+#include "Task.hpp"
+
+using namespace std;
+using namespace ecf;
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_variable_int_value_cache) {
+    cout << "ANode:: ...test_variable_int_value_cache\n";
+
+    Variable var("VAR", "10");
+    BOOST_CHECK_MESSAGE(var.value() == 10, "Expected 10 but found " << var.value());
+
+    var.set_value("20");
+    BOOST_CHECK_MESSAGE(var.value() == 20, "Expected set_value to invalidate the cached value " << var.value());
+
+    var.value_by_ref() = "30";
+    BOOST_CHECK_MESSAGE(var.value() == 30, "Expected value_by_ref to invalidate the cached value " << var.value());
+
+    var.set_value("fred");
+    BOOST_CHECK_MESSAGE(var.value() == 0, "Expected 0 for a non integer value but found " << var.value());
+
+    Variable copy = var;
+    copy.set_value("40");
+    BOOST_CHECK_MESSAGE(copy.value() == 40 && var.value() == 0, "Expected copies to have their own cached value");
+}
+
+BOOST_AUTO_TEST_CASE(test_parent_variable_owner_cache) {
+    cout << "ANode:: ...test_parent_variable_owner_cache\n";
+    Ecf::set_server(true);
+
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("suite");
+    suite->addVariable(Variable("VAR", "1"));
+    family_ptr fam = suite->add_family("f");
+    task_ptr task  = fam->add_task("t");
+    task->add_trigger(":VAR == 2");
+    task->triggerAst(); // create AST
+
+    const auto* var = dynamic_cast<const AstParentVariable*>(task->triggerAst()->left()->left());
+    BOOST_REQUIRE_MESSAGE(var, "Expected parent variable on the left of the trigger");
+    BOOST_CHECK_MESSAGE(var->referencedNode() == suite.get(), "Expected variable to be found on the suite");
+    BOOST_CHECK_MESSAGE(!task->triggerAst()->evaluate(), "Expected trigger to hold");
+
+    suite->add_variable("VAR", "2");
+    BOOST_CHECK_MESSAGE(task->triggerAst()->evaluate(), "Expected changed value to free the trigger");
+
+    // A variable added to a node that was searched, must be found
+    fam->add_variable("VAR", "3");
+    BOOST_CHECK_MESSAGE(var->referencedNode() == fam.get(), "Expected variable to be found on the family");
+    BOOST_CHECK_MESSAGE(!task->triggerAst()->evaluate(), "Expected the family variable to hold the trigger");
+
+    fam->deleteVariable("VAR");
+    BOOST_CHECK_MESSAGE(var->referencedNode() == suite.get(), "Expected variable to be found on the suite again");
+    BOOST_CHECK_MESSAGE(task->triggerAst()->evaluate(), "Expected the suite variable to free the trigger");
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+// Evaluate the AST of triggers that reference variables on the parent nodes
+BOOST_AUTO_TEST_CASE(test_expr_variable_perf) {
+    cout << "ANode:: ...test_expr_variable_perf\n";
+
+    defs_ptr defs   = Defs::create();
+    suite_ptr suite = defs->add_suite("suite");
+    suite->addVariable(Variable("YMD", "20240101"));
+    suite->addVariable(Variable("STEP", "12"));
+    std::vector<Ast*> triggers;
+    for (int f = 0; f < 20; f++) {
+        family_ptr fam = suite->add_family("f" + std::to_string(f));
+        family_ptr sub = fam->add_family("g");
+        for (int t = 0; t < 200; t++) {
+            task_ptr task = sub->add_task("t" + std::to_string(t));
+            task->addVariable(Variable("MEMBER", std::to_string(t)));
+            task->add_trigger(":YMD >= 20240101 and :STEP + 12 == 24 and :MEMBER < 200");
+            triggers.push_back(task->triggerAst());
+        }
+    }
+
+    // The owner of the parent variables is only cached in the server
+    const int rounds = 50;
+    for (bool server : {false, true}) {
+        Ecf::set_server(server);
+        size_t free = 0;
+        DurationTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            for (Ast* trigger : triggers) {
+                if (trigger->evaluate())
+                    free++;
+            }
+        }
+        cout << " Time for " << rounds * triggers.size() << " parent variable trigger evaluations, "
+             << (server ? "cached owner:  " : "search owner: ") << timer.elapsed() << "\n";
+        BOOST_CHECK_MESSAGE(free == rounds * triggers.size(),
+                            "Expected all triggers to evaluate, but found " << free << " of "
+                                                                            << rounds * triggers.size());
+    }
+
+    const Variable& ymd = suite->findVariable("YMD");
+    long sum            = 0;
+    {
+        DurationTimer timer;
+        for (int i = 0; i < 1000000; i++) {
+            sum += Str::to_int(ymd.theValue(), 0);
+        }
+        cout << " Time for 1000000 Str::to_int():      " << timer.elapsed() << "\n";
+    }
+    {
+        DurationTimer timer;
+        for (int i = 0; i < 1000000; i++) {
+            sum += ymd.value();
+        }
+        cout << " Time for 1000000 Variable::value():  " << timer.elapsed() << "\n";
+    }
+    BOOST_CHECK_MESSAGE(sum == 2 * 20240101L * 1000000L, "Unexpected sum " << sum);
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 // nor does it submit to any jurisdiction.
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 #include "Defs.hpp"
+#include "Ecf.hpp"
 #include "Family.hpp"
 #include "Suite.hpp"
 #include "Task.hpp"
@@ -80,4 +81,57 @@ BOOST_AUTO_TEST_CASE(test_find_abs_node_path) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_find_abs_node_path_index) {
+    cout << "ANode:: ...test_find_abs_node_path_index\n";
+
+    defs_ptr defs = Defs::create();
+    defs->enable_path_index(true);
+    suite_ptr suite = defs->add_suite("s");
+    family_ptr f1   = suite->add_family("f1");
+    family_ptr f2   = suite->add_family("f2");
+    task_ptr t1     = f1->add_task("t1");
+    f2->add_task("t1");
+
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s/f1/t1") == t1, "Expected to find /s/f1/t1");
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s/f1/t1") == t1, "Expected to find /s/f1/t1 via the index");
+    BOOST_CHECK_MESSAGE(defs->path_index().hits() == 1, "Expected 1 hit but found " << defs->path_index().hits());
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s/f1/t2"), "Expected not to find /s/f1/t2");
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s/f1/t1/t1"), "Expected not to find /s/f1/t1/t1");
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s/f4"), "Expected not to find /s/f4");
+
+    // On the client side, Ecf::modify_change_no() is not updated. Hits must be verified against the node tree
+    // Move /s/f1/t1 to /s/f3/t1
+    family_ptr f3 = suite->add_family("f3");
+    node_ptr moved = t1->remove();
+    f3->addChild(moved);
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s/f1/t1"), "Expected not to find moved task");
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s/f3/t1") == moved, "Expected to find moved task");
+
+    // Replace /s/f3/t1
+    moved->remove();
+    task_ptr replaced = f3->add_task("t1");
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s/f3/t1") == replaced, "Expected to find replaced task");
+
+    // Delete the suite, but keep it alive. The suite is no longer in defs
+    suite_ptr deleted = defs->findSuite("s");
+    BOOST_CHECK_MESSAGE(defs->deleteChild(deleted.get()), "Expected to delete suite");
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s/f3/t1"), "Expected not to find task of deleted suite");
+    BOOST_CHECK_MESSAGE(!defs->findAbsNode("/s"), "Expected not to find deleted suite");
+
+    // On the server, structural changes (Ecf::modify_change_no) clear the index
+    Ecf::set_server(true);
+    suite_ptr s2 = defs->add_suite("s2");
+    task_ptr t2  = s2->add_family("f")->add_task("t");
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s2/f/t") == t2, "Expected to find /s2/f/t");
+    BOOST_CHECK_MESSAGE(defs->path_index().size() == 1, "Expected 1 indexed path");
+    defs->add_suite("s3");
+    BOOST_CHECK_MESSAGE(defs->findAbsNode("/s3"), "Expected to find /s3");
+    BOOST_CHECK_MESSAGE(defs->path_index().size() == 1,
+                        "Expected index to be cleared after structural change, but found "
+                            << defs->path_index().size() << " paths");
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "DurationTimer.hpp"
+#include "Family.hpp"
+#include "Suite.hpp"
+#include "Task.hpp"
+
+using namespace std;
+using namespace ecf;
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+// Simulate the child commands (init, event, meter, label, complete) finding their task,
+// in a definition with wide families
+BOOST_AUTO_TEST_CASE(test_find_abs_node_path_perf) {
+    cout << "ANode:: ...test_find_abs_node_path_perf\n";
+
+    defs_ptr defs = Defs::create();
+    std::vector<std::string> paths;
+    for (int s = 0; s < 10; s++) {
+        suite_ptr suite = defs->add_suite("suite" + std::to_string(s));
+        for (int f = 0; f < 2; f++) {
+            family_ptr fam = suite->add_family("family" + std::to_string(f));
+            for (int t = 0; t < 2000; t++) {
+                task_ptr task = fam->add_task("task" + std::to_string(t));
+                paths.push_back(task->absNodePath());
+            }
+        }
+    }
+
+    const int rounds = 5;
+    std::vector<node_ptr> found;
+    found.reserve(paths.size());
+    {
+        DurationTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            found.clear();
+            for (const auto& path : paths) {
+                found.push_back(defs->findAbsNode(path));
+            }
+        }
+        cout << " Time for " << rounds * paths.size() << " findAbsNode, without path index: " << timer.elapsed()
+             << "\n";
+    }
+
+    defs->enable_path_index(true);
+    {
+        DurationTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < paths.size(); i++) {
+                node_ptr node = defs->findAbsNode(paths[i]);
+                if (node != found[i]) {
+                    BOOST_CHECK_MESSAGE(node == found[i], "Path index returned different node for " << paths[i]);
+                    break;
+                }
+            }
+        }
+        cout << " Time for " << rounds * paths.size() << " findAbsNode, with path index:    " << timer.elapsed()
+             << "\n";
+    }
+    BOOST_CHECK_MESSAGE(defs->path_index().size() == paths.size(),
+                        "Expected " << paths.size() << " indexed paths but found " << defs->path_index().size());
+    BOOST_CHECK_MESSAGE(defs->path_index().hits() == (rounds - 1) * paths.size(),
+                        "Expected " << (rounds - 1) * paths.size() << " hits but found "
+                                    << defs->path_index().hits());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
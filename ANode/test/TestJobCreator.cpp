@@ -12,6 +12,7 @@
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 #include <iostream>
 
+#include <boost/filesystem/operations.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "Defs.hpp"
@@ -24,6 +25,7 @@
 #include "System.hpp"
 #include "Task.hpp"
 
+namespace fs = boost::filesystem;
 using namespace std;
 using namespace ecf;
 
@@ -111,4 +113,51 @@ BOOST_AUTO_TEST_CASE(test_job_creator) {
     System::destroy();
 }
 
+BOOST_AUTO_TEST_CASE(test_job_batch_cmd) {
+    cout << "ANode:: ...test_job_batch_cmd\n";
+
+    std::string ecf_home = File::test_data("ANode/test/data/SMSHOME", "ANode");
+
+    // Tasks with the same (substituted) ECF_JOB_BATCH_CMD are submitted together
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    suite->addVariable(Variable(Str::ECF_INCLUDE(), "$ECF_HOME/../includes"));
+    suite->addVariable(Variable("SLEEPTIME", "1"));
+    suite->addVariable(Variable("ECF_CLIENT_EXE_PATH", "a/made/up/path"));
+    suite->addVariable(Variable("QUEUE", "normal"));
+    suite->addVariable(Variable(Str::ECF_JOB_BATCH_CMD(), "submit_batch %QUEUE%"));
+    family_ptr fam = suite->add_family("family");
+    fam->add_task("t1");
+    fam->add_task("t2");
+    task_ptr t3 = fam->add_task("t3");
+    t3->addVariable(Variable("QUEUE", "express"));
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    JobsParam jobsParam(true /*create jobs*/); // spawn_jobs = false
+    Jobs jobs(&theDefs);
+    jobs.generate(jobsParam);
+    BOOST_REQUIRE_MESSAGE(jobsParam.submitted().size() == 3,
+                          "expected 3 jobs but found " << jobsParam.submitted().size() << "\n"
+                                                       << jobsParam.errorMsg());
+
+    std::vector<JobsParam::JobBatch>& batches = jobsParam.job_batches();
+    BOOST_REQUIRE_MESSAGE(batches.size() == 2, "Expected 2 batches but found " << batches.size());
+    BOOST_CHECK_MESSAGE(batches[0].cmd_ == "submit_batch normal" && batches[0].submittables_.size() == 2,
+                        "Expected t1 and t2 to be batched, but found " << batches[0].cmd_ << " "
+                                                                        << batches[0].submittables_.size());
+    BOOST_CHECK_MESSAGE(batches[1].cmd_ == "submit_batch express" && batches[1].submittables_.size() == 1 &&
+                            batches[1].submittables_[0] == t3.get(),
+                        "Expected t3 to be in a separate batch");
+    BOOST_CHECK_MESSAGE(batches[1].job_files_[0] == ecf_home + "/suite/family/t3.job1",
+                        "Expected job file of t3, but found " << batches[1].job_files_[0]);
+    for (Submittable* t : jobsParam.submitted()) {
+        BOOST_CHECK_MESSAGE(t->state() == NState::SUBMITTED, "Expected " << t->absNodePath() << " to be submitted");
+        fs::remove(ecf_home + t->absNodePath() + ".job1");
+    }
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
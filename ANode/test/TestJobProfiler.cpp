@@ -19,12 +19,14 @@
 #include "Defs.hpp"
 #include "Family.hpp"
 #include "File.hpp"
+#include "JobProfiler.hpp"
 #include "Jobs.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
 #include "Str.hpp"
 #include "Suite.hpp"
 #include "System.hpp"
+#include "Task.hpp"
 
 using namespace std;
 using namespace ecf;
@@ -81,4 +83,76 @@ BOOST_AUTO_TEST_CASE(test_job_profiler) {
     System::destroy();
 }
 
+BOOST_AUTO_TEST_CASE(test_job_phase_profile) {
+    cout << "ANode:: ...test_job_phase_profile\n";
+
+    std::string ecf_home = File::test_data("ANode/test/data/SMSHOME", "ANode");
+    auto generate        = [&ecf_home]() {
+        Defs theDefs;
+        suite_ptr suite = theDefs.add_suite("suite");
+        suite->addVariable(Variable(Str::ECF_INCLUDE(), File::test_data("ANode/test/data/includes", "ANode")));
+        suite->addVariable(Variable("ECF_HOME", ecf_home));
+        suite->addVariable(Variable("SLEEPTIME", "10"));
+        family_ptr fam = suite->add_family("family");
+        task_ptr t1    = fam->add_task("t1");
+        theDefs.beginAll();
+
+        JobsParam jobParam(true /*createJobs*/); // spawn jobs = false
+        Jobs job(&theDefs);
+        BOOST_CHECK_MESSAGE(job.generate(jobParam), "generate failed: " << jobParam.getErrorMsg());
+        BOOST_CHECK_MESSAGE(t1->state() == NState::SUBMITTED, "Expected task t1 to be submitted");
+    };
+
+    // Disabled by default, nothing is recorded
+    JobProfiler::reset_phases();
+    generate();
+    size_t polls = 0;
+    (void)JobProfiler::phase_histograms(polls);
+    BOOST_CHECK_MESSAGE(polls == 0, "Expected no profiled polls but found " << polls);
+    BOOST_CHECK_MESSAGE(!JobProfiler::profiling(), "Expected profiling to be disabled");
+
+    // Only the last 2 polls are kept
+    JobProfiler::set_profile_polls(2);
+    for (int i = 0; i < 3; i++)
+        generate();
+    BOOST_CHECK_MESSAGE(!JobProfiler::profiling(), "Expected profiling to stop at the end of the poll");
+
+    std::vector<JobPhaseHistogram> histograms = JobProfiler::phase_histograms(polls);
+    BOOST_CHECK_MESSAGE(polls == 2, "Expected 2 profiled polls but found " << polls);
+    BOOST_REQUIRE_MESSAGE(histograms.size() == JobProfiler::NO_OF_PHASES,
+                          "Expected a histogram for each phase but found " << histograms.size());
+    for (int phase = 0; phase < JobProfiler::NO_OF_PHASES; phase++) {
+        const JobPhaseHistogram& histogram = histograms[phase];
+        BOOST_CHECK_MESSAGE(histogram.phase_ == JobProfiler::to_string(static_cast<JobProfiler::Phase>(phase)),
+                            "Unexpected phase name " << histogram.phase_);
+
+        // One job per poll, the job is not spawned
+        std::uint64_t expected = (phase == JobProfiler::SPAWN) ? 0 : 2;
+        BOOST_CHECK_MESSAGE(histogram.count_ == expected,
+                            "Expected " << expected << " samples for phase " << histogram.phase_ << " but found "
+                                        << histogram.count_);
+
+        std::uint64_t samples = 0;
+        for (std::uint64_t bucket : histogram.buckets_)
+            samples += bucket;
+        BOOST_CHECK_MESSAGE(histogram.buckets_.size() == JobProfiler::NO_OF_BUCKETS && samples == histogram.count_,
+                            "Expected the buckets of phase " << histogram.phase_ << " to hold each sample");
+        BOOST_CHECK_MESSAGE(histogram.max_us_ <= histogram.total_us_, "Expected max <= total");
+    }
+    BOOST_CHECK_MESSAGE(histograms[JobProfiler::DEPENDENCIES].total_us_ <= histograms[JobProfiler::POLL].total_us_,
+                        "Expected the dependency resolution to exclude the job creation");
+
+    std::string report = JobProfiler::phase_report();
+    cout << report;
+    BOOST_CHECK_MESSAGE(report.find("last 2 polls") != std::string::npos, "Unexpected report " << report);
+    BOOST_CHECK_MESSAGE(report.find("pre_process") != std::string::npos, "Unexpected report " << report);
+
+    JobProfiler::set_profile_polls(0);
+    JobProfiler::reset_phases();
+    fs::remove(ecf_home + "/suite/family/t1.job1");
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
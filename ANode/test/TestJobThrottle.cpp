@@ -0,0 +1,154 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "Ecf.hpp"
+#include "Family.hpp"
+#include "File.hpp"
+#include "JobThrottle.hpp"
+#include "Jobs.hpp"
+#include "JobsParam.hpp"
+#include "Signal.hpp"
+#include "Str.hpp"
+#include "Suite.hpp"
+#include "System.hpp"
+#include "Task.hpp"
+
+namespace fs = boost::filesystem;
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+void generate(Defs& theDefs, bool spawn_jobs = false) {
+    JobsParam jobsParam(60 /*submitJobsInterval*/, true /*createJobs*/, spawn_jobs);
+    jobsParam.set_throttle_jobs(true);
+    jobsParam.set_use_dependency_index(true);
+    Jobs jobs(&theDefs);
+    BOOST_CHECK_MESSAGE(jobs.generate(jobsParam), "generate failed: " << jobsParam.getErrorMsg());
+}
+
+size_t submitted(const std::vector<task_ptr>& tasks) {
+    size_t count = 0;
+    for (const task_ptr& t : tasks) {
+        if (t->state() == NState::SUBMITTED)
+            count++;
+        else {
+            BOOST_CHECK_MESSAGE(t->state() == NState::QUEUED,
+                                "Expected task " << t->absNodePath() << " to be queued but found "
+                                                 << NState::toString(t->state()));
+            BOOST_CHECK_MESSAGE(t->try_no() == 0, "Expected try number 0 but found " << t->try_no());
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_job_throttle) {
+    cout << "ANode:: ...test_job_throttle\n";
+
+    Ecf::set_server(true); // needed for state change numbers, used by the DependencyIndex
+
+    std::string ecf_home = File::test_data("ANode/test/data/job_throttle", "ANode");
+    fs::remove_all(ecf_home);
+    fs::create_directories(ecf_home + "/files");
+    for (int i = 0; i < 3; i++) {
+        std::vector<std::string> lines{"echo %ECF_NAME%"};
+        std::string err;
+        BOOST_REQUIRE_MESSAGE(File::create(ecf_home + "/files/t" + std::to_string(i) + ".ecf", lines, err), err);
+    }
+
+    // Family a and b submit to different hosts, family c has no ECF_JOB_HOST
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    suite->addVariable(Variable(Str::ECF_FILES(), ecf_home + "/files"));
+    suite->addVariable(Variable(Str::ECF_JOB_CMD(), "sleep 1"));
+    std::vector<task_ptr> tasks;
+    for (const auto& name : {"a", "b", "c"}) {
+        family_ptr f = suite->add_family(name);
+        if (std::string(name) != "c")
+            f->addVariable(Variable(Str::ECF_JOB_HOST(), std::string("host_") + name));
+        for (int i = 0; i < 3; i++)
+            tasks.push_back(f->add_task("t" + std::to_string(i)));
+    }
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    JobThrottle& throttle = JobThrottle::instance();
+    throttle.clear();
+
+    // At most 4 jobs for each job generation, and 1 for each host. Excess tasks stay queued.
+    throttle.set_rate(4);
+    throttle.set_host_rate(1);
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 4, "Expected 4 submitted tasks but found " << submitted(tasks));
+    BOOST_CHECK_MESSAGE(tasks[0]->state() == NState::SUBMITTED && tasks[3]->state() == NState::SUBMITTED,
+                        "Expected the first task of each host to be submitted");
+    BOOST_CHECK_MESSAGE(throttle.queue_depth() == 5, "Expected queue depth 5 but found " << throttle.queue_depth());
+
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 7, "Expected 7 submitted tasks but found " << submitted(tasks));
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 9, "Expected 9 submitted tasks but found " << submitted(tasks));
+    BOOST_CHECK_MESSAGE(throttle.queue_depth() == 0, "Expected queue depth 0 but found " << throttle.queue_depth());
+    BOOST_CHECK_MESSAGE(throttle.max_queue_depth() == 5,
+                        "Expected max queue depth 5 but found " << throttle.max_queue_depth());
+    BOOST_CHECK_MESSAGE(throttle.deferrals() == 7, "Expected 7 deferrals but found " << throttle.deferrals());
+
+    // The job commands still running, count against the limit
+    theDefs.requeue();
+    throttle.clear();
+    throttle.set_rate(2);
+    throttle.set_host_rate(0);
+    generate(theDefs, true /* spawn jobs */);
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 2, "Expected 2 submitted tasks but found " << submitted(tasks));
+    unsigned int state_change_no = Ecf::state_change_no();
+    generate(theDefs, true);
+    BOOST_CHECK_MESSAGE(throttle.backlog() == 2, "Expected a backlog of 2 but found " << throttle.backlog());
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 2, "Expected no more submitted tasks, whilst the jobs commands run");
+    BOOST_CHECK_MESSAGE(Ecf::state_change_no() == state_change_no, "Expected no state change for deferred tasks");
+
+    while (System::instance()->process() > 0) {
+        Signal unblock_on_desctruction_then_reblock;
+        System::instance()->processTerminatedChildren();
+    }
+    generate(theDefs, true);
+    BOOST_CHECK_MESSAGE(throttle.backlog() == 0, "Expected no backlog but found " << throttle.backlog());
+    BOOST_CHECK_MESSAGE(submitted(tasks) == 4, "Expected 4 submitted tasks but found " << submitted(tasks));
+    while (System::instance()->process() > 0) {
+        Signal unblock_on_desctruction_then_reblock;
+        System::instance()->processTerminatedChildren();
+    }
+
+    throttle.clear();
+    throttle.set_rate(0);
+    fs::remove_all(ecf_home);
+
+    Ecf::set_server(false);
+    Ecf::set_state_change_no(0);
+    Ecf::set_modify_change_no(0);
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "Family.hpp"
+#include "File.hpp"
+#include "InLimit.hpp"
+#include "Jobs.hpp"
+#include "JobsParam.hpp"
+#include "Limit.hpp"
+#include "Str.hpp"
+#include "Suite.hpp"
+#include "System.hpp"
+#include "Task.hpp"
+
+namespace fs = boost::filesystem;
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+const int NO_OF_TASKS = 10;
+
+struct Result
+{
+    std::vector<std::string> submitted_;
+    std::vector<std::string> states_;
+    std::vector<std::string> jobs_;
+    std::string error_msg_;
+    int limit_value_{0};
+};
+
+// The tasks t0...t9 share a limit of 4. Task 'missing' has no script, and the script of
+// task 'bad' references an undefined variable.
+Result generate(const std::string& ecf_home, size_t job_threads) {
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    suite->addVariable(Variable("SLEEPTIME", "1"));
+    suite->addLimit(Limit("lim", 4));
+    family_ptr f = suite->add_family("f");
+    f->addInLimit(InLimit("lim", "/suite"));
+    for (int i = 0; i < NO_OF_TASKS; i++)
+        f->add_task("t" + std::to_string(i));
+    family_ptr g = suite->add_family("g");
+    g->add_task("missing");
+    g->add_task("bad");
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    JobsParam jobsParam(true /*create jobs*/); // spawn_jobs = false
+    jobsParam.set_job_threads(job_threads);
+    Jobs jobs(&theDefs);
+    jobs.generate(jobsParam);
+
+    Result result;
+    for (Submittable* t : jobsParam.submitted())
+        result.submitted_.push_back(t->absNodePath());
+    std::vector<Task*> tasks;
+    theDefs.getAllTasks(tasks);
+    for (Task* t : tasks) {
+        result.states_.push_back(t->absNodePath() + " " + NState::toString(t->state()));
+        std::string job;
+        File::open(ecf_home + t->absNodePath() + ".job1", job);
+        result.jobs_.push_back(job);
+        fs::remove(ecf_home + t->absNodePath() + ".job1");
+    }
+    result.error_msg_   = jobsParam.getErrorMsg();
+    result.limit_value_ = suite->find_limit("lim")->value();
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_parallel_job_creation) {
+    cout << "ANode:: ...test_parallel_job_creation\n";
+
+    std::string ecf_home = File::test_data("ANode/test/data/parallel_job_creation", "ANode");
+    fs::remove_all(ecf_home);
+    fs::create_directories(ecf_home + "/suite/f");
+    fs::create_directories(ecf_home + "/suite/g");
+    for (int i = 0; i < NO_OF_TASKS; i++) {
+        std::string err;
+        std::vector<std::string> lines{"echo %ECF_NAME% %SLEEPTIME% %ECF_TRYNO%"};
+        BOOST_REQUIRE_MESSAGE(File::create(ecf_home + "/suite/f/t" + std::to_string(i) + ".ecf", lines, err), err);
+    }
+    {
+        std::string err;
+        std::vector<std::string> lines{"echo %UNDEFINED_VARIABLE%"};
+        BOOST_REQUIRE_MESSAGE(File::create(ecf_home + "/suite/g/bad.ecf", lines, err), err);
+    }
+
+    Result serial   = generate(ecf_home, 0);
+    Result parallel = generate(ecf_home, 4);
+
+    // Parallel job creation must be indistinguishable from serial job creation
+    BOOST_CHECK_MESSAGE(serial.submitted_.size() == 4, "Expected 4 jobs, limited by lim, but found "
+                                                           << serial.submitted_.size());
+    BOOST_CHECK_MESSAGE(serial.submitted_ == parallel.submitted_, "Expected same jobs submitted in same order");
+    BOOST_CHECK_MESSAGE(serial.states_ == parallel.states_, "Expected the same task states");
+    BOOST_CHECK_MESSAGE(serial.jobs_ == parallel.jobs_, "Expected the same job files");
+    BOOST_CHECK_MESSAGE(serial.limit_value_ == 4 && parallel.limit_value_ == 4,
+                        "Expected limit value 4 but found " << serial.limit_value_ << " and "
+                                                            << parallel.limit_value_);
+    BOOST_CHECK_MESSAGE(serial.error_msg_ == parallel.error_msg_, "Expected the same errors:\n"
+                                                                      << serial.error_msg_ << "\n---\n"
+                                                                      << parallel.error_msg_);
+    for (const auto& state : parallel.states_) {
+        if (state.find("/suite/g/") == 0)
+            BOOST_CHECK_MESSAGE(state.find("aborted") != std::string::npos, "Expected aborted: " << state);
+    }
+    for (size_t i = 0; i < parallel.submitted_.size(); i++) {
+        BOOST_CHECK_MESSAGE(parallel.jobs_[i].find("echo " + parallel.submitted_[i] + " 1 1") != std::string::npos,
+                            "Expected job file of " << parallel.submitted_[i] << " but found " << parallel.jobs_[i]);
+    }
+
+    fs::remove_all(ecf_home);
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,223 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "File.hpp"
+#include "Jobs.hpp"
+#include "JobsParam.hpp"
+#include "Limit.hpp"
+#include "ScriptFetcher.hpp"
+#include "Signal.hpp"
+#include "Str.hpp"
+#include "Suite.hpp"
+#include "System.hpp"
+#include "Task.hpp"
+
+namespace fs = boost::filesystem;
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+void generate(Defs& theDefs, size_t job_threads = 0) {
+    JobsParam jobsParam(true /*create jobs*/); // spawn_jobs = false
+    jobsParam.set_async_fetch(true);
+    jobsParam.set_job_threads(job_threads);
+    Jobs jobs(&theDefs);
+    jobs.generate(jobsParam);
+}
+
+void wait_for_fetches(size_t running) {
+    while (ScriptFetcher::instance().running() > running) {
+        Signal unblock_on_desctruction_then_reblock;
+        System::instance()->processTerminatedChildren();
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_script_fetcher) {
+    cout << "ANode:: ...test_script_fetcher\n";
+
+    std::string ecf_home = File::test_data("ANode/test/data/script_fetcher", "ANode");
+    fs::remove_all(ecf_home);
+    fs::create_directories(ecf_home + "/scripts");
+    {
+        std::string err;
+        std::vector<std::string> lines{"echo fetched %ECF_NAME% %ECF_TRYNO%"};
+        BOOST_REQUIRE_MESSAGE(File::create(ecf_home + "/scripts/ok.ecf", lines, err), err);
+    }
+
+    // The script of task 'fail' does not exist, and the command for task 'slow' times out
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    task_ptr ok     = suite->add_task("ok");
+    ok->addVariable(Variable("ECF_SCRIPT_CMD", "cat " + ecf_home + "/scripts/ok.ecf"));
+    task_ptr fail = suite->add_task("fail");
+    fail->addVariable(Variable("ECF_SCRIPT_CMD", "cat " + ecf_home + "/scripts/fail.ecf"));
+    task_ptr slow = suite->add_task("slow");
+    slow->addVariable(Variable("ECF_SCRIPT_CMD", "sleep 30"));
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    ScriptFetcher::instance().clear();
+    ScriptFetcher::instance().set_max_fetches(2);
+    ScriptFetcher::instance().set_timeout(1);
+
+    // A task waiting for its script keeps its state, i.e. the reason it previously aborted
+    slow->aborted("previous abort");
+    slow->set_state(NState::QUEUED);
+    std::string slow_password = slow->jobsPassword();
+
+    // The first job generation only starts the commands, limited to 2, the tasks stay queued
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().running() == 2,
+                        "Expected 2 running fetches but found " << ScriptFetcher::instance().running());
+    for (const task_ptr& t : {ok, fail, slow}) {
+        BOOST_CHECK_MESSAGE(t->state() == NState::QUEUED,
+                            "Expected task " << t->name() << " to be queued but found " << NState::toString(t->state()));
+        BOOST_CHECK_MESSAGE(t->try_no() == 0, "Expected try number 0 but found " << t->try_no());
+    }
+    BOOST_CHECK_MESSAGE(!fs::exists(ecf_home + "/suite/ok.job1"), "Expected no job file");
+    BOOST_CHECK_MESSAGE(slow->abortedReason() == "previous abort",
+                        "Expected aborted reason to be kept but found " << slow->abortedReason());
+    BOOST_CHECK_MESSAGE(slow->jobsPassword() == slow_password, "Expected the password to be kept");
+    wait_for_fetches(0);
+
+    // The next job generation uses the output of the commands, and starts the remaining command
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(ok->state() == NState::SUBMITTED,
+                        "Expected task ok to be submitted but found " << NState::toString(ok->state()));
+    BOOST_CHECK_MESSAGE(fail->state() == NState::ABORTED,
+                        "Expected task fail to be aborted but found " << NState::toString(fail->state()));
+    BOOST_CHECK_MESSAGE(slow->state() == NState::QUEUED,
+                        "Expected task slow to be queued but found " << NState::toString(slow->state()));
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().running() == 1,
+                        "Expected 1 running fetch but found " << ScriptFetcher::instance().running());
+    std::string job;
+    BOOST_CHECK_MESSAGE(File::open(ecf_home + "/suite/ok.job1", job), "Expected job file for task ok");
+    BOOST_CHECK_MESSAGE(job.find("echo fetched /suite/ok 1") != std::string::npos,
+                        "Expected the fetched script in the job file but found " << job);
+
+    // The command for task slow is killed, once it has timed out
+    sleep(2);
+    generate(theDefs);
+    wait_for_fetches(0);
+    generate(theDefs);
+    BOOST_CHECK_MESSAGE(slow->state() == NState::ABORTED,
+                        "Expected task slow to be aborted but found " << NState::toString(slow->state()));
+    BOOST_CHECK_MESSAGE(slow->abortedReason().find("timed out") != std::string::npos,
+                        "Expected timed out in aborted reason but found " << slow->abortedReason());
+
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().fetches() == 3,
+                        "Expected 3 fetches but found " << ScriptFetcher::instance().fetches());
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().failures() == 2,
+                        "Expected 2 failures but found " << ScriptFetcher::instance().failures());
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().timeouts() == 1,
+                        "Expected 1 timeout but found " << ScriptFetcher::instance().timeouts());
+
+    ScriptFetcher::instance().clear();
+    ScriptFetcher::instance().set_max_fetches(8);
+    ScriptFetcher::instance().set_timeout(60);
+    fs::remove_all(ecf_home);
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
+BOOST_AUTO_TEST_CASE(test_script_fetcher_job_threads) {
+    cout << "ANode:: ...test_script_fetcher_job_threads\n";
+
+    // the commands. The commands are started afterwards, and the tasks stay queued until the output is available
+    // the commands. The commands are started afterwards, the tasks stay queued until the output is available
+    std::string ecf_home = File::test_data("ANode/test/data/script_fetcher_job_threads", "ANode");
+    fs::remove_all(ecf_home);
+    fs::create_directories(ecf_home + "/scripts");
+
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    suite->addLimit(Limit("lim", 4));
+    suite->addInLimit(InLimit("lim", "/suite"));
+    std::vector<task_ptr> tasks;
+    for (int i = 0; i < 4; i++) {
+        task_ptr t = suite->add_task("t" + std::to_string(i));
+        std::string script = ecf_home + "/scripts/" + t->name() + ".ecf";
+        std::string err;
+        std::vector<std::string> lines{"echo fetched %ECF_NAME% %ECF_TRYNO%"};
+        BOOST_REQUIRE_MESSAGE(File::create(script, lines, err), err);
+        t->addVariable(Variable("ECF_SCRIPT_CMD", "sleep 1; cat " + script));
+        tasks.push_back(t);
+    }
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    ScriptFetcher::instance().clear();
+    std::vector<std::string> passwords;
+    for (const task_ptr& t : tasks)
+        passwords.push_back(t->jobsPassword());
+
+    // The first job generation starts the commands, the tasks stay queued and unchanged
+    generate(theDefs, 4);
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().running() == 4,
+                        "Expected 4 running fetches but found " << ScriptFetcher::instance().running());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        const task_ptr& t = tasks[i];
+        BOOST_CHECK_MESSAGE(t->state() == NState::QUEUED,
+                            "Expected task " << t->name() << " to be queued but found " << NState::toString(t->state()));
+        BOOST_CHECK_MESSAGE(t->try_no() == 0, "Expected try number 0 but found " << t->try_no());
+        BOOST_CHECK_MESSAGE(t->jobsPassword() == passwords[i], "Expected the password to be kept");
+        BOOST_CHECK_MESSAGE(!fs::exists(ecf_home + t->absNodePath() + ".job1"), "Expected no job file");
+    }
+    limit_ptr lim = suite->find_limit("lim");
+    BOOST_CHECK_MESSAGE(lim->value() == 0, "Expected the limit to be released but found " << lim->value());
+
+    // Whilst the commands are running, the tasks stay queued
+    generate(theDefs, 4);
+    if (ScriptFetcher::instance().running() != 0) {
+        for (const task_ptr& t : tasks) {
+            BOOST_CHECK_MESSAGE(t->state() == NState::QUEUED,
+                                "Expected task " << t->name() << " to be queued whilst fetched but found "
+                                                 << NState::toString(t->state()));
+        }
+    }
+    wait_for_fetches(0);
+
+    // The next job generation creates the jobs from the output of the commands
+    generate(theDefs, 4);
+    for (const task_ptr& t : tasks) {
+        BOOST_CHECK_MESSAGE(t->state() == NState::SUBMITTED,
+                            "Expected task " << t->name() << " to be submitted but found "
+                                             << NState::toString(t->state()));
+        std::string job;
+        BOOST_CHECK_MESSAGE(File::open(ecf_home + t->absNodePath() + ".job1", job), "Expected a job file");
+        BOOST_CHECK_MESSAGE(job.find("echo fetched " + t->absNodePath() + " 1") != std::string::npos,
+                            "Expected the fetched script in the job file but found " << job);
+    }
+    BOOST_CHECK_MESSAGE(lim->value() == 4, "Expected the limit to be consumed but found " << lim->value());
+    BOOST_CHECK_MESSAGE(ScriptFetcher::instance().fetches() == 4,
+                        "Expected 4 fetches but found " << ScriptFetcher::instance().fetches());
+
+    ScriptFetcher::instance().clear();
+    fs::remove_all(ecf_home);
+    System::destroy();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
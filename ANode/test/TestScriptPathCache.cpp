@@ -0,0 +1,159 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Defs.hpp"
+#include "Family.hpp"
+#include "File.hpp"
+#include "JobProfiler.hpp"
+#include "Jobs.hpp"
+#include "JobsParam.hpp"
+#include "ScriptPathCache.hpp"
+#include "Str.hpp"
+#include "Suite.hpp"
+#include "System.hpp"
+#include "Task.hpp"
+
+namespace fs = boost::filesystem;
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+const int NO_OF_TASKS = 5;
+
+struct Result
+{
+    std::vector<std::string> states_;
+    std::vector<std::string> jobs_;
+    std::uint64_t script_probes_{0};
+    std::uint64_t include_probes_{0};
+};
+
+// The scripts of tasks t0...t4 are found by searching ECF_FILES, and include <head.h> is
+// found in the last ECF_INCLUDE directory. Task 'missing' has no script.
+Result generate(const std::string& ecf_home) {
+    Defs theDefs;
+    suite_ptr suite = theDefs.add_suite("suite");
+    suite->addVariable(Variable(Str::ECF_FILES(), ecf_home + "/files"));
+    suite->addVariable(Variable(Str::ECF_INCLUDE(), ecf_home + "/inc1:" + ecf_home + "/inc2:" + ecf_home + "/inc3"));
+    family_ptr f = suite->add_family("f");
+    for (int i = 0; i < NO_OF_TASKS; i++)
+        f->add_task("t" + std::to_string(i));
+    f->add_task("missing");
+    theDefs.set_server().add_or_update_user_variables(Str::ECF_HOME(), ecf_home);
+    theDefs.beginAll();
+
+    JobProfiler::reset_file_probes();
+    JobsParam jobsParam(true /*create jobs*/); // spawn_jobs = false
+    Jobs jobs(&theDefs);
+    jobs.generate(jobsParam);
+
+    Result result;
+    result.script_probes_  = JobProfiler::file_probes(false);
+    result.include_probes_ = JobProfiler::file_probes(true);
+    std::vector<Task*> tasks;
+    theDefs.getAllTasks(tasks);
+    for (Task* t : tasks) {
+        result.states_.push_back(t->absNodePath() + " " + NState::toString(t->state()));
+        std::string job;
+        File::open(ecf_home + t->absNodePath() + ".job1", job);
+        result.jobs_.push_back(job);
+        fs::remove(ecf_home + t->absNodePath() + ".job1");
+    }
+    return result;
+}
+
+void create_file(const std::string& path, const std::string& line) {
+    std::string err;
+    std::vector<std::string> lines{line};
+    BOOST_REQUIRE_MESSAGE(File::create(path, lines, err), err);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_script_path_cache) {
+    cout << "ANode:: ...test_script_path_cache\n";
+
+    std::string ecf_home = File::test_data("ANode/test/data/script_path_cache", "ANode");
+    fs::remove_all(ecf_home);
+    fs::create_directories(ecf_home + "/suite/f");
+    for (const auto& dir : {"files", "inc1", "inc2", "inc3"})
+        fs::create_directories(ecf_home + "/" + dir);
+    for (int i = 0; i < NO_OF_TASKS; i++)
+        create_file(ecf_home + "/files/t" + std::to_string(i) + ".ecf", "%include <head.h>\necho %ECF_NAME%");
+    create_file(ecf_home + "/inc3/head.h", "echo inc3");
+
+    Result uncached = generate(ecf_home);
+    for (const auto& state : uncached.states_) {
+        bool missing = state.find("missing") != std::string::npos;
+        BOOST_CHECK_MESSAGE(state.find(missing ? "aborted" : "submitted") != std::string::npos, "Unexpected " << state);
+    }
+
+    ScriptPathCache& cache = ScriptPathCache::instance();
+    cache.clear();
+    cache.enable(true);
+    cache.set_negative_ttl(600);
+
+    Result cold = generate(ecf_home);
+    Result warm = generate(ecf_home);
+    BOOST_CHECK_MESSAGE(cold.states_ == uncached.states_ && warm.states_ == uncached.states_,
+                        "Expected the same task states");
+    BOOST_CHECK_MESSAGE(cold.jobs_ == uncached.jobs_ && warm.jobs_ == uncached.jobs_, "Expected the same job files");
+
+    // Each cached location is checked once, and the failed search is not repeated.
+    // Note: include files are only stat'ed once for each job generation (see EcfFile::file_exists)
+    cout << "   Script probes " << uncached.script_probes_ << " uncached, " << warm.script_probes_ << " cached\n";
+    cout << "   Include probes " << uncached.include_probes_ << " uncached, " << warm.include_probes_ << " cached\n";
+    BOOST_CHECK_MESSAGE(warm.script_probes_ == NO_OF_TASKS,
+                        "Expected " << NO_OF_TASKS << " script probes but found " << warm.script_probes_);
+    BOOST_CHECK_MESSAGE(warm.include_probes_ == 1, "Expected 1 include probe but found " << warm.include_probes_);
+    BOOST_CHECK_MESSAGE(uncached.script_probes_ > 4 * NO_OF_TASKS, "Expected more probes without the cache");
+    BOOST_CHECK_MESSAGE(uncached.include_probes_ == 3,
+                        "Expected 3 include probes but found " << uncached.include_probes_);
+
+    // New files are only found, once the cache is cleared
+    create_file(ecf_home + "/files/missing.ecf", "echo missing");
+    create_file(ecf_home + "/inc1/head.h", "echo inc1");
+    Result stale = generate(ecf_home);
+    BOOST_CHECK_MESSAGE(stale.states_ == uncached.states_, "Expected the same task states, before clear");
+    BOOST_CHECK_MESSAGE(stale.jobs_ == uncached.jobs_, "Expected the same job files, before clear");
+
+    cache.clear();
+    Result cleared = generate(ecf_home);
+    for (size_t i = 0; i < cleared.states_.size(); i++) {
+        BOOST_CHECK_MESSAGE(cleared.states_[i].find("submitted") != std::string::npos,
+                            "Expected submitted " << cleared.states_[i]);
+        if (cleared.states_[i].find("missing") == std::string::npos) {
+            BOOST_CHECK_MESSAGE(cleared.jobs_[i].find("echo inc1") != std::string::npos,
+                                "Expected include file from inc1 but found " << cleared.jobs_[i]);
+        }
+    }
+
+    cache.clear();
+    cache.enable(false);
+    cache.set_negative_ttl(60);
+    fs::remove_all(ecf_home);
+
+    /// Destroy System singleton to avoid valgrind from complaining
+    System::destroy();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
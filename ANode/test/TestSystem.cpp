@@ -16,8 +16,13 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include "Defs.hpp"
+#include "File.hpp"
+#include "DurationTimer.hpp"
 #include "Signal.hpp"
+#include "Suite.hpp"
 #include "System.hpp"
+#include "Task.hpp"
 
 using namespace std;
 using namespace ecf;
@@ -46,4 +51,102 @@ BOOST_AUTO_TEST_CASE(test_system) {
     fs::remove(file); // Remove the file. Comment out for debugging
 }
 
+BOOST_AUTO_TEST_CASE(test_system_posix_spawn) {
+    cout << "ANode:: ...test_system_posix_spawn \n";
+    if (!System::posix_spawn_supported()) {
+        cout << "   posix_spawn not supported, ignoring test\n";
+        return;
+    }
+
+    // Compare the time to spawn with fork and posix_spawn, and check the processes are reaped in the same way
+    const int no_of_cmds = 50;
+    for (bool use_posix_spawn : {false, true}) {
+        System::instance()->set_use_posix_spawn(use_posix_spawn);
+
+        std::string file = "test_system_posix_spawn.log";
+        std::string cmd  = "echo sat siri akal dunyia > " + file;
+        std::string errorMsg;
+        {
+            DurationTimer timer;
+            BOOST_REQUIRE_MESSAGE(System::instance()->spawn(System::ECF_STATUS_CMD, cmd, "", errorMsg),
+                                  "System::instance()->spawn() failed: " << errorMsg);
+            for (int i = 1; i < no_of_cmds; i++) {
+                BOOST_REQUIRE_MESSAGE(System::instance()->spawn(System::ECF_STATUS_CMD, "exit 1", "", errorMsg),
+                                      "System::instance()->spawn() failed: " << errorMsg);
+            }
+            cout << "   Time to spawn " << no_of_cmds << " commands with " << (use_posix_spawn ? "posix_spawn" : "fork")
+                 << ": " << timer.elapsed().total_microseconds() << "us\n";
+        }
+        BOOST_CHECK_MESSAGE(System::instance()->process() == no_of_cmds,
+                            "Expected " << no_of_cmds << " processes but found " << System::instance()->process());
+
+        while (System::instance()->process() != 0) {
+            Signal unblock_on_desctruction_then_reblock;
+            System::instance()->processTerminatedChildren();
+        }
+
+        BOOST_CHECK_MESSAGE(fs::exists(file), "Expected cmd(" << cmd << ") to produce a file " << file);
+        fs::remove(file);
+    }
+    System::instance()->set_use_posix_spawn(false);
+}
+
+BOOST_AUTO_TEST_CASE(test_system_spawn_batch) {
+    cout << "ANode:: ...test_system_spawn_batch \n";
+
+    defs_ptr defs = Defs::create();
+    suite_ptr s   = defs->add_suite("s");
+    std::vector<std::string> paths, job_files;
+    for (const auto& name : {"a", "b", "c"}) {
+        task_ptr t = s->add_task(name);
+        t->set_state(NState::SUBMITTED);
+        paths.push_back(t->absNodePath());
+        job_files.push_back("/made up" + t->absNodePath() + ".job1");
+    }
+    System::instance()->setDefs(defs);
+
+    auto wait_for_batch = []() {
+        while (System::instance()->process() != 0) {
+            Signal unblock_on_desctruction_then_reblock;
+            System::instance()->processTerminatedChildren();
+        }
+    };
+
+    // The command reads the job files from stdin, and reports the job of task b as not submitted.
+    // The job files contain a space, the line that matches no job file is only logged
+    std::string file = "test_system_spawn_batch.log";
+    std::string cmd  = "cat > " + file + "; printf '%s\\t%s\\n%s\\n' '/made up/s/b.job1' 'queue is closed' 'unexpected'";
+    std::string errorMsg;
+    BOOST_REQUIRE_MESSAGE(System::instance()->spawn_batch(cmd, paths, job_files, errorMsg),
+                          "System::instance()->spawn_batch() failed: " << errorMsg);
+    wait_for_batch();
+
+    std::string contents;
+    BOOST_CHECK_MESSAGE(File::open(file, contents) && contents == "/made up/s/a.job1\n/made up/s/b.job1\n/made up/s/c.job1\n",
+                        "Expected the job files on stdin, but found: " << contents);
+    fs::remove(file);
+
+    task_ptr a = s->findTask("a");
+    task_ptr b = s->findTask("b");
+    task_ptr c = s->findTask("c");
+    BOOST_CHECK_MESSAGE(a->state() == NState::SUBMITTED && c->state() == NState::SUBMITTED,
+                        "Expected tasks a and c to stay submitted");
+    BOOST_CHECK_MESSAGE(b->state() == NState::ABORTED && b->flag().is_set(ecf::Flag::JOBCMD_FAILED),
+                        "Expected task b to be aborted, with JOBCMD_FAILED flag set");
+    BOOST_CHECK_MESSAGE(b->abortedReason().find("queue is closed") != std::string::npos,
+                        "Expected reason from the batch command, but found: " << b->abortedReason());
+
+    // Failure of the command, fails all its jobs
+    a->set_state(NState::SUBMITTED);
+    b->set_state(NState::SUBMITTED);
+    BOOST_REQUIRE_MESSAGE(System::instance()->spawn_batch("exit 3", paths, job_files, errorMsg),
+                          "System::instance()->spawn_batch() failed: " << errorMsg);
+    wait_for_batch();
+    BOOST_CHECK_MESSAGE(a->state() == NState::ABORTED && b->state() == NState::ABORTED &&
+                            c->state() == NState::ABORTED,
+                        "Expected all tasks to be aborted, when the batch command fails");
+
+    System::instance()->setDefs(defs_ptr());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
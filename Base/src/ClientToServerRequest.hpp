@@ -40,6 +40,9 @@ public:
     bool getRequest() const { return (cmd_.get()) ? cmd_->get_cmd() : false; }
     bool terminateRequest() const { return (cmd_.get()) ? cmd_->terminate_cmd() : false; }
     bool groupRequest() const { return (cmd_.get()) ? cmd_->group_cmd() : false; }
+    /// Read only requests do not change the defs or the server, and can run concurrently with each other.
+    /// This excludes read only commands that are mutable (i.e check pt) or update the defs (i.e client handles)
+    bool readOnlyRequest() const { return (cmd_.get()) ? cmd_->allowed_on_reader_thread() : false; }
 
     void cleanup() {
         if (cmd_.get())
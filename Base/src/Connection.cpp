@@ -36,6 +36,77 @@ connection::connection(boost::asio::io_service& io_service) : socket_(io_service
 #endif
 }
 
+bool connection::format_header(std::size_t data_size, ecf::ArchiveFormat format, bool compressed) {
+    std::ostringstream header_stream;
+    if (data_size <= max_marked_data_size) {
+        char marker = ecf::Compression::available() ? json_compress_marker : json_marker;
+        if (format == ecf::ArchiveFormat::PORTABLE_BINARY)
+            marker = compressed ? compressed_marker : binary_marker;
+        header_stream << std::setw(header_length - 1) << std::hex << data_size << marker;
+    }
+    else {
+        // Legacy header, only JSON can be sent this way
+        if (format != ecf::ArchiveFormat::JSON)
+            return false;
+        header_stream << std::setw(header_length) << std::hex << data_size;
+    }
+    if (!header_stream || header_stream.str().size() != header_length)
+        return false;
+    outbound_header_ = header_stream.str();
+    return true;
+}
+
+bool connection::parse_header(std::size_t& data_size) {
+    std::size_t size_length = header_length;
+    inbound_format_         = ecf::ArchiveFormat::JSON;
+    inbound_compressed_     = false;
+
+    char marker = inbound_header_[header_length - 1];
+    switch (marker) {
+        case compressed_marker:
+            inbound_compressed_ = true;
+            [[fallthrough]];
+        case binary_marker:
+            inbound_format_ = ecf::ArchiveFormat::PORTABLE_BINARY;
+            [[fallthrough]];
+        case json_compress_marker:
+            peer_accepts_compression_ = (marker != binary_marker);
+            [[fallthrough]];
+        case json_marker:
+            peer_accepts_binary_ = true;
+            size_length          = header_length - 1;
+            break;
+        default: {
+            // legacy header, the peer only understands JSON
+        }
+    }
+
+    std::istringstream is(std::string(inbound_header_, size_length));
+    return static_cast<bool>(is >> std::hex >> data_size);
+}
+
+bool connection::compress_outbound_data() {
+    uncompressed_size_ = outbound_data_.size();
+    compressed_size_   = 0;
+    compression_time_  = std::chrono::microseconds(0);
+    if (!peer_accepts_compression_ || compression_threshold_ == 0 || outbound_data_.size() < compression_threshold_)
+        return false;
+    if (outbound_data_.size() > max_marked_data_size)
+        return false; // the peer rejects compressed data that is larger than this, once uncompressed
+
+    auto start = std::chrono::steady_clock::now();
+    std::string compressed_data;
+    ecf::Compression::compress(outbound_data_, compressed_data);
+    compression_time_ =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    if (compressed_data.size() >= outbound_data_.size())
+        return false; // not worth it
+
+    outbound_data_.swap(compressed_data);
+    compressed_size_ = outbound_data_.size();
+    return true;
+}
+
 void connection::log_error(const char* msg) {
     const char* in_context = ", in client";
     if (Ecf::server())
@@ -20,12 +20,14 @@
     #include <sys/select.h> // hp-ux uses pselect
 #endif
 
+#include <chrono>
 #include <iomanip>
 #include <memory>
 #include <sstream>
 
 #include <boost/asio.hpp>
 
+#include "Compression.hpp"
 #include "Serialization.hpp"
 
 // #define DEBUG_CONNECTION 1
@@ -39,6 +41,16 @@
  * @li An 8-byte header containing the length of the serialized data in
  * hexadecimal.
  * @li The serialized data.
+ *
+ * The archive used for the serialized data is negotiated per connection, using the
+ * last byte of the header:
+ * @li a hex digit: the whole header is the length, and the data is JSON (legacy)
+ * @li 'J': 7-byte length, the data is JSON, and the sender accepts a binary reply
+ * @li 'K': as 'J', but the sender also accepts a compressed binary reply
+ * @li 'P': 7-byte length, the data uses the portable binary archive
+ * @li 'Z': 7-byte length, the data uses the portable binary archive and is compressed
+ * Older peers read the length with std::hex, which stops at the marker, and they never
+ * advertise binary support. Hence they continue to exchange JSON with newer peers.
  */
 class connection {
 public:
@@ -48,6 +60,15 @@ public:
     boost::asio::ip::tcp::socket& socket() { return socket_; }
     boost::asio::ip::tcp::socket& socket_ll() { return socket_; }
 
+    /// Binary data written to a peer that accepts compression is compressed when larger than
+    /// the threshold (in bytes). The default of 0 disables compression.
+    void set_compression_threshold(std::size_t threshold) { compression_threshold_ = threshold; }
+
+    /// Details of the last write. compressed_size() is 0 when the data was not compressed.
+    std::size_t uncompressed_size() const { return uncompressed_size_; }
+    std::size_t compressed_size() const { return compressed_size_; }
+    std::chrono::microseconds compression_time() const { return compression_time_; }
+
     /// Asynchronously write a data structure to the socket.
     template <typename T, typename Handler>
     void async_write(const T& t, Handler handler) {
@@ -60,8 +81,21 @@ public:
         std::cout << "   Serialise the data first so we know how large it is\n";
 #endif
         // Serialise the data first so we know how large it is.
+        // Only use the binary archive, if the peer has told us it can read it.
+        ecf::ArchiveFormat format =
+            peer_accepts_binary_ ? ecf::ArchiveFormat::PORTABLE_BINARY : ecf::ArchiveFormat::JSON;
+        bool compressed = false;
         try {
-            ecf::save_as_string(outbound_data_, t);
+            ecf::save_as_string(outbound_data_, t, format);
+            if (format == ecf::ArchiveFormat::PORTABLE_BINARY) {
+                compressed = compress_outbound_data();
+                if (outbound_data_.size() > max_marked_data_size) {
+                    // Too large for a header with a marker, fall back to JSON with a legacy header
+                    format     = ecf::ArchiveFormat::JSON;
+                    compressed = false;
+                    ecf::save_as_string(outbound_data_, t, format);
+                }
+            }
         }
         catch (const std::exception& ae) {
             // Unable to decode data. Something went wrong, inform the caller.
@@ -74,15 +108,12 @@ public:
         std::cout << "   Format the header:\n";
 #endif
         // Format the header.
-        std::ostringstream header_stream;
-        header_stream << std::setw(header_length) << std::hex << outbound_data_.size();
-        if (!header_stream || header_stream.str().size() != header_length) {
+        if (!format_header(outbound_data_.size(), format, compressed)) {
             // Something went wrong, inform the caller.
             log_error("Connection::async_write, could not format header");
             boost::asio::post(socket_.get_executor(), [handler]() { handler(boost::asio::error::invalid_argument); });
             return;
         }
-        outbound_header_ = header_stream.str();
 
 #ifdef DEBUG_CONNECTION
         std::cout << "   Write the HEADER and serialised DATA to the socket\n";
@@ -143,10 +174,9 @@ private:
             handler(e);
         }
         else {
-            // Determine the length of the serialized data.
-            std::istringstream is(std::string(inbound_header_, header_length));
+            // Determine the length and archive format of the serialized data.
             std::size_t inbound_data_size = 0;
-            if (!(is >> std::hex >> inbound_data_size)) {
+            if (!parse_header(inbound_data_size)) {
 
                 // Header doesn't seem to be valid. Inform the caller.
                 std::string err =
@@ -182,17 +212,29 @@ private:
         }
         else {
             // Extract the data structure from the data just received.
-            std::string archive_data(&inbound_data_[0], inbound_data_.size());
+            // Uncompressed data is restored in place, without first copying it into a string.
+            std::string uncompressed_data;
             try {
+                const char* archive_data = inbound_data_.data();
+                std::size_t archive_size = inbound_data_.size();
+                if (inbound_compressed_) {
+                    ecf::Compression::decompress(
+                        inbound_data_.data(), inbound_data_.size(), uncompressed_data, max_marked_data_size);
+                    archive_data = uncompressed_data.data();
+                    archive_size = uncompressed_data.size();
+                }
 #ifdef DEBUG_CONNECTION
                 std::cout << "   inbound_data_.size(" << inbound_data_.size() << ") typeid(" << typeid(t).name()
                           << ")\n";
-                std::cout << "   '" << archive_data << "'\n";
+                std::cout << "   '" << std::string(archive_data, archive_size) << "'\n";
 #endif
-                ecf::restore_from_string(archive_data, t);
+                ecf::restore_from_buffer(archive_data, archive_size, t, inbound_format_);
             }
             catch (std::exception& e) {
-                log_archive_error("Connection::handle_read_data, Unable to decode data :", e, archive_data);
+                log_archive_error("Connection::handle_read_data, Unable to decode data :",
+                                  e,
+                                  inbound_compressed_ ? uncompressed_data
+                                                      : std::string(inbound_data_.begin(), inbound_data_.end()));
                 handler(boost::asio::error::invalid_argument);
                 return;
             }
@@ -203,6 +245,17 @@ private:
     }
 
 private:
+    /// Format outbound_header_, i.e. the length of the data in hex followed by the archive marker.
+    /// Returns false if the header could not be formatted.
+    bool format_header(std::size_t data_size, ecf::ArchiveFormat format, bool compressed);
+
+    /// Parse inbound_header_, returning false if it is not valid
+    bool parse_header(std::size_t& data_size);
+
+    /// Compress the binary outbound_data_, if the peer accepts it and it is above the threshold.
+    /// Returns true if the data was compressed.
+    bool compress_outbound_data();
+
     static void log_error(const char* msg);
     static void log_archive_error(const char* msg, const std::exception& ae, const std::string& data);
 
@@ -213,6 +266,22 @@ private:
     enum { header_length = 8 };           /// The size of a fixed length header.
     char inbound_header_[header_length];  /// Holds an in-bound header.
     std::vector<char> inbound_data_;      /// Holds the in-bound data.
+
+    ecf::ArchiveFormat inbound_format_{ecf::ArchiveFormat::JSON}; /// The archive used by the in-bound data
+    bool inbound_compressed_{false};                              /// Set when the in-bound data is compressed
+    bool peer_accepts_binary_{false};                             /// Set when the peer can read binary data
+    bool peer_accepts_compression_{false};                        /// Set when the peer can read compressed data
+
+    std::size_t compression_threshold_{0};                /// Compress binary data larger than this, 0 means never
+    std::size_t uncompressed_size_{0};                    /// Size of the last out-bound data, before compression
+    std::size_t compressed_size_{0};                      /// Size of the last out-bound data, 0 if not compressed
+    std::chrono::microseconds compression_time_{0};       /// Time taken to compress the last out-bound data
+
+    static constexpr char json_marker                 = 'J';        /// Header marker for JSON data
+    static constexpr char json_compress_marker        = 'K';        /// As above, and accepts compressed data
+    static constexpr char binary_marker               = 'P';        /// Header marker for portable binary data
+    static constexpr char compressed_marker           = 'Z';        /// Header marker for compressed binary data
+    static constexpr std::size_t max_marked_data_size = 0x0FFFFFFF; /// Max length in a header with a marker
 };
 
 typedef std::shared_ptr<connection> connection_ptr;
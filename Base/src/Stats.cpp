@@ -85,9 +85,23 @@ void Stats::update_for_serialisation() {
     request_stats_ = ss.str();
 }
 
+void Stats::update_compression(std::size_t uncompressed_size,
+                               std::size_t compressed_size,
+                               std::chrono::microseconds compression_time) {
+    compressed_replies_++;
+    uncompressed_bytes_ += uncompressed_size;
+    compressed_bytes_ += compressed_size;
+    compression_time_us_ += compression_time.count();
+}
+
 void Stats::reset() {
     checkpt_                   = 0;
     restore_defs_from_checkpt_ = 0;
+    checkpt_background_        = 0;
+    checkpt_save_time_us_      = 0;
+    checkpt_stall_time_us_     = 0;
+    checkpt_journal_records_   = 0;
+    checkpt_journal_bytes_     = 0;
 
     server_version_            = 0;
     restart_server_            = 0;
@@ -103,6 +117,8 @@ void Stats::reset() {
     sync_full_                 = 0;
     sync_clock_                = 0;
     news_                      = 0;
+    sync_cache_hits_           = 0;
+    sync_cache_misses_         = 0;
 
     node_job_gen_              = 0;
     node_check_job_gen_only_   = 0;
@@ -161,6 +177,13 @@ void Stats::reset() {
     stats_                     = 0;
     check_                     = 0;
     query_                     = 0;
+
+    compressed_replies_        = 0;
+    uncompressed_bytes_        = 0;
+    compressed_bytes_          = 0;
+    compression_time_us_       = 0;
+
+    // include cache counters are held by IncludeFileCache, copied on each stats request
 }
 
 static string show_checkpt_mode(ecf::CheckPt::Mode m) {
@@ -200,9 +223,9 @@ void Stats::show(std::ostream& os) const {
     os << left << setw(width) << "   Number of Suites " << no_of_suites_ << "\n";
     os << left << setw(width) << "   Request/s per 1,5,15,30,60 min " << request_stats_ << "\n";
 
-    if (checkpt_ || restore_defs_from_checkpt_ || server_version_ || restart_server_ || shutdown_server_ ||
-        halt_server_ || ping_ || debug_server_on_ || debug_server_off_ || get_defs_ || sync_ || sync_full_ ||
-        sync_clock_ || news_)
+    if (checkpt_ || restore_defs_from_checkpt_ || checkpt_background_ || checkpt_journal_records_ || server_version_ ||
+        restart_server_ || shutdown_server_ || halt_server_ || ping_ || debug_server_on_ || debug_server_off_ ||
+        get_defs_ || sync_ || sync_full_ || sync_clock_ || news_)
         os << "\n";
     if (!locked_by_user_.empty())
         os << left << setw(width) << "   Locked by user " << locked_by_user_ << "\n";
@@ -210,6 +233,17 @@ void Stats::show(std::ostream& os) const {
         os << left << setw(width) << "   Check points " << checkpt_ << "\n";
     if (restore_defs_from_checkpt_ != 0)
         os << left << setw(width) << "   Restore from Check point " << restore_defs_from_checkpt_ << "\n";
+    if (checkpt_background_ != 0) {
+        os << left << setw(width) << "   Background check points " << checkpt_background_ << "\n";
+        os << left << setw(width) << "   Background check pt save (avg) " << setprecision(3) << fixed
+           << static_cast<double>(checkpt_save_time_us_) / (1000.0 * checkpt_background_) << "ms\n";
+        os << left << setw(width) << "   Background check pt stall (avg) " << setprecision(3) << fixed
+           << static_cast<double>(checkpt_stall_time_us_) / (1000.0 * checkpt_background_) << "ms\n";
+    }
+    if (checkpt_journal_records_ != 0) {
+        os << left << setw(width) << "   Check pt journal records " << checkpt_journal_records_ << "\n";
+        os << left << setw(width) << "   Check pt journal bytes " << checkpt_journal_bytes_ << "\n";
+    }
     if (restart_server_ != 0)
         os << left << setw(width) << "   Restart server " << restart_server_ << "\n";
     if (shutdown_server_ != 0)
@@ -234,6 +268,10 @@ void Stats::show(std::ostream& os) const {
         os << left << setw(width) << "   Sync suite clock " << sync_clock_ << "\n";
     if (news_ != 0)
         os << left << setw(width) << "   News " << news_ << "\n";
+    if (sync_cache_hits_ + sync_cache_misses_ != 0) {
+        os << left << setw(width) << "   Sync cache hits " << sync_cache_hits_ << "\n";
+        os << left << setw(width) << "   Sync cache misses " << sync_cache_misses_ << "\n";
+    }
 
     if (task_init_ || task_complete_ || task_wait_ || task_abort_ || task_event_ || task_meter_ || task_label_ ||
         task_queue_)
@@ -357,5 +395,67 @@ void Stats::show(std::ostream& os) const {
         os << left << setw(width) << "   File Cmd out " << file_cmdout_ << "\n";
     if (file_manual_ != 0)
         os << left << setw(width) << "   File manual " << file_manual_ << "\n";
+
+    if (compressed_replies_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Compressed replies " << compressed_replies_ << "\n";
+        os << left << setw(width) << "   Compression ratio " << setprecision(2) << fixed
+           << static_cast<double>(uncompressed_bytes_) / static_cast<double>(compressed_bytes_) << "\n";
+        os << left << setw(width) << "   Compression time (avg) " << setprecision(3) << fixed
+           << static_cast<double>(compression_time_us_) / (1000.0 * compressed_replies_) << "ms\n";
+    }
+
+    if (include_cache_misses_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Include cache hits " << include_cache_hits_ << "\n";
+        os << left << setw(width) << "   Include cache misses " << include_cache_misses_ << "\n";
+        os << left << setw(width) << "   Include cache evictions " << include_cache_evictions_ << "\n";
+        os << left << setw(width) << "   Include cache bytes " << include_cache_bytes_ << "\n";
+    }
+
+    if (script_cache_misses_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Script cache hits " << script_cache_hits_ << "\n";
+        os << left << setw(width) << "   Script cache misses " << script_cache_misses_ << "\n";
+    }
+
+    if (script_fetches_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Script fetches " << script_fetches_ << "\n";
+        os << left << setw(width) << "   Script fetch failures " << script_fetch_failures_ << "\n";
+        os << left << setw(width) << "   Script fetch timeouts " << script_fetch_timeouts_ << "\n";
+        os << left << setw(width) << "   Script fetch latency (avg) " << setprecision(1) << fixed
+           << static_cast<double>(script_fetch_latency_ms_) / script_fetches_ << "ms\n";
+        os << left << setw(width) << "   Script fetch latency (max) " << script_fetch_max_latency_ms_ << "ms\n";
+    }
+
+    if (script_file_probes_ != 0 || path_cache_misses_ != 0) {
+        os << "\n";
+        if (path_cache_misses_ != 0) {
+            os << left << setw(width) << "   Path cache hits " << path_cache_hits_ << "\n";
+            os << left << setw(width) << "   Path cache misses " << path_cache_misses_ << "\n";
+        }
+        os << left << setw(width) << "   Script file probes " << script_file_probes_ << "\n";
+        os << left << setw(width) << "   Include file probes " << include_file_probes_ << "\n";
+    }
+
+    if (job_deferrals_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Jobs deferred " << job_deferrals_ << "\n";
+        os << left << setw(width) << "   Job queue depth " << job_queue_depth_ << "\n";
+        os << left << setw(width) << "   Job queue depth (max) " << job_max_queue_depth_ << "\n";
+        os << left << setw(width) << "   Job command backlog " << job_backlog_ << "\n";
+    }
+
+    if (expr_cache_misses_ != 0) {
+        os << "\n";
+        os << left << setw(width) << "   Expression cache hits " << expr_cache_hits_ << "\n";
+        os << left << setw(width) << "   Expression cache misses " << expr_cache_misses_ << "\n";
+    }
+
+    if (job_profile_polls_ != 0) {
+        os << "\n";
+        os << ecf::JobProfiler::phase_report(job_profile_polls_, job_profile_);
+    }
     os << flush;
 }
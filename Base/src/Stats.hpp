@@ -14,12 +14,27 @@
 //
 // Description :
 //============================================================================
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "CheckPt.hpp"
+#include "JobProfiler.hpp"
 #include "Serialization.hpp"
 
+namespace ecf {
+template <class Archive>
+void serialize(Archive& ar, JobPhaseHistogram& h) {
+    ar(cereal::make_nvp("phase", h.phase_),
+       cereal::make_nvp("count", h.count_),
+       cereal::make_nvp("total_us", h.total_us_),
+       cereal::make_nvp("max_us", h.max_us_),
+       cereal::make_nvp("buckets", h.buckets_));
+}
+} // namespace ecf
+
 /// This class is used to store all statistical data about all the
 /// commands processed by the server. Uses default copy constructor
 struct Stats
@@ -31,6 +46,9 @@ struct Stats
     void update() { request_count_++; }
     void update_stats(int poll_interval);
     void update_for_serialisation();
+    void update_compression(std::size_t uncompressed_size,
+                            std::size_t compressed_size,
+                            std::chrono::microseconds compression_time);
     void reset();
 
     std::string locked_by_user_;
@@ -54,6 +72,11 @@ struct Stats
 
     unsigned int checkpt_{0};
     unsigned int restore_defs_from_checkpt_{0};
+    unsigned int checkpt_background_{0};      // check points saved in the background, see ECF_CHECKPT_ASYNC
+    std::uint64_t checkpt_save_time_us_{0};   // time spent writing the background check points
+    std::uint64_t checkpt_stall_time_us_{0};  // time the server was blocked, taking the background check points
+    unsigned int checkpt_journal_records_{0}; // state changes appended to the journal, see ECF_CHECKPT_JOURNAL
+    std::uint64_t checkpt_journal_bytes_{0};
 
     unsigned int server_version_{0};
     unsigned int restart_server_{0};
@@ -69,6 +92,8 @@ struct Stats
     unsigned int sync_full_{0};
     unsigned int sync_clock_{0};
     unsigned int news_{0};
+    unsigned int sync_cache_hits_{0};   // incremental changes returned from DefsDeltaCache
+    unsigned int sync_cache_misses_{0}; // incremental changes collated, and added to DefsDeltaCache
 
     unsigned int node_job_gen_{0};
     unsigned int node_check_job_gen_only_{0};
@@ -128,6 +153,51 @@ struct Stats
     unsigned int check_{0};
     unsigned int query_{0};
 
+    // Compression of replies sent to the client
+    unsigned int compressed_replies_{0};
+    std::uint64_t uncompressed_bytes_{0};
+    std::uint64_t compressed_bytes_{0};
+    std::uint64_t compression_time_us_{0};
+
+    // Include file cache used in job generation, since server start. See IncludeFileCache
+    std::uint64_t include_cache_hits_{0};
+    std::uint64_t include_cache_misses_{0};
+    std::uint64_t include_cache_evictions_{0};
+    std::uint64_t include_cache_bytes_{0};
+
+    // Pre-processed script cache used in job generation, since server start. See PreProcessedScriptCache
+    std::uint64_t script_cache_hits_{0};
+    std::uint64_t script_cache_misses_{0};
+
+    // ECF_FETCH/ECF_SCRIPT_CMD commands run to obtain the scripts, since server start. See ScriptFetcher
+    std::uint64_t script_fetches_{0};
+    std::uint64_t script_fetch_failures_{0};
+    std::uint64_t script_fetch_timeouts_{0};
+    std::uint64_t script_fetch_latency_ms_{0}; // total
+    std::uint64_t script_fetch_max_latency_ms_{0};
+
+    // File system look ups made to locate scripts and include files, since server start.
+    // See ScriptPathCache and JobProfiler::file_probes()
+    std::uint64_t path_cache_hits_{0};
+    std::uint64_t path_cache_misses_{0};
+    std::uint64_t script_file_probes_{0};
+    std::uint64_t include_file_probes_{0};
+
+    // Jobs deferred to a later job generation, since server start. See JobThrottle
+    std::uint64_t job_deferrals_{0};
+    unsigned int job_queue_depth_{0}; // tasks deferred by the last job generation
+    unsigned int job_max_queue_depth_{0};
+    unsigned int job_backlog_{0}; // ECF_JOB_CMD still running, at the start of the last job generation
+
+    // Trigger/complete expression evaluations, since server start. A hit re-uses the last result,
+    // since nothing the expression references has changed. See ExprByteCode
+    std::uint64_t expr_cache_hits_{0};
+    std::uint64_t expr_cache_misses_{0};
+
+    // Latency of each phase of job generation, over the last job_profile_polls_. See ECF_JOB_PROFILE
+    unsigned int job_profile_polls_{0};
+    std::vector<ecf::JobPhaseHistogram> job_profile_;
+
 private:
     std::deque<std::pair<int, int>> request_vec_; // pair.first =  number of requests, pair.second = poll interval
 
@@ -226,6 +296,41 @@ private:
         ar& stats_;
         ar& check_;
         ar& query_;
+
+        CEREAL_OPTIONAL_NVP(ar, compressed_replies_, [this]() { return compressed_replies_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, uncompressed_bytes_, [this]() { return compressed_replies_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, compressed_bytes_, [this]() { return compressed_replies_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, compression_time_us_, [this]() { return compressed_replies_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, sync_cache_hits_, [this]() { return sync_cache_hits_ + sync_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, sync_cache_misses_, [this]() { return sync_cache_hits_ + sync_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, checkpt_background_, [this]() { return checkpt_background_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, checkpt_save_time_us_, [this]() { return checkpt_background_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, checkpt_stall_time_us_, [this]() { return checkpt_background_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, checkpt_journal_records_, [this]() { return checkpt_journal_records_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, checkpt_journal_bytes_, [this]() { return checkpt_journal_records_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, include_cache_hits_, [this]() { return include_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, include_cache_misses_, [this]() { return include_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, include_cache_evictions_, [this]() { return include_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, include_cache_bytes_, [this]() { return include_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_cache_hits_, [this]() { return script_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_cache_misses_, [this]() { return script_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_fetches_, [this]() { return script_fetches_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_fetch_failures_, [this]() { return script_fetches_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_fetch_timeouts_, [this]() { return script_fetches_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_fetch_latency_ms_, [this]() { return script_fetches_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_fetch_max_latency_ms_, [this]() { return script_fetches_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, path_cache_hits_, [this]() { return path_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, path_cache_misses_, [this]() { return path_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, script_file_probes_, [this]() { return script_file_probes_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, include_file_probes_, [this]() { return include_file_probes_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_deferrals_, [this]() { return job_deferrals_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_queue_depth_, [this]() { return job_deferrals_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_max_queue_depth_, [this]() { return job_deferrals_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_backlog_, [this]() { return job_deferrals_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, expr_cache_hits_, [this]() { return expr_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, expr_cache_misses_, [this]() { return expr_cache_misses_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_profile_polls_, [this]() { return job_profile_polls_ != 0; });
+        CEREAL_OPTIONAL_NVP(ar, job_profile_, [this]() { return job_profile_polls_ != 0; });
     }
 };
 #endif
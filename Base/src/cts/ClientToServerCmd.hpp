@@ -107,6 +107,10 @@ public:
     /// This return true for those commands that affect the defs, that we need sync on the client side.
     virtual bool cmd_updates_defs() const { return isWrite(); }
 
+    /// Return true for commands that change neither the defs nor the server. The server handles
+    /// these on the reader threads, concurrently with each other. See ECF_READ_THREADS
+    virtual bool allowed_on_reader_thread() const { return !isWrite() && !is_mutable() && !cmd_updates_defs(); }
+
     /// This Must be called for client->server commands.As this is required
     /// for authentication. *However* task based commands have their own authentication
     /// mechanism, and don't need setup_user_authentification().
@@ -709,7 +713,9 @@ public:
         STATS_RESET,
         RELOAD_PASSWD_FILE,
         STATS_SERVER,
-        RELOAD_CUSTOM_PASSWD_FILE
+        RELOAD_CUSTOM_PASSWD_FILE,
+        CLEAR_PATH_CACHE,
+        JOB_PROFILE
     };
 
     explicit CtsCmd(Api a) : api_(a) {}
@@ -723,6 +729,7 @@ public:
 
     bool isWrite() const override;
     bool cmd_updates_defs() const override;
+    bool allowed_on_reader_thread() const override;
     bool terminate_cmd() const override { return api_ == TERMINATE_SERVER; }
     bool ping_cmd() const override { return api_ == PING; }
     int timeout() const override;
@@ -2129,6 +2136,7 @@ public:
 
     bool isWrite() const override;
     bool cmd_updates_defs() const override;
+    bool allowed_on_reader_thread() const override;
 
     PrintStyle::Type_t show_style() const override;
     bool get_cmd() const override;
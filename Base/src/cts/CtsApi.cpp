@@ -94,6 +94,20 @@ const char* CtsApi::stats_reset_arg() {
     return "stats_reset";
 }
 
+std::string CtsApi::clear_path_cache() {
+    return "--clear_path_cache";
+}
+const char* CtsApi::clear_path_cache_arg() {
+    return "clear_path_cache";
+}
+
+std::string CtsApi::job_profile() {
+    return "--job_profile";
+}
+const char* CtsApi::job_profile_arg() {
+    return "job_profile";
+}
+
 std::string CtsApi::suites() {
     return "--suites";
 }
@@ -201,6 +201,8 @@ public:
     static std::string stats();
     static std::string stats_server(); // used in test, as serialisation subject to change
     static std::string stats_reset();
+    static std::string clear_path_cache();
+    static std::string job_profile();
 
     static std::vector<std::string> edit_script(const std::string& path_to_task,
                                                 const std::string& edit_type,
@@ -215,6 +217,8 @@ public:
     static const char* statsArg();
     static const char* stats_server_arg();
     static const char* stats_reset_arg();
+    static const char* clear_path_cache_arg();
+    static const char* job_profile_arg();
     static const char* suitesArg();
     static const char* ch_register_arg();
     static const char* ch_drop_arg();
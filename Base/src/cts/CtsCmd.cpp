@@ -21,9 +21,11 @@
 #include "CtsApi.hpp"
 #include "Defs.hpp"
 #include "Gnuplot.hpp"
+#include "JobProfiler.hpp"
 #include "Jobs.hpp"
 #include "JobsParam.hpp"
 #include "Log.hpp"
+#include "ScriptPathCache.hpp"
 
 using namespace ecf;
 using namespace std;
@@ -76,6 +78,12 @@ void CtsCmd::print(std::string& os) const {
         case CtsCmd::STATS_RESET:
             user_cmd(os, CtsApi::stats_reset());
             break;
+        case CtsCmd::CLEAR_PATH_CACHE:
+            user_cmd(os, CtsApi::clear_path_cache());
+            break;
+        case CtsCmd::JOB_PROFILE:
+            user_cmd(os, CtsApi::job_profile());
+            break;
         case CtsCmd::SUITES:
             user_cmd(os, CtsApi::suites());
             break;
@@ -143,6 +151,12 @@ void CtsCmd::print_only(std::string& os) const {
         case CtsCmd::STATS_RESET:
             os += CtsApi::stats_reset();
             break;
+        case CtsCmd::CLEAR_PATH_CACHE:
+            os += CtsApi::clear_path_cache();
+            break;
+        case CtsCmd::JOB_PROFILE:
+            os += CtsApi::job_profile();
+            break;
         case CtsCmd::SUITES:
             os += CtsApi::suites();
             break;
@@ -219,6 +233,12 @@ bool CtsCmd::isWrite() const {
         case CtsCmd::STATS_RESET:
             return true;
             break; // requires write privilege
+        case CtsCmd::CLEAR_PATH_CACHE:
+            return true;
+            break; // requires write privilege
+        case CtsCmd::JOB_PROFILE:
+            return false;
+            break; // read only
         case CtsCmd::SUITES:
             return false;
             break; // read only
@@ -286,6 +306,12 @@ bool CtsCmd::cmd_updates_defs() const {
         case CtsCmd::STATS_RESET:
             return false;
             break;
+        case CtsCmd::CLEAR_PATH_CACHE:
+            return false;
+            break;
+        case CtsCmd::JOB_PROFILE:
+            return false;
+            break;
         case CtsCmd::SUITES:
             return false;
             break;
@@ -309,6 +335,13 @@ bool CtsCmd::cmd_updates_defs() const {
     return false;
 }
 
+bool CtsCmd::allowed_on_reader_thread() const {
+    // Anyone may switch the debug output of the server, but it changes the server
+    if (api_ == CtsCmd::DEBUG_SERVER_ON || api_ == CtsCmd::DEBUG_SERVER_OFF)
+        return false;
+    return ClientToServerCmd::allowed_on_reader_thread();
+}
+
 int CtsCmd::timeout() const {
     if (api_ == CtsCmd::PING)
         return 10;
@@ -359,6 +392,12 @@ const char* CtsCmd::theArg() const {
         case CtsCmd::STATS_RESET:
             return CtsApi::stats_reset_arg();
             break;
+        case CtsCmd::CLEAR_PATH_CACHE:
+            return CtsApi::clear_path_cache_arg();
+            break;
+        case CtsCmd::JOB_PROFILE:
+            return CtsApi::job_profile_arg();
+            break;
         case CtsCmd::SUITES:
             return CtsApi::suitesArg();
             break;
@@ -464,6 +503,13 @@ STC_Cmd_ptr CtsCmd::doHandleRequest(AbstractServer* as) const {
         case CtsCmd::STATS_RESET:
             as->update_stats().reset();
             break; // we could have done as->update_stats().stats_++, to honor reset, we dont
+        case CtsCmd::CLEAR_PATH_CACHE:
+            ScriptPathCache::instance().clear();
+            break;
+        case CtsCmd::JOB_PROFILE:
+            as->update_stats().stats_++;
+            return PreAllocatedReply::string_cmd(JobProfiler::phase_report());
+            break;
         case CtsCmd::SUITES:
             as->update_stats().suites_++;
             return PreAllocatedReply::suites_cmd(as);
@@ -705,6 +751,30 @@ void CtsCmd::addOption(boost::program_options::options_description& desc) const
             desc.add_options()(CtsApi::stats_reset_arg(), "Resets the server statistics.");
             break;
         }
+        case CtsCmd::CLEAR_PATH_CACHE: {
+            desc.add_options()(
+                CtsApi::clear_path_cache_arg(),
+                "Clears the cached location of scripts and include files. Only used when the server\n"
+                "is started with ECF_PATH_CACHE=1. Use this after adding a script or include file, that\n"
+                "should be found earlier in the search of ECF_FILES, ECF_HOME or ECF_INCLUDE, than the\n"
+                "file currently used, or after creating a script that could not be found.\n"
+                "Usage:\n"
+                "  --clear_path_cache");
+            break;
+        }
+        case CtsCmd::JOB_PROFILE: {
+            desc.add_options()(
+                CtsApi::job_profile_arg(),
+                "Returns the time taken by each phase of job generation, as histograms, for the most\n"
+                "recent polls. Only available when the server is started with ECF_JOB_PROFILE=<polls>.\n"
+                "The phases are: dependencies (resolving triggers, limits, time dependencies etc),\n"
+                "locate (finding the script), pre_process (reading the script and expanding includes),\n"
+                "substitute (variable substitution), write (creating the job file) and spawn\n"
+                "(running ECF_JOB_CMD). poll is the total time of each job generation.\n"
+                "Usage:\n"
+                "  --job_profile");
+            break;
+        }
         case CtsCmd::SUITES: {
             desc.add_options()(CtsApi::suitesArg(), "Returns the list of suites, in the order defined in the server.");
             break;
@@ -44,9 +44,11 @@ CtsCmdRegistry::CtsCmdRegistry(bool addGroupCmd) {
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::RELOAD_WHITE_LIST_FILE));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::RELOAD_PASSWD_FILE));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::RELOAD_CUSTOM_PASSWD_FILE));
+    vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::CLEAR_PATH_CACHE));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::FORCE_DEP_EVAL));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::STATS));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::STATS_SERVER));
+    vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::JOB_PROFILE));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::STATS_RESET));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::DEBUG_SERVER_ON));
     vec_.push_back(std::make_shared<CtsCmd>(CtsCmd::DEBUG_SERVER_OFF));
@@ -161,6 +161,14 @@ bool GroupCTSCmd::cmd_updates_defs() const {
     return false;
 }
 
+bool GroupCTSCmd::allowed_on_reader_thread() const {
+    for (Cmd_ptr subCmd : cmdVec_) {
+        if (!subCmd->allowed_on_reader_thread())
+            return false;
+    }
+    return true;
+}
+
 bool GroupCTSCmd::get_cmd() const {
     for (Cmd_ptr subCmd : cmdVec_) {
         if (subCmd->get_cmd())
@@ -16,6 +16,7 @@
 
 #include "AbstractClientEnv.hpp"
 #include "AbstractServer.hpp"
+#include "ChangeJournal.hpp"
 #include "ClientToServerCmd.hpp"
 #include "Defs.hpp"
 #include "Expression.hpp"
@@ -889,6 +890,7 @@ STC_Cmd_ptr MeterCmd::doHandleRequest(AbstractServer* as) const {
             /// Invalid meter values(out or range) will raise exceptions.
             /// Just ignore the request rather than failing client cmd
             the_meter.set_value(value_);
+            ChangeJournal::record(submittable_);
         }
         catch (std::exception& e) {
             LOG(Log::ERR, "MeterCmd::doHandleRequest: failed for task " << path_to_node() << ". " << e.what());
@@ -1123,6 +1125,7 @@ STC_Cmd_ptr QueueCmd::doHandleRequest(AbstractServer* as) const {
                     }
 
                     result = handle_queue(queue_attr);
+                    ChangeJournal::record(node_with_queue.get());
                 }
                 else {
                     std::stringstream ss;
@@ -1141,6 +1144,7 @@ STC_Cmd_ptr QueueCmd::doHandleRequest(AbstractServer* as) const {
                     if (!queue_attr1.empty()) {
                         fnd_queue = true;
                         result    = handle_queue(queue_attr1);
+                        ChangeJournal::record(parent);
                         break;
                     }
                     parent = parent->parent();
@@ -1149,6 +1153,7 @@ STC_Cmd_ptr QueueCmd::doHandleRequest(AbstractServer* as) const {
             else {
                 fnd_queue = true;
                 result    = handle_queue(queue_attr);
+                ChangeJournal::record(submittable_);
             }
 
             if (!fnd_queue) {
@@ -31,14 +31,14 @@ using namespace boost;
 // ===========================================================================================
 // CACHE: the deserialization costs, so that if multiple clients request the full defs
 //        we can improve the performance, by only performing that once for each state change.
-std::string DefsCache::full_server_defs_as_string_ = "";
-unsigned int DefsCache::state_change_no_           = 0;
-unsigned int DefsCache::modify_change_no_          = 0;
+std::shared_ptr<const std::string> DefsCache::full_server_defs_as_string_;
+unsigned int DefsCache::state_change_no_  = 0;
+unsigned int DefsCache::modify_change_no_ = 0;
 
 void DefsCache::update_cache_if_state_changed(Defs* defs) {
     // See if there was a state change *OR* if cache is empty
     if (state_change_no_ != Ecf::state_change_no() || modify_change_no_ != Ecf::modify_change_no() ||
-        full_server_defs_as_string_.empty()) {
+        !full_server_defs_as_string_ || full_server_defs_as_string_->empty()) {
         update_cache(defs);
     }
 #ifdef DEBUG_SERVER_SYNC
@@ -52,7 +52,9 @@ void DefsCache::update_cache(Defs* defs) {
 #ifdef DEBUG_SERVER_SYNC
     cout << ": *updating* cache";
 #endif
-    defs->save_as_string(full_server_defs_as_string_, PrintStyle::NET); // update cache
+    auto full_server_defs_as_string = std::make_shared<std::string>();
+    defs->save_as_string(*full_server_defs_as_string, PrintStyle::NET); // update cache
+    full_server_defs_as_string_ = full_server_defs_as_string;
     state_change_no_  = Ecf::state_change_no();
     modify_change_no_ = Ecf::modify_change_no();
 }
@@ -84,5 +86,5 @@ defs_ptr DefsCache::restore_defs_from_string(const std::string& archive_data) {
 
 defs_ptr DefsCache::restore_defs_from_string() {
     // Used in Test when no client/server
-    return restore_defs_from_string(full_server_defs_as_string_);
+    return restore_defs_from_string(full_server_defs_as_string_ ? *full_server_defs_as_string_ : std::string());
 }
@@ -14,6 +14,9 @@
 //
 // Description :
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <memory>
+#include <string>
+
 #include <boost/core/noncopyable.hpp>
 
 #include "NodeFwd.hpp"
@@ -45,6 +48,9 @@
 //
 //      client3:  --------------> get---------------> Server
 //                serialise---------<----return cache
+//
+// The cache is held by shared pointer. Each reply takes a reference, so that replies
+// still being serialised (possibly on another thread) are not affected by a cache update.
 //================================================================================
 class DefsCache : private boost::noncopyable {
 public:
@@ -62,7 +68,7 @@ private:
 
     DefsCache()  = delete;
     ~DefsCache() = delete;
-    static std::string full_server_defs_as_string_;
+    static std::shared_ptr<const std::string> full_server_defs_as_string_;
     static unsigned int state_change_no_;  // detect state change in defs across clients
     static unsigned int modify_change_no_; // detect state change in defs across clients
 };
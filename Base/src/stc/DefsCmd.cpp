@@ -43,6 +43,7 @@ void DefsCmd::init(AbstractServer* as, bool save_edit_history) {
     // The CACHE is only updated if state/modify numbers change, hence does not take into account suite CLOCK
     // However DefsCmd should always return the most up to date server contents.
     DefsCache::update_cache(server_defs);
+    cached_server_defs_ = DefsCache::full_server_defs_as_string_;
 }
 
 bool DefsCmd::equals(ServerToClientCmd* rhs) const {
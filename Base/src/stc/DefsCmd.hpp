@@ -35,19 +35,21 @@ public:
     bool equals(ServerToClientCmd*) const override;
     void cleanup() override {
         std::string().swap(full_server_defs_as_string_);
+        cached_server_defs_.reset();
     } /// run in the server, after command send to client
 
 private:
     std::string full_server_defs_as_string_;
+    std::shared_ptr<const std::string> cached_server_defs_; // server side, the DefsCache at the time of the request
 
     friend class cereal::access;
     template <class Archive>
     void serialize(Archive& ar, std::uint32_t const version) {
         ar(cereal::base_class<ServerToClientCmd>(this));
 
-        if (Archive::is_saving::value) {
+        if constexpr (Archive::is_saving::value) {
             // Avoid copying the string. As this could be very large
-            ar& DefsCache::full_server_defs_as_string_;
+            ar(cached_server_defs_ ? *cached_server_defs_ : full_server_defs_as_string_);
         }
         else {
             ar& full_server_defs_as_string_;
@@ -0,0 +1,86 @@
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include "DefsDeltaCache.hpp"
+
+#include "AbstractServer.hpp"
+#include "Defs.hpp"
+#include "Ecf.hpp"
+#include "Serialization.hpp"
+
+using namespace std;
+
+std::list<std::pair<DefsDeltaCache::Key, DefsDeltaCache::entry_ptr>> DefsDeltaCache::entries_;
+std::weak_ptr<Defs> DefsDeltaCache::defs_;
+unsigned int DefsDeltaCache::state_change_no_  = 0;
+unsigned int DefsDeltaCache::modify_change_no_ = 0;
+
+DefsDeltaCache::entry_ptr DefsDeltaCache::collateChanges(unsigned int client_handle,
+                                                         unsigned int client_state_change_no,
+                                                         unsigned int server_state_change_no,
+                                                         unsigned int server_modify_change_no,
+                                                         AbstractServer* as) {
+    defs_ptr defs = as->defs();
+
+    // The cache only holds the changes for the *current* server state
+    if (defs_.lock() != defs || state_change_no_ != Ecf::state_change_no() || modify_change_no_ != Ecf::modify_change_no()) {
+        clear();
+        defs_             = defs;
+        state_change_no_  = Ecf::state_change_no();
+        modify_change_no_ = Ecf::modify_change_no();
+    }
+
+    Key key;
+    key.all_suites_              = (client_handle == 0);
+    key.client_state_change_no_  = client_state_change_no;
+    key.server_state_change_no_  = server_state_change_no;
+    key.server_modify_change_no_ = server_modify_change_no;
+    if (client_handle != 0)
+        defs->client_suite_mgr().suites(client_handle, key.suites_);
+
+    for (auto i = entries_.begin(); i != entries_.end(); ++i) {
+        if (i->first == key) {
+            as->stats().sync_cache_hits_++;
+            entries_.splice(entries_.begin(), entries_, i); // most recently used
+            return entries_.front().second;
+        }
+    }
+    as->stats().sync_cache_misses_++;
+
+    auto entry = std::make_shared<Entry>(client_state_change_no);
+    defs->collateChanges(client_handle, entry->delta_);
+    entry->delta_.set_server_state_change_no(server_state_change_no);
+    entry->delta_.set_server_modify_change_no(server_modify_change_no);
+
+    entries_.emplace_front(std::move(key), entry);
+    if (entries_.size() > max_entries())
+        entries_.pop_back(); // least recently used
+    return entry;
+}
+
+const std::string& DefsDeltaCache::Entry::delta_as_string(ecf::ArchiveFormat format) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto i = delta_as_string_.find(format);
+    if (i == delta_as_string_.end()) {
+        std::string delta_as_string;
+        ecf::save_as_string(delta_as_string, delta_, format);
+        i = delta_as_string_.emplace(format, std::move(delta_as_string)).first;
+    }
+    return i->second;
+}
+
+void DefsDeltaCache::clear() {
+    entries_.clear();
+    defs_.reset();
+}
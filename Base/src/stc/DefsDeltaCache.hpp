@@ -0,0 +1,109 @@
+#ifndef DEFS_DELTA_CACHE_HPP_
+#define DEFS_DELTA_CACHE_HPP_
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "DefsDelta.hpp"
+#include "NodeFwd.hpp"
+#include "Serialization.hpp"
+
+class AbstractServer;
+
+//================================================================================
+// Cache the incremental changes (DefsDelta) returned by SSyncCmd, in the *SERVER*
+// Many clients (viewers) syncing against the same server state, will typically ask for the
+// same changes, i.e. since the same client_state_change_no. Rather than collating and
+// serialising the changes for each client, the changes are shared.
+//
+// The cache is keyed on:
+//    o the suites of the client handle, (*all* suites when no handle is used)
+//    o the client state change no, (from)
+//    o the server state and modify change no, returned to the client (to)
+// Only the most recently used entries are kept. The cache only holds changes for the
+// *current* server state, hence it is cleared whenever the server state changes.
+//
+// Each entry holds the DefsDelta, and its serialised form for each archive format. An entry is
+// only serialised on first use by a client with that archive format, i.e. the portable binary
+// archive is never created, when only JSON clients sync the changes.
+//
+// The cache is held by shared pointer. Each reply takes a reference, so that replies
+// still being serialised (possibly on another thread) are not affected by a cache update.
+// The cache itself is only updated by sync requests, which are handled one at a time.
+//================================================================================
+class DefsDeltaCache : private boost::noncopyable {
+public:
+    struct Entry {
+        explicit Entry(unsigned int client_state_change_no) : delta_(client_state_change_no) {}
+
+        /// Return delta_ serialised with the given archive format. Serialised on the first call for each
+        /// format, and then shared. Thread safe, replies may be serialised on different threads.
+        const std::string& delta_as_string(ecf::ArchiveFormat format) const;
+
+        DefsDelta delta_;
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::map<ecf::ArchiveFormat, std::string> delta_as_string_; // keyed by archive format
+    };
+    using entry_ptr = std::shared_ptr<const Entry>;
+
+    /// Server side: Return the changes since client_state_change_no, for the suites of the client handle.
+    /// The changes are collated, if not found in the cache. Updates the cache hit/miss statistics.
+    static entry_ptr collateChanges(unsigned int client_handle,
+                                    unsigned int client_state_change_no,
+                                    unsigned int server_state_change_no,
+                                    unsigned int server_modify_change_no,
+                                    AbstractServer* as);
+
+    /// Remove all entries
+    static void clear();
+
+    /// The maximum number of entries held in the cache
+    static constexpr size_t max_entries() { return 16; }
+
+private:
+    DefsDeltaCache()  = delete;
+    ~DefsDeltaCache() = delete;
+
+    struct Key
+    {
+        bool operator==(const Key& rhs) const {
+            return all_suites_ == rhs.all_suites_ && client_state_change_no_ == rhs.client_state_change_no_ &&
+                   server_state_change_no_ == rhs.server_state_change_no_ &&
+                   server_modify_change_no_ == rhs.server_modify_change_no_ && suites_ == rhs.suites_;
+        }
+
+        bool all_suites_{true};
+        std::vector<std::string> suites_; // the suites of the client handle
+        unsigned int client_state_change_no_{0};
+        unsigned int server_state_change_no_{0};
+        unsigned int server_modify_change_no_{0};
+    };
+
+    static std::list<std::pair<Key, entry_ptr>> entries_; // most recently used first
+    static std::weak_ptr<Defs> defs_;                     // detect change of defs
+    static unsigned int state_change_no_;                 // detect state change in defs across clients
+    static unsigned int modify_change_no_;                // detect state change in defs across clients
+};
+
+#endif
@@ -27,7 +27,8 @@ class AbstractServer;
 // This class pre allocates the replies back to the client
 // This will help to reduce memory fragmentation.
 // Since the commands are re-used those commands with state,
-// should be cleared first
+// should be cleared first.
+// The replies are per thread, since read only requests can be handled on several threads.
 class PreAllocatedReply : private boost::noncopyable {
 public:
     static STC_Cmd_ptr ok_cmd();
@@ -62,21 +63,21 @@ public:
     static STC_Cmd_ptr sync_full_cmd(unsigned int client_handle, AbstractServer* as);
 
 private:
-    static STC_Cmd_ptr stc_cmd_;
-    static STC_Cmd_ptr defs_cmd_;
-    static STC_Cmd_ptr node_cmd_;
-    static STC_Cmd_ptr stats_cmd_;
-    static STC_Cmd_ptr suites_cmd_;
-    static STC_Cmd_ptr zombie_get_cmd_;
-    static STC_Cmd_ptr error_cmd_;
-    static STC_Cmd_ptr client_handle_cmd_;
-    static STC_Cmd_ptr client_handle_suites_cmd_;
-    static STC_Cmd_ptr string_cmd_;
-    static STC_Cmd_ptr string_vec_cmd_;
-    static STC_Cmd_ptr server_load_cmd_;
-    static STC_Cmd_ptr news_cmd_;
-    static STC_Cmd_ptr sync_cmd_;
-    static STC_Cmd_ptr block_client_zombie_cmd_;
+    static thread_local STC_Cmd_ptr stc_cmd_;
+    static thread_local STC_Cmd_ptr defs_cmd_;
+    static thread_local STC_Cmd_ptr node_cmd_;
+    static thread_local STC_Cmd_ptr stats_cmd_;
+    static thread_local STC_Cmd_ptr suites_cmd_;
+    static thread_local STC_Cmd_ptr zombie_get_cmd_;
+    static thread_local STC_Cmd_ptr error_cmd_;
+    static thread_local STC_Cmd_ptr client_handle_cmd_;
+    static thread_local STC_Cmd_ptr client_handle_suites_cmd_;
+    static thread_local STC_Cmd_ptr string_cmd_;
+    static thread_local STC_Cmd_ptr string_vec_cmd_;
+    static thread_local STC_Cmd_ptr server_load_cmd_;
+    static thread_local STC_Cmd_ptr news_cmd_;
+    static thread_local STC_Cmd_ptr sync_cmd_;
+    static thread_local STC_Cmd_ptr block_client_zombie_cmd_;
 };
 
 #endif
@@ -17,6 +17,12 @@
 
 #include "AbstractServer.hpp"
 #include "Defs.hpp"
+#include "EcfFile.hpp"
+#include "ExprByteCode.hpp"
+#include "JobProfiler.hpp"
+#include "JobThrottle.hpp"
+#include "ScriptFetcher.hpp"
+#include "ScriptPathCache.hpp"
 
 using namespace std;
 
@@ -30,6 +36,42 @@ void SStatsCmd::init(AbstractServer* as) {
     as->stats().update_for_serialisation();
     stats_               = as->stats();
     stats_.no_of_suites_ = as->defs()->suiteVec().size();
+
+    IncludeFileCache& include_cache = IncludeFileCache::instance();
+    stats_.include_cache_hits_      = include_cache.hits();
+    stats_.include_cache_misses_    = include_cache.misses();
+    stats_.include_cache_evictions_ = include_cache.evictions();
+    stats_.include_cache_bytes_     = include_cache.bytes();
+
+    PreProcessedScriptCache& script_cache = PreProcessedScriptCache::instance();
+    stats_.script_cache_hits_             = script_cache.hits();
+    stats_.script_cache_misses_           = script_cache.misses();
+
+    ScriptFetcher& fetcher              = ScriptFetcher::instance();
+    stats_.script_fetches_              = fetcher.fetches();
+    stats_.script_fetch_failures_       = fetcher.failures();
+    stats_.script_fetch_timeouts_       = fetcher.timeouts();
+    stats_.script_fetch_latency_ms_     = fetcher.latency_ms();
+    stats_.script_fetch_max_latency_ms_ = fetcher.max_latency_ms();
+
+    ScriptPathCache& path_cache = ScriptPathCache::instance();
+    stats_.path_cache_hits_     = path_cache.hits();
+    stats_.path_cache_misses_   = path_cache.misses();
+    stats_.script_file_probes_  = ecf::JobProfiler::file_probes(false);
+    stats_.include_file_probes_ = ecf::JobProfiler::file_probes(true);
+
+    JobThrottle& throttle       = JobThrottle::instance();
+    stats_.job_deferrals_       = throttle.deferrals();
+    stats_.job_queue_depth_     = throttle.queue_depth();
+    stats_.job_max_queue_depth_ = throttle.max_queue_depth();
+    stats_.job_backlog_         = throttle.backlog();
+
+    stats_.expr_cache_hits_   = ecf::ExprByteCode::cache_hits();
+    stats_.expr_cache_misses_ = ecf::ExprByteCode::cache_misses();
+
+    size_t polls              = 0;
+    stats_.job_profile_       = ecf::JobProfiler::phase_histograms(polls);
+    stats_.job_profile_polls_ = polls;
 }
 
 bool SStatsCmd::equals(ServerToClientCmd* rhs) const {
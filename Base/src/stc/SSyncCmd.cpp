@@ -43,6 +43,8 @@ void SSyncCmd::reset_data_members(unsigned int client_state_change_no, bool sync
                               sync_suite_clock); // persisted, used for returning INCREMENTAL changes
     server_defs_.clear();                        // persisted, used for returning FULL definition
     full_server_defs_as_string_.clear(); // semi-persisted, i.e on load & not on saving used to return cached defs
+    cached_server_defs_.reset();
+    cached_incremental_changes_.reset();
 }
 
 void SSyncCmd::init(unsigned int client_handle, // a reference to a set of suites used by client
@@ -110,12 +112,10 @@ void SSyncCmd::init(unsigned int client_handle, // a reference to a set of suite
         // and here to avoid traversing down the hierarchy.
         // ******** We must trap all child changes under the suite. See class SuiteChanged
         // ******** otherwise some attribute sync's will be missed
-        as->defs()->collateChanges(client_handle, incremental_changes_);
-        incremental_changes_.set_server_state_change_no(Ecf::state_change_no());
-        incremental_changes_.set_server_modify_change_no(Ecf::modify_change_no());
+        collate_changes(client_handle, Ecf::state_change_no(), Ecf::modify_change_no(), as);
 #ifdef DEBUG_SERVER_SYNC
-        if (incremental_changes_.size())
-            cout << ":*small* scale changes: no of changes(" << incremental_changes_.size() << ")\n";
+        if (incremental_changes().size())
+            cout << ":*small* scale changes: no of changes(" << incremental_changes().size() << ")\n";
         else
             cout << ": *No changes*\n";
 #endif
@@ -177,17 +177,35 @@ void SSyncCmd::init(unsigned int client_handle, // a reference to a set of suite
     }
 
     // small scale changes
-    as->defs()->collateChanges(client_handle, incremental_changes_);
-    incremental_changes_.set_server_state_change_no(max_client_handle_state_change_no);
-    incremental_changes_.set_server_modify_change_no(max_client_handle_modify_change_no);
+    collate_changes(client_handle, max_client_handle_state_change_no, max_client_handle_modify_change_no, as);
 #ifdef DEBUG_SERVER_SYNC
-    if (incremental_changes_.size())
-        cout << ": *small* scale changes: no of changes(" << incremental_changes_.size() << ")\n";
+    if (incremental_changes().size())
+        cout << ": *small* scale changes: no of changes(" << incremental_changes().size() << ")\n";
     else
         cout << ": *No changes*\n";
 #endif
 }
 
+void SSyncCmd::collate_changes(unsigned int client_handle,
+                               unsigned int server_state_change_no,
+                               unsigned int server_modify_change_no,
+                               AbstractServer* as) {
+    if (incremental_changes_.sync_suite_clock()) {
+        // The suite calendar is requested explicitly, and must be current. Hence not shared via the cache
+        as->defs()->collateChanges(client_handle, incremental_changes_);
+        incremental_changes_.set_server_state_change_no(server_state_change_no);
+        incremental_changes_.set_server_modify_change_no(server_modify_change_no);
+        return;
+    }
+
+    // Clients syncing against the same server state, typically ask for the same changes
+    cached_incremental_changes_ = DefsDeltaCache::collateChanges(client_handle,
+                                                                 incremental_changes_.client_state_change_no(),
+                                                                 server_state_change_no,
+                                                                 server_modify_change_no,
+                                                                 as);
+}
+
 void SSyncCmd::full_sync(unsigned int client_handle, AbstractServer* as) {
     Defs* server_defs = as->defs().get();
 
@@ -197,10 +215,11 @@ void SSyncCmd::full_sync(unsigned int client_handle, AbstractServer* as) {
         server_defs->set_modify_change_no(Ecf::modify_change_no());
 
         DefsCache::update_cache_if_state_changed(server_defs);
-        full_defs_ = true;
+        cached_server_defs_ = DefsCache::full_server_defs_as_string_;
+        full_defs_          = true;
 #ifdef DEBUG_SERVER_SYNC
         cout << ": *no handle* returning FULL defs(*cached* string, size("
-             << DefsCache::full_server_defs_as_string_.size() << "))" << endl;
+             << cached_server_defs_->size() << "))" << endl;
 #endif
         return;
     }
@@ -228,10 +247,11 @@ void SSyncCmd::full_sync(unsigned int client_handle, AbstractServer* as) {
     defs_ptr the_server_defs = server_defs->client_suite_mgr().create_defs(client_handle, as->defs());
     if (the_server_defs.get() == server_defs) {
         DefsCache::update_cache_if_state_changed(server_defs);
-        full_defs_ = true;
+        cached_server_defs_ = DefsCache::full_server_defs_as_string_;
+        full_defs_          = true;
 #ifdef DEBUG_SERVER_SYNC
         cout << ": The handle has *ALL* the suites: return the FULL defs(*cached* string, size("
-             << DefsCache::full_server_defs_as_string_.size() << "))";
+             << cached_server_defs_->size() << "))";
 #endif
     }
     else {
@@ -251,6 +271,8 @@ void SSyncCmd::cleanup() {
     incremental_changes_.cleanup();
     std::string().swap(server_defs_);
     std::string().swap(full_server_defs_as_string_); // will typically be empty in server
+    cached_server_defs_.reset();
+    cached_incremental_changes_.reset();
 }
 
 bool SSyncCmd::equals(ServerToClientCmd* rhs) const {
@@ -341,20 +363,20 @@ bool SSyncCmd::do_sync(ServerReply& server_reply, bool debug) const {
         // If *no* server loaded, then no changes applied
         // Returns true if are any memento's, i.e. server changed.
         server_reply.set_full_sync(false);
-        bool changes_made_to_client = incremental_changes_.incremental_sync(
+        bool changes_made_to_client = incremental_changes().incremental_sync(
             server_reply.client_defs_, server_reply.changed_nodes(), server_reply.client_handle());
         server_reply.set_sync(changes_made_to_client);
 
         if (debug)
             cout << "  SSyncCmd::do_sync::*INCREMENTAL sync*, client side state/modify numbers("
-                 << incremental_changes_.get_server_state_change_no() << ","
-                 << incremental_changes_.get_server_modify_change_no() << ") changes_made_to_client("
+                 << incremental_changes().get_server_state_change_no() << ","
+                 << incremental_changes().get_server_modify_change_no() << ") changes_made_to_client("
                  << changes_made_to_client << ")\n";
 
 #ifdef DEBUG_CLIENT_SYNC
         cout << "SSyncCmd::do_sync::*INCREMENTAL sync*, client side state/modify numbers("
-             << incremental_changes_.get_server_state_change_no() << ","
-             << incremental_changes_.get_server_modify_change_no() << ") changes_made_to_client("
+             << incremental_changes().get_server_state_change_no() << ","
+             << incremental_changes().get_server_modify_change_no() << ") changes_made_to_client("
              << changes_made_to_client << "), changed_node_paths(" << server_reply.changed_nodes().size() << ")\n";
 #endif
         return changes_made_to_client;
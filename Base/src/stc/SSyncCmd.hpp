@@ -16,6 +16,7 @@
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
 #include "DefsCache.hpp"
+#include "DefsDeltaCache.hpp"
 #include "DefsDelta.hpp"
 #include "ServerToClientCmd.hpp"
 class AbstractServer;
@@ -32,7 +33,7 @@ class AbstractServer;
 // The *client_state_change_no* was passed from the client to the server
 // The *client_modify_change_no* was passed from the client to the server
 //
-// This class make use of DefsCache as a performance optimisation.
+// This class make use of DefsCache and DefsDeltaCache as a performance optimisation.
 //================================================================================
 class SSyncCmd final : public ServerToClientCmd {
 public:
@@ -71,32 +72,74 @@ private:
 
     void reset_data_members(unsigned int client_state_change_no, bool sync_suite_clock);
     void full_sync(unsigned int client_handle, AbstractServer* as);
+    void collate_changes(unsigned int client_handle,
+                         unsigned int server_state_change_no,
+                         unsigned int server_modify_change_no,
+                         AbstractServer* as);
     void cleanup() override; /// run in the server, after command sent to client
 
+    /// The incremental changes, shared via DefsDeltaCache in the server
+    const DefsDelta& incremental_changes() const {
+        return cached_incremental_changes_ ? cached_incremental_changes_->delta_ : incremental_changes_;
+    }
+
 private:
     bool full_defs_{false};
     DefsDelta incremental_changes_;
     std::string server_defs_;                // for returning a subset of the suites
     std::string full_server_defs_as_string_; // semi-persisted, i.e on load & not on saving, used to return cached defs
+    std::shared_ptr<const std::string> cached_server_defs_; // server side, the DefsCache used when full_defs_ is set
+    DefsDeltaCache::entry_ptr cached_incremental_changes_;  // server side, used in place of incremental_changes_
 
     friend class cereal::access;
+    template <class Archive>
+    void serialize_incremental_changes(Archive& ar) {
+        if constexpr (cereal::traits::is_text_archive<Archive>::value) {
+            if constexpr (Archive::is_saving::value) {
+                // Avoid copying the DefsDelta, when shared via DefsDeltaCache
+                ar(cereal::make_nvp("incremental_changes_", incremental_changes()));
+            }
+            else
+                ar(CEREAL_NVP(incremental_changes_));
+        }
+        else {
+            // The binary archive is only used with clients that support it. The changes are transferred
+            // already serialised, so that clients syncing the same changes share the serialisation
+            std::string incremental_changes_as_string;
+            if constexpr (Archive::is_saving::value) {
+                if (cached_incremental_changes_) {
+                    ar(cached_incremental_changes_->delta_as_string(ecf::ArchiveFormat::PORTABLE_BINARY));
+                    return;
+                }
+                ecf::save_as_string(
+                    incremental_changes_as_string, incremental_changes_, ecf::ArchiveFormat::PORTABLE_BINARY);
+                ar(incremental_changes_as_string);
+            }
+            else {
+                ar(incremental_changes_as_string);
+                ecf::restore_from_string(
+                    incremental_changes_as_string, incremental_changes_, ecf::ArchiveFormat::PORTABLE_BINARY);
+            }
+        }
+    }
+
     template <class Archive>
     void serialize(Archive& ar, std::uint32_t const version) {
         ar(cereal::base_class<ServerToClientCmd>(this),
-           CEREAL_NVP(full_defs_),           // returning full defs as a string
-           CEREAL_NVP(incremental_changes_), // state changes, small scale changes
+           CEREAL_NVP(full_defs_)); // returning full defs as a string
+        serialize_incremental_changes(ar); // state changes, small scale changes
 
-           /// When the server_defs_ was created the def's pointer on the suites was reset back to real server defs
+        ar(/// When the server_defs_ was created the def's pointer on the suites was reset back to real server defs
            /// This is not correct for server_defs_, since we use the *same* suites
            /// **** This is OK since by default the Defs serialisation will fix up the suite's def's pointers ***
            /// The alternative is to clone all the suites, which is very expensive
            CEREAL_NVP(server_defs_)); // large scale changes, if non zero handle, a small subset of the suites
 
         // when full_defs_ is set 'server_defs_' will be empty.
-        if (Archive::is_saving::value) {
+        if constexpr (Archive::is_saving::value) {
             // Avoid copying the string. As this could be very large
-            if (full_defs_) {
-                ar& DefsCache::full_server_defs_as_string_;
+            if (full_defs_ && cached_server_defs_) {
+                ar(*cached_server_defs_);
             }
             else
                 ar& full_server_defs_as_string_;
@@ -19,6 +19,8 @@
 #include <boost/filesystem/path.hpp>
 
 #include "Defs.hpp"
+#include "DurationTimer.hpp"
+#include "EcfFile.hpp"
 #include "File.hpp"
 #include "JobProfiler.hpp"
 #include "Jobs.hpp"
@@ -81,11 +83,34 @@ namespace fs = boost::filesystem;
 //   <not supported>      LLC-load-misses
 //
 //       3.118979324 seconds time elapsed                                          ( +-  2.80% )
+//
+// With --script-cache, the pre-processed scripts are shared between tasks (as with ECF_SCRIPT_CACHE=1 in the
+// server). The job generation is then repeated, after re-queueing the submitted tasks, so that the time with a
+// populated cache can be compared:
+//
+//     perf_job_gen ./metabuilder.def --script-cache
+//
+// With --job-threads <n>, the job files are created in parallel on n threads (as with ECF_JOB_THREADS=n in the
+// server):
+//
+//     perf_job_gen ./metabuilder.def --job-threads 8
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    bool script_cache  = false;
+    size_t job_threads = 0;
+    bool args_ok       = (argc >= 2);
+    for (int i = 2; i < argc && args_ok; i++) {
+        std::string arg = argv[i];
+        if (arg == "--script-cache")
+            script_cache = true;
+        else if (arg == "--job-threads" && i + 1 < argc)
+            job_threads = std::stoul(argv[++i]);
+        else
+            args_ok = false;
+    }
+    if (!args_ok) {
         cout << "TestJobGenPerf.cpp --> " << argv[0] << "\n";
-        cout << "Expect single argument which is path to a defs file\n";
+        cout << "Expect path to a defs file, and optionally --script-cache and --job-threads <n>\n";
         return 1;
     }
 
@@ -161,10 +186,33 @@ int main(int argc, char* argv[]) {
     JobProfiler::set_task_threshold(100); // 100ms where 1000ms is one second
 
     JobsParam jobParam(20 /*submitJobsInterval*/, true /*createJobs*/, false /* spawn jobs */);
+    jobParam.set_use_script_cache(script_cache);
+    jobParam.set_job_threads(job_threads);
     Jobs job(&defs);
-    if (!job.generate(jobParam))
-        cout << " generate failed: " << jobParam.getErrorMsg();
-    cout << "submitted " << jobParam.submitted().size() << " out of " << tasks.size() << "\n";
+    {
+        DurationTimer timer;
+        if (!job.generate(jobParam))
+            cout << " generate failed: " << jobParam.getErrorMsg();
+        cout << "submitted " << jobParam.submitted().size() << " out of " << tasks.size() << " in "
+             << timer.elapsed_seconds() << "s\n";
+    }
+
+    if (script_cache) {
+        // Repeat with the populated cache
+        for (Submittable* t : jobParam.submitted())
+            t->set_state(NState::QUEUED);
+
+        JobsParam jobParam2(20 /*submitJobsInterval*/, true /*createJobs*/, false /* spawn jobs */);
+        jobParam2.set_use_script_cache(true);
+        jobParam2.set_job_threads(job_threads);
+        DurationTimer timer;
+        if (!job.generate(jobParam2))
+            cout << " generate failed: " << jobParam2.getErrorMsg();
+        cout << "submitted " << jobParam2.submitted().size() << " out of " << tasks.size() << " in "
+             << timer.elapsed_seconds() << "s, with script cache hits " << PreProcessedScriptCache::instance().hits()
+             << " misses " << PreProcessedScriptCache::instance().misses() << "\n";
+    }
+    cout << JobProfiler::variable_substitution_report() << "\n";
 
     if (jobParam.submitted().size() != tasks.size()) {
         for (size_t i = 0; i < tasks.size(); i++) {
@@ -82,6 +82,8 @@ populateCmdVec(std::vector<Cmd_ptr>& cmd_vec, std::vector<STC_Cmd_ptr>& stc_cmd_
     cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::STATS)));
     cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::STATS_SERVER)));
     cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::STATS_RESET)));
+    cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::CLEAR_PATH_CACHE)));
+    cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::JOB_PROFILE)));
     cmd_vec.push_back(Cmd_ptr(new CtsCmd(CtsCmd::SUITES)));
     cmd_vec.push_back(Cmd_ptr(new CSyncCmd(CSyncCmd::NEWS, 0, 0, 0)));
     cmd_vec.push_back(Cmd_ptr(new CSyncCmd(CSyncCmd::SYNC, 0, 0, 0)));
@@ -391,6 +393,15 @@ static void test_persistence(const Defs& theFixtureDefs) {
             BOOST_REQUIRE_MESSAGE(restoredRequest == cmd_request,
                                   "restoredRequest " << restoredRequest << " cmd_request " << cmd_request);
         }
+        {
+            std::string binary_request;
+            BOOST_REQUIRE_NO_THROW(ecf::save_as_string(binary_request, cmd_request, ArchiveFormat::PORTABLE_BINARY));
+            ClientToServerRequest restoredRequest;
+            BOOST_REQUIRE_NO_THROW(
+                ecf::restore_from_string(binary_request, restoredRequest, ArchiveFormat::PORTABLE_BINARY));
+            BOOST_REQUIRE_MESSAGE(restoredRequest == cmd_request,
+                                  "binary restoredRequest " << restoredRequest << " cmd_request " << cmd_request);
+        }
 
         fs::remove("request.txt");
     }
@@ -410,6 +421,14 @@ static void test_persistence(const Defs& theFixtureDefs) {
         BOOST_REQUIRE_MESSAGE(restoredRequest == cmd_request,
                               "restoredRequest " << restoredRequest << " cmd_request " << cmd_request);
         fs::remove("request.txt");
+
+        std::string binary_response;
+        BOOST_REQUIRE_NO_THROW(ecf::save_as_string(binary_response, cmd_request, ArchiveFormat::PORTABLE_BINARY));
+        ServerToClientResponse restoredResponse;
+        BOOST_REQUIRE_NO_THROW(
+            ecf::restore_from_string(binary_response, restoredResponse, ArchiveFormat::PORTABLE_BINARY));
+        BOOST_REQUIRE_MESSAGE(restoredResponse == cmd_request,
+                              "binary restoredResponse " << restoredResponse << " cmd_request " << cmd_request);
     }
 }
 
@@ -439,4 +458,29 @@ BOOST_AUTO_TEST_CASE(test_request_authenticate) {
     System::destroy();
 }
 
+BOOST_AUTO_TEST_CASE(test_read_only_request) {
+    cout << "Base:: ...test_read_only_request\n";
+
+    // Only requests that can not change the defs or the server, may be handled on the reader threads
+    ClientToServerRequest request;
+    request.set_cmd(Cmd_ptr(new ShowCmd()));
+    BOOST_CHECK_MESSAGE(request.readOnlyRequest(), "Expected show to be read only");
+    request.set_cmd(Cmd_ptr(new CtsCmd(CtsCmd::PING)));
+    BOOST_CHECK_MESSAGE(request.readOnlyRequest(), "Expected ping to be read only");
+
+    request.set_cmd(Cmd_ptr(new CheckPtCmd()));
+    BOOST_CHECK_MESSAGE(!request.readOnlyRequest(), "Expected check pt to be handled on the main thread");
+    request.set_cmd(Cmd_ptr(new CtsCmd(CtsCmd::DEBUG_SERVER_ON)));
+    BOOST_CHECK_MESSAGE(!request.readOnlyRequest(), "Expected debug server on to be handled on the main thread");
+    request.set_cmd(Cmd_ptr(new ClientHandleCmd(1)));
+    BOOST_CHECK_MESSAGE(!request.readOnlyRequest(), "Expected client handle drop to be handled on the main thread");
+    request.set_cmd(Cmd_ptr(new GroupCTSCmd(Cmd_ptr(new CheckPtCmd()))));
+    BOOST_CHECK_MESSAGE(!request.readOnlyRequest(), "Expected group with check pt to be handled on the main thread");
+    request.set_cmd(Cmd_ptr(new GroupCTSCmd(Cmd_ptr(new CtsCmd(CtsCmd::DEBUG_SERVER_OFF)))));
+    BOOST_CHECK_MESSAGE(!request.readOnlyRequest(), "Expected group with debug server off to be handled on the main thread");
+
+    // Keeping the debug commands off the reader threads, does not make them mutable (used for check pt warnings)
+    BOOST_CHECK_MESSAGE(!CtsCmd(CtsCmd::DEBUG_SERVER_ON).is_mutable(), "Expected debug server on not to be mutable");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -478,4 +478,61 @@ BOOST_AUTO_TEST_CASE(test_ssync_cmd) {
     test_sync_scaffold(set_defs_state, "set_defs_state");
 }
 
+BOOST_AUTO_TEST_CASE(test_ssync_cmd_shared_changes) {
+    cout << "Base:: ...test_ssync_cmd_shared_changes\n";
+    TestLog test_log("test_ssync_cmd_shared_changes.log"); // will create log file, and destroy log and remove file at end of scope
+
+    // Clients syncing the same changes, should share the changes collated in the server
+    MyDefsFixture serverFixture;
+    defs_ptr server_defs = serverFixture.create_defs();
+    server_defs->set_server().set_state(SState::HALTED);
+
+    MyDefsFixture clientFixtures[3];
+    std::vector<defs_ptr> clients;
+    for (auto& clientFixture : clientFixtures) {
+        clients.push_back(clientFixture.create_defs());
+        clients.back()->set_server().set_state(SState::HALTED);
+    }
+
+    unsigned int client_state_change_no  = Ecf::state_change_no();
+    unsigned int client_modify_change_no = Ecf::modify_change_no();
+
+    MockServer mock_server(server_defs);
+    update_repeat(server_defs);
+    set_defs_state(server_defs);
+
+    for (size_t i = 0; i < clients.size(); i++) {
+        ServerReply server_reply;
+        server_reply.set_client_defs(clients[i]);
+
+        SSyncCmd server_cmd(0, client_state_change_no, client_modify_change_no, &mock_server);
+        BOOST_CHECK_MESSAGE(mock_server.stats().sync_cache_misses_ == 1,
+                            "Expected changes to be collated once, but found "
+                                << mock_server.stats().sync_cache_misses_);
+        BOOST_CHECK_MESSAGE(mock_server.stats().sync_cache_hits_ == i,
+                            "Expected " << i << " cache hits but found " << mock_server.stats().sync_cache_hits_);
+
+        // Transfer to the client, the binary archive transfers the shared changes as a string
+        ecf::ArchiveFormat format = (i % 2) ? ecf::ArchiveFormat::PORTABLE_BINARY : ecf::ArchiveFormat::JSON;
+        std::string archive_data;
+        ecf::save_as_string(archive_data, server_cmd, format);
+        SSyncCmd cmd;
+        ecf::restore_from_string(archive_data, cmd, format);
+
+        Ecf::set_server(false); // apply the changes, as if on the client side
+        BOOST_CHECK_MESSAGE(cmd.do_sync(server_reply), "Expected server to change");
+        BOOST_CHECK_MESSAGE(!server_reply.full_sync(), "Expected incremental sync");
+        Ecf::set_server(true);
+
+        DebugEquality debug_equality; // only has affect in DEBUG build
+        BOOST_CHECK_MESSAGE(*server_defs == *server_reply.client_defs(),
+                            "Server and client " << i << " should be same after sync");
+    }
+
+    // Any further change to the server, invalidates the shared changes
+    set_defs_flag(server_defs);
+    SSyncCmd cmd(0, client_state_change_no, client_modify_change_no, &mock_server);
+    BOOST_CHECK_MESSAGE(mock_server.stats().sync_cache_misses_ == 2, "Expected changes to be collated again");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
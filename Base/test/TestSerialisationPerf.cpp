@@ -0,0 +1,138 @@
+//============================================================================
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description : Micro benchmark, comparing serialisation of a large request via
+//               std::ostringstream/std::istringstream (which copy the data), with
+//               the in place stream buffers used by the client/server connection.
+//============================================================================
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ClientToServerCmd.hpp"
+#include "ClientToServerRequest.hpp"
+#include "Defs.hpp"
+#include "Family.hpp"
+#include "Serialization.hpp"
+#include "Suite.hpp"
+#include "Task.hpp"
+
+using namespace std;
+using namespace ecf;
+
+namespace {
+
+defs_ptr create_large_defs() {
+    defs_ptr defs = Defs::create();
+    for (int s = 0; s < 20; s++) {
+        suite_ptr suite = defs->add_suite("suite_" + std::to_string(s));
+        suite->add_variable("SUITE_VAR", "a suite variable with a reasonably long value " + std::to_string(s));
+        for (int f = 0; f < 20; f++) {
+            family_ptr family = suite->add_family("family_" + std::to_string(f));
+            family->add_variable("FAMILY_VAR", "family value " + std::to_string(f));
+            for (int t = 0; t < 20; t++) {
+                task_ptr task = family->add_task("task_" + std::to_string(t));
+                task->add_variable("TASK_VAR", "task value " + std::to_string(t));
+                task->addMeter(Meter("meter", 0, 100));
+                task->addEvent(Event(1, "event"));
+                task->addLabel(Label("label", "label value"));
+            }
+        }
+    }
+    return defs;
+}
+
+/// The serialisation as performed before the in place stream buffers were used
+template <typename T>
+void copying_save_as_string(std::string& outbound_data, const T& t) {
+    std::ostringstream archive_stream;
+    {
+        cereal::JSONOutputArchive oarchive(archive_stream, cereal::JSONOutputArchive::Options::NoIndent());
+        oarchive(cereal::make_nvp(typeid(t).name(), t));
+    }
+    outbound_data = archive_stream.str();
+}
+
+template <typename T>
+void copying_restore_from_buffer(const std::vector<char>& inbound_data, T& restored) {
+    std::string archive_data(inbound_data.begin(), inbound_data.end());
+    std::istringstream archive_stream(archive_data);
+    cereal::JSONInputArchive iarchive(archive_stream);
+    iarchive(restored);
+}
+
+template <typename F>
+double time_in_ms(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(BaseTestSuite)
+
+BOOST_AUTO_TEST_CASE(test_serialisation_perf) {
+    cout << "Base:: ...test_serialisation_perf\n";
+
+    ClientToServerRequest request;
+    request.set_cmd(std::make_shared<LoadDefsCmd>(create_large_defs()));
+
+    const int iterations = 5;
+    std::string outbound_data;
+    std::vector<char> inbound_data;
+
+    // Copying: the archive is copied from the std::ostringstream on save, and twice more on restore.
+    double copying_save_ms    = 0;
+    double copying_restore_ms = 0;
+    for (int i = 0; i < iterations; i++) {
+        copying_save_ms += time_in_ms([&]() { copying_save_as_string(outbound_data, request); });
+        inbound_data.assign(outbound_data.begin(), outbound_data.end()); // as if read from the socket
+
+        ClientToServerRequest restored;
+        copying_restore_ms += time_in_ms([&]() { copying_restore_from_buffer(inbound_data, restored); });
+        BOOST_REQUIRE_MESSAGE(restored == request, "Copying restore failed");
+    }
+    std::size_t data_size = outbound_data.size();
+
+    // In place: written directly into outbound_data, reusing its memory, and restored directly from inbound_data.
+    double in_place_save_ms     = 0;
+    double in_place_restore_ms  = 0;
+    const char* outbound_memory = nullptr;
+    for (int i = 0; i < iterations; i++) {
+        in_place_save_ms += time_in_ms([&]() { ecf::save_as_string(outbound_data, request); });
+        BOOST_CHECK_MESSAGE(outbound_data.size() == data_size,
+                            "Expected " << data_size << " bytes but found " << outbound_data.size());
+        if (i == 0)
+            outbound_memory = outbound_data.data();
+        BOOST_CHECK_MESSAGE(outbound_data.data() == outbound_memory, "Expected the out-bound memory to be reused");
+        inbound_data.assign(outbound_data.begin(), outbound_data.end());
+
+        ClientToServerRequest restored;
+        in_place_restore_ms +=
+            time_in_ms([&]() { ecf::restore_from_buffer(inbound_data.data(), inbound_data.size(), restored); });
+        BOOST_REQUIRE_MESSAGE(restored == request, "In place restore failed");
+    }
+
+    cout << "  Request size " << data_size << " bytes, averaged over " << iterations << " iterations\n";
+    cout << "  Save    copying: " << copying_save_ms / iterations << "ms   in place: " << in_place_save_ms / iterations
+         << "ms\n";
+    cout << "  Restore copying: " << copying_restore_ms / iterations
+         << "ms   in place: " << in_place_restore_ms / iterations << "ms\n";
+    cout << "  Bytes copied per round trip, copying: " << 3 * data_size << "   in place: 0\n";
+}
+
+BOOST_AUTO_TEST_SUITE_END()
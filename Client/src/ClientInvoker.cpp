@@ -742,6 +742,16 @@ int ClientInvoker::stats_reset() const {
         return invoke(CtsApi::stats_reset());
     return invoke(std::make_shared<CtsCmd>(CtsCmd::STATS_RESET));
 }
+int ClientInvoker::clear_path_cache() const {
+    if (testInterface_)
+        return invoke(CtsApi::clear_path_cache());
+    return invoke(std::make_shared<CtsCmd>(CtsCmd::CLEAR_PATH_CACHE));
+}
+int ClientInvoker::job_profile() const {
+    if (testInterface_)
+        return invoke(CtsApi::job_profile());
+    return invoke(std::make_shared<CtsCmd>(CtsCmd::JOB_PROFILE));
+}
 int ClientInvoker::suites() const {
     if (testInterface_)
         return invoke(CtsApi::suites());
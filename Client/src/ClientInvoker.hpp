@@ -242,6 +242,8 @@ public:
     int debug_server_off() const;
     int stats() const; // returns stats as string, server does formatting, & hence is free to change ECFLOW-880
     int stats_reset() const;
+    int clear_path_cache() const; // clears the cached location of scripts and include files
+    int job_profile() const;      // returns the job generation profile as a string, ECF_JOB_PROFILE
     int stats_server() const; // for test only, as stats returned may change for each release ECFLOW-880
     int server_version() const;
 
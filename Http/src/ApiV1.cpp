@@ -619,6 +619,18 @@ void create(httplib::Server& http_server) {
                       {"num_cached_requests", num_cached_requests.load()},
                       {"since", std::string(date)}};
 
+            // The job generation profile of the ecflow server, when enabled with ECF_JOB_PROFILE
+            try {
+                auto client = get_client(request);
+                client->stats_server();
+                const Stats& stats = client->server_reply().stats();
+                if (stats.job_profile_polls_ != 0)
+                    j["job_generation"] = {{"polls", stats.job_profile_polls_}, {"phases", stats.job_profile_}};
+            }
+            catch (const std::exception&) {
+                // The statistics of this server are returned, even when the ecflow server is not available
+            }
+
             j      = filter_json(j, request);
             response.set_content(j.dump(), "application/json");
             set_cors(response);
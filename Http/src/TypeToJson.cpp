@@ -218,6 +218,10 @@ void to_json(nlohmann::json& j, const Stats& s) {
     j["file_jobout"]               = s.file_jobout_;
     j["file_cmdout"]               = s.file_cmdout_;
     j["file_manual"]               = s.file_manual_;
+    if (s.job_profile_polls_ != 0) {
+        j["job_profile_polls"] = s.job_profile_polls_;
+        j["job_profile"]       = s.job_profile_;
+    }
 }
 
 void to_json(json& j, const Expression* a) {
@@ -270,6 +274,14 @@ void ecf::to_json(json& j, const LateAttr& a) {
     j["value"]                = value;
 }
 
+void ecf::to_json(json& j, const JobPhaseHistogram& a) {
+    j["phase"]    = a.phase_;
+    j["count"]    = a.count_;
+    j["total_us"] = a.total_us_;
+    j["max_us"]   = a.max_us_;
+    j["buckets"]  = a.buckets_;
+}
+
 void ecf::to_json(json& j, const TimeSlot& a) {
     j["value"] = a.toString();
 }
@@ -78,6 +78,7 @@ void to_json(nlohmann::json&, const AutoArchiveAttr*);
 void to_json(nlohmann::json&, const AutoArchiveAttr&);
 void to_json(nlohmann::json&, const AutoRestoreAttr*);
 void to_json(nlohmann::json&, const AutoRestoreAttr&);
+void to_json(nlohmann::json&, const JobPhaseHistogram&);
 } // namespace ecf
 
 #endif
@@ -708,6 +708,30 @@ const char* ClientDoc::stats_reset() {
            "       print(str(e))\n";
 }
 
+const char* ClientDoc::clear_path_cache() {
+    return "Clears the cached location of scripts and include files, in the server (ECF_PATH_CACHE=1)\n::\n\n"
+           "   void clear_path_cache()\n"
+           "\nUsage:\n\n"
+           ".. code-block:: python\n\n"
+           "   try:\n"
+           "       ci = Client()  # use default host(ECF_HOST) & port(ECF_PORT)\n"
+           "       ci.clear_path_cache()\n"
+           "   except RuntimeError, e:\n"
+           "       print(str(e))\n";
+}
+
+const char* ClientDoc::job_profile() {
+    return "Returns the time taken by each phase of job generation, for the most recent polls (ECF_JOB_PROFILE)\n::\n\n"
+           "   string job_profile()\n"
+           "\nUsage:\n\n"
+           ".. code-block:: python\n\n"
+           "   try:\n"
+           "       ci = Client()  # use default host(ECF_HOST) & port(ECF_PORT)\n"
+           "       print(ci.job_profile())\n"
+           "   except RuntimeError, e:\n"
+           "       print(str(e))\n";
+}
+
 const char* ClientDoc::suites() {
     return "Returns a list strings representing the `suite`_ names\n::\n\n"
            "   list(string) suites()\n"
@@ -60,6 +60,8 @@ public:
     static const char* ping();
     static const char* stats();
     static const char* stats_reset();
+    static const char* clear_path_cache();
+    static const char* job_profile();
     static const char* suites();
     static const char* ch_register();
     static const char* ch_suites();
@@ -142,6 +142,13 @@ void stats(ClientInvoker* self) {
 void stats_reset(ClientInvoker* self) {
     self->stats_reset();
 }
+void clear_path_cache(ClientInvoker* self) {
+    self->clear_path_cache();
+}
+std::string job_profile(ClientInvoker* self) {
+    self->job_profile();
+    return self->get_string();
+}
 bp::list suites(ClientInvoker* self) {
     self->suites();
     const std::vector<std::string>& the_suites = self->server_reply().get_string_vec();
@@ -581,6 +588,8 @@ void export_Client() {
         .def("ping", &ClientInvoker::pingServer, ClientDoc::ping())
         .def("stats", &stats, ClientDoc::stats())
         .def("stats_reset", &stats_reset, ClientDoc::stats_reset())
+        .def("clear_path_cache", &clear_path_cache, ClientDoc::clear_path_cache())
+        .def("job_profile", &job_profile, ClientDoc::job_profile())
         .def("get_file",
              &get_file,
              (bp::arg("task"), bp::arg("type") = "script", bp::arg("max_lines") = "10000", bp::arg("as_bytes") = false),
@@ -27,10 +27,16 @@
 #include <boost/filesystem/operations.hpp>
 
 #include "Calendar.hpp"
+#include "CheckPtJournal.hpp"
 #include "Defs.hpp"
 #include "Ecf.hpp"
+#include "EcfFile.hpp"
 #include "ExprDuplicate.hpp"
+#include "JobProfiler.hpp"
+#include "JobThrottle.hpp"
 #include "Log.hpp"
+#include "ScriptFetcher.hpp"
+#include "ScriptPathCache.hpp"
 #include "ServerEnvironment.hpp"
 #include "System.hpp"
 #include "Version.hpp"
@@ -56,6 +62,25 @@ BaseServer::BaseServer(boost::asio::io_service& io_service, ServerEnvironment& s
     // Must be set before checkpt file is loaded.
     defs_->ecf_prune_node_log(serverEnv.ecf_prune_node_log());
 
+    // Child commands find the task by path, avoid searching the node tree each time
+    defs_->enable_path_index(true);
+
+    // Avoid fork() of a large server process, for each ECF_JOB_CMD, ECF_KILL_CMD and ECF_STATUS_CMD
+    ecf::System::instance()->set_use_posix_spawn(serverEnv.posix_spawn());
+
+    ScriptFetcher::instance().set_max_fetches(serverEnv.fetch_async());
+    ScriptFetcher::instance().set_timeout(serverEnv.fetch_timeout());
+
+    ScriptPathCache::instance().enable(serverEnv.path_cache());
+    ScriptPathCache::instance().set_negative_ttl(serverEnv.path_cache_ttl());
+    IncludeFileCache::instance().set_max_bytes(static_cast<size_t>(serverEnv.include_cache_size()) * 1024 * 1024);
+    PreProcessedScriptCache::instance().set_max_bytes(static_cast<size_t>(serverEnv.script_cache_size()) * 1024 * 1024);
+
+    JobProfiler::set_profile_polls(serverEnv.job_profile());
+
+    JobThrottle::instance().set_rate(serverEnv.job_rate());
+    JobThrottle::instance().set_host_rate(serverEnv.job_host_rate());
+
     LogFlusher logFlusher;
 
     // Register to handle the signals.
@@ -180,7 +205,13 @@ bool BaseServer::restore_from_checkpt(const std::string& filename, bool& failed)
         log(Log::MSG, s);
 
         try {
-            defs_->restore(filename);   // this can throw
+            defs_->restore(filename); // this can throw
+            if (filename == serverEnv_.checkPtFilename()) {
+                // The state changes made after the check point, see ECF_CHECKPT_JOURNAL
+                size_t records = CheckPtJournal::replay(filename, defs_);
+                if (records != 0)
+                    LOG(Log::MSG, "Replayed " << records << " check point journal records");
+            }
             defs_->handle_migration();  // handle any migration of checkpt file.
             update_defs_server_state(); // works on def_
             LOG(Log::MSG,
@@ -193,6 +224,9 @@ bool BaseServer::restore_from_checkpt(const std::string& filename, bool& failed)
                 log(Log::MSG,
                     "Suite time attributes updated to catch up with real time. Down time was less than 1 hour");
             }
+
+            // New state changes must not be appended to the journals, of a different check point
+            checkPtSaver_.restored();
             return true;
         }
         catch (exception& e) {
@@ -507,8 +541,11 @@ void BaseServer::sigterm_signal_handler() {
         cout << "BaseServer::sigterm_signal_handler(): Received SIGTERM : starting check pointing" << endl;
     ecf::log(Log::MSG, "BaseServer::sigterm_signal_handler(): Received SIGTERM : starting check pointing");
 
-    defs_->flag().set(ecf::Flag::ECF_SIGTERM);
-    checkPtDefs();
+    {
+        std::unique_lock<std::shared_mutex> state_lock(state_mutex_); // exclude read only requests
+        defs_->flag().set(ecf::Flag::ECF_SIGTERM);
+        checkPtDefs();
+    }
 
     ecf::log(Log::MSG, "BaseServer::sigterm_signal_handler(): finished check pointing");
     if (serverEnv_.debug())
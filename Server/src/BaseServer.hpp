@@ -21,6 +21,9 @@
 //  o Dynamic and/or Private Ports.                    49151-65535
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
+#include <mutex>
+#include <shared_mutex>
+
 #include <boost/asio.hpp>
 
 #include "AbstractServer.hpp"
@@ -88,6 +91,15 @@ public:
     // used in signal, for emergency check point during system session
     void sigterm_signal_handler();
 
+    /// Read only requests can be handled on a pool of threads, see ECF_READ_THREADS.
+    /// These hold a shared lock on the server state. Anything that can change the server state, i.e.
+    /// write requests, job generation and check pointing, must hold an exclusive lock.
+    std::shared_mutex& state_mutex() { return state_mutex_; }
+
+    /// Read only requests still update the log, statistics and cached replies.
+    /// Hence their execution is serialised with this mutex; only their replies are written concurrently.
+    std::mutex& read_request_mutex() { return read_request_mutex_; }
+
 protected:
     /// The io_service used to perform asynchronous operations.
     boost::asio::io_service& io_service_;
@@ -107,6 +119,9 @@ protected:
 
     ServerEnvironment& serverEnv_;
     std::string userWhoHasLock_;
+
+    std::shared_mutex state_mutex_;
+    std::mutex read_request_mutex_;
 };
 
 #endif
@@ -0,0 +1,262 @@
+//============================================================================
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+//============================================================================
+
+#include "CheckPtJournal.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "Defs.hpp"
+#include "DefsDelta.hpp"
+#include "Ecf.hpp"
+#include "File.hpp"
+#include "Log.hpp"
+#include "Serialization.hpp"
+
+namespace fs = boost::filesystem;
+using namespace ecf;
+
+namespace {
+
+// Each record is the size of the serialised DefsDelta, followed by the DefsDelta
+using record_size_t = std::uint32_t;
+
+std::string errno_error(const std::string& what, const std::string& path) {
+    std::string err = "CheckPtJournal: ";
+    err += what;
+    err += " ";
+    err += path;
+    err += " failed: ";
+    err += strerror(errno);
+    return err;
+}
+
+/// Returns the size of the complete records, at the start of the contents
+size_t complete_records_size(const std::string& contents) {
+    size_t pos = 0;
+    while (pos + sizeof(record_size_t) <= contents.size()) {
+        record_size_t size;
+        memcpy(&size, contents.data() + pos, sizeof(record_size_t));
+        if (pos + sizeof(record_size_t) + size > contents.size())
+            break;
+        pos += sizeof(record_size_t) + size;
+    }
+    return pos;
+}
+
+/// Returns false, if the replay should stop
+bool replay_file(const std::string& filename, const defs_ptr& defs, size_t& records) {
+    if (!fs::exists(filename))
+        return true;
+
+    std::string contents;
+    if (!File::open(filename, contents)) {
+        LOG(Log::ERR, "CheckPtJournal: Could not open " << filename);
+        return false;
+    }
+
+    // The records are replayed in order. Hence on error, the defs holds the state up to the previous record
+    size_t pos = 0;
+    std::vector<std::string> changed_nodes;
+    while (pos + sizeof(record_size_t) <= contents.size()) {
+        record_size_t size;
+        memcpy(&size, contents.data() + pos, sizeof(record_size_t));
+        if (pos + sizeof(record_size_t) + size > contents.size())
+            break; // Incomplete record, i.e. server died whilst writing
+        pos += sizeof(record_size_t);
+
+        try {
+            DefsDelta changes(0);
+            ecf::restore_from_buffer(contents.data() + pos, size, changes, ecf::ArchiveFormat::PORTABLE_BINARY);
+            changes.incremental_sync(defs, changed_nodes, 0);
+        }
+        catch (std::exception& e) {
+            LOG(Log::ERR,
+                "CheckPtJournal: Could not replay " << filename << ", after " << records
+                                                    << " records, because: " << e.what());
+            return false;
+        }
+        pos += size;
+        records++;
+    }
+    if (pos != contents.size()) {
+        LOG(Log::WAR, "CheckPtJournal: Ignoring incomplete record at the end of " << filename);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CheckPtJournal::CheckPtJournal(const std::string& checkPtFilename)
+    : journal_filename_(journal_filename(checkPtFilename)),
+      prev_journal_filename_(prev_journal_filename(checkPtFilename)),
+      state_change_no_(Ecf::state_change_no()),
+      modify_change_no_(Ecf::modify_change_no()) {
+}
+
+CheckPtJournal::~CheckPtJournal() {
+    close();
+}
+
+std::string CheckPtJournal::journal_filename(const std::string& checkPtFilename) {
+    return checkPtFilename + ".journal";
+}
+
+std::string CheckPtJournal::prev_journal_filename(const std::string& checkPtFilename) {
+    return checkPtFilename + ".journal.prev";
+}
+
+bool CheckPtJournal::exists(const std::string& checkPtFilename) {
+    return fs::exists(journal_filename(checkPtFilename)) || fs::exists(prev_journal_filename(checkPtFilename));
+}
+
+bool CheckPtJournal::append(const Defs& defs) {
+    if (modify_change_no_ != Ecf::modify_change_no())
+        return false; // structural changes, requires full check point
+    if (state_change_no_ == Ecf::state_change_no())
+        return true; // no changes
+
+    DefsDelta changes(state_change_no_);
+    defs.collateChanges(0, changes);
+    changes.set_server_state_change_no(Ecf::state_change_no());
+    changes.set_server_modify_change_no(Ecf::modify_change_no());
+    state_change_no_ = Ecf::state_change_no();
+    if (changes.size() == 0)
+        return true;
+
+    // Reserve space for the size, and serialise the changes after it
+    record_.assign(sizeof(record_size_t), '\0');
+    std::string archive;
+    ecf::save_as_string(archive, changes, ecf::ArchiveFormat::PORTABLE_BINARY);
+    auto size = static_cast<record_size_t>(archive.size());
+    memcpy(&record_[0], &size, sizeof(record_size_t));
+    record_ += archive;
+
+    if (fd_ == -1)
+        open();
+
+    // Write directly to the file (no user space buffering), so that the records survive the server dying
+    const char* data = record_.data();
+    size_t remaining = record_.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd_, data, remaining);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(errno_error("write", journal_filename_));
+        }
+        data += written;
+        remaining -= written;
+    }
+    records_++;
+    bytes_ += record_.size();
+
+    // Sync to disk at most once a second. Protects against the machine going down.
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+    if (last_sync_.is_not_a_date_time() || (now - last_sync_).total_seconds() >= 1) {
+        if (::fdatasync(fd_) == -1)
+            throw std::runtime_error(errno_error("fdatasync", journal_filename_));
+        last_sync_ = now;
+    }
+    return true;
+}
+
+void CheckPtJournal::checkpt_started() {
+    close();
+
+    // If the last check point failed, the previous journal is still needed
+    if (fs::exists(journal_filename_)) {
+        if (fs::exists(prev_journal_filename_)) {
+            {
+                std::ifstream journal(journal_filename_.c_str(), std::ios::binary);
+                std::ofstream prev_journal(prev_journal_filename_.c_str(), std::ios::binary | std::ios::app);
+                prev_journal << journal.rdbuf();
+                if (!prev_journal.good())
+                    throw std::runtime_error("CheckPtJournal: Could not append to " + prev_journal_filename_ + ": " +
+                                             File::stream_error_condition(prev_journal));
+            }
+            fs::remove(journal_filename_);
+        }
+        else {
+            fs::rename(journal_filename_, prev_journal_filename_);
+        }
+    }
+
+    state_change_no_  = Ecf::state_change_no();
+    modify_change_no_ = Ecf::modify_change_no();
+    records_          = 0;
+    bytes_            = 0;
+}
+
+void CheckPtJournal::checkpt_saved() {
+    fs::remove(prev_journal_filename_);
+}
+
+void CheckPtJournal::remove() {
+    close();
+    fs::remove(journal_filename_);
+    fs::remove(prev_journal_filename_);
+
+    state_change_no_  = Ecf::state_change_no();
+    modify_change_no_ = Ecf::modify_change_no();
+    records_          = 0;
+    bytes_            = 0;
+}
+
+size_t CheckPtJournal::replay(const std::string& checkPtFilename, const defs_ptr& defs) {
+    // The change numbers of the journal, are not those of the restored defs
+    unsigned int state_change_no  = defs->state_change_no();
+    unsigned int modify_change_no = defs->modify_change_no();
+
+    size_t records = 0;
+    if (replay_file(prev_journal_filename(checkPtFilename), defs, records))
+        replay_file(journal_filename(checkPtFilename), defs, records);
+
+    defs->set_state_change_no(state_change_no);
+    defs->set_modify_change_no(modify_change_no);
+    return records;
+}
+
+void CheckPtJournal::open() {
+    // Remove any incomplete record, i.e. server died whilst writing. Otherwise new records can not be replayed
+    if (fs::exists(journal_filename_)) {
+        std::string contents;
+        if (File::open(journal_filename_, contents)) {
+            size_t size = complete_records_size(contents);
+            if (size != contents.size())
+                fs::resize_file(journal_filename_, size);
+        }
+    }
+
+    fd_ = ::open(journal_filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ == -1)
+        throw std::runtime_error(errno_error("open", journal_filename_));
+}
+
+void CheckPtJournal::close() {
+    if (fd_ != -1) {
+        ::fdatasync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef CHECKPTJOURNAL_HPP_
+#define CHECKPTJOURNAL_HPP_
+
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+// Name        :
+// Author      : Avi
+// Revision    : $Revision: #1 $
+//
+// Copyright 2009- ECMWF.
+// This software is licensed under the terms of the Apache Licence version 2.0
+// which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+// In applying this licence, ECMWF does not waive the privileges and immunities
+// granted to it by virtue of its status as an intergovernmental organisation
+// nor does it submit to any jurisdiction.
+//
+// Description :
+//
+// An append only journal of the state changes, made since the last check point.
+// Writing the full check point can take a long time for large definitions, hence
+// is only done periodically (ECF_CHECKINTERVAL). In between, the state changes
+// are appended to the journal, after each command and node tree traversal.
+//
+// Each record holds the incremental changes (DefsDelta) since the previous record,
+// i.e. the same mementos that are used to sync the clients. On start up the journal
+// is replayed over the check point file, see BaseServer::restore_from_checkpt.
+//
+// Structural changes (i.e. adding/deleting suites) are not journaled, these require
+// a full check point. Nothing is appended after a structural change, until the next
+// periodic check point. The journal then holds the changes up to the structural change.
+//
+// After the check point file is restored, the journals no longer apply to it (i.e. the
+// backup check point file was restored), hence the server writes a new check point.
+//
+// When a full check point is taken, the journal is moved aside (<journal>.prev) and
+// a new journal started. The previous journal is only deleted, once the check point
+// has been written. Hence if the server crashes, whilst the check point is written,
+// both journals are replayed over the previous check point file. Since the mementos
+// hold the latest value of each attribute, replaying the previous journal over the
+// new check point file is harmless.
+//
+/////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
+
+#include <cstddef>
+#include <string>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "NodeFwd.hpp"
+
+class CheckPtJournal {
+    CheckPtJournal(const CheckPtJournal&)                  = delete;
+    const CheckPtJournal& operator=(const CheckPtJournal&) = delete;
+
+public:
+    explicit CheckPtJournal(const std::string& checkPtFilename);
+    ~CheckPtJournal();
+
+    /// The journal files, for the given check point file
+    static std::string journal_filename(const std::string& checkPtFilename);
+    static std::string prev_journal_filename(const std::string& checkPtFilename);
+
+    /// Return true if there are journals, for the given check point file
+    static bool exists(const std::string& checkPtFilename);
+
+    /// Append the state changes since the last record, to the journal
+    /// Returns false if there were structural changes, since the last full check point. Nothing is then
+    /// appended until the next full check point. Can throw, if the journal can not be written
+    bool append(const Defs& defs);
+
+    /// Called when the defs are saved for a full check point: Move the journal aside and start a new journal
+    void checkpt_started();
+
+    /// Called once the full check point has been written: Remove the previous journal
+    void checkpt_saved();
+
+    /// Remove the journals, and start a new journal
+    void remove();
+
+    /// Replay the journals over the defs, restored from the check point file
+    /// Returns the number of records replayed. Stops at the first incomplete record.
+    static size_t replay(const std::string& checkPtFilename, const defs_ptr& defs);
+
+    /// The number of records/bytes appended, since the last full check point
+    size_t records() const { return records_; }
+    size_t bytes() const { return bytes_; }
+
+private:
+    void open();
+    void close();
+
+    std::string journal_filename_;
+    std::string prev_journal_filename_;
+    std::string record_;                 // re-used, for each record
+    int fd_{-1};
+    unsigned int state_change_no_{0};    // Changes after this are appended
+    unsigned int modify_change_no_{0};   // Structural changes after this, require a full check point
+    size_t records_{0};
+    size_t bytes_{0};
+    boost::posix_time::ptime last_sync_; // sync to disk at most once a second
+};
+
+#endif
@@ -15,6 +15,12 @@
 
 #include "CheckPtSaver.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <unistd.h>
+
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
@@ -37,6 +43,85 @@
 namespace fs = boost::filesystem;
 using namespace ecf;
 
+namespace {
+
+std::string errno_error(const std::string& what, const std::string& path) {
+    std::string err = what;
+    err += " ";
+    err += path;
+    err += " failed: ";
+    err += strerror(errno);
+    return err;
+}
+
+void fsync_directory(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw std::runtime_error(errno_error("open", path));
+    if (::fsync(fd) == -1) {
+        std::string err = errno_error("fsync", path);
+        ::close(fd);
+        throw std::runtime_error(err);
+    }
+    ::close(fd);
+}
+
+/// Write the check point, so that a crash never leaves a partially written check point file:
+///   o write to a temporary file, and sync to disk
+///   o keep the previous check point file as the backup
+///   o atomically rename the temporary file over the check point file
+/// Runs in the writer thread, hence must not access the server. Can throw.
+void write_checkpt(const std::string& snapshot,
+                   const std::string& checkPtFilename,
+                   const std::string& oldCheckPtFilename) {
+    std::string tmpFilename = checkPtFilename + ".tmp";
+    {
+        int fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            throw std::runtime_error(errno_error("open", tmpFilename));
+        const char* data = snapshot.data();
+        size_t remaining = snapshot.size();
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written == -1) {
+                if (errno == EINTR)
+                    continue;
+                std::string err = errno_error("write", tmpFilename);
+                ::close(fd);
+                throw std::runtime_error(err);
+            }
+            data += written;
+            remaining -= written;
+        }
+        if (::fsync(fd) == -1) {
+            std::string err = errno_error("fsync", tmpFilename);
+            ::close(fd);
+            throw std::runtime_error(err);
+        }
+        if (::close(fd) == -1)
+            throw std::runtime_error(errno_error("close", tmpFilename));
+    }
+
+    // Backup check point file if it exists & is non zero
+    // Link rather than rename, so that there is always a check point file
+    fs::path checkPtFile(checkPtFilename);
+    if (fs::exists(checkPtFile) && fs::file_size(checkPtFile) != 0) {
+        fs::path oldCheckPtFile(oldCheckPtFilename);
+        fs::remove(oldCheckPtFile);
+        boost::system::error_code ec;
+        fs::create_hard_link(checkPtFile, oldCheckPtFile, ec);
+        if (ec)
+            fs::rename(checkPtFile, oldCheckPtFile); // i.e. file system does not support hard links
+    }
+
+    fs::rename(tmpFilename, checkPtFile);
+
+    // Make the rename durable
+    fsync_directory(fs::absolute(checkPtFile).parent_path().string());
+}
+
+} // namespace
+
 //-------------------------------------------------------------------------------------
 CheckPtSaver::CheckPtSaver(BaseServer* s, boost::asio::io_service& io, const ServerEnvironment* serverEnv)
     : server_(s),
@@ -45,7 +130,8 @@ CheckPtSaver::CheckPtSaver(BaseServer* s, boost::asio::io_service& io, const Ser
       running_(false),
       serverEnv_(serverEnv),
       state_change_no_(Ecf::state_change_no()),
-      modify_change_no_(Ecf::modify_change_no()) {
+      modify_change_no_(Ecf::modify_change_no()),
+      journal_(serverEnv->checkPtFilename()) {
 #ifdef DEBUG_CHECKPT
     std::cout << "      CheckPtSaver::CheckPtSaver period = " << serverEnv_->checkPtInterval() << "\n";
 #endif
@@ -55,6 +141,9 @@ CheckPtSaver::~CheckPtSaver() {
 #ifdef DEBUG_CHECKPT
     std::cout << "      ~CheckPtSaver::CheckPtSaver\n";
 #endif
+    // Any completion handler, still to be run by the server thread, does nothing once background_save_ is destroyed
+    if (writer_.joinable())
+        writer_.join();
 }
 
 void CheckPtSaver::start() {
@@ -99,8 +188,15 @@ void CheckPtSaver::terminate() {
 }
 
 bool CheckPtSaver::explicitSave(bool from_server) const {
-    bool ret = true;
+    if (from_server && serverEnv_->checkpt_async()) {
+        backgroundSave();
+        return true;
+    }
 
+    // Any background save must complete first, otherwise it could overwrite this check point
+    backgroundSaveCompleted();
+
+    bool ret = true;
     try {
 #ifdef DEBUG_CHECKPT
         std::cout << "      CheckPtSaver::explicitSave() Saving checkpt file " << serverEnv_->checkPtFilename() << "\n";
@@ -108,6 +204,9 @@ bool CheckPtSaver::explicitSave(bool from_server) const {
         // Time how long we take to checkpt, Help to recognise *SLOW* disk, which can *AFFECT* server performance
         DurationTimer durationTimer;
 
+        // Changes made after this point, are recorded in a new journal
+        journal_.checkpt_started();
+
         // Backup checkpoint file if it exists & is non zero
         // Avoid an empty file as a backup file, could results from a full file system
         // i.e move ecf_checkpt_file --> ecf_backup_checkpt_file
@@ -121,6 +220,7 @@ bool CheckPtSaver::explicitSave(bool from_server) const {
 
         // write to ecf_checkpt_file, if file system is full this could result in an empty file. ?
         server_->defs_->save_as_checkpt(serverEnv_->checkPtFilename());
+        journal_.checkpt_saved();
 
         state_change_no_  = Ecf::state_change_no();  // For periodic update only save checkPt if it has changed
         modify_change_no_ = Ecf::modify_change_no(); // For periodic update only save checkPt if it has changed
@@ -161,6 +261,99 @@ bool CheckPtSaver::explicitSave(bool from_server) const {
     return ret;
 }
 
+void CheckPtSaver::backgroundSave() const {
+    // Time how long the server is blocked. Includes waiting for the previous save, when saving faster than the disk
+    DurationTimer stallTimer;
+    backgroundSaveCompleted();
+
+    auto snapshot = std::make_shared<std::string>();
+    try {
+        journal_.checkpt_started(); // Changes made after the snapshot, are recorded in a new journal
+        server_->defs_->save_checkpt_as_string(*snapshot);
+    }
+    catch (std::exception& e) {
+        std::string msg = "Could not save checkPoint file! ";
+        msg += e.what();
+        server_->defs_->flag().set(ecf::Flag::CHECKPT_ERROR);
+        server_->defs()->set_server().add_or_update_user_variables("ECF_CHECKPT_ERROR", msg);
+        LOG(Log::ERR, msg);
+        return;
+    }
+
+    state_change_no_  = Ecf::state_change_no();  // For periodic update only save checkPt if it has changed
+    modify_change_no_ = Ecf::modify_change_no(); // For periodic update only save checkPt if it has changed
+
+    server_->stats().checkpt_background_++;
+    server_->stats().checkpt_stall_time_us_ += stallTimer.elapsed().total_microseconds();
+
+    // The writer thread must not access the CheckPtSaver, which may be destroyed before the completion is handled
+    auto save                      = std::make_shared<BackgroundSave>();
+    background_save_               = save;
+    boost::asio::io_service& io    = server_->io_service_;
+    std::string checkPtFilename    = serverEnv_->checkPtFilename();
+    std::string oldCheckPtFilename = serverEnv_->oldCheckPtFilename();
+    writer_                        = std::thread([this, &io, save, snapshot, checkPtFilename, oldCheckPtFilename]() {
+        DurationTimer durationTimer;
+        try {
+            write_checkpt(*snapshot, checkPtFilename, oldCheckPtFilename);
+        }
+        catch (std::exception& e) {
+            save->error_ = e.what();
+        }
+        save->save_time_ = durationTimer.elapsed_seconds();
+
+        // Report the result on the server thread. The CheckPtSaver keeps the save, until it is completed.
+        // Hence if the save has expired, it was completed already (i.e. by explicitSave), or the CheckPtSaver
+        // was destroyed, which joins this thread first.
+        std::weak_ptr<BackgroundSave> weak_save = save;
+        io.post([this, weak_save]() {
+            std::shared_ptr<BackgroundSave> the_save = weak_save.lock();
+            if (the_save && the_save == background_save_) {
+                std::unique_lock<std::shared_mutex> state_lock(server_->state_mutex()); // exclude read only requests
+                backgroundSaveCompleted();
+            }
+        });
+    });
+}
+
+void CheckPtSaver::backgroundSaveCompleted() const {
+    if (!writer_.joinable())
+        return;
+    writer_.join();
+
+    std::shared_ptr<BackgroundSave> save;
+    save.swap(background_save_);
+    const std::string& error_msg = save->error_;
+    double save_time             = save->save_time_;
+
+    server_->stats().checkpt_save_time_us_ += static_cast<std::uint64_t>(save_time * 1000000);
+    if (!error_msg.empty()) {
+        std::string msg = "Could not save checkPoint file! ";
+        msg += error_msg;
+        server_->defs_->flag().set(ecf::Flag::CHECKPT_ERROR);
+        server_->defs()->set_server().add_or_update_user_variables("ECF_CHECKPT_ERROR", msg);
+        LOG(Log::ERR, msg);
+        return;
+    }
+    journal_.checkpt_saved();
+
+    Log::instance()->cache_time_stamp();
+    std::string msg = Str::SVR_CMD();
+    msg += CtsApi::checkPtDefsArg();
+    std::stringstream ss;
+    ss << msg << " in background in " << save_time << " seconds";
+    log(Log::MSG, ss.str());
+
+    /// The save no longer blocks the server. However still report slow disks
+    if (static_cast<size_t>(save_time) > server_->serverEnv_.checkpt_save_time_alarm()) {
+        server_->defs_->flag().set(ecf::Flag::LATE);
+        std::stringstream ss;
+        ss << "Check pt save time(" << save_time << ") is greater than alarm time("
+           << server_->serverEnv_.checkpt_save_time_alarm() << "). Check the disk used by ECF_CHECK!";
+        log(Log::WAR, ss.str());
+    }
+}
+
 void CheckPtSaver::periodicSaveCheckPt(const boost::system::error_code& error) {
 #ifdef DEBUG_CHECKPT
     std::cout << "      CheckPtSaver::periodicSaveCheckPt() interval = " << serverEnv_->checkPtInterval()
@@ -184,6 +377,7 @@ void CheckPtSaver::periodicSaveCheckPt(const boost::system::error_code& error) {
     if (running_) {
         // state changed
         if (state_change_no_ != Ecf::state_change_no() || modify_change_no_ != Ecf::modify_change_no()) {
+            std::unique_lock<std::shared_mutex> state_lock(server_->state_mutex()); // exclude read only requests
             doSave();
         }
     }
@@ -218,4 +412,41 @@ void CheckPtSaver::saveIfAllowed() {
     if (serverEnv_->checkMode() == ecf::CheckPt::ALWAYS) {
         doSave();
     }
+    else {
+        journalChanges();
+    }
+}
+
+void CheckPtSaver::journalChanges() const {
+    if (!serverEnv_->checkpt_journal() || serverEnv_->checkMode() != ecf::CheckPt::ON_TIME)
+        return;
+
+    try {
+        size_t records = journal_.records();
+        size_t bytes   = journal_.bytes();
+        if (!journal_.append(*server_->defs_)) {
+            // Structural changes can not be journaled. Rather than saving now, i.e. for each alter, replace or load
+            // command, the journal is suspended until the next periodic save. See periodicSaveCheckPt
+            return;
+        }
+        server_->stats().checkpt_journal_records_ += journal_.records() - records;
+        server_->stats().checkpt_journal_bytes_ += journal_.bytes() - bytes;
+    }
+    catch (std::exception& e) {
+        std::string msg = "Could not append to check point journal! ";
+        msg += e.what();
+        server_->defs_->flag().set(ecf::Flag::CHECKPT_ERROR);
+        server_->defs()->set_server().add_or_update_user_variables("ECF_CHECKPT_ERROR", msg);
+        LOG(Log::ERR, msg);
+    }
+}
+
+void CheckPtSaver::restored() const {
+    if (!CheckPtJournal::exists(serverEnv_->checkPtFilename()))
+        return;
+
+    // The journals were replayed, or do not apply to the restored check point file. Write the restored defs
+    // as the new check point, this removes the journals.
+    if (!explicitSave())
+        journal_.remove();
 }
@@ -21,9 +21,24 @@
 // The checkpoint files is the defs file, with state. However its saved in
 // boost serialisation format(i.e can be text,binary,portable binary)
 //
+// When ECF_CHECKPT_ASYNC is set, the periodic save only takes a snapshot of the
+// defs (in memory) on the server thread. The snapshot is written by a separate
+// thread, to a temporary file which is synced to disk, and then renamed over the
+// check point file. Hence a crash during the save, never leaves a partial check
+// point file. Once written, the result is handled back on the server thread.
+//
+// When ECF_CHECKPT_JOURNAL is set, the state changes in between the periodic saves
+// are appended to a journal. See class CheckPtJournal
+//
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
+#include <memory>
+#include <string>
+#include <thread>
+
 #include <boost/asio.hpp>
+
+#include "CheckPtJournal.hpp"
 class ServerEnvironment;
 class BaseServer;
 
@@ -53,6 +68,7 @@ public:
     /// we log the request. However we also check point automatically via the server
     /// This allows us to distinguish the two cases in the log file:
     /// Return true if no errors, otherwise false
+    /// Must be called on the server thread, (not the reader threads), since it may wait for a background save
     bool explicitSave(bool from_server = false) const;
 
     /// This function is called after node state changes. Check for save
@@ -61,6 +77,16 @@ public:
     /// CheckPt::ALWAYS  - will save immediately, may cause performance issues with large Node trees
     void saveIfAllowed();
 
+    /// Append the state changes, since the last call, to the journal. Only if configuration allows it.
+    /// Called after each command, and node tree traversal. Structural changes are not journaled, and
+    /// suspend the journal until the next periodic save.
+    void journalChanges() const;
+
+    /// Called after the defs have been restored from a check point file. Any journals, are replaced
+    /// with a new check point. Otherwise new records would be appended to a journal, that was made
+    /// against a different check point, i.e. when the backup check point file was restored.
+    void restored() const;
+
 private:
     /// save the node tree in the server to a checkPt file.
     /// this is controlled by the configuration. If the configuration does not
@@ -76,6 +102,22 @@ private:
     /// This avoids writing out a checkpt file, unnecessarily & filling up log file
     void periodicSaveCheckPt(const boost::system::error_code& error);
 
+    /// Take a snapshot of the defs, and write it to the check point file in the background
+    void backgroundSave() const;
+
+    /// Wait for any background save to complete, and report its result. Must be called on the server thread
+    void backgroundSaveCompleted() const;
+
+    /// The result of a save in the background. Shared with the writer thread, which only
+    /// holds on to it whilst it runs. The completion handler, posted by the writer thread
+    /// to the server thread, only holds a weak reference. Hence the handler does nothing
+    /// if the save has been completed already, or the CheckPtSaver destroyed.
+    struct BackgroundSave
+    {
+        std::string error_;   // Only accessed, after the writer_ has been joined
+        double save_time_{0}; // Only accessed, after the writer_ has been joined
+    };
+
     BaseServer* server_;
     boost::asio::deadline_timer timer_;
     bool firstTime_;
@@ -83,5 +125,11 @@ private:
     const ServerEnvironment* serverEnv_;
     mutable unsigned int state_change_no_;  // detect state change in defs
     mutable unsigned int modify_change_no_; // detect state change in defs
+
+    mutable CheckPtJournal journal_; // state changes, in between the check points
+
+    // Only accessed on the server thread
+    mutable std::thread writer_;                              // writes the snapshot, when saving in the background
+    mutable std::shared_ptr<BackgroundSave> background_save_; // the save written by writer_
 };
 #endif
@@ -310,7 +310,11 @@ void NodeTreeTraverser::traverse(const boost::system::error_code& error) {
         return;
     }
 
+    std::unique_lock<std::shared_mutex> state_lock(server_->state_mutex()); // exclude read only requests
     do_traverse();
+
+    // Record any state changes made by job generation, time dependencies, etc
+    server_->checkPtSaver_.journalChanges();
 }
 
 void NodeTreeTraverser::update_suite_calendar_and_traverse_node_tree(const boost::posix_time::ptime& time_now) {
@@ -385,6 +389,13 @@ void NodeTreeTraverser::traverse_node_tree_and_job_generate(const boost::posix_t
         // Note: There are other place where we may not want to timeout job generation.
         jobsParam.set_next_poll_time(next_poll_time_);
 
+        // Only resolve dependencies of suites affected by changes since the last job generation
+        jobsParam.set_use_dependency_index(serverEnv_.dependency_index());
+        jobsParam.set_use_script_cache(serverEnv_.script_cache());
+        jobsParam.set_job_threads(serverEnv_.job_threads());
+        jobsParam.set_async_fetch(serverEnv_.fetch_async() > 0);
+        jobsParam.set_throttle_jobs(serverEnv_.job_rate() > 0 || serverEnv_.job_host_rate() > 0);
+
         Jobs jobs(server_->defs_);
         if (!jobs.generate(jobsParam)) {
             ecf::log(Log::ERR, jobsParam.getErrorMsg());
@@ -74,6 +74,23 @@ ServerEnvironment::ServerEnvironment(int argc, char* argv[])
       checkpt_save_time_alarm_(CheckPt::default_save_time_alarm()),
       submitJobsInterval_(defaultSubmitJobsInterval),
       ecf_prune_node_log_(0),
+      compression_threshold_(0),
+      read_threads_(0),
+      checkpt_async_(0),
+      checkpt_journal_(0),
+      script_cache_(0),
+      job_threads_(0),
+      posix_spawn_(0),
+      fetch_async_(0),
+      fetch_timeout_(60),
+      path_cache_(0),
+      path_cache_ttl_(60),
+      job_profile_(0),
+      job_rate_(0),
+      job_host_rate_(0),
+      dependency_index_(0),
+      include_cache_size_(64),
+      script_cache_size_(128),
       jobGeneration_(true),
       debug_(false),
       help_option_(false),
@@ -95,6 +112,23 @@ ServerEnvironment::ServerEnvironment(int argc, char* argv[], const std::string&
       checkpt_save_time_alarm_(CheckPt::default_save_time_alarm()),
       submitJobsInterval_(defaultSubmitJobsInterval),
       ecf_prune_node_log_(0),
+      compression_threshold_(0),
+      read_threads_(0),
+      checkpt_async_(0),
+      checkpt_journal_(0),
+      script_cache_(0),
+      job_threads_(0),
+      posix_spawn_(0),
+      fetch_async_(0),
+      fetch_timeout_(60),
+      path_cache_(0),
+      path_cache_ttl_(60),
+      job_profile_(0),
+      job_rate_(0),
+      job_host_rate_(0),
+      dependency_index_(0),
+      include_cache_size_(64),
+      script_cache_size_(128),
       jobGeneration_(true),
       debug_(false),
       help_option_(false),
@@ -266,6 +300,108 @@ bool ServerEnvironment::valid(std::string& errorMsg) const {
         errorMsg = ss.str();
         return false;
     }
+    if (compression_threshold_ < 0) {
+        ss << "ECF_COMPRESSION_THRESHOLD not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. It must be 0 (disabled) or a size in bytes\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (read_threads_ < 0 || read_threads_ > 64) {
+        ss << "ECF_READ_THREADS not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. It must be in the range [0-64]\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (checkpt_async_ < 0 || checkpt_async_ > 1) {
+        ss << "ECF_CHECKPT_ASYNC not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (checkpt_journal_ < 0 || checkpt_journal_ > 1) {
+        ss << "ECF_CHECKPT_JOURNAL not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (script_cache_ < 0 || script_cache_ > 1) {
+        ss << "ECF_SCRIPT_CACHE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (job_threads_ < 0 || job_threads_ > 256) {
+        ss << "ECF_JOB_THREADS not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a value between 0 and 256\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (posix_spawn_ < 0 || posix_spawn_ > 1) {
+        ss << "ECF_POSIX_SPAWN not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (fetch_async_ < 0 || fetch_async_ > 1024) {
+        ss << "ECF_FETCH_ASYNC not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0-1024\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (fetch_timeout_ < 0) {
+        ss << "ECF_FETCH_TIMEOUT not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (path_cache_ < 0 || path_cache_ > 1) {
+        ss << "ECF_PATH_CACHE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (path_cache_ttl_ < 0) {
+        ss << "ECF_PATH_CACHE_TTL not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected value >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (job_profile_ < 0) {
+        ss << "ECF_JOB_PROFILE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a number of polls >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (job_rate_ < 0) {
+        ss << "ECF_JOB_RATE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a number of jobs >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (job_host_rate_ < 0) {
+        ss << "ECF_JOB_HOST_RATE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a number of jobs >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (dependency_index_ < 0 || dependency_index_ > 1) {
+        ss << "ECF_DEPENDENCY_INDEX not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected 0 or 1\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (include_cache_size_ < 0) {
+        ss << "ECF_INCLUDE_CACHE_SIZE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a size in MB >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
+    if (script_cache_size_ < 0) {
+        ss << "ECF_SCRIPT_CACHE_SIZE not set correctly. Please set in Server/server_environment.cfg\n";
+        ss << "or via environment variable of same name. Expected a size in MB >= 0\n";
+        errorMsg = ss.str();
+        return false;
+    }
     if (ecf_checkpt_file_.empty()) {
         ss << "No checkpoint file name specified. Please set in Server/server_environment.cfg or\n";
         ss << "set the environment variable ECF_CHECK\n";
@@ -622,7 +758,58 @@ void ServerEnvironment::read_config_file(std::string& log_file_name, const std::
             "The defaults thresholds when profiling job generation")(
             "ECF_PRUNE_NODE_LOG",
             po::value<int>(&ecf_prune_node_log_)->default_value(30),
-            "Node log, older than 180 days automatically pruned when checkpoint file loaded");
+            "Node log, older than 180 days automatically pruned when checkpoint file loaded")(
+            "ECF_COMPRESSION_THRESHOLD",
+            po::value<int>(&compression_threshold_)->default_value(0),
+            "Compress replies larger than this size in bytes, for clients that support it. 0 disables compression")(
+            "ECF_READ_THREADS",
+            po::value<int>(&read_threads_)->default_value(0),
+            "Number of threads used to handle read only requests. 0 handles all requests on the main thread")(
+            "ECF_CHECKPT_ASYNC",
+            po::value<int>(&checkpt_async_)->default_value(0),
+            "0 saves the check point file on the main server thread. 1 saves in the background")(
+            "ECF_CHECKPT_JOURNAL",
+            po::value<int>(&checkpt_journal_)->default_value(0),
+            "1 appends the state changes to a journal, in between the periodic check points")(
+            "ECF_SCRIPT_CACHE",
+            po::value<int>(&script_cache_)->default_value(0),
+            "1 shares the pre-processed scripts, between tasks using the same script")(
+            "ECF_JOB_THREADS",
+            po::value<int>(&job_threads_)->default_value(0),
+            "Number of threads used to create the job files. 0 or 1 creates the job files on the main thread")(
+            "ECF_POSIX_SPAWN",
+            po::value<int>(&posix_spawn_)->default_value(0),
+            "Start ECF_JOB_CMD, ECF_KILL_CMD and ECF_STATUS_CMD with posix_spawn, rather than fork. Default is 0")(
+            "ECF_FETCH_ASYNC",
+            po::value<int>(&fetch_async_)->default_value(0),
+            "Maximum number of ECF_FETCH/ECF_SCRIPT_CMD commands run in the background. 0 runs them synchronously")(
+            "ECF_FETCH_TIMEOUT",
+            po::value<int>(&fetch_timeout_)->default_value(60),
+            "Seconds after which a background ECF_FETCH/ECF_SCRIPT_CMD command is killed. 0 means no timeout")(
+            "ECF_PATH_CACHE",
+            po::value<int>(&path_cache_)->default_value(0),
+            "When 1, cache the location of scripts and include files across job submissions")(
+            "ECF_PATH_CACHE_TTL",
+            po::value<int>(&path_cache_ttl_)->default_value(60),
+            "Seconds a failed search for a script or include file is cached, when ECF_PATH_CACHE=1")(
+            "ECF_JOB_PROFILE",
+            po::value<int>(&job_profile_)->default_value(0),
+            "Number of polls for which the latency of each phase of job generation is kept. 0 disables")(
+            "ECF_JOB_RATE",
+            po::value<int>(&job_rate_)->default_value(0),
+            "Maximum number of jobs submitted by each job generation. 0 means no limit")(
+            "ECF_JOB_HOST_RATE",
+            po::value<int>(&job_host_rate_)->default_value(0),
+            "Maximum number of jobs submitted by each job generation, for each ECF_JOB_HOST. 0 means no limit")(
+            "ECF_DEPENDENCY_INDEX",
+            po::value<int>(&dependency_index_)->default_value(0),
+            "1 only resolves the dependencies of suites affected by changes. 0 resolves all suites on every poll")(
+            "ECF_INCLUDE_CACHE_SIZE",
+            po::value<int>(&include_cache_size_)->default_value(64),
+            "Maximum size in MB of the include files cached by job generation. 0 disables the cache")(
+            "ECF_SCRIPT_CACHE_SIZE",
+            po::value<int>(&script_cache_size_)->default_value(128),
+            "Maximum size in MB of the pre-processed scripts cached, when ECF_SCRIPT_CACHE=1");
 
         ifstream ifs(path_to_config_file.c_str());
         if (!ifs) {
@@ -728,6 +915,19 @@ void ServerEnvironment::read_environment_variables(std::string& log_file_name) {
         }
     }
 
+    char* compression_threshold = getenv("ECF_COMPRESSION_THRESHOLD");
+    if (compression_threshold) {
+        try {
+            compression_threshold_ = boost::lexical_cast<int>(compression_threshold);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_COMPRESSION_THRESHOLD is defined("
+               << compression_threshold << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
     if (getenv("ECF_DEBUG_SERVER")) {
         debug_ = true; // can also be enabled via --debug option
     }
@@ -751,6 +951,214 @@ void ServerEnvironment::read_environment_variables(std::string& log_file_name) {
             throw ServerEnvironmentException(ss.str());
         }
     }
+
+    char* read_threads = getenv("ECF_READ_THREADS");
+    if (read_threads) {
+        try {
+            read_threads_ = boost::lexical_cast<int>(read_threads);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_READ_THREADS is defined("
+               << read_threads << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* checkpt_async = getenv("ECF_CHECKPT_ASYNC");
+    if (checkpt_async) {
+        try {
+            checkpt_async_ = boost::lexical_cast<int>(checkpt_async);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_CHECKPT_ASYNC is defined("
+               << checkpt_async << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* checkpt_journal = getenv("ECF_CHECKPT_JOURNAL");
+    if (checkpt_journal) {
+        try {
+            checkpt_journal_ = boost::lexical_cast<int>(checkpt_journal);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_CHECKPT_JOURNAL is defined("
+               << checkpt_journal << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* script_cache = getenv("ECF_SCRIPT_CACHE");
+    if (script_cache) {
+        try {
+            script_cache_ = boost::lexical_cast<int>(script_cache);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_SCRIPT_CACHE is defined("
+               << script_cache << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* job_threads = getenv("ECF_JOB_THREADS");
+    if (job_threads) {
+        try {
+            job_threads_ = boost::lexical_cast<int>(job_threads);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_JOB_THREADS is defined("
+               << job_threads << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* posix_spawn = getenv("ECF_POSIX_SPAWN");
+    if (posix_spawn) {
+        try {
+            posix_spawn_ = boost::lexical_cast<int>(posix_spawn);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_POSIX_SPAWN is defined("
+               << posix_spawn << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* fetch_async = getenv("ECF_FETCH_ASYNC");
+    if (fetch_async) {
+        try {
+            fetch_async_ = boost::lexical_cast<int>(fetch_async);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_FETCH_ASYNC is defined("
+               << fetch_async << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* fetch_timeout = getenv("ECF_FETCH_TIMEOUT");
+    if (fetch_timeout) {
+        try {
+            fetch_timeout_ = boost::lexical_cast<int>(fetch_timeout);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_FETCH_TIMEOUT is defined("
+               << fetch_timeout << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* path_cache = getenv("ECF_PATH_CACHE");
+    if (path_cache) {
+        try {
+            path_cache_ = boost::lexical_cast<int>(path_cache);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_PATH_CACHE is defined("
+               << path_cache << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* path_cache_ttl = getenv("ECF_PATH_CACHE_TTL");
+    if (path_cache_ttl) {
+        try {
+            path_cache_ttl_ = boost::lexical_cast<int>(path_cache_ttl);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_PATH_CACHE_TTL is defined("
+               << path_cache_ttl << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* job_profile = getenv("ECF_JOB_PROFILE");
+    if (job_profile) {
+        try {
+            job_profile_ = boost::lexical_cast<int>(job_profile);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_JOB_PROFILE is defined("
+               << job_profile << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* job_rate = getenv("ECF_JOB_RATE");
+    if (job_rate) {
+        try {
+            job_rate_ = boost::lexical_cast<int>(job_rate);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_JOB_RATE is defined("
+               << job_rate << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* job_host_rate = getenv("ECF_JOB_HOST_RATE");
+    if (job_host_rate) {
+        try {
+            job_host_rate_ = boost::lexical_cast<int>(job_host_rate);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_JOB_HOST_RATE is defined("
+               << job_host_rate << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* dependency_index = getenv("ECF_DEPENDENCY_INDEX");
+    if (dependency_index) {
+        try {
+            dependency_index_ = boost::lexical_cast<int>(dependency_index);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_DEPENDENCY_INDEX is defined("
+               << dependency_index << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* include_cache_size = getenv("ECF_INCLUDE_CACHE_SIZE");
+    if (include_cache_size) {
+        try {
+            include_cache_size_ = boost::lexical_cast<int>(include_cache_size);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_INCLUDE_CACHE_SIZE is defined("
+               << include_cache_size << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
+
+    char* script_cache_size = getenv("ECF_SCRIPT_CACHE_SIZE");
+    if (script_cache_size) {
+        try {
+            script_cache_size_ = boost::lexical_cast<int>(script_cache_size);
+        }
+        catch (boost::bad_lexical_cast& e) {
+            std::stringstream ss;
+            ss << "ServerEnvironment::read_environment_variables(): ECF_SCRIPT_CACHE_SIZE is defined("
+               << script_cache_size << ") but value is *not* convertible to an integer\n";
+            throw ServerEnvironmentException(ss.str());
+        }
+    }
 }
 
 void ServerEnvironment::change_dir_to_ecf_home_and_check_accesibility() {
@@ -793,6 +1201,23 @@ std::string ServerEnvironment::dump() const {
     ss << "ECF_URL = '" << url_ << "'\n";
     ss << "ECF_MICRO = '" << ecf_micro_ << "'\n";
     ss << "ECF_PRUNE_NODE_LOG = '" << ecf_prune_node_log_ << "'\n";
+    ss << "ECF_COMPRESSION_THRESHOLD = '" << compression_threshold_ << "'\n";
+    ss << "ECF_READ_THREADS = '" << read_threads_ << "'\n";
+    ss << "ECF_CHECKPT_ASYNC = '" << checkpt_async_ << "'\n";
+    ss << "ECF_CHECKPT_JOURNAL = '" << checkpt_journal_ << "'\n";
+    ss << "ECF_SCRIPT_CACHE = '" << script_cache_ << "'\n";
+    ss << "ECF_JOB_THREADS = '" << job_threads_ << "'\n";
+    ss << "ECF_POSIX_SPAWN = '" << posix_spawn_ << "'\n";
+    ss << "ECF_FETCH_ASYNC = '" << fetch_async_ << "'\n";
+    ss << "ECF_FETCH_TIMEOUT = '" << fetch_timeout_ << "'\n";
+    ss << "ECF_PATH_CACHE = '" << path_cache_ << "'\n";
+    ss << "ECF_PATH_CACHE_TTL = '" << path_cache_ttl_ << "'\n";
+    ss << "ECF_JOB_PROFILE = '" << job_profile_ << "'\n";
+    ss << "ECF_JOB_RATE = '" << job_rate_ << "'\n";
+    ss << "ECF_JOB_HOST_RATE = '" << job_host_rate_ << "'\n";
+    ss << "ECF_DEPENDENCY_INDEX = '" << dependency_index_ << "'\n";
+    ss << "ECF_INCLUDE_CACHE_SIZE = '" << include_cache_size_ << "'\n";
+    ss << "ECF_SCRIPT_CACHE_SIZE = '" << script_cache_size_ << "'\n";
     ss << "check pt save time alarm " << checkpt_save_time_alarm_ << "\n";
     ss << "Job generation " << jobGeneration_ << "\n";
     ss << "Server host name " << serverHost_ << "\n";
@@ -137,6 +137,71 @@ public:
     /// A value of 0, means no pruning. i.e keep old edit history .
     int ecf_prune_node_log() const { return ecf_prune_node_log_; }
 
+    /// Returns ECF_COMPRESSION_THRESHOLD, the size in bytes above which replies are compressed.
+    /// Only applies to clients that support compression. A value of 0 (the default) disables compression.
+    int compression_threshold() const { return compression_threshold_; }
+
+    /// Returns ECF_READ_THREADS, the number of threads used to handle read only requests, i.e. sync, news
+    /// and show. These run alongside the main thread, but never at the same time as requests that change
+    /// the server state, job generation or check pointing. 0 (the default) handles all requests on the
+    /// main thread.
+    int read_threads() const { return read_threads_; }
+
+    /// Returns true if ECF_CHECKPT_ASYNC is 1. The periodic check point is then saved in the background: the
+    /// server only takes an in memory snapshot of the definition, which a writer thread saves to a temporary
+    /// file, syncs to disk and renames over ECF_CHECK. Explicit check point requests are always saved immediately.
+    bool checkpt_async() const { return checkpt_async_ != 0; }
+
+    /// Returns true if ECF_CHECKPT_JOURNAL is 1. In between the periodic check points, the state changes are
+    /// appended to a journal, which is replayed over the check point file on start up.
+    bool checkpt_journal() const { return checkpt_journal_ != 0; }
+
+    /// Returns true if ECF_SCRIPT_CACHE is 1. The pre-processed scripts are then shared between the tasks using
+    /// the same script, see PreProcessedScriptCache.
+    bool script_cache() const { return script_cache_ != 0; }
+
+    /// Returns ECF_JOB_THREADS, the number of threads used to create the job files, of the tasks that are free
+    /// in the same node tree traversal. 0 or 1 (the default is 0) creates the job files on the main thread.
+    int job_threads() const { return job_threads_; }
+
+    /// Returns true if ECF_POSIX_SPAWN is 1. ECF_JOB_CMD, ECF_KILL_CMD and ECF_STATUS_CMD are then started with
+    /// posix_spawn, rather than fork, see ecf::System
+    bool posix_spawn() const { return posix_spawn_ != 0; }
+
+    /// Returns ECF_FETCH_ASYNC, the maximum number of ECF_FETCH/ECF_SCRIPT_CMD commands run in the background,
+    /// see ScriptFetcher. 0 (the default) runs the commands synchronously, during job generation.
+    int fetch_async() const { return fetch_async_; }
+
+    /// Returns ECF_FETCH_TIMEOUT, the seconds after which a background fetch command is killed. 0 means no timeout
+    int fetch_timeout() const { return fetch_timeout_; }
+
+    /// Cache the location of scripts and include files, see ScriptPathCache
+    bool path_cache() const { return path_cache_ != 0; }
+
+    /// Returns ECF_PATH_CACHE_TTL, the seconds a failed search for a script or include file is cached
+    int path_cache_ttl() const { return path_cache_ttl_; }
+
+    /// Returns ECF_JOB_PROFILE, the number of polls for which the job generation is profiled
+    int job_profile() const { return job_profile_; }
+
+    /// Returns ECF_JOB_RATE, the maximum number of jobs submitted by each job generation, see JobThrottle
+    int job_rate() const { return job_rate_; }
+
+    /// Returns ECF_JOB_HOST_RATE, as job_rate(), for each ECF_JOB_HOST
+    int job_host_rate() const { return job_host_rate_; }
+
+    /// Returns true if ECF_DEPENDENCY_INDEX is 1 (the default is 0). Job generation then only resolves the
+    /// dependencies of the suites affected by changes since the last job generation, see DependencyIndex
+    bool dependency_index() const { return dependency_index_ != 0; }
+
+    /// Returns ECF_INCLUDE_CACHE_SIZE, the maximum size in MB of the include files cached by job generation,
+    /// see IncludeFileCache. The least recently used files are evicted first. 0 disables the cache
+    int include_cache_size() const { return include_cache_size_; }
+
+    /// Returns ECF_SCRIPT_CACHE_SIZE, the maximum size in MB of the pre-processed scripts cached, when
+    /// ECF_SCRIPT_CACHE is 1, see PreProcessedScriptCache. The least recently used scripts are evicted first
+    int script_cache_size() const { return script_cache_size_; }
+
     /// returns server variables, as vector of pairs.
     /// Some of these variables hold environment variables
     /// Note:: additional variable are created for use by clients, i.e like
@@ -210,6 +275,23 @@ private:
     int checkpt_save_time_alarm_;
     int submitJobsInterval_;
     int ecf_prune_node_log_;
+    int compression_threshold_;
+    int read_threads_;
+    int checkpt_async_;
+    int checkpt_journal_;
+    int script_cache_;
+    int job_threads_;
+    int posix_spawn_;
+    int fetch_async_;
+    int fetch_timeout_;
+    int path_cache_;
+    int path_cache_ttl_;
+    int job_profile_;
+    int job_rate_;
+    int job_host_rate_;
+    int dependency_index_;
+    int include_cache_size_;
+    int script_cache_size_;
     bool jobGeneration_; // used in debug/test mode only
     bool debug_;
     bool help_option_;
@@ -39,6 +39,7 @@ void SslTcpServer::start_accept() {
     ssl_connection_ptr new_conn =
         std::make_shared<ssl_connection>(boost::ref(io_service_), boost::ref(serverEnv_.openssl().context()));
 
+    new_conn->set_compression_threshold(serverEnv_.compression_threshold());
     acceptor_.async_accept(new_conn->socket_ll(),
                            [this, new_conn](const boost::system::error_code& e) { handle_accept(e, new_conn); });
 }
@@ -107,6 +108,10 @@ void SslTcpServer::handle_read(const boost::system::error_code& e, ssl_connectio
     // ***********************************************************************************
     if (!e) {
 
+        // Read only requests may be handled on a reader thread, which also replies to the client
+        if (handle_read_only_request(conn))
+            return;
+
         handle_request(); // populates outbound_response_
 
         // Always *Reply* back to the client, Otherwise client will get EOF
@@ -137,6 +142,8 @@ void SslTcpServer::handle_write(const boost::system::error_code& e, ssl_connecti
         return;
     }
 
+    update_compression_stats(conn->uncompressed_size(), conn->compressed_size(), conn->compression_time());
+
     // Do any necessary clean up after outbound_response_  has run. i.e like re-claiming memory
     outbound_response_.cleanup();
 
@@ -34,6 +34,9 @@ TcpBaseServer::TcpBaseServer(BaseServer* server, boost::asio::io_service& io_ser
     acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
     acceptor_.bind(endpoint);
     acceptor_.listen(); // address is use error, when it comes, bombs out here
+
+    if (serverEnv.read_threads() > 0)
+        reader_pool_ = std::make_unique<boost::asio::thread_pool>(serverEnv.read_threads());
 }
 
 void TcpBaseServer::handle_request() {
@@ -41,6 +44,8 @@ void TcpBaseServer::handle_request() {
     if (serverEnv_.debug())
         std::cout << "   TcpBaseServer::handle_request  : client request " << inbound_request_ << endl;
 
+    // Exclude read only requests, that may be running on other threads
+    std::unique_lock<std::shared_mutex> state_lock(server_->state_mutex());
     try {
         // Service the in bound request, handling the request will populate the outbound_response_
         // Note:: Handle request will first authenticate
@@ -54,6 +59,45 @@ void TcpBaseServer::handle_request() {
     inbound_request_.cleanup();
 }
 
+void TcpBaseServer::reply_to_read_only_request(const Cmd_ptr& cmd,
+                                               const std::function<void(ServerToClientResponse&)>& reply) {
+    if (serverEnv_.debug())
+        std::cout << "   TcpBaseServer::reply_to_read_only_request : client request " << cmd->print_short() << endl;
+
+    // Exclude anything that can change the server state, but not other read only requests
+    std::shared_lock<std::shared_mutex> state_lock(server_->state_mutex());
+
+    // The replies are allocated per thread, see PreAllocatedReply
+    ServerToClientResponse response;
+    {
+        std::lock_guard<std::mutex> request_lock(server_->read_request_mutex());
+        try {
+            response.set_cmd(cmd->handleRequest(server_));
+        }
+        catch (exception& e) {
+            response.set_cmd(PreAllocatedReply::error_cmd(e.what()));
+        }
+        cmd->cleanup();
+    }
+
+    // Serialise the response, and write it to the client, concurrently with other read only requests
+    reply(response);
+    response.cleanup();
+}
+
+void TcpBaseServer::update_compression_stats(std::size_t uncompressed_size,
+                                             std::size_t compressed_size,
+                                             std::chrono::microseconds compression_time) {
+    if (compressed_size == 0)
+        return;
+
+    std::lock_guard<std::mutex> request_lock(server_->read_request_mutex());
+    server_->stats().update_compression(uncompressed_size, compressed_size, compression_time);
+    if (serverEnv_.debug())
+        std::cout << "   TcpBaseServer::update_compression_stats: compressed reply from " << uncompressed_size
+                  << " to " << compressed_size << " bytes in " << compression_time.count() << "us" << endl;
+}
+
 void TcpBaseServer::handle_read_error(const boost::system::error_code& e) {
     // An error occurred.
     // o/ If client has been killed/disconnected/timed out
@@ -110,6 +154,10 @@ void TcpBaseServer::handle_terminate() {
     if (serverEnv_.debug())
         cout << "   Server::handle_terminate() : cancelling checkpt and traverser timers, and signals" << endl;
 
+    // Let the reader threads finish any outstanding requests
+    if (reader_pool_)
+        reader_pool_->join();
+
     server_->handle_terminate();
 
     acceptor_.close();
@@ -14,7 +14,12 @@
 // nor does it submit to any jurisdiction.
 /////////1/////////2/////////3/////////4/////////5/////////6/////////7/////////8
 
+#include <chrono>
+#include <functional>
+#include <memory>
+
 #include <boost/asio.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include "ClientToServerRequest.hpp"
 #include "Log.hpp"
@@ -38,6 +43,41 @@ public:
     void terminate();
     void handle_terminate();
 
+    /// Record the compression of the reply just sent, if it was compressed.
+    void update_compression_stats(std::size_t uncompressed_size,
+                                  std::size_t compressed_size,
+                                  std::chrono::microseconds compression_time);
+
+    /// Hand a read only request to the pool of reader threads (see ECF_READ_THREADS), which also replies
+    /// to the client. Returns false if the request must be handled by the caller, on the main thread.
+    template <typename T>
+    bool handle_read_only_request(T conn) {
+        if (!reader_pool_ || !inbound_request_.readOnlyRequest())
+            return false;
+
+        Cmd_ptr cmd = inbound_request_.get_cmd();
+        boost::asio::post(*reader_pool_, [this, conn, cmd]() {
+            reply_to_read_only_request(cmd, [this, conn](ServerToClientResponse& response) {
+                conn->async_write(response,
+                                  [this, conn](const boost::system::error_code& e) { handle_read_only_write(e, conn); });
+            });
+        });
+        return true;
+    }
+
+    template <typename T>
+    void handle_read_only_write(const boost::system::error_code& e, T conn) {
+        if (e) {
+            ecf::LogFlusher logFlusher;
+            ecf::LogToCout logToCout;
+            ecf::log(ecf::Log::ERR, "TcpBaseServer::handle_read_only_write: " + e.message());
+            return;
+        }
+
+        update_compression_stats(conn->uncompressed_size(), conn->compressed_size(), conn->compression_time());
+        (void)shutdown_socket(conn, "TcpBaseServer::handle_read_only_write:");
+    }
+
     template <typename T>
     bool shutdown_socket(T conn, const std::string& msg) const {
         // For portable behaviour with respect to graceful closure of a connected socket,
@@ -61,6 +101,10 @@ public:
         return true;
     }
 
+private:
+    /// Run on a reader thread. Handles the read only request, and then calls reply to serialise the response
+    void reply_to_read_only_request(const Cmd_ptr& cmd, const std::function<void(ServerToClientResponse&)>& reply);
+
 protected:
     BaseServer* server_;
     boost::asio::io_service& io_service_;
@@ -72,6 +116,9 @@ protected:
     /// The data, typically loaded once, and then sent to many clients
     ClientToServerRequest inbound_request_;
     ServerToClientResponse outbound_response_;
+
+    /// Handles read only requests, when ECF_READ_THREADS is set
+    std::unique_ptr<boost::asio::thread_pool> reader_pool_;
 };
 
 #endif
@@ -35,6 +35,7 @@ void TcpServer::start_accept() {
     if (serverEnv_.debug())
         cout << "   TcpServer::start_accept()" << endl;
     connection_ptr new_conn = std::make_shared<connection>(boost::ref(io_service_));
+    new_conn->set_compression_threshold(serverEnv_.compression_threshold());
     acceptor_.async_accept(new_conn->socket_ll(),
                            [this, new_conn](const boost::system::error_code& e) { handle_accept(e, new_conn); });
 }
@@ -89,6 +90,10 @@ void TcpServer::handle_read(const boost::system::error_code& e, connection_ptr c
     // ***********************************************************************************
     if (!e) {
 
+        // Read only requests may be handled on a reader thread, which also replies to the client
+        if (handle_read_only_request(conn))
+            return;
+
         handle_request(); // populates outbound_response_
         // log(Log::DBG," handle_read()  n"  + timer_.format(3,Str::cpu_timer_format()));
 
@@ -123,6 +128,8 @@ void TcpServer::handle_write(const boost::system::error_code& e, connection_ptr
         return;
     }
 
+    update_compression_stats(conn->uncompressed_size(), conn->compressed_size(), conn->compression_time());
+
     // Do any necessary clean up after outbound_response_  has run. i.e like re-claiming memory
     outbound_response_.cleanup();
 
@@ -14,18 +14,24 @@
 //============================================================================
 
 #include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iostream>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include "CheckPtJournal.hpp"
 #include "Defs.hpp"
 #include "EcfPortLock.hpp"
 #include "Host.hpp"
 #include "Log.hpp"
 #include "Server.hpp"
 #include "ServerEnvironment.hpp"
+#include "Suite.hpp"
+#include "SuiteChanged.hpp"
+#include "Task.hpp"
 
 using namespace std;
 using namespace ecf;
@@ -154,9 +160,8 @@ void test_the_server(const std::string& port) {
     }
 }
 
-BOOST_AUTO_TEST_CASE(test_server) {
-    cout << "Server:: ...test_server\n";
-
+/// Run the test, with a server on a free port
+void run_on_free_port(const std::function<void(const std::string&)>& test) {
     // Create a unique port number, allowing debug and release,gnu,clang,intel to run at the same time
     // Hence the lock file is not always sufficient.
     // ECF_FREE_PORT should be unique among  gnu,clang,intel, etc
@@ -177,7 +182,7 @@ BOOST_AUTO_TEST_CASE(test_server) {
     int count = 0;
     while (1) {
         try {
-            test_the_server(port);
+            test(port);
             cout << "\n";
             break;
         }
@@ -211,4 +216,167 @@ BOOST_AUTO_TEST_CASE(test_server) {
     Log::destroy();
 }
 
+BOOST_AUTO_TEST_CASE(test_server) {
+    cout << "Server:: ...test_server\n";
+    run_on_free_port(test_the_server);
+}
+
+void test_the_server_checkpt_async(const std::string& port) {
+    std::string server_port = "--port=" + port;
+    int argc                = 2;
+    char* argv[]            = {const_cast<char*>("ServerEnvironment"), const_cast<char*>(server_port.c_str())};
+
+    ServerEnvironment server_environment(argc, argv); // This can throw ServerEnvironmentException
+    std::string errorMsg;
+    BOOST_CHECK_MESSAGE(server_environment.valid(errorMsg), errorMsg);
+    BOOST_REQUIRE_MESSAGE(server_environment.checkpt_async(), "Expected check point to be saved in the background");
+
+    std::string checkpt_file = server_environment.checkPtFilename();
+    {
+        boost::asio::io_service io_service;
+        TestServer theServer(io_service, server_environment); // This can throw exception, bind address in use.
+        theServer.defs()->add_suite("s1");
+
+        // Save on each state change, this is saved in the background
+        theServer.checkPtDefs(ecf::CheckPt::ALWAYS);
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_background_ == 1,
+                            "Expected a background check point but found " << theServer.stats().checkpt_background_);
+
+        // An explicit check point waits for the background save, and then saves immediately
+        theServer.defs()->add_suite("s2");
+        BOOST_CHECK_MESSAGE(theServer.checkPtDefs(), "Expected explicit check point to succeed");
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_background_ == 1,
+                            "Expected explicit check point to be immediate");
+        BOOST_CHECK_MESSAGE(fs::exists(server_environment.oldCheckPtFilename()),
+                            "Expected background check point to be backed up");
+
+        // Saved in the background, the server destructor waits for the save to complete
+        theServer.defs()->add_suite("s3");
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_background_ == 2,
+                            "Expected a background check point but found " << theServer.stats().checkpt_background_);
+    }
+
+    BOOST_CHECK_MESSAGE(!fs::exists(checkpt_file + ".tmp"), "Expected temporary check point file to be renamed");
+    defs_ptr defs = Defs::create();
+    defs->restore(checkpt_file);
+    BOOST_CHECK_MESSAGE(defs->suiteVec().size() == 3,
+                        "Expected 3 suites in the check point file but found " << defs->suiteVec().size());
+
+    fs::remove(checkpt_file);
+    fs::remove(server_environment.oldCheckPtFilename());
+}
+
+BOOST_AUTO_TEST_CASE(test_server_checkpt_async) {
+    cout << "Server:: ...test_server_checkpt_async\n";
+
+    auto* put = const_cast<char*>("ECF_CHECKPT_ASYNC=1");
+    BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+
+    run_on_free_port(test_the_server_checkpt_async);
+
+    unsetenv(const_cast<char*>("ECF_CHECKPT_ASYNC")); // remove from env, otherwise affects other tests
+}
+
+void test_the_server_checkpt_journal(const std::string& port) {
+    std::string server_port = "--port=" + port;
+    int argc                = 2;
+    char* argv[]            = {const_cast<char*>("ServerEnvironment"), const_cast<char*>(server_port.c_str())};
+
+    ServerEnvironment server_environment(argc, argv); // This can throw ServerEnvironmentException
+    std::string errorMsg;
+    BOOST_CHECK_MESSAGE(server_environment.valid(errorMsg), errorMsg);
+    BOOST_REQUIRE_MESSAGE(server_environment.checkpt_journal(), "Expected state changes to be journaled");
+
+    std::string checkpt_file = server_environment.checkPtFilename();
+    std::string journal_file = CheckPtJournal::journal_filename(checkpt_file);
+    {
+        boost::asio::io_service io_service;
+        TestServer theServer(io_service, server_environment); // This can throw exception, bind address in use.
+        suite_ptr suite = theServer.defs()->add_suite("s1");
+        suite->add_task("t1")->addEvent(Event("event"));
+        BOOST_CHECK_MESSAGE(theServer.checkPtDefs(), "Expected explicit check point to succeed");
+
+        // State changes are journaled
+        {
+            SuiteChanged1 changed(suite.get());
+            theServer.defs()->findAbsNode("/s1/t1")->set_event("event", true);
+        }
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_journal_records_ == 1,
+                            "Expected 1 journal record but found " << theServer.stats().checkpt_journal_records_);
+        BOOST_CHECK_MESSAGE(fs::exists(journal_file), "Expected journal file " << journal_file);
+
+        // Structural changes suspend the journal, until the next full check point
+        theServer.defs()->add_suite("s2");
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(fs::exists(journal_file), "Expected no full check point for a structural change");
+        {
+            SuiteChanged1 changed(suite.get());
+            theServer.defs()->findAbsNode("/s1/t1")->set_state(NState::SUBMITTED);
+        }
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_journal_records_ == 1,
+                            "Expected journal to be suspended, but found "
+                                << theServer.stats().checkpt_journal_records_ << " records");
+
+        BOOST_CHECK_MESSAGE(theServer.checkPtDefs(), "Expected explicit check point to succeed");
+        BOOST_CHECK_MESSAGE(!fs::exists(journal_file), "Expected full check point to start a new journal");
+        {
+            SuiteChanged1 changed(suite.get());
+            theServer.defs()->findAbsNode("/s1/t1")->set_state(NState::ABORTED);
+        }
+        theServer.nodeTreeStateChanged();
+        BOOST_CHECK_MESSAGE(theServer.stats().checkpt_journal_records_ == 2,
+                            "Expected 2 journal records but found " << theServer.stats().checkpt_journal_records_);
+    }
+
+    // The journal is replayed over the check point file, on start up
+    {
+        boost::asio::io_service io_service;
+        TestServer theServer(io_service, server_environment);
+        BOOST_REQUIRE_MESSAGE(theServer.defs()->suiteVec().size() == 2,
+                              "Expected 2 suites to be restored but found " << theServer.defs()->suiteVec().size());
+        node_ptr task = theServer.defs()->findAbsNode("/s1/t1");
+        BOOST_REQUIRE_MESSAGE(task, "Expected to find /s1/t1");
+        BOOST_CHECK_MESSAGE(task->state() == NState::ABORTED,
+                            "Expected journaled state to be replayed, but found " << NState::toString(task->state()));
+        BOOST_CHECK_MESSAGE(task->findEventByNameOrNumber("event").value(), "Expected journaled event to be replayed");
+
+        // The restored defs are written as the new check point, further changes start a new journal
+        BOOST_CHECK_MESSAGE(!CheckPtJournal::exists(checkpt_file), "Expected journals to be replaced by a check point");
+    }
+
+    // The journal of the check point file, does not apply to the backup check point file
+    {
+        {
+            std::ofstream journal(journal_file.c_str(), std::ios::binary);
+            journal << "journal of a different check point";
+        }
+        fs::remove(checkpt_file);
+        boost::asio::io_service io_service;
+        TestServer theServer(io_service, server_environment);
+        BOOST_CHECK_MESSAGE(theServer.defs()->suiteVec().size() == 2,
+                            "Expected 2 suites to be restored from the backup check point file");
+        BOOST_CHECK_MESSAGE(!CheckPtJournal::exists(checkpt_file), "Expected journal to be removed after restore");
+        BOOST_CHECK_MESSAGE(fs::exists(checkpt_file), "Expected a new check point, after restore");
+    }
+
+    fs::remove(checkpt_file);
+    fs::remove(server_environment.oldCheckPtFilename());
+    fs::remove(journal_file);
+}
+
+BOOST_AUTO_TEST_CASE(test_server_checkpt_journal) {
+    cout << "Server:: ...test_server_checkpt_journal\n";
+
+    auto* put = const_cast<char*>("ECF_CHECKPT_JOURNAL=1");
+    BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+
+    run_on_free_port(test_the_server_checkpt_journal);
+
+    unsetenv(const_cast<char*>("ECF_CHECKPT_JOURNAL")); // remove from env, otherwise affects other tests
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -368,4 +368,162 @@ BOOST_AUTO_TEST_CASE(test_server_profile_threshold_environment_variable) {
     Log::destroy();
 }
 
+BOOST_AUTO_TEST_CASE(test_server_read_threads_environment_variable) {
+    cout << "Server:: ...test_server_read_threads_environment_variable\n";
+    int argc     = 1;
+    char* argv[] = {const_cast<char*>("ServerEnvironment")};
+    {
+        ServerEnvironment serverEnv(argc, argv);
+        BOOST_CHECK_MESSAGE(serverEnv.read_threads() == 0,
+                            "Expected no read threads by default but found " << serverEnv.read_threads());
+    }
+    {
+        auto* put = const_cast<char*>("ECF_READ_THREADS=4");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+    }
+    ServerEnvironment serverEnv(argc, argv);
+    BOOST_CHECK_MESSAGE(serverEnv.read_threads() == 4, "Expected 4 read threads but found " << serverEnv.read_threads());
+
+    {
+        auto* put = const_cast<char*>("ECF_READ_THREADS=100");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment too_many(argc, argv);
+        std::string errorMsg;
+        BOOST_CHECK_MESSAGE(!too_many.valid(errorMsg), "Expected ECF_READ_THREADS=100 to be invalid");
+    }
+    {
+        auto* put = const_cast<char*>("ECF_READ_THREADS=x");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        BOOST_CHECK_THROW(ServerEnvironment serverEnv(argc, argv), std::runtime_error);
+    }
+
+    unsetenv(const_cast<char*>("ECF_READ_THREADS")); // remove from env, otherwise affects other tests
+
+    Host h;
+    fs::remove(h.ecf_log_file(serverEnv.the_port()));
+
+    /// Destroy Log singleton to avoid valgrind from complaining
+    Log::destroy();
+}
+
+BOOST_AUTO_TEST_CASE(test_server_checkpt_async_environment_variable) {
+    cout << "Server:: ...test_server_checkpt_async_environment_variable\n";
+    int argc     = 1;
+    char* argv[] = {const_cast<char*>("ServerEnvironment")};
+    ServerEnvironment serverEnv(argc, argv);
+    BOOST_CHECK_MESSAGE(!serverEnv.checkpt_async(), "Expected check point to be saved on the server thread by default");
+    {
+        auto* put = const_cast<char*>("ECF_CHECKPT_ASYNC=1");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment async(argc, argv);
+        BOOST_CHECK_MESSAGE(async.checkpt_async(), "Expected check point to be saved in the background");
+    }
+    {
+        auto* put = const_cast<char*>("ECF_CHECKPT_ASYNC=2");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment invalid(argc, argv);
+        std::string errorMsg;
+        BOOST_CHECK_MESSAGE(!invalid.valid(errorMsg), "Expected ECF_CHECKPT_ASYNC=2 to be invalid");
+    }
+
+    unsetenv(const_cast<char*>("ECF_CHECKPT_ASYNC")); // remove from env, otherwise affects other tests
+
+    Host h;
+    fs::remove(h.ecf_log_file(serverEnv.the_port()));
+
+    /// Destroy Log singleton to avoid valgrind from complaining
+    Log::destroy();
+}
+
+BOOST_AUTO_TEST_CASE(test_server_dependency_index_environment_variable) {
+    cout << "Server:: ...test_server_dependency_index_environment_variable\n";
+    int argc     = 1;
+    char* argv[] = {const_cast<char*>("ServerEnvironment")};
+    ServerEnvironment serverEnv(argc, argv);
+    BOOST_CHECK_MESSAGE(!serverEnv.dependency_index(), "Expected the dependency index to be disabled by default");
+    {
+        auto* put = const_cast<char*>("ECF_DEPENDENCY_INDEX=1");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment on(argc, argv);
+        BOOST_CHECK_MESSAGE(on.dependency_index(), "Expected the dependency index to be enabled");
+    }
+    {
+        auto* put = const_cast<char*>("ECF_DEPENDENCY_INDEX=2");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment invalid(argc, argv);
+        std::string errorMsg;
+        BOOST_CHECK_MESSAGE(!invalid.valid(errorMsg), "Expected ECF_DEPENDENCY_INDEX=2 to be invalid");
+    }
+
+    unsetenv(const_cast<char*>("ECF_DEPENDENCY_INDEX")); // remove from env, otherwise affects other tests
+
+    Host h;
+    fs::remove(h.ecf_log_file(serverEnv.the_port()));
+
+    /// Destroy Log singleton to avoid valgrind from complaining
+    Log::destroy();
+}
+
+BOOST_AUTO_TEST_CASE(test_server_include_cache_size_environment_variable) {
+    cout << "Server:: ...test_server_include_cache_size_environment_variable\n";
+    int argc     = 1;
+    char* argv[] = {const_cast<char*>("ServerEnvironment")};
+    ServerEnvironment serverEnv(argc, argv);
+    BOOST_CHECK_MESSAGE(serverEnv.include_cache_size() == 64,
+                        "Expected default include cache size of 64MB but found " << serverEnv.include_cache_size());
+    {
+        auto* put = const_cast<char*>("ECF_INCLUDE_CACHE_SIZE=256");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment changed(argc, argv);
+        BOOST_CHECK_MESSAGE(changed.include_cache_size() == 256,
+                            "Expected include cache size of 256MB but found " << changed.include_cache_size());
+    }
+    {
+        auto* put = const_cast<char*>("ECF_INCLUDE_CACHE_SIZE=-1");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment invalid(argc, argv);
+        std::string errorMsg;
+        BOOST_CHECK_MESSAGE(!invalid.valid(errorMsg), "Expected ECF_INCLUDE_CACHE_SIZE=-1 to be invalid");
+    }
+
+    unsetenv(const_cast<char*>("ECF_INCLUDE_CACHE_SIZE")); // remove from env, otherwise affects other tests
+
+    Host h;
+    fs::remove(h.ecf_log_file(serverEnv.the_port()));
+
+    /// Destroy Log singleton to avoid valgrind from complaining
+    Log::destroy();
+}
+
+BOOST_AUTO_TEST_CASE(test_server_script_cache_size_environment_variable) {
+    cout << "Server:: ...test_server_script_cache_size_environment_variable\n";
+    int argc     = 1;
+    char* argv[] = {const_cast<char*>("ServerEnvironment")};
+    ServerEnvironment serverEnv(argc, argv);
+    BOOST_CHECK_MESSAGE(serverEnv.script_cache_size() == 128,
+                        "Expected default script cache size of 128MB but found " << serverEnv.script_cache_size());
+    {
+        auto* put = const_cast<char*>("ECF_SCRIPT_CACHE_SIZE=512");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment changed(argc, argv);
+        BOOST_CHECK_MESSAGE(changed.script_cache_size() == 512,
+                            "Expected script cache size of 512MB but found " << changed.script_cache_size());
+    }
+    {
+        auto* put = const_cast<char*>("ECF_SCRIPT_CACHE_SIZE=-1");
+        BOOST_CHECK_MESSAGE(putenv(put) == 0, "putenv failed for " << put);
+        ServerEnvironment invalid(argc, argv);
+        std::string errorMsg;
+        BOOST_CHECK_MESSAGE(!invalid.valid(errorMsg), "Expected ECF_SCRIPT_CACHE_SIZE=-1 to be invalid");
+    }
+
+    unsetenv(const_cast<char*>("ECF_SCRIPT_CACHE_SIZE")); // remove from env, otherwise affects other tests
+
+    Host h;
+    fs::remove(h.ecf_log_file(serverEnv.the_port()));
+
+    /// Destroy Log singleton to avoid valgrind from complaining
+    Log::destroy();
+}
+
 BOOST_AUTO_TEST_SUITE_END()